@@ -0,0 +1,54 @@
+#ifndef ADC_FRAME_H
+#define ADC_FRAME_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief Pure decoder for ESP32-C6 continuous (DMA) ADC conversion frames.
+ *
+ * The continuous driver writes one 4-byte TYPE2 result per conversion,
+ * interleaved across every channel in the scan pattern:
+ *
+ *   bits  0..11  raw code
+ *   bit   12     reserved
+ *   bits 13..15  channel
+ *   bit   16     unit (0 = ADC1)
+ *
+ * ADC2 results, and channels that no lane asked for, are skipped.
+ */
+
+#define ADC_FRAME_RESULT_BYTES 4   ///< SOC_ADC_DIGI_RESULT_BYTES on the C6
+
+/**
+ * @brief One per-channel destination for de-interleaved samples.
+ *
+ * `channel`  — ADC1 channel whose results land in this lane
+ * `samples`  — caller-owned buffer of raw codes
+ * `capacity` — size of `samples`; extra results for the channel are dropped
+ * `count`    — out: number of samples written
+ */
+typedef struct {
+    uint8_t channel;
+    int    *samples;
+    size_t  capacity;
+    size_t  count;
+} adc_frame_lane_t;
+
+/**
+ * @brief Split a DMA buffer into per-channel lanes.
+ *
+ * Resets every lane's `count`, then walks `len / ADC_FRAME_RESULT_BYTES`
+ * results. Results from ADC2, for channels with no lane, or beyond a lane's
+ * capacity are skipped. A trailing partial result is ignored.
+ *
+ * @return number of results stored across all lanes
+ */
+size_t adc_frame_deinterleave(const uint8_t *buf, size_t len,
+                              adc_frame_lane_t *lanes, size_t n_lanes);
+
+/** True iff every lane has been filled to capacity. */
+bool adc_frame_lanes_full(const adc_frame_lane_t *lanes, size_t n_lanes);
+
+#endif // ADC_FRAME_H
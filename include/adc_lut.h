@@ -0,0 +1,61 @@
+#ifndef ADC_LUT_H
+#define ADC_LUT_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * @brief Precomputed raw-code -> mV conversion table.
+ *
+ * The IDF curve-fitting scheme is sampled once at ADC_LUT_KNOTS knots
+ * (every 64 codes). The knots are small enough to retain in RTC memory
+ * across deep sleep, keyed by eFuse calibration version + attenuation and
+ * guarded by a CRC. At boot they are expanded by linear interpolation into
+ * a full 4096-entry table so every conversion is a single indexed load.
+ *
+ * The knots cost about 150 bytes of RTC memory per attenuation; the
+ * expanded table is 8 KB of heap.
+ */
+
+#define ADC_LUT_CODES       4096
+#define ADC_LUT_KNOT_SHIFT  6
+#define ADC_LUT_KNOTS       ((ADC_LUT_CODES >> ADC_LUT_KNOT_SHIFT) + 1)   ///< 65: last knot at code 4095
+#define ADC_LUT_MAGIC       0xADC1707Bu
+
+/** RTC-retained knot set, valid only for the cali_ver and atten it was sampled at. */
+typedef struct {
+    uint32_t magic;
+    uint32_t cali_ver;                 ///< eFuse ADC calibration version
+    uint32_t atten;                    ///< adc_atten_t the knots were sampled at
+    uint16_t knot_mv[ADC_LUT_KNOTS];
+    uint16_t reserved;                 ///< Always 0
+    uint32_t crc;                      ///< crc32 over every field above
+} adc_lut_knots_t;
+
+/** Conversion the knots are sampled from; returns false on failure. */
+typedef bool (*adc_lut_convert_fn)(int raw, int *mv, void *ctx);
+
+/** Code at which knot `i` is sampled (the last knot is clamped to 4095). */
+int adc_lut_knot_code(int i);
+
+/**
+ * @brief Sample `convert` at every knot and seal the set with its CRC.
+ * @return false if any conversion failed (the set is left invalid)
+ */
+bool adc_lut_build_knots(adc_lut_knots_t *k, uint32_t cali_ver, uint32_t atten,
+                         adc_lut_convert_fn convert, void *ctx);
+
+/** True iff `k` is intact and was built for this calibration version + attenuation. */
+bool adc_lut_knots_valid(const adc_lut_knots_t *k, uint32_t cali_ver, uint32_t atten);
+
+/** Interpolate a valid knot set into `table[ADC_LUT_CODES]`. */
+void adc_lut_expand(const adc_lut_knots_t *k, uint16_t *table);
+
+/** Single indexed load; out-of-range codes clamp to the table ends. */
+static inline int adc_lut_lookup(const uint16_t *table, int raw) {
+    if (raw < 0) raw = 0;
+    if (raw >= ADC_LUT_CODES) raw = ADC_LUT_CODES - 1;
+    return table[raw];
+}
+
+#endif // ADC_LUT_H
@@ -1,9 +1,12 @@
 #ifndef ADC_MANAGER_H
 #define ADC_MANAGER_H
 
+#include <stdbool.h>
+#include <stdint.h>
 #include "esp_err.h"
 #include "esp_adc/adc_oneshot.h"
 #include "esp_adc/adc_cali.h"
+#include "adc_frame.h"
 
 /**
  * @brief Shared ADC manager
@@ -33,13 +36,63 @@ adc_cali_handle_t adc_manager_get_cali_handle(adc_channel_t channel, adc_atten_t
 
 /**
  * @brief Create or get calibration handle for channel
+ *
+ * Prefers a cached raw->mV table for the attenuation (restored from RTC
+ * memory on a warm wake); in that case no IDF scheme is built and
+ * *cali_handle is set to NULL. adc_manager_raw_to_mv() calls this on
+ * demand, so sensors never need to.
+ *
  * @param channel ADC channel
  * @param atten Attenuation level
- * @param cali_handle Output calibration handle
+ * @param cali_handle Output calibration handle (NULL when served by the table)
  * @return ESP_OK on success, error code otherwise
  */
 esp_err_t adc_manager_create_cali(adc_channel_t channel, adc_atten_t atten, adc_cali_handle_t *cali_handle);
 
+/**
+ * @brief Per-path counters and timings for adc_manager_resume().
+ */
+typedef struct {
+    uint32_t fast_count;        ///< Resumes whose first burst was not railed
+    uint32_t rebuild_count;     ///< Resumes that fell back to a full rebuild
+    uint32_t last_fast_us;      ///< Latest fast resume: validating scan + railed check
+    uint32_t last_rebuild_us;   ///< Latest rebuild: scan + check + reinit + on_rebuild + rescan
+    uint64_t total_fast_us;     ///< Sum over all fast resumes (for averages)
+    uint64_t total_rebuild_us;  ///< Sum over all rebuilds (for averages)
+    bool     last_rebuilt;      ///< The latest resume took the rebuild path
+} adc_manager_resume_stats_t;
+
+/**
+ * @brief Cheap post-light-sleep recovery: validate first, rebuild only if needed.
+ *
+ * Arms a check of the next adc_manager_scan() burst, taken while the
+ * caller's probes are powered. If no lane in it is railed (the signature
+ * of the lost C6 pad state), the unit is left as-is. Otherwise that scan
+ * falls back to adc_manager_reinit(), calls `on_rebuild` so the sensors can
+ * re-establish their channels, and samples again. Both paths are counted
+ * and timed in the resume stats.
+ *
+ * @param on_rebuild Called after a successful rebuild (may be NULL)
+ */
+void adc_manager_resume(void (*on_rebuild)(void));
+
+/** Snapshot of the resume counters and timings. */
+void adc_manager_get_resume_stats(adc_manager_resume_stats_t *out);
+
+/**
+ * @brief Convert a raw code to calibrated millivolts.
+ *
+ * A single indexed load from the cached table for `atten`; falls back to the
+ * IDF curve-fitting scheme if the table is missing or its RTC copy was corrupt.
+ *
+ * @param channel ADC channel (only used to build a fallback scheme)
+ * @param atten Attenuation the code was sampled at
+ * @param raw Raw ADC code
+ * @param[out] mv Calibrated millivolts
+ * @return ESP_OK on success, error code otherwise
+ */
+esp_err_t adc_manager_raw_to_mv(adc_channel_t channel, adc_atten_t atten, int raw, int *mv);
+
 /**
  * @brief Tear down and rebuild the shared ADC unit and all calibration schemes.
  *
@@ -52,4 +105,25 @@ esp_err_t adc_manager_create_cali(adc_channel_t channel, adc_atten_t atten, adc_
  */
 esp_err_t adc_manager_reinit(void);
 
+/**
+ * @brief Sample several ADC1 channels together in one continuous-mode (DMA) burst.
+ *
+ * Builds a scan pattern from the lanes, lets the DMA engine fill a frame with
+ * interleaved conversions while the calling task blocks (so the CPU can idle),
+ * then de-interleaves the frame into each lane's buffer. Each lane receives up
+ * to `capacity` raw codes; the burst length is sized from the largest lane.
+ *
+ * Falls back to an adc_oneshot_read() loop per lane if the continuous driver
+ * cannot be brought up, so callers always get samples on a healthy unit.
+ * The first scan after adc_manager_resume() also runs its railed check.
+ *
+ * @param lanes   Per-channel destinations (channel + buffer + capacity)
+ * @param n_lanes Number of lanes, at most ADC_MANAGER_SCAN_MAX_LANES
+ * @param atten   Attenuation applied to every channel in the burst
+ * @return ESP_OK if every lane received at least one sample
+ */
+#define ADC_MANAGER_SCAN_MAX_LANES    5    ///< Four soil probes + battery
+#define ADC_MANAGER_SCAN_MAX_SAMPLES  32   ///< per lane
+esp_err_t adc_manager_scan(adc_frame_lane_t *lanes, size_t n_lanes, adc_atten_t atten);
+
 #endif // ADC_MANAGER_H
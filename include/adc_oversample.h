@@ -0,0 +1,41 @@
+#ifndef ADC_OVERSAMPLE_H
+#define ADC_OVERSAMPLE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief Oversampling-and-decimation for extra effective ADC resolution.
+ *
+ * Summing 4^n noisy conversions and shifting right by n yields a code with
+ * n extra fractional bits (the ADC's own noise acts as dither). The result
+ * is a fixed-point code in Q`bits`: integer code = result >> bits.
+ *
+ * Reject outliers first (soil_moisture runs sample_reduce's MAD filter):
+ * one spike would shift the whole sum.
+ */
+
+/** Samples needed for `bits` extra bits of resolution (4^bits). */
+#define ADC_OVERSAMPLE_COUNT(bits)  (1u << (2u * (bits)))
+
+/**
+ * @brief Decimate a burst into one fixed-point code.
+ *
+ * Computes round(sum * 2^bits / n). For n == 4^bits this is exactly the
+ * classic sum >> bits decimation; a shorter burst (e.g. after outlier
+ * rejection) still averages correctly, with proportionally less gain.
+ *
+ * @return code in Q`bits`, or -1 if n == 0
+ */
+int32_t adc_oversample_decimate(const int *codes, size_t n, unsigned bits);
+
+/**
+ * @brief Interpolate calibrated mV for a fixed-point code.
+ *
+ * `mv_lo` / `mv_hi` are the calibrated mV of integer codes floor(code) and
+ * floor(code) + 1. Returns mV in Q`mv_frac_bits`, rounded to nearest.
+ */
+int32_t adc_oversample_interp_mv(int mv_lo, int mv_hi, uint32_t code_frac,
+                                 unsigned code_bits, unsigned mv_frac_bits);
+
+#endif // ADC_OVERSAMPLE_H
@@ -2,7 +2,9 @@
 #define BATTERY_MONITOR_H
 
 #ifndef TEST_HOST
+#include <stddef.h>
 #include "esp_err.h"
+#include "adc_frame.h"
 #endif
 
 /**
@@ -19,10 +21,10 @@
 esp_err_t battery_monitor_init(void);
 
 /**
- * @brief Re-establish the ADC channel + calibration after an adc_manager_reinit().
+ * @brief Re-establish the ADC channel after an adc_manager_reinit().
  *
- * The shared-unit rebuild invalidates this module's calibration handle; call
- * this afterward to refresh the channel config + cal on the new unit.
+ * The shared-unit rebuild drops the channel config; call this afterward to
+ * apply it on the new unit.
  *
  * @return ESP_OK on success, error code otherwise
  */
@@ -34,6 +36,38 @@ esp_err_t battery_monitor_reconfigure(void);
  */
 float battery_monitor_read_voltage(void);
 
+/**
+ * @brief Read current battery voltage in integer millivolts
+ * @return Cell voltage in mV, 0 if not initialized or the read fails
+ */
+int battery_monitor_read_mv(void);
+
+/**
+ * @brief Point a scan lane at the battery channel.
+ *
+ * Lets the battery ride along another sensor's DMA burst (see
+ * soil_moisture_read_mv_fx()) instead of paying for its own.
+ */
+void battery_monitor_scan_lane(adc_frame_lane_t *lane, int *buf, size_t capacity);
+
+/**
+ * @brief Convert a filled battery scan lane to cell millivolts.
+ *
+ * Integer path for the fixed-point report pipeline (see
+ * battery_monitor_mv_to_pct_x100()). Reduces the lane with sample_reduce(),
+ * which sorts its samples in place.
+ * @return Cell voltage in mV, 0 if the lane is empty or cal fails
+ */
+int battery_monitor_mv_from_lane(adc_frame_lane_t *lane);
+
+/**
+ * @brief Convert a filled battery scan lane to cell volts.
+ *
+ * Reduces the lane with sample_reduce(), which sorts its samples in place.
+ * @return Battery voltage in volts, 0.0 if the lane is empty or cal fails
+ */
+float battery_monitor_voltage_from_lane(adc_frame_lane_t *lane);
+
 /**
  * @brief Clean up battery monitor resources
  * @return ESP_OK on success, error code otherwise
@@ -2,6 +2,7 @@
 #define BATTERY_SOC_H
 
 #include <stdbool.h>
+#include <stdint.h>
 
 /* Cell voltage at or above which the device is allowed to power up
  * WiFi / MQTT for a normal publish cycle. Below this, the firmware
@@ -16,6 +17,12 @@
  * Pure function — host-testable, no ESP-IDF dependencies. */
 float battery_monitor_v_to_pct(float volts);
 
+/* Fixed-point twin of battery_monitor_v_to_pct(): cell mV in, SoC in
+ * 0.01% units (0..10000) out, rounded to nearest. Same 11-point curve as
+ * an integer table with a binary-search segment lookup — no float work.
+ * test_telemetry_fx holds it to the float curve across 0-5000 mV. */
+uint16_t battery_monitor_mv_to_pct_x100(int mv);
+
 /* Returns true iff volts >= BATTERY_LOW_CUTOFF_V.
  * Boundary is inclusive: exactly 3.70V is considered safe. */
 bool battery_monitor_is_safe(float volts);
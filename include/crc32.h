@@ -0,0 +1,18 @@
+#ifndef CRC32_H
+#define CRC32_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief CRC-32 (IEEE 802.3, reflected 0xEDB88320), bitwise — no table.
+ *
+ * Guards state we retain across deep sleep or in flash. Chain calls by
+ * passing the previous result as `crc`; start from 0.
+ *
+ * Bitwise rather than table-driven: the inputs are small records and one
+ * 4 KB frame per wake, not worth a 1 KB table.
+ */
+uint32_t crc32_update(uint32_t crc, const void *data, size_t len);
+
+#endif // CRC32_H
@@ -24,25 +24,34 @@ typedef struct {
 } display_telemetry_t;
 
 #ifndef TEST_HOST
-/** Initialise SPI bus, GPIOs, wake panel from deep sleep. */
-esp_err_t display_init(void);
+/*
+ * Each display_show_*() composes its view in RAM first. If the glass already
+ * shows that exact frame (hash kept in RTC memory) it returns without touching
+ * SPI or the panel. Otherwise it brings the panel up (SPI bus, reset probe;
+ * nothing happens if no panel answers), refreshes it and puts it back into
+ * deep sleep.
+ */
 
-/** Render the dashboard view in a fresh full refresh. */
+/**
+ * Render the dashboard view. A partial refresh of the changed window while the
+ * dashboard is already up; a full one every DISPLAY_FULL_REFRESH_EVERY
+ * updates and after another view (display_fb.h).
+ */
 void display_show_telemetry(const display_telemetry_t *t);
 
-/** Render the portal view (SSID + URL + QR) in a fresh full refresh. */
+/** Render the portal view (SSID + URL + QR); full refresh when coming from another view. */
 void display_show_portal(void);
 
 /* Render a minimal full-screen "LOW BATTERY <volts>V" warning.
  * Intended for one-shot display when battery_monitor_is_safe() is false.
  * Uses large text only — fast refresh, minimal energy. */
 void display_show_low_battery(float volts);
-
-/** Put the panel back into deep sleep and release the SPI bus. */
-void display_deinit(void);
 #endif
 
 /** Pure: 3.3 V = 0 %, 4.2 V = 100 %, clamped. No hardware access. */
 int display_battery_v_to_pct(float v);
 
+/** Pure integer twin of display_battery_v_to_pct(), from cell mV. */
+int display_battery_mv_to_pct(int mv);
+
 #endif // DISPLAY_H
@@ -0,0 +1,122 @@
+#ifndef DISPLAY_FB_H
+#define DISPLAY_FB_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * @brief Framebuffer geometry, drawing and refresh planning for the SSD1680 panel.
+ *
+ * A full refresh (waveform mode 1) flashes the whole panel black and white
+ * and holds BUSY for about 3 s. A partial refresh (mode 2) only drives the
+ * pixels whose new value differs from the previous-frame RAM, in about
+ * 0.3 s, but leaves a little ghosting that builds up. So: partial updates
+ * of the changed window while the same view stays up, and a full refresh
+ * every DISPLAY_FULL_REFRESH_EVERY of them, on a view change, or when the
+ * last frame shown is not known.
+ *
+ * The frame last shown is kept (in RTC memory on the device) with a
+ * display_shown_t record. display_shown_same() compares the record's frame
+ * hash with the newly composed frame, so an unchanged frame costs neither
+ * the panel bring-up nor a refresh; otherwise display_refresh_choose()
+ * compares the frames themselves.
+ *
+ * test_display_fb checks the blitter pixel for pixel against a plain
+ * reference (test/display_fb_ref.h).
+ */
+
+#define DISPLAY_W        122
+#define DISPLAY_H_PX     250
+#define DISPLAY_BPR      ((DISPLAY_W + 7) / 8)          // 16
+#define DISPLAY_FB_SIZE  (DISPLAY_BPR * DISPLAY_H_PX)   // 4000
+
+#ifndef DISPLAY_FULL_REFRESH_EVERY
+#define DISPLAY_FULL_REFRESH_EVERY  20  ///< Partial updates between ghost-clearing full refreshes; 0 = always full
+#endif
+
+#define DISPLAY_SHOWN_MAGIC  0xD15B0001u
+
+/*
+ * Drawing. Coordinates are pixels, (0, 0) top-left; anything off the panel
+ * is clipped. A framebuffer byte holds 8 horizontal pixels, MSB on the left,
+ * bit 0 = black. Source bitmaps are MSB-first rows of (w + 7) / 8 bytes, a 1
+ * bit draws black, a 0 bit leaves the framebuffer alone.
+ *
+ * Bitmaps go in a whole byte at a time, shifted to the pixel and ANDed into
+ * the one or two framebuffer bytes it straddles. Clipping is worked out once
+ * per blit, not per pixel.
+ */
+
+/** Black span of `w` pixels from (x, y). */
+void display_fb_hline(uint8_t *fb, int x, int y, int w);
+
+/** Bitmap `w` x `h` at (x, y). */
+void display_fb_blit(uint8_t *fb, int x, int y, const uint8_t *bm, int w, int h);
+
+/** Bitmap pixel-doubled to 2w x 2h at (x, y). */
+void display_fb_blit_2x(uint8_t *fb, int x, int y, const uint8_t *bm, int w, int h);
+
+/** Changed window: RAM X in bytes (8 px), Y in rows, both inclusive. */
+typedef struct {
+    uint8_t  x0, x1;
+    uint16_t y0, y1;
+} display_rect_t;
+
+typedef enum {
+    DISPLAY_REFRESH_NONE = 0,   ///< Glass already shows this frame
+    DISPLAY_REFRESH_PARTIAL,    ///< Mode-2 update of the dirty window
+    DISPLAY_REFRESH_FULL,       ///< Mode-1 update of the whole panel
+} display_refresh_t;
+
+/** Which layout is on the glass; a change of view always refreshes in full. */
+typedef enum {
+    DISPLAY_VIEW_NONE = 0,
+    DISPLAY_VIEW_TELEMETRY,
+    DISPLAY_VIEW_PORTAL,
+    DISPLAY_VIEW_LOW_BATTERY,
+} display_view_t;
+
+/** What the glass shows. An invalid record makes the next update a full refresh. */
+typedef struct {
+    uint32_t magic;
+    uint32_t view;              ///< display_view_t
+    uint32_t partials;          ///< Partial updates since the last full refresh
+    uint32_t frame_crc;         ///< crc32 of the frame shown
+    uint32_t crc;               ///< crc32 over every field above
+} display_shown_t;
+
+/**
+ * @brief Bounding window of every byte that differs between two frames.
+ * @return false if the frames are identical (`r` untouched)
+ */
+bool display_fb_dirty(const uint8_t *prev, const uint8_t *cur, display_rect_t *r);
+
+/** Forget the frame shown: the next refresh is full. */
+void display_shown_reset(display_shown_t *h);
+
+/** True iff `h` is intact and `frame` is the frame it recorded. */
+bool display_shown_valid(const display_shown_t *h, const uint8_t *frame);
+
+/**
+ * @brief True iff the glass already shows `next` in `view`: `h` is intact
+ * and its frame hash matches. Needs only the record, not the frame it was
+ * taken from, so it can decide before the panel or SPI bus is touched.
+ */
+bool display_shown_same(const display_shown_t *h, const uint8_t *next, display_view_t view);
+
+/** Record that `frame` is now on the glass, shown with `how`. */
+void display_shown_note(display_shown_t *h, const uint8_t *frame, display_view_t view,
+                        display_refresh_t how);
+
+/**
+ * @brief Pick the refresh that takes the glass from `shown` to `next`.
+ *
+ * FULL if `h` doesn't vouch for `shown`, the view changes, full_every is 0
+ * or the partial budget is spent; NONE if nothing changed; else PARTIAL
+ * with the changed window in `dirty`.
+ */
+display_refresh_t display_refresh_choose(const display_shown_t *h, const uint8_t *shown,
+                                         const uint8_t *next, display_view_t view,
+                                         uint32_t full_every, display_rect_t *dirty);
+
+#endif // DISPLAY_FB_H
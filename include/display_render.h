@@ -0,0 +1,24 @@
+#ifndef DISPLAY_RENDER_H
+#define DISPLAY_RENDER_H
+
+#include <stdint.h>
+#include "display.h"
+
+/**
+ * @brief The e-paper views, composed into a DISPLAY_FB_SIZE framebuffer.
+ *
+ * Each call clears `fb` and draws the whole view; display.c then puts it on
+ * the panel. test_display_render compares every view with a golden PBM, so
+ * a layout change shows up as an image diff.
+ */
+
+/** Dashboard: device ID, moisture hero number, sensor/battery/WiFi rows. */
+void display_render_telemetry(uint8_t *fb, const display_telemetry_t *t);
+
+/** Portal: SoftAP SSID, URL and the QR code for it. */
+void display_render_portal(uint8_t *fb);
+
+/** "LOW BATTERY <volts> V" warning. */
+void display_render_low_battery(uint8_t *fb, float volts);
+
+#endif // DISPLAY_RENDER_H
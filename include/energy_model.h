@@ -0,0 +1,160 @@
+#ifndef ENERGY_MODEL_H
+#define ENERGY_MODEL_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "telemetry_enc.h"
+#include "wake_timing.h"
+
+/**
+ * @brief Per-wake charge estimate from measured phase durations.
+ *
+ * A model is a current per wake_timing phase (radio, CPU, probe and
+ * e-paper load folded into each phase's figure), an idle current for
+ * awake time outside every phase, and the average sleep current. Charge
+ * is kept in nAh so a single wake (~0.1 mAh) keeps four significant
+ * digits in integer math.
+ *
+ * The ledger accumulates the estimate in RTC memory across deep sleep and
+ * cross-checks it against the SoC drop seen on the zero-load OCV sample:
+ * once the OCV has fallen far enough to be meaningful, the ratio of
+ * observed to modelled charge is published alongside the estimate and
+ * used to correct the days-remaining projection.
+ *
+ * test/sim_lifetime runs this same model to project battery life on the
+ * host.
+ */
+
+#ifndef ENERGY_BATTERY_MAH
+#define ENERGY_BATTERY_MAH  2000            ///< Cell capacity used for projections
+#endif
+
+/** OCV SoC drop (0.01 % units) needed before the model is cross-checked. */
+#define ENERGY_OCV_MIN_DROP_X100   300
+/** OCV SoC rise (0.01 % units) treated as a recharge: restart the cross-check. */
+#define ENERGY_OCV_RECHARGE_X100   500
+
+#define ENERGY_NAH_PER_MAH         1000000ULL
+
+typedef struct {
+    const char *name;
+    uint32_t phase_ua[WAKE_PHASE_COUNT];    ///< Average current while in each phase
+    uint32_t idle_ua;                       ///< Awake but outside every phase
+    uint32_t sleep_ua;                      ///< Average between wakes / report cycles
+} energy_model_t;
+
+/** Deep-sleep WiFi build: radio phases dominate, ~10 µA asleep. */
+extern const energy_model_t ENERGY_MODEL_WIFI;
+/** Light-sleep Zigbee build: short radio bursts, sleep current includes parent polls. */
+extern const energy_model_t ENERGY_MODEL_ZIGBEE;
+
+/**
+ * @brief Charge of one record's awake time: phases plus unaccounted time at idle_ua.
+ *
+ * Phases that ran concurrently draw their currents added together, less
+ * idle_ua for each extra phase, which both figures already include.
+ */
+uint64_t energy_model_wake_nah(const energy_model_t *m, const wake_timing_record_t *r);
+
+/** Charge of `sleep_s` seconds at sleep_ua. */
+uint64_t energy_model_sleep_nah(const energy_model_t *m, uint32_t sleep_s);
+
+/**
+ * @brief Days until empty at `cycle_nah` per `cycle_s`, from `pct_x100` SoC.
+ * @param ratio_x100 Observed/model correction (100 = model is right); 0 = none yet
+ * @return days x10, saturating at UINT32_MAX; 0 if the cycle is degenerate
+ */
+uint32_t energy_days_remaining_x10(uint16_t pct_x100, uint32_t capacity_mah,
+                                   uint64_t cycle_nah, uint32_t cycle_s,
+                                   uint16_t ratio_x100);
+
+#define ENERGY_LEDGER_MAGIC  0xE7E46E02u
+
+/** RTC-retained running total. A failed magic/CRC check restarts it from zero. */
+typedef struct {
+    uint32_t magic;
+    uint32_t wakes;                         ///< Cycles accounted since reset
+    uint64_t total_nah;                     ///< Modelled charge since reset
+    uint64_t ref_nah;                       ///< total_nah when the OCV reference was taken
+    uint32_t last_nah;                      ///< Last cycle: awake + following sleep
+    uint32_t last_cycle_s;                  ///< Last cycle length (awake + sleep)
+    uint32_t total_s;                       ///< Sum of cycle lengths since reset
+    uint16_t ref_pct_x100;                  ///< OCV SoC at the reference
+    uint16_t ocv_pct_x100;                  ///< Latest OCV SoC
+    uint16_t ratio_x100;                    ///< Observed/model charge; 0 until cross-checked
+    uint16_t reserved;                      ///< Always 0
+    uint32_t crc;                           ///< crc32 over every field above
+} energy_ledger_t;
+
+/** Start a fresh ledger with the OCV reference at `ocv_pct_x100`. */
+void energy_ledger_reset(energy_ledger_t *l, uint16_t ocv_pct_x100);
+
+/** True iff `l` is intact (magic + CRC). */
+bool energy_ledger_valid(const energy_ledger_t *l);
+
+/** Add one cycle's modelled charge and reseal. */
+void energy_ledger_add(energy_ledger_t *l, uint64_t cycle_nah, uint32_t cycle_s);
+
+/**
+ * @brief Mean modelled charge of one cycle (awake + sleep) since reset, nAh.
+ *
+ * The per-wake figure every transport publishes. Saturates at UINT32_MAX;
+ * 0 before the first cycle.
+ */
+uint32_t energy_ledger_mean_nah(const energy_ledger_t *l);
+
+/**
+ * @brief Days of battery left at the ledger's mean cycle since reset.
+ *
+ * Uses the mean rather than the last cycle: with report suppression most
+ * wakes skip the radio, so any single cycle is unrepresentative.
+ *
+ * @return days x10 (see energy_days_remaining_x10); 0 before the first cycle
+ */
+uint32_t energy_ledger_days_remaining_x10(const energy_ledger_t *l, uint32_t capacity_mah);
+
+/**
+ * @brief Feed the latest OCV SoC and reseal.
+ *
+ * A rise of ENERGY_OCV_RECHARGE_X100 or more restarts the reference (the
+ * cell was charged). Once the SoC has dropped ENERGY_OCV_MIN_DROP_X100
+ * below the reference, ratio_x100 = observed charge / modelled charge.
+ */
+void energy_ledger_observe_ocv(energy_ledger_t *l, uint16_t ocv_pct_x100,
+                               uint32_t capacity_mah);
+
+/**
+ * @brief JSON members (no braces) for the telemetry payload:
+ *        "mAh_per_wake":0.1183,"days_remaining":412.5[,"model_ratio":1.08]
+ *
+ * Both figures use the mean cycle since reset.
+ *
+ * Nothing is written (returns 0, buf = "") before the first cycle is accounted.
+ *
+ * @return bytes written (excluding NUL), or -1 if `buf` is too small
+ */
+int energy_ledger_format_json(const energy_ledger_t *l, uint32_t capacity_mah,
+                              char *buf, size_t len);
+
+/** Same members through an encoder, into the enclosing map. */
+void energy_ledger_encode(const energy_ledger_t *l, uint32_t capacity_mah,
+                          telemetry_enc_t *e);
+
+#ifndef TEST_HOST
+/*
+ * Device ledger in RTC_DATA_ATTR memory, reset when its CRC does not check.
+ * The model is ENERGY_MODEL_ZIGBEE on USE_ZIGBEE builds, else ENERGY_MODEL_WIFI.
+ */
+const energy_model_t *energy_model_active(void);
+
+/** Validate (or reset) the RTC ledger and feed this wake's OCV SoC. */
+void energy_ledger_begin(uint16_t ocv_pct_x100);
+
+/** Account a finished timing record followed by `sleep_s` of sleep. */
+void energy_ledger_account(const wake_timing_record_t *r, uint32_t sleep_s);
+
+const energy_ledger_t *energy_ledger(void);
+#endif // TEST_HOST
+
+#endif // ENERGY_MODEL_H
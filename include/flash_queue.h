@@ -0,0 +1,117 @@
+#ifndef FLASH_QUEUE_H
+#define FLASH_QUEUE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "flash_shim.h"
+#include "soil_probe.h"
+#include "telemetry_enc.h"
+
+/**
+ * @brief Store-and-forward queue of readings on the `fqueue` flash partition.
+ *
+ * Readings that could not be delivered (no WiFi, no broker, no PUBACK) are
+ * appended here instead of waiting in RTC memory, which is small and lost on
+ * a power cut. The next good connection drains them in batches of
+ * FLASH_QUEUE_BATCH.
+ *
+ * Layout: the partition is a ring of 4 KB sectors. Each sector starts with a
+ * header slot (magic, epoch) followed by fixed 32-byte record slots written in
+ * order. Sectors are erased only when the ring comes back round to them, so
+ * wear is spread evenly. When the ring is full the oldest sector is erased,
+ * along with any undelivered readings still in it (counted in `dropped`).
+ *
+ * Delivery clears the record's `done` word in place (1 -> 0 bits need no
+ * erase). A record with a bad CRC, such as one torn by a reset mid-write, is
+ * skipped. Mount rebuilds all state by scanning, so nothing else needs
+ * persisting.
+ *
+ * Every record carries a sequence number, unique and increasing for the life
+ * of the partition, so the backend can drop a batch it sees twice (PUBACK lost,
+ * batch resent).
+ *
+ * Pure apart from flash_shim — tested on the host against a RAM emulator.
+ */
+
+#define FLASH_QUEUE_SLOT          32
+#define FLASH_QUEUE_SLOTS         (FLASH_SHIM_SECTOR / FLASH_QUEUE_SLOT)   ///< Incl. the header slot
+#define FLASH_QUEUE_MAX_SECTORS   16
+#define FLASH_QUEUE_MAGIC         0xF1A5C0DEu
+
+#ifndef FLASH_QUEUE_BATCH
+#define FLASH_QUEUE_BATCH         32     ///< Records per backlog message
+#endif
+#ifndef FLASH_QUEUE_DRAIN_BATCHES
+#define FLASH_QUEUE_DRAIN_BATCHES 4      ///< Backlog messages per wake, to bound radio time
+#endif
+
+/** One reading as stored. A record whose CRC fails (torn write) is skipped. */
+typedef struct {
+    uint32_t seq;
+    uint32_t t_s;                           ///< RTC-backed clock when taken
+    uint16_t boot;                          ///< Power-cycle generation t_s belongs to
+    uint16_t battery_mv;
+    uint16_t soil_mv[SOIL_PROBE_MAX];
+    uint8_t  n_probes;
+    uint8_t  reserved[3];                   ///< Always 0
+    uint32_t crc;                           ///< Over everything above
+    uint32_t done;                          ///< 0xFFFFFFFF until delivered, then 0
+} flash_queue_record_t;
+
+typedef struct {
+    uint32_t n_sectors;
+    uint32_t epoch[FLASH_QUEUE_MAX_SECTORS];   ///< Per sector; 0 = erased or unformatted
+    uint32_t head;                  ///< Sector being appended to
+    uint32_t head_slot;             ///< Next free slot in it (FLASH_QUEUE_SLOTS = full)
+    uint32_t next_seq;
+    uint32_t pending;               ///< Stored and not yet delivered
+    uint32_t dropped;               ///< Undelivered readings erased for room, since mount
+    uint16_t boot;                  ///< Generation stamped on appends (set by the caller)
+    uint16_t max_boot;              ///< Highest generation found at mount
+} flash_queue_t;
+
+/**
+ * @brief Scan the partition and rebuild the queue state.
+ *
+ * An empty, foreign or partly written partition is fine; unusable sectors
+ * are erased when the ring reaches them.
+ *
+ * @return false if the partition is missing or smaller than two sectors
+ */
+bool flash_queue_mount(flash_queue_t *q);
+
+/** Append one reading. Returns false on a flash error. */
+bool flash_queue_append(flash_queue_t *q, uint32_t t_s, uint16_t battery_mv,
+                        const uint16_t *soil_mv, size_t n_probes);
+
+/**
+ * @brief Oldest undelivered readings, in order.
+ * @param offsets Where each one is stored, for flash_queue_mark_delivered()
+ * @return number filled in (<= max)
+ */
+size_t flash_queue_peek(const flash_queue_t *q, flash_queue_record_t *out,
+                        uint32_t *offsets, size_t max);
+
+/** Mark peeked readings delivered once the broker has acked them. */
+bool flash_queue_mark_delivered(flash_queue_t *q, const uint32_t *offsets, size_t n);
+
+/**
+ * @brief "backlog" member for a drained batch, oldest first:
+ *        "backlog":{"seq":[..],"age_s":[..],"battery_mv":[..],"soil_moisture_mv":[..]}
+ *
+ * age_s is seconds before `now_s`, or -1 when the reading is from an earlier
+ * power cycle (`boot` differs) and the clock has restarted since.
+ */
+void flash_queue_encode(const flash_queue_record_t *recs, size_t n, uint16_t boot,
+                        uint32_t now_s, telemetry_enc_t *e);
+
+#ifndef TEST_HOST
+/**
+ * Device queue, mounted on first use. Its `boot` generation is kept in RTC
+ * memory and advances on every power cycle. NULL if there is no partition.
+ */
+flash_queue_t *flash_queue(void);
+#endif // TEST_HOST
+
+#endif // FLASH_QUEUE_H
@@ -0,0 +1,32 @@
+#ifndef FLASH_SHIM_H
+#define FLASH_SHIM_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief Raw read/write/erase on the `fqueue` data partition.
+ *
+ * Same idea as nvs_shim: flash_queue talks to flash only through these, so
+ * it can be unit-tested on the host against a RAM emulator. The ESP build
+ * links flash_shim_esp.c (esp_partition); native tests link an in-test
+ * emulator with NOR semantics (erase sets 0xFF, writes only clear bits).
+ *
+ * Offsets are relative to the partition start.
+ */
+
+#define FLASH_SHIM_SECTOR  4096
+
+/** Partition size in bytes, or 0 if it is missing from the table. */
+uint32_t flash_shim_size(void);
+
+bool flash_shim_read(uint32_t offset, void *buf, size_t len);
+
+/** Program bytes; bits can only go 1 -> 0 without an erase. */
+bool flash_shim_write(uint32_t offset, const void *buf, size_t len);
+
+/** Erase one FLASH_SHIM_SECTOR-aligned sector to 0xFF. */
+bool flash_shim_erase_sector(uint32_t offset);
+
+#endif
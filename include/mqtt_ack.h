@@ -0,0 +1,45 @@
+#ifndef MQTT_ACK_H
+#define MQTT_ACK_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+/**
+ * @brief Outstanding QoS 1 message ids, for "sleep as soon as it's acked".
+ *
+ * mqtt_publisher adds each msg_id esp_mqtt_client_publish() returns and
+ * completes it on MQTT_EVENT_PUBLISHED. The PUBACK can be handled by the
+ * MQTT task before the publishing task gets to add the id, so a completion
+ * for an unknown id is remembered and cancels the matching add.
+ *
+ * Not thread-safe on its own; the caller serialises access.
+ */
+
+#define MQTT_ACK_MAX  8
+
+typedef struct {
+    int    pending[MQTT_ACK_MAX];       ///< Published, not yet acked
+    int    early[MQTT_ACK_MAX];         ///< Acked before being added, oldest first
+    size_t n_pending;
+    size_t n_early;
+} mqtt_ack_t;
+
+void mqtt_ack_reset(mqtt_ack_t *t);
+
+/**
+ * @brief Track a msg_id returned by publish.
+ *
+ * Ids <= 0 (QoS 0, or a failed publish) have nothing to wait for and are
+ * ignored. An id that was already acked early is consumed instead.
+ *
+ * @return false if the table is full (the id is not tracked)
+ */
+bool mqtt_ack_add(mqtt_ack_t *t, int msg_id);
+
+/** Mark msg_id acked. Returns true if it was pending. */
+bool mqtt_ack_complete(mqtt_ack_t *t, int msg_id);
+
+/** Messages still waiting for their PUBACK. */
+size_t mqtt_ack_pending(const mqtt_ack_t *t);
+
+#endif // MQTT_ACK_H
@@ -2,7 +2,11 @@
 #define MQTT_PUBLISHER_H
 
 #include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
 #include "esp_err.h"
+#include "reading_buffer.h"
+#include "telemetry_enc.h"
 
 /**
  * @brief MQTT publishing interface
@@ -19,8 +23,16 @@ typedef struct {
     const char *password;
     const char *base_topic;
     int keepalive_sec;
+    telemetry_fmt_t format;     ///< Payload encoding; CBOR goes to "<base_topic>/cbor"
 } mqtt_config_t;
 
+/**
+ * @brief Adds members to the telemetry payload (see mqtt_publisher_publish_telemetry)
+ * @param e Encoder positioned inside the payload map
+ * @param ctx Caller context
+ */
+typedef void (*mqtt_publisher_extra_fn)(telemetry_enc_t *e, void *ctx);
+
 /**
  * @brief Initialize and start MQTT client
  * @param config MQTT configuration
@@ -34,14 +46,66 @@ esp_err_t mqtt_publisher_init(const mqtt_config_t *config);
  */
 bool mqtt_publisher_is_connected(void);
 
+/**
+ * @brief Block until the client is connected, or the timeout expires
+ *
+ * Returns the moment MQTT_EVENT_CONNECTED fires.
+ *
+ * @param timeout_ms Maximum time to wait
+ * @return true if connected, false on timeout
+ */
+bool mqtt_publisher_wait_connected(uint32_t timeout_ms);
+
+/**
+ * @brief Block until every QoS 1 publish has been acknowledged, or the timeout expires
+ *
+ * Message ids returned by publish are tracked until their PUBACK
+ * (MQTT_EVENT_PUBLISHED), so the caller can power down as soon as the broker
+ * has the data instead of sleeping a fixed time.
+ *
+ * @param timeout_ms Maximum time to wait
+ * @return ESP_OK once nothing is outstanding, ESP_ERR_TIMEOUT otherwise,
+ *         ESP_ERR_INVALID_STATE if the publisher was never initialised
+ */
+esp_err_t mqtt_publisher_wait_acked(uint32_t timeout_ms);
+
 /**
  * @brief Publish telemetry data
- * @param battery_voltage Current battery voltage
- * @param soil_moisture Soil moisture percentage (0-100)
+ *
+ * Fields are integers and go through telemetry_enc in the configured format,
+ * so no float is formatted on the device. JSON stays as before:
+ * {"battery":4.15,"soil_moisture":42.5,...,"device":"..."}.
+ *
+ * @param battery_mv Battery voltage in mV (reported in V, 2 decimals)
+ * @param soil_pct_x100 Soil moisture per probe in 0.01 % units, in soil_probe
+ *                      table order (reported in %, 1 decimal)
+ * @param n_probes Number of entries in soil_pct_x100 (1..SOIL_PROBE_COUNT)
+ * @param batch Buffered readings to send along as a "batch" member (see
+ *              reading_buffer_encode()); NULL or empty to omit
+ * @param now_s Clock the batch ages are measured against
+ * @param device_name Device identifier
+ * @param extra Called to add further members before "device"; NULL to omit
+ * @param extra_ctx Passed to extra
+ * @return ESP_OK on success, error code otherwise
+ */
+esp_err_t mqtt_publisher_publish_telemetry(int battery_mv, const uint16_t *soil_pct_x100,
+                                           size_t n_probes, const reading_buffer_t *batch,
+                                           uint32_t now_s, const char *device_name,
+                                           mqtt_publisher_extra_fn extra, void *extra_ctx);
+
+/**
+ * @brief Publish a batch of stored readings to "<base_topic>/backlog"
+ *
+ * Same format (and "/cbor" suffix) as telemetry, on its own subtopic so
+ * consumers of the live topic don't mistake old readings for current state.
+ *
  * @param device_name Device identifier
+ * @param members Writes the batch members (see flash_queue_encode())
+ * @param ctx Passed to members
  * @return ESP_OK on success, error code otherwise
  */
-esp_err_t mqtt_publisher_publish_telemetry(float battery_voltage, float soil_moisture, const char *device_name);
+esp_err_t mqtt_publisher_publish_backlog(const char *device_name,
+                                         mqtt_publisher_extra_fn members, void *ctx);
 
 /**
  * @brief Stop and destroy the MQTT client
@@ -0,0 +1,97 @@
+#ifndef READING_BUFFER_H
+#define READING_BUFFER_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "soil_probe.h"
+#include "telemetry_enc.h"
+
+/**
+ * @brief RTC-retained ring of readings for batched MQTT publishes (WiFi build).
+ *
+ * Every wake samples and appends one reading; the radio only comes up when
+ * READING_BATCH_SIZE readings are waiting or the report policy sees a
+ * threshold crossed. The whole ring then goes out in one message, so one
+ * association + MQTT handshake covers several readings.
+ *
+ * Times are offsets (seconds) from the first reading since the ring was last
+ * cleared, on the same RTC-backed clock as report_policy. The ring holds up to
+ * READING_BUFFER_CAP readings so a failed flush keeps the backlog; past that
+ * the oldest reading is overwritten.
+ */
+
+#define READING_BUFFER_CAP   12
+
+#ifndef READING_BATCH_SIZE
+#define READING_BATCH_SIZE   6       ///< Flush once this many readings are waiting (1 = every wake)
+#endif
+
+#if READING_BATCH_SIZE < 1 || READING_BATCH_SIZE > READING_BUFFER_CAP
+#error "READING_BATCH_SIZE must be 1..READING_BUFFER_CAP"
+#endif
+
+typedef struct {
+    uint32_t t_off_s;                       ///< Seconds after reading_buffer_t.base_s
+    uint16_t battery_mv;                    ///< Battery OCV
+    uint16_t soil_mv[SOIL_PROBE_MAX];       ///< Raw soil AOUT per probe
+    uint16_t reserved;                      ///< Always 0
+} reading_t;
+
+#define READING_BUFFER_MAGIC  0x8EAD0B01u
+
+/** RTC-retained ring. A failed check, or a new probe count, clears it. */
+typedef struct {
+    uint32_t  magic;
+    uint32_t  base_s;                       ///< Clock at the oldest reading since clear
+    uint16_t  head;                         ///< Next slot to write
+    uint16_t  count;                        ///< Readings held (<= READING_BUFFER_CAP)
+    uint16_t  n_probes;                     ///< soil_mv entries used per reading
+    uint16_t  overwritten;                  ///< Readings lost to a full ring since clear
+    reading_t rec[READING_BUFFER_CAP];
+    uint32_t  crc;                          ///< crc32 over every field above
+} reading_buffer_t;
+
+/** Empty the ring for `n_probes` probes and seal it. */
+void reading_buffer_clear(reading_buffer_t *rb, size_t n_probes);
+
+/** True iff `rb` is intact (magic + CRC + sane indices). */
+bool reading_buffer_valid(const reading_buffer_t *rb);
+
+/**
+ * @brief Append one reading taken at `now_s` and reseal.
+ *
+ * A corrupt ring, a changed probe count, or a clock behind base_s (it was
+ * restarted) clears the ring first, since those readings can't be placed.
+ */
+void reading_buffer_push(reading_buffer_t *rb, uint32_t now_s, int battery_mv,
+                         const uint16_t *soil_mv, size_t n_probes);
+
+/** True once READING_BATCH_SIZE or more readings are waiting. */
+bool reading_buffer_due(const reading_buffer_t *rb);
+
+/** i-th reading, oldest first (i < count). */
+const reading_t *reading_buffer_at(const reading_buffer_t *rb, size_t i);
+
+/**
+ * @brief JSON member (no braces) for the batched payload, oldest first:
+ *        "batch":{"age_s":[7200,3600,0],"battery_mv":[...],"soil_moisture_mv":[...]}
+ *
+ * Ages are seconds before `now_s`; one "<key>_mv" column per soil probe,
+ * keyed from the soil_probe table. Nothing is written (returns 0, buf = "")
+ * when the ring is empty or invalid.
+ *
+ * @return bytes written (excluding NUL), or -1 if `buf` is too small
+ */
+int reading_buffer_format_json(const reading_buffer_t *rb, uint32_t now_s,
+                               char *buf, size_t len);
+
+/** Same member through an encoder, into the enclosing map. */
+void reading_buffer_encode(const reading_buffer_t *rb, uint32_t now_s, telemetry_enc_t *e);
+
+#ifndef TEST_HOST
+/* Device ring in RTC_DATA_ATTR memory; validated (or cleared) on first use. */
+reading_buffer_t *reading_buffer(void);
+#endif // TEST_HOST
+
+#endif // READING_BUFFER_H
@@ -0,0 +1,108 @@
+#ifndef REPORT_POLICY_H
+#define REPORT_POLICY_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "soil_probe.h"
+
+/**
+ * @brief Change-driven report suppression (WiFi build).
+ *
+ * Bringing up WiFi + MQTT is by far the most expensive part of a wake.
+ * The last *published* readings and publish time are retained in RTC
+ * memory; a wake whose readings moved less than the configured deltas,
+ * and whose heartbeat has not expired, skips the radio entirely.
+ *
+ * Time is in seconds on the RTC-backed system clock, which keeps running
+ * through deep sleep (it need not be wall-clock time).
+ *
+ * test_report_policy replays soil and battery traces to count the wakes
+ * each setting saves.
+ */
+
+#ifndef REPORT_SOIL_DELTA_X100
+#define REPORT_SOIL_DELTA_X100   100     ///< 1.00 % soil change forces a report (0 = always report)
+#endif
+#ifndef REPORT_BATTERY_DELTA_MV
+#define REPORT_BATTERY_DELTA_MV  50      ///< Battery change forcing a report
+#endif
+#ifndef REPORT_HEARTBEAT_S
+#define REPORT_HEARTBEAT_S       (6 * 3600)  ///< Max silence between reports
+#endif
+
+typedef struct {
+    uint16_t soil_delta_x100;   ///< |delta soil| (0.01 % units) at or above which to report
+    uint16_t battery_delta_mv;  ///< |delta battery| at or above which to report
+    uint32_t heartbeat_s;       ///< Report at least this often regardless
+} report_policy_cfg_t;
+
+#define REPORT_POLICY_CFG_DEFAULT { \
+    .soil_delta_x100 = REPORT_SOIL_DELTA_X100, \
+    .battery_delta_mv = REPORT_BATTERY_DELTA_MV, \
+    .heartbeat_s = REPORT_HEARTBEAT_S }
+
+typedef enum {
+    REPORT_SKIP = 0,        ///< Nothing moved enough: stay off the radio
+    REPORT_FIRST,           ///< No valid retained state (cold boot, layout change)
+    REPORT_SOIL,            ///< A probe moved by at least soil_delta_x100
+    REPORT_BATTERY,         ///< Battery moved by at least battery_delta_mv
+    REPORT_HEARTBEAT,       ///< heartbeat_s elapsed (or the clock went backwards)
+} report_reason_t;
+
+#define REPORT_POLICY_MAGIC  0x5E9A0001u
+
+/** RTC-retained last-published state. If it is invalid the next wake reports (REPORT_FIRST). */
+typedef struct {
+    uint32_t magic;
+    uint32_t published_s;                       ///< Clock at the last publish
+    uint32_t skipped;                           ///< Wakes skipped since that publish
+    uint16_t soil_pct_x100[SOIL_PROBE_MAX];     ///< Last published soil %, per probe
+    uint16_t battery_mv;                        ///< Last published battery
+    uint16_t n_probes;                          ///< Probes in the last publish
+    uint32_t crc;                               ///< crc32 over every field above
+} report_policy_state_t;
+
+/** Name for logs ("skip", "soil", ...). */
+const char *report_policy_reason_name(report_reason_t r);
+
+/** True iff `st` is intact (magic + CRC). */
+bool report_policy_valid(const report_policy_state_t *st);
+
+/**
+ * @brief Decide whether this wake should publish.
+ *
+ * @param soil_pct_x100 This wake's soil % per probe (0.01 % units)
+ * @param now_s         Current clock (seconds)
+ */
+report_reason_t report_policy_decide(const report_policy_state_t *st,
+                                     const report_policy_cfg_t *cfg,
+                                     const uint16_t *soil_pct_x100, size_t n_probes,
+                                     int battery_mv, uint32_t now_s);
+
+/**
+ * @brief Decide before the soil probes are read, from the battery and clock.
+ *
+ * Anything but REPORT_SKIP means report_policy_decide() will report whatever
+ * the probes read, so the radio can come up while they are sampled.
+ * REPORT_SKIP means it depends on the readings.
+ */
+report_reason_t report_policy_decide_early(const report_policy_state_t *st,
+                                           const report_policy_cfg_t *cfg,
+                                           size_t n_probes, int battery_mv, uint32_t now_s);
+
+/** Record a successful publish of these readings at `now_s` and seal. */
+void report_policy_note_published(report_policy_state_t *st,
+                                  const uint16_t *soil_pct_x100, size_t n_probes,
+                                  int battery_mv, uint32_t now_s);
+
+/** Count a skipped wake (no-op on an invalid state) and reseal. */
+void report_policy_note_skipped(report_policy_state_t *st);
+
+#ifndef TEST_HOST
+/* Device state in RTC_DATA_ATTR memory; the clock is gettimeofday(). */
+uint32_t report_policy_now_s(void);
+report_policy_state_t *report_policy_state(void);
+#endif // TEST_HOST
+
+#endif // REPORT_POLICY_H
@@ -0,0 +1,52 @@
+#ifndef REPORT_SLOT_H
+#define REPORT_SLOT_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief Fleet-wide spreading of reports across the reporting interval.
+ *
+ * Nodes installed (or powered up) together wake and publish together, and
+ * the broker and access points see one burst per interval. A burst means
+ * association failures and retries, and every retry costs battery. Each
+ * device instead takes one of REPORT_SLOTS equal slots of the interval,
+ * chosen by a hash of a stable per-device key (the MAC), and reports at the
+ * start of its slot.
+ *
+ * The hash is FNV-1a finished with an avalanche step, so keys that differ
+ * in one byte (consecutive MACs) land in unrelated slots.
+ *
+ * A device keeps its slot across reboots and updates while REPORT_SLOTS is
+ * unchanged.
+ */
+
+#ifndef REPORT_SLOTS
+#define REPORT_SLOTS  60    ///< Slots per reporting interval; 1 = no spreading
+#endif
+
+/** 32-bit hash of `key`, well mixed in every bit. */
+uint32_t report_slot_hash(const void *key, size_t len);
+
+/** This key's slot, in [0, n_slots); 0 if n_slots is 0. */
+uint32_t report_slot_index(const void *key, size_t len, uint32_t n_slots);
+
+/** Start of `slot` within an interval cut into `n_slots` equal slots, ms. */
+uint32_t report_slot_offset_ms(uint32_t slot, uint32_t n_slots, uint32_t interval_ms);
+
+/**
+ * @brief Delay from `now_ms` until the next time t with t ≡ offset_ms
+ *        (mod interval_ms), at least half an interval away.
+ *
+ * For timers re-armed from their own callback: a callback that fired a
+ * little early or late still schedules the next slot, never the one it is
+ * in. Returns 0 if interval_ms is 0.
+ */
+uint32_t report_slot_delay_ms(int64_t now_ms, uint32_t interval_ms, uint32_t offset_ms);
+
+#ifndef TEST_HOST
+/** This device's slot start within `interval_ms`, keyed on the station MAC. */
+uint32_t report_slot_device_offset_ms(uint32_t interval_ms);
+#endif // TEST_HOST
+
+#endif // REPORT_SLOT_H
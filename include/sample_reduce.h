@@ -0,0 +1,57 @@
+#ifndef SAMPLE_REDUCE_H
+#define SAMPLE_REDUCE_H
+
+#include <stddef.h>
+
+/**
+ * @brief Robust reduction of a burst of raw ADC codes to one value.
+ *
+ * Integer-only and allocation-free (scratch lives on the stack, bounded by
+ * SAMPLE_REDUCE_MAX_N). Every reducer sorts `buf` in place — callers hand
+ * over a scratch buffer they no longer need. All reducers return -1 for an
+ * empty buffer.
+ *
+ * sample_reduce() picks the algorithm at compile time via
+ * SAMPLE_REDUCE_ALGO (default: MAD outlier rejection), so both sensors and
+ * the calibration capture agree on how a reading is formed.
+ *
+ * Bursts are 5-32 codes, so the sort is a plain insertion sort.
+ */
+
+#define SAMPLE_REDUCE_MEAN     0   ///< Plain truncating mean (legacy behaviour)
+#define SAMPLE_REDUCE_MEDIAN   1   ///< Median-of-N
+#define SAMPLE_REDUCE_TRIMMED  2   ///< Mean after dropping SAMPLE_REDUCE_TRIM from each end
+#define SAMPLE_REDUCE_MAD      3   ///< Mean of samples within K x MAD-sigma of the median
+
+#ifndef SAMPLE_REDUCE_ALGO
+#define SAMPLE_REDUCE_ALGO     SAMPLE_REDUCE_MAD
+#endif
+
+#ifndef SAMPLE_REDUCE_TRIM
+#define SAMPLE_REDUCE_TRIM     2   ///< Samples dropped from each end (trimmed mean)
+#endif
+
+#ifndef SAMPLE_REDUCE_MAD_K_X10
+#define SAMPLE_REDUCE_MAD_K_X10 30 ///< Rejection threshold in tenths of a sigma (3.0)
+#endif
+
+#define SAMPLE_REDUCE_MAX_N    64  ///< Largest burst the MAD scratch can hold
+
+int sample_reduce_mean(const int *buf, size_t n);
+int sample_reduce_median(int *buf, size_t n);
+int sample_reduce_trimmed_mean(int *buf, size_t n, size_t trim);
+int sample_reduce_mad(int *buf, size_t n, int k_x10);
+
+/**
+ * @brief Drop samples further than K x MAD-sigma from the median.
+ *
+ * Compacts the survivors to the front of `buf` (sorted) and returns how
+ * many remain — for callers that post-process the clean burst themselves,
+ * e.g. oversampling decimation. Returns 0 for an empty buffer.
+ */
+size_t sample_reduce_reject_outliers(int *buf, size_t n, int k_x10);
+
+/** Reduce with the compile-time SAMPLE_REDUCE_ALGO. */
+int sample_reduce(int *buf, size_t n);
+
+#endif // SAMPLE_REDUCE_H
@@ -0,0 +1,140 @@
+#ifndef SLEEP_SCHEDULE_H
+#define SLEEP_SCHEDULE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "telemetry_enc.h"
+
+/**
+ * @brief Deep-sleep scheduling: exact cadence, drift-corrected, slot-aligned.
+ *
+ * Sleeping a fixed interval after each wake makes reports slip later by
+ * the awake time every cycle. Instead, the next wake is a point in time:
+ * the previous one plus the interval, with whole intervals skipped if the
+ * wake overran. The awake time is absorbed, however long it was.
+ *
+ * The system clock runs off the RTC slow clock through deep sleep, and
+ * that clock drifts with temperature. An SNTP sync about once a day
+ * (cached here, in RTC memory, and never written to the system clock)
+ * measures the drift against real time, and sleeps are scaled to cancel it.
+ *
+ * Wakes can also be aligned to slots: every `interval_s`, offset by this
+ * device's report slot (report_slot.h), so a fleet on the same interval
+ * spreads its reports across it instead of bunching up on the broker.
+ * Slots are on the wall clock once synced, on the system clock before.
+ *
+ * Times are milliseconds: "system" on the RTC-backed system clock, "wall"
+ * Unix time.
+ */
+
+#ifndef SLEEP_ALIGN_TO_SLOTS
+#define SLEEP_ALIGN_TO_SLOTS    1           ///< Wake on this device's report slot (wall clock once synced)
+#endif
+#ifndef SLEEP_MIN_S
+#define SLEEP_MIN_S             60          ///< Skip a slot rather than wake again this soon
+#endif
+#ifndef SNTP_SYNC_INTERVAL_S
+#define SNTP_SYNC_INTERVAL_S    (24 * 3600) ///< Re-sync the cached wall clock this often
+#endif
+#ifndef SNTP_SERVER
+#define SNTP_SERVER             "pool.ntp.org"
+#endif
+#ifndef SNTP_RETRY_S
+#define SNTP_RETRY_S            (6 * 3600)  ///< Wait this long after any attempt, failed or not
+#endif
+#ifndef SNTP_TIMEOUT_MS
+#define SNTP_TIMEOUT_MS         3000
+#endif
+
+/** Syncs closer together than this don't update the drift estimate. */
+#define SLEEP_DRIFT_MIN_SPAN_S  (6 * 3600)
+/** Larger measured drifts are clamped: the RC slow clock is specified to ±5 %. */
+#define SLEEP_DRIFT_MAX_PPM     50000
+
+#define SLEEP_SCHEDULE_MAGIC    0x5CED0001u
+
+typedef struct {
+    uint32_t interval_s;
+    uint32_t min_sleep_s;       ///< Shortest sleep worth taking
+    bool     align;             ///< Wake on slots rather than keep the last plan's cadence
+    uint32_t jitter_s;          ///< Slot offset, < interval_s
+} sleep_schedule_cfg_t;
+
+/** RTC-retained state. If its check fails the schedule starts over: no drift, no plan. */
+typedef struct {
+    uint32_t magic;
+    int32_t  drift_ppm;         ///< System clock error; + = it runs slow against real time
+    int64_t  next_ms;           ///< Wake planned last, system clock; 0 = none
+    int64_t  sync_sys_ms;       ///< System clock at the last SNTP sync; 0 = never synced
+    int64_t  sync_wall_ms;      ///< Unix time at that moment
+    int64_t  try_ms;            ///< System clock at the last SNTP attempt; 0 = none
+    uint16_t syncs;             ///< SNTP syncs since reset
+    uint16_t drifts;            ///< Drift measurements averaged into drift_ppm
+    uint32_t crc;               ///< crc32 over every field above
+} sleep_schedule_t;
+
+/** Clear all state and seal. */
+void sleep_schedule_reset(sleep_schedule_t *s);
+
+/** True iff `s` is intact (magic + CRC). */
+bool sleep_schedule_valid(const sleep_schedule_t *s);
+
+/**
+ * @brief True if never synced, or the last sync is SNTP_SYNC_INTERVAL_S old,
+ *        and no attempt was made in the last SNTP_RETRY_S.
+ */
+bool sleep_schedule_sync_due(const sleep_schedule_t *s, int64_t now_ms);
+
+/** Record that a sync is being attempted at system `now_ms`. */
+void sleep_schedule_note_try(sleep_schedule_t *s, int64_t now_ms);
+
+/**
+ * @brief Record an SNTP result: `wall_ms` was the time at system `now_ms`.
+ *
+ * Updates the drift estimate when the previous sync is at least
+ * SLEEP_DRIFT_MIN_SPAN_S back (averaged with the previous estimate), and
+ * makes this sync the reference for wall-clock estimates.
+ */
+void sleep_schedule_note_sync(sleep_schedule_t *s, int64_t now_ms, int64_t wall_ms);
+
+/** Estimated Unix time at system `now_ms`; false if never synced. */
+bool sleep_schedule_wall_ms(const sleep_schedule_t *s, int64_t now_ms, int64_t *wall_ms);
+
+/** `interval_s` of real time on the system clock, drift-corrected, ms. */
+int64_t sleep_schedule_step_ms(const sleep_schedule_t *s, uint32_t interval_s);
+
+/**
+ * @brief Plan the next wake, remember it, and return it (system clock).
+ *
+ * The caller sleeps for (returned - now) just before going down, so the
+ * teardown after planning is absorbed too.
+ */
+int64_t sleep_schedule_plan(sleep_schedule_t *s, const sleep_schedule_cfg_t *cfg,
+                            int64_t now_ms);
+
+/** "clock":{"drift_ppm":..,"sync_age_s":..}; nothing before the first sync. */
+void sleep_schedule_encode(const sleep_schedule_t *s, int64_t now_ms, telemetry_enc_t *e);
+
+#ifndef TEST_HOST
+/* Device state in RTC_DATA_ATTR memory (reset if its CRC fails on the first call after boot). */
+sleep_schedule_t *sleep_schedule(void);
+
+/** System clock (gettimeofday), ms. */
+int64_t sleep_schedule_now_ms(void);
+
+/** Default config: DEEP_SLEEP-style `interval_s`, offset by this device's report slot. */
+sleep_schedule_cfg_t sleep_schedule_default_cfg(uint32_t interval_s);
+
+/**
+ * @brief One SNTP exchange with SNTP_SERVER; needs a network link.
+ *
+ * The result only updates the cached wall clock; the system clock (which
+ * report_policy and reading_buffer time against) is left alone.
+ *
+ * @return true if a time arrived within SNTP_TIMEOUT_MS
+ */
+bool sleep_schedule_sync_sntp(void);
+#endif // TEST_HOST
+
+#endif // SLEEP_SCHEDULE_H
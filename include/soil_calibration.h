@@ -2,19 +2,21 @@
 #define SOIL_CALIBRATION_H
 
 #include <stdbool.h>
+#include <stddef.h>
 #include <stdint.h>
 
 /**
  * @brief Runtime soil-moisture calibration values.
  *
- * Owns the per-device dry/wet mV thresholds and the last-cal timestamp.
- * Backed by NVS namespace "soil_cal" through nvs_shim.
+ * Owns the dry/wet mV thresholds and the last-cal timestamp of every probe
+ * in the soil_probe table. Each probe has its own NVS namespace (probe 0:
+ * "soil_cal") through nvs_shim. The unsuffixed functions act on probe 0.
  *
  * Defaults if NVS has no values:
  *   dry_mv = 2800, wet_mv = 0, cal_ts = 0
  */
 
-/** Load from NVS into RAM. Falls back to defaults on missing keys. */
+/** Load every probe from NVS into RAM. Falls back to defaults on missing keys. */
 void soil_calibration_init(void);
 
 uint32_t soil_calibration_get_dry_mv(void);
@@ -27,4 +29,15 @@ bool soil_calibration_save(uint32_t dry_mv, uint32_t wet_mv, uint32_t cal_ts);
 /** Erase the whole "soil_cal" namespace. RAM cache reverts on next init. */
 bool soil_calibration_clear(void);
 
+/** Per-probe getters; an out-of-range probe reads as the defaults. */
+uint32_t soil_calibration_get_probe_dry_mv(size_t probe);
+uint32_t soil_calibration_get_probe_wet_mv(size_t probe);
+uint32_t soil_calibration_get_probe_cal_ts(size_t probe);
+
+/** Persist one probe's values to its namespace. False if out of range. */
+bool soil_calibration_save_probe(size_t probe, uint32_t dry_mv, uint32_t wet_mv, uint32_t cal_ts);
+
+/** Erase one probe's namespace. RAM cache reverts on next init. */
+bool soil_calibration_clear_probe(size_t probe);
+
 #endif
@@ -1,8 +1,12 @@
 #ifndef SOIL_MOISTURE_H
 #define SOIL_MOISTURE_H
 
+#include <stddef.h>
+#include <stdint.h>
+
 #ifndef TEST_HOST
 #include "esp_err.h"
+#include "adc_frame.h"
 #endif
 
 /**
@@ -17,6 +21,44 @@
  * - Response time: <1s
  */
 
+/** Fractional bits of the fixed-point soil mV (Q4 = 1/16 mV steps). */
+#define SOIL_MV_FRAC_BITS     4
+
+/** Extra ADC bits gained by oversampling; the burst is 4^bits samples.
+ *  At most 2: a lane holds ADC_MANAGER_SCAN_MAX_SAMPLES (32) codes. */
+#ifndef SOIL_OVERSAMPLE_BITS
+#define SOIL_OVERSAMPLE_BITS  2
+#endif
+
+/** Fixed-point mV to whole mV, rounded to nearest (non-negative input). */
+#define SOIL_MV_FX_TO_MV(fx)  ((int)(((fx) + (1 << (SOIL_MV_FRAC_BITS - 1))) >> SOIL_MV_FRAC_BITS))
+
+/**
+ * @brief Pure percentage math from raw ADC mV and calibration mV.
+ *
+ * Linear interpolation, clamped to [0, 100]. No hardware access.
+ * Exposed for unit testing and for direct callers that want the math
+ * without triggering a physical read.
+ */
+float soil_moisture_calc_percentage(int raw_mv, int dry_mv, int wet_mv);
+
+/**
+ * @brief Percentage math on a fixed-point (Q SOIL_MV_FRAC_BITS) sensor mV.
+ *
+ * Same curve as soil_moisture_calc_percentage(), but keeps the sub-mV
+ * resolution of an oversampled read instead of snapping to whole mV.
+ */
+float soil_moisture_calc_percentage_fx(int32_t raw_mv_fx, int dry_mv, int wet_mv);
+
+/**
+ * @brief Integer percentage math: fixed-point mV in, 0.01 % units out.
+ *
+ * Same curve as soil_moisture_calc_percentage_fx(), rounded to nearest and
+ * already in the ZCL Soil Moisture MeasuredValue format (0..10000).
+ */
+uint16_t soil_moisture_calc_pct_x100(int32_t raw_mv_fx, int dry_mv, int wet_mv);
+
+#ifndef TEST_HOST
 /**
  * @brief Initialize the soil moisture sensor
  * 
@@ -29,11 +71,10 @@
 esp_err_t soil_moisture_init(void);
 
 /**
- * @brief Re-establish the ADC channel + calibration after an adc_manager_reinit().
+ * @brief Re-establish the ADC channels after an adc_manager_reinit().
  *
  * Cheaper than a full re-init: re-applies only the unit-dependent state (channel
- * config + calibration handle), leaving the GPIO power-pin config and PM lock in
- * place. Call after adc_manager_reinit() rebuilds the shared unit.
+ * config), leaving the GPIO power-pin config and PM lock in place. Call after adc_manager_reinit() rebuilds the shared unit.
  *
  * @return ESP_OK on success, error code otherwise
  */
@@ -65,31 +106,82 @@ float soil_moisture_read_voltage(void);
 /**
  * @brief Clean up soil moisture sensor resources
  *
- * Releases ADC handles and calibration schemes.
+ * Marks the sensor uninitialised; the shared ADC unit stays with adc_manager.
  * Should be called before shutdown or reconfiguration.
  *
  * @return ESP_OK on success, error code otherwise
  */
 esp_err_t soil_moisture_deinit(void);
 
-/**
- * @brief Pure percentage math from raw ADC mV and calibration mV.
- *
- * Linear interpolation, clamped to [0, 100]. No hardware access.
- * Exposed for unit testing and for direct callers that want the math
- * without triggering a physical read.
- */
-float soil_moisture_calc_percentage(int raw_mv, int dry_mv, int wet_mv);
-
 /**
  * @brief Read averaged raw sensor value in millivolts.
  *
  * Like soil_moisture_read_voltage() but returns the integer mV from
- * the same 10-sample average. Used by the calibration capture
+ * the same outlier-rejecting sample reduction. Used by the calibration capture
  * endpoints in config_portal.
  *
  * @return mV (0 if sensor not initialized or all reads fail)
  */
 int soil_moisture_read_raw_mv(void);
 
+/**
+ * @brief soil_moisture_read_raw_mv() for any probe of the soil_probe table.
+ *
+ * Powers and samples probes [0, probe] together and returns this one's mV.
+ * Used by the per-probe calibration capture in config_portal.
+ *
+ * @return mV (0 if the probe is out of range or its read failed)
+ */
+int soil_moisture_read_probe_raw_mv(size_t probe);
+
+/**
+ * @brief Oversampled soil mV, sampling other ADC1 channels in the same burst.
+ *
+ * Takes ADC_OVERSAMPLE_COUNT(SOIL_OVERSAMPLE_BITS) conversions, drops MAD
+ * outliers, and decimates the rest into a code with SOIL_OVERSAMPLE_BITS
+ * fractional bits; the mV is interpolated between the calibrated values of
+ * the neighbouring integer codes. Result is Q SOIL_MV_FRAC_BITS mV.
+ *
+ * The companion lanes are scanned together with the soil channel in one
+ * continuous-mode (DMA) burst while the probe is powered, so a caller that
+ * needs e.g. the battery channel too pays for a single sampling window.
+ * Companions must use the soil channel's 12 dB attenuation.
+ *
+ * @param companions   Up to ADC_MANAGER_SCAN_MAX_LANES - 1 extra lanes (may be NULL)
+ * @param n_companions Number of companion lanes
+ * @return fixed-point mV (0 if sensor not initialized or all reads fail)
+ */
+int32_t soil_moisture_read_mv_fx(adc_frame_lane_t *companions, size_t n_companions);
+
+/**
+ * @brief Oversampled mV of several probes from one shared power window.
+ *
+ * Powers probes [0, n_probes) of the soil_probe table together, waits once
+ * for the slowest to settle, and samples every probe channel (plus the
+ * companion lanes) in a single DMA burst — one warm-up instead of N.
+ * Each probe is reduced as in soil_moisture_read_mv_fx().
+ *
+ * @param[out] mv_fx   n_probes fixed-point mV values (0 for a failed probe)
+ * @param n_probes     1..SOIL_PROBE_COUNT
+ * @param companions   Extra lanes; n_probes + n_companions must fit
+ *                     ADC_MANAGER_SCAN_MAX_LANES (may be NULL)
+ * @param n_companions Number of companion lanes
+ * @return ESP_OK if every probe read, ESP_FAIL if any failed, or an
+ *         argument/state error
+ */
+esp_err_t soil_moisture_read_probes_fx(int32_t *mv_fx, size_t n_probes,
+                                       adc_frame_lane_t *companions, size_t n_companions);
+
+/**
+ * @brief Warm-up time of the most recent read, in milliseconds.
+ *
+ * The probe is polled after power-up and sampled as soon as its output
+ * settles (see soil_settle.h), so this varies per read and per soil state.
+ *
+ * @return ms between power-up and the sample window (0 before the first read)
+ */
+int soil_moisture_get_last_settle_ms(void);
+
+#endif // TEST_HOST
+
 #endif // SOIL_MOISTURE_H
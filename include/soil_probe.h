@@ -0,0 +1,42 @@
+#ifndef SOIL_PROBE_H
+#define SOIL_PROBE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief Board table of soil probes (e.g. several depths on one node).
+ *
+ * Every probe has its own ADC1 channel, power GPIO and calibration
+ * namespace. Probes may share a power GPIO; soil_moisture powers all of
+ * them together, waits out one shared warm-up and samples every channel
+ * in a single DMA burst.
+ *
+ * Probe 0 is the original single-probe wiring and keeps the "soil_cal"
+ * namespace and the "soil_moisture" report key, so single-probe builds
+ * are unchanged. Set SOIL_PROBE_COUNT (build flag) to enable more rows.
+ *
+ * Rows are fixed at build time (src/soil_probe.c); nothing is detected at
+ * run time.
+ */
+
+#define SOIL_PROBE_MAX  4
+
+#ifndef SOIL_PROBE_COUNT
+#define SOIL_PROBE_COUNT 1
+#endif
+
+#if SOIL_PROBE_COUNT < 1 || SOIL_PROBE_COUNT > SOIL_PROBE_MAX
+#error "SOIL_PROBE_COUNT must be 1..SOIL_PROBE_MAX"
+#endif
+
+typedef struct {
+    uint8_t     adc_channel;  ///< ADC1 channel (on the C6, channel n is GPIO n)
+    uint8_t     pwr_gpio;     ///< Switched probe VCC, driven HIGH only while reading
+    const char *cal_ns;       ///< NVS namespace holding this probe's dry/wet mV
+    const char *key;          ///< Field name in the MQTT JSON payload
+} soil_probe_t;
+
+extern const soil_probe_t soil_probes[SOIL_PROBE_COUNT];
+
+#endif // SOIL_PROBE_H
@@ -0,0 +1,77 @@
+#ifndef SOIL_SETTLE_H
+#define SOIL_SETTLE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+/**
+ * @brief Soil-probe warm-up settle detector.
+ *
+ * After the probe is powered, the caller takes one short read every
+ * `step_ms` and feeds it here. The output counts as settled once the
+ * step-to-step change stays within `slope_mv` for `stable_steps`
+ * consecutive steps (and at least `min_ms` has elapsed). `max_ms` is a
+ * hard ceiling: the detector gives up and lets the caller sample anyway.
+ *
+ * The defaults are tuned on the recorded warm-ups in test/test_soil_settle.
+ */
+
+typedef struct {
+    int step_ms;        ///< Interval between probe reads
+    int min_ms;         ///< Never declare settled before this
+    int max_ms;         ///< Hard ceiling — sample regardless after this
+    int slope_mv;       ///< |delta| per step at or below which a step is calm
+    int stable_steps;   ///< Consecutive calm steps required
+} soil_settle_cfg_t;
+
+typedef enum {
+    SOIL_SETTLE_WAIT = 0,   ///< Keep reading
+    SOIL_SETTLE_DONE,       ///< Output has settled
+    SOIL_SETTLE_TIMEOUT,    ///< Ceiling reached without settling
+} soil_settle_state_t;
+
+typedef struct {
+    int  elapsed_ms;
+    int  last_mv;
+    int  calm;
+    bool have_last;
+} soil_settle_t;
+
+/** Defaults tuned on the DFRobot v2 probe (10 ms tick, 300 ms ceiling). */
+#define SOIL_SETTLE_CFG_DEFAULT { \
+    .step_ms = 10, .min_ms = 20, .max_ms = 300, .slope_mv = 8, .stable_steps = 2 }
+
+/** Reset the detector; call right after powering the probe. */
+void soil_settle_begin(soil_settle_t *s);
+
+/**
+ * @brief Feed one probe read taken `cfg->step_ms` after the previous one.
+ * @return WAIT to keep going, DONE or TIMEOUT to start the real sample window
+ */
+soil_settle_state_t soil_settle_feed(soil_settle_t *s, const soil_settle_cfg_t *cfg, int mv);
+
+/**
+ * @brief Feed one read per probe for probes sharing a power window.
+ *
+ * Only detectors still in WAIT are fed (a settled probe keeps its state
+ * and elapsed time), so the window lasts as long as the slowest probe
+ * rather than the sum of all of them.
+ *
+ * @param s     One detector per probe (soil_settle_begin() each first)
+ * @param st    One state per probe, initialised to SOIL_SETTLE_WAIT
+ * @param mv    This step's read for each probe
+ * @return true once no probe is in WAIT
+ */
+bool soil_settle_feed_all(soil_settle_t *s, soil_settle_state_t *st, size_t n,
+                          const soil_settle_cfg_t *cfg, const int *mv);
+
+/**
+ * @brief Run the detector over a recorded trace (one read per step).
+ *
+ * @param[out] state Final state (WAIT if the trace ran out first); may be NULL
+ * @return elapsed ms at which the detector stopped
+ */
+int soil_settle_run(const soil_settle_cfg_t *cfg, const int *trace, size_t n,
+                    soil_settle_state_t *state);
+
+#endif // SOIL_SETTLE_H
@@ -0,0 +1,79 @@
+#ifndef TELEMETRY_ENC_H
+#define TELEMETRY_ENC_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief Zero-allocation telemetry serializer with JSON and CBOR backends.
+ *
+ * One streaming API writes either format into a caller buffer. Values are
+ * integers; decimals are fixed-point (`value`, `decimals`), so the device
+ * never formats a float:
+ *
+ *   JSON  telemetry_enc_fixed(e, "battery", 415, 2)  ->  "battery":4.15
+ *   CBOR  same call                                  ->  "battery": 4([-2, 415])
+ *
+ * CBOR uses indefinite-length maps/arrays (no element counts up front) and
+ * RFC 8949 tag 4 (decimal fraction) for fixed-point values;
+ * z2m/telemetry_cbor.js decodes it back to the JSON shape.
+ *
+ * `key` names the value inside a map and is NULL inside arrays. Writing
+ * members at the top level without an enclosing map produces a member list
+ * ("a":1,"b":2 in JSON) for splicing into another payload.
+ *
+ * Any overflow is sticky: later calls write nothing and telemetry_enc_finish()
+ * returns -1.
+ */
+
+typedef enum {
+    TELEMETRY_FMT_JSON = 0,
+    TELEMETRY_FMT_CBOR = 1,
+} telemetry_fmt_t;
+
+#ifndef TELEMETRY_FORMAT_DEFAULT
+#define TELEMETRY_FORMAT_DEFAULT  TELEMETRY_FMT_JSON   ///< Until set per device in the portal
+#endif
+
+#define TELEMETRY_ENC_MAX_DEPTH  6
+
+typedef struct {
+    uint8_t        *buf;
+    size_t          cap;            ///< Usable bytes (JSON keeps one back for the NUL)
+    size_t          len;
+    telemetry_fmt_t fmt;
+    uint8_t         depth;
+    bool            overflow;
+    bool            has_item[TELEMETRY_ENC_MAX_DEPTH + 1];   ///< JSON: comma needed at this level
+} telemetry_enc_t;
+
+void telemetry_enc_init(telemetry_enc_t *e, telemetry_fmt_t fmt, void *buf, size_t cap);
+
+void telemetry_enc_map_begin(telemetry_enc_t *e, const char *key);
+void telemetry_enc_map_end(telemetry_enc_t *e);
+void telemetry_enc_array_begin(telemetry_enc_t *e, const char *key);
+void telemetry_enc_array_end(telemetry_enc_t *e);
+
+void telemetry_enc_int(telemetry_enc_t *e, const char *key, int32_t value);
+
+/** `value` / 10^`decimals`, written with exactly `decimals` places (0..9). */
+void telemetry_enc_fixed(telemetry_enc_t *e, const char *key, int32_t value, uint8_t decimals);
+
+/** UTF-8 text; JSON escapes quotes, backslashes and control characters. */
+void telemetry_enc_str(telemetry_enc_t *e, const char *key, const char *s);
+
+/**
+ * @brief Close out the buffer.
+ *
+ * JSON output is NUL-terminated (not counted). On failure JSON output is
+ * left as "".
+ *
+ * @return bytes written, or -1 on overflow or unbalanced begin/end
+ */
+int telemetry_enc_finish(telemetry_enc_t *e);
+
+/** Name for logs and MQTT subtopics ("json" / "cbor"). */
+const char *telemetry_fmt_name(telemetry_fmt_t fmt);
+
+#endif // TELEMETRY_ENC_H
@@ -0,0 +1,124 @@
+#ifndef WAKE_GRAPH_H
+#define WAKE_GRAPH_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief Wake steps as a small dependency graph, run concurrently.
+ *
+ * Most of a WiFi wake is spent waiting: on association and DHCP, on the
+ * broker, on the PUBACK, on the e-paper's BUSY line. Steps that don't need
+ * each other's results can wait at the same time, so the wake takes about
+ * as long as its longest chain of dependent steps instead of the sum of all
+ * of them.
+ *
+ * Each node names the nodes that must finish before it starts (a bitmask of
+ * indices). A node that fails, or is skipped, skips everything that depends
+ * on it, directly or not; independent nodes still run.
+ *
+ * Scheduling (wake_graph_next / wake_graph_complete) and the checks only
+ * track bitmasks; wake_graph_run() drives them with one FreeRTOS task per
+ * node on the device.
+ */
+
+#define WAKE_GRAPH_MAX_NODES  8
+#define WAKE_GRAPH_DEP(i)     (1u << (i))
+
+#ifndef WAKE_PIPELINE_PARALLEL
+#define WAKE_PIPELINE_PARALLEL  1   ///< 0 = run nodes one at a time on the caller, in graph order
+#endif
+
+/** One step. Returns false on failure (or when its dependents should not run). */
+typedef bool (*wake_graph_fn)(void *ctx);
+
+typedef struct {
+    const char   *name;             ///< Task name, for logs
+    uint32_t      deps;             ///< WAKE_GRAPH_DEP() of every node that must finish first
+    wake_graph_fn run;
+    uint32_t      stack;            ///< Task stack, bytes
+} wake_graph_node_t;
+
+typedef struct {
+    const wake_graph_node_t *node;
+    size_t n;                       ///< <= WAKE_GRAPH_MAX_NODES
+} wake_graph_t;
+
+/** Progress of one run. Start from all zeroes. */
+typedef struct {
+    uint32_t started;               ///< Handed out by wake_graph_next()
+    uint32_t done;                  ///< Finished, failed or skipped
+    uint32_t ok;                    ///< Finished and returned true
+} wake_graph_state_t;
+
+/** True iff every dependency names an existing node and there is no cycle. */
+bool wake_graph_valid(const wake_graph_t *g);
+
+/**
+ * @brief Nodes to start now.
+ *
+ * Marks as done (not ok) every node that can no longer run because a
+ * dependency failed or was skipped, then returns the not-yet-started nodes
+ * whose dependencies all succeeded, marking them started.
+ */
+uint32_t wake_graph_next(const wake_graph_t *g, wake_graph_state_t *st);
+
+/** Record that `node` has returned. */
+void wake_graph_complete(wake_graph_state_t *st, size_t node, bool ok);
+
+/** True once every node is done. */
+bool wake_graph_finished(const wake_graph_t *g, const wake_graph_state_t *st);
+
+/**
+ * @brief Wall time of a run with every node at its estimated duration and
+ *        unlimited concurrency: the longest dependency chain.
+ * @param dur Per node, any unit
+ */
+uint32_t wake_graph_critical_path(const wake_graph_t *g, const uint32_t *dur);
+
+/** Nodes of the WiFi wake, in main.c. */
+typedef enum {
+    WAKE_NODE_SENSE = 0,    ///< Soil read + report decision; false = nothing to report
+    WAKE_NODE_NET,          ///< WiFi association + DHCP
+    WAKE_NODE_BROKER,       ///< MQTT client start
+    WAKE_NODE_PUBLISH,      ///< Broker connect, publish, PUBACK, backlog drain
+    WAKE_NODE_DISPLAY,      ///< Framebuffer, SPI transfer and panel refresh
+    WAKE_NODE_CLOCK,        ///< SNTP sync for the sleep schedule, when due
+    WAKE_NODE_COUNT
+} wake_node_t;
+
+#ifndef WAKE_PIPELINE_STACK
+#define WAKE_PIPELINE_STACK  4096   ///< Per node task, bytes
+#endif
+
+/**
+ * @brief Wire up the WiFi wake.
+ *
+ * Publish and the display both need the readings and the started MQTT
+ * client (which brings the device ID, and implies a link for the RSSI), so
+ * the display runs alongside the broker connect and PUBACK wait. So does
+ * the clock sync, which needs only the link. WiFi normally waits for the
+ * report decision, so an unchanged reading never powers the radio. With
+ * `net_first` (the report is due whatever the probes read) association
+ * starts at once and overlaps the soil read.
+ *
+ * @param run Node functions, indexed by wake_node_t
+ */
+void wake_pipeline_init(wake_graph_node_t node[WAKE_NODE_COUNT],
+                        const wake_graph_fn run[WAKE_NODE_COUNT], bool net_first);
+
+#ifndef TEST_HOST
+/**
+ * @brief Run the graph and block until every node is done.
+ *
+ * Each node gets its own task at the caller's priority as soon as its
+ * dependencies have succeeded; with WAKE_PIPELINE_PARALLEL 0 they run on
+ * the calling task instead, one at a time.
+ *
+ * @return WAKE_GRAPH_DEP() of every node that ran and returned true
+ */
+uint32_t wake_graph_run(const wake_graph_t *g, void *ctx);
+#endif // TEST_HOST
+
+#endif // WAKE_GRAPH_H
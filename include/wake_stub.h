@@ -0,0 +1,111 @@
+#ifndef WAKE_STUB_H
+#define WAKE_STUB_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "telemetry_enc.h"
+
+/**
+ * @brief Deep-sleep wake stub: absorb timer wakes that need no full boot.
+ *
+ * A full boot (bootloader, image check, NVS, netif, ADC) costs far more
+ * than the "read, nothing changed, sleep" it often leads to. While the soil
+ * readings stay quiet, the app arms the stub to absorb the next few timer
+ * wakes: the stub runs from RTC fast memory straight out of deep sleep,
+ * counts the wake and goes back down within a few hundred microseconds,
+ * keeping the wake cadence. The last wake of the run, any non-timer wake
+ * (the portal button) and a corrupt schedule boot normally.
+ *
+ * The streak of quiet boots sets how many wakes are absorbed: one more per
+ * quiet boot, up to WAKE_STUB_MAX_SKIP, never past the report heartbeat. A
+ * reading that moved drops straight back to booting every wake.
+ *
+ * The stub can only run code in RTC memory, so it cannot call crc32 (in
+ * flash): the fields it reads are guarded by a complement word instead, and
+ * the functions it calls are forced inline.
+ */
+
+#ifndef WAKE_STUB_MAX_SKIP
+#define WAKE_STUB_MAX_SKIP  3       ///< Most timer wakes absorbed between full boots; 0 = stub off
+#endif
+
+#define WAKE_STUB_MAGIC     0x57AB0001u
+
+/** RTC-retained schedule, shared by the stub and the app. */
+typedef struct {
+    uint32_t magic;
+    uint32_t countdown;         ///< Wakes until the next full boot, this one included
+    uint64_t step_us;           ///< Sleep between absorbed wakes
+    uint32_t check;             ///< ~(magic ^ countdown ^ step_us halves)
+    uint32_t wakes;             ///< Every wake since reset, absorbed or not
+    uint32_t absorbed;          ///< Wakes the stub sent straight back to sleep
+    uint16_t quiet;             ///< Consecutive full boots with nothing to report
+    uint16_t boot_every;        ///< Last armed run: full boot every this many wakes
+} wake_stub_t;
+
+static inline __attribute__((always_inline)) uint32_t wake_stub_check(const wake_stub_t *s) {
+    return ~(s->magic ^ s->countdown ^ (uint32_t)s->step_us ^ (uint32_t)(s->step_us >> 32));
+}
+
+/** True iff the fields the stub acts on are intact. */
+static inline __attribute__((always_inline)) bool wake_stub_valid(const wake_stub_t *s) {
+    return s->magic == WAKE_STUB_MAGIC && s->check == wake_stub_check(s);
+}
+
+/**
+ * @brief The stub's decision, on every wake.
+ *
+ * Counts the wake. Returns true if it is a timer wake with more of the run
+ * to go (sleep again for step_us), false to boot. A boot leaves countdown
+ * at 0, so only a new wake_stub_arm() absorbs wakes again.
+ */
+static inline __attribute__((always_inline)) bool wake_stub_absorb(wake_stub_t *s, bool timer_wake) {
+    if (!wake_stub_valid(s)) {
+        return false;
+    }
+    s->wakes++;
+    if (timer_wake && s->countdown > 1 && s->step_us > 0) {
+        s->countdown--;
+        s->absorbed++;
+        s->check = wake_stub_check(s);
+        return true;
+    }
+    s->countdown = 0;
+    s->check = wake_stub_check(s);
+    return false;
+}
+
+/** Clear all state and seal. */
+void wake_stub_reset(wake_stub_t *s);
+
+/** This boot had nothing to report: lengthen the streak. */
+void wake_stub_note_quiet(wake_stub_t *s);
+
+/** This boot reported a reading that moved: end the streak. */
+void wake_stub_note_change(wake_stub_t *s);
+
+/**
+ * @brief How many wakes the next run should span (1 = boot every wake).
+ *
+ * 1 + the quiet streak, capped at WAKE_STUB_MAX_SKIP + 1 and at the number
+ * of whole intervals in `headroom_s` (time left before a boot must happen,
+ * e.g. the report heartbeat).
+ */
+uint32_t wake_stub_boot_every(const wake_stub_t *s, uint32_t interval_s, uint32_t headroom_s);
+
+/** Arm the stub before sleeping: the next full boot is `boot_every` wakes away, `step_us` apart. */
+void wake_stub_arm(wake_stub_t *s, uint32_t boot_every, uint64_t step_us);
+
+/** "stub":{"wakes":..,"absorbed":..}; nothing until the first wake. */
+void wake_stub_encode(const wake_stub_t *s, telemetry_enc_t *e);
+
+#ifndef TEST_HOST
+/* Device state in RTC_DATA_ATTR memory (reset if invalid on the first call after boot). */
+wake_stub_t *wake_stub(void);
+
+/** Make the stub this deep sleep's wake entry point (no-op with WAKE_STUB_MAX_SKIP 0). */
+void wake_stub_install(void);
+#endif // TEST_HOST
+
+#endif // WAKE_STUB_H
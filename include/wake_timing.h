@@ -0,0 +1,166 @@
+#ifndef WAKE_TIMING_H
+#define WAKE_TIMING_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "telemetry_enc.h"
+
+/**
+ * @brief Per-phase wake-cycle timing.
+ *
+ * Each wake (WiFi build) or report cycle (Zigbee build) fills one record
+ * with the microseconds spent in each named phase. Records go into a small
+ * ring retained in RTC memory across deep sleep and guarded by a CRC, so
+ * the telemetry can carry a summary of the last few complete wakes: where
+ * the awake time went, not just how long it was.
+ *
+ * Phases may nest (e.g. CONNECT inside the publish path), overlap (the
+ * wake pipeline runs SENSE, NET and DISPLAY in their own tasks) and may be
+ * entered more than once per record; time accumulates. Phase times can
+ * therefore add up to more than total_us.
+ *
+ * The record/ring/summary functions take explicit timestamps; the
+ * esp_timer-backed markers at the end are the device's wrappers.
+ */
+
+typedef enum {
+    WAKE_PHASE_BOOT = 0,    ///< Startup before app_main (esp_timer zero -> begin)
+    WAKE_PHASE_INIT,        ///< init_system(): NVS, netif, ADC, sensors
+    WAKE_PHASE_OCV,         ///< Zero-load battery sample
+    WAKE_PHASE_NET,         ///< setup_wifi()
+    WAKE_PHASE_BROKER,      ///< setup_mqtt()
+    WAKE_PHASE_CONNECT,     ///< Waiting for the MQTT connection
+    WAKE_PHASE_ADC,         ///< ADC resume after light sleep (Zigbee)
+    WAKE_PHASE_SENSE,       ///< Soil (+ battery) read
+    WAKE_PHASE_PUBLISH,     ///< Publish + delivery wait / Zigbee report
+    WAKE_PHASE_DISPLAY,     ///< E-paper refresh
+    WAKE_PHASE_COUNT
+} wake_phase_t;
+
+#define WAKE_TIMING_RECORDS  8              ///< Wakes retained in the RTC ring
+#define WAKE_TIMING_MAGIC    0x7A4E7100u
+
+/** One wake, as kept in the RTC ring. */
+typedef struct {
+    uint32_t phase_us[WAKE_PHASE_COUNT];    ///< Accumulated time per phase
+    uint32_t total_us;                      ///< Begin -> commit
+    uint16_t phase_mask;                    ///< Bit n set iff phase n was entered
+    uint16_t reserved;                      ///< Always 0
+} wake_timing_record_t;
+
+/** RTC-retained ring of the most recent records. */
+typedef struct {
+    uint32_t magic;
+    uint32_t seq;                           ///< Records ever pushed (wraps)
+    uint32_t count;                         ///< Valid records, <= WAKE_TIMING_RECORDS
+    uint32_t head;                          ///< Slot the next record goes into
+    wake_timing_record_t rec[WAKE_TIMING_RECORDS];
+    uint32_t crc;                           ///< crc32 over every field above
+} wake_timing_log_t;
+
+/** In-progress record plus the open phase start times (not retained). */
+typedef struct {
+    wake_timing_record_t rec;
+    int64_t begin_us;
+    int64_t start_us[WAKE_PHASE_COUNT];     ///< < 0 while the phase is closed
+} wake_timing_t;
+
+/** Aggregate of one phase (or the total) over the records that entered it. */
+typedef struct {
+    uint32_t n;
+    uint32_t last_us;                       ///< Most recent record
+    uint32_t min_us;
+    uint32_t max_us;
+    uint32_t mean_us;
+} wake_timing_stats_t;
+
+/** Short name used as the JSON key ("init", "net", ...). */
+const char *wake_timing_phase_name(wake_phase_t phase);
+
+/**
+ * @brief Start a record at `now_us`.
+ * @param since_boot Also charge [0, now_us) to WAKE_PHASE_BOOT and count it
+ *                   in the total (the first record after a deep-sleep wake)
+ */
+void wake_timing_begin_at(wake_timing_t *t, int64_t now_us, bool since_boot);
+
+/** Open `phase`; a phase that is already open is left alone. */
+void wake_timing_start_at(wake_timing_t *t, wake_phase_t phase, int64_t now_us);
+
+/** Close `phase` and add its elapsed time; closing a closed phase is a no-op. */
+void wake_timing_stop_at(wake_timing_t *t, wake_phase_t phase, int64_t now_us);
+
+/** Close any open phases and set the total; the record is then ready to push. */
+void wake_timing_finish_at(wake_timing_t *t, int64_t now_us);
+
+/** Empty the ring and seal it. */
+void wake_timing_log_reset(wake_timing_log_t *log);
+
+/** True iff `log` is intact (magic, bounds and CRC). */
+bool wake_timing_log_valid(const wake_timing_log_t *log);
+
+/** Append a record, overwriting the oldest once full, and reseal. */
+void wake_timing_log_push(wake_timing_log_t *log, const wake_timing_record_t *rec);
+
+/** Most recently pushed record, or NULL if the ring is empty. */
+const wake_timing_record_t *wake_timing_log_last(const wake_timing_log_t *log);
+
+/**
+ * @brief Aggregate one phase across the retained records.
+ * @param phase A wake_phase_t, or WAKE_PHASE_COUNT for the total
+ */
+void wake_timing_log_stats(const wake_timing_log_t *log, int phase,
+                           wake_timing_stats_t *out);
+
+/**
+ * @brief Compact JSON summary, in ms: {"n":8,"total":[last,mean,max],"init":[...],...}
+ *
+ * Only phases entered in at least one record are listed.
+ *
+ * @return bytes written (excluding NUL), or -1 if `buf` is too small
+ */
+int wake_timing_format_json(const wake_timing_log_t *log, char *buf, size_t len);
+
+/** Same summary through an encoder, as the value of `key` (NULL inside an array). */
+void wake_timing_encode(const wake_timing_log_t *log, telemetry_enc_t *e, const char *key);
+
+#define WAKE_TIMING_PACK_VERSION  1
+/** Packed summary size: version, n, then last/mean ms (u16 LE) for the total and each phase. */
+#define WAKE_TIMING_PACK_LEN      (2 + 4 * (1 + WAKE_PHASE_COUNT))
+
+/**
+ * @brief Binary summary for the Zigbee manufacturer-specific attribute.
+ *
+ * Layout: version, n, then {last_ms, mean_ms} as little-endian uint16
+ * (saturating) for the total and for each phase in enum order; phases
+ * never entered read 0xFFFF. Written as a ZCL octet string, so `out[0]`
+ * is the length prefix and the payload starts at `out[1]`.
+ *
+ * @param out At least WAKE_TIMING_PACK_LEN + 1 bytes
+ */
+void wake_timing_pack_zcl(const wake_timing_log_t *log, uint8_t *out);
+
+#ifndef TEST_HOST
+/*
+ * Device markers over a single module-owned record, timed with
+ * esp_timer_get_time(). The ring lives in RTC_DATA_ATTR memory and is
+ * reset if its CRC does not check (cold boot, brownout, layout change).
+ * Markers outside a begin..commit pair are ignored. start/stop may be
+ * called from any task.
+ */
+void wake_timing_begin(bool since_boot);
+void wake_timing_start(wake_phase_t phase);
+void wake_timing_stop(wake_phase_t phase);
+
+/**
+ * @brief Finish the current record and push it into the RTC ring.
+ * @return true if a record was pushed (false if none was open)
+ */
+bool wake_timing_commit(void);
+
+/** The retained ring (previous complete records; not the one in progress). */
+const wake_timing_log_t *wake_timing_log(void);
+#endif // TEST_HOST
+
+#endif // WAKE_TIMING_H
@@ -4,6 +4,7 @@
 #include <stdbool.h>
 #include <stddef.h>
 #include "esp_err.h"
+#include "telemetry_enc.h"
 
 /**
  * @brief WiFi credentials storage interface
@@ -50,6 +51,19 @@ esp_err_t wifi_credentials_save_device_id(const char *device_id);
  */
 bool wifi_credentials_load_device_id(char *device_id, size_t device_id_len);
 
+/**
+ * @brief Save the telemetry payload format for this device
+ * @param fmt TELEMETRY_FMT_JSON or TELEMETRY_FMT_CBOR
+ * @return ESP_OK on success, ESP_ERR_INVALID_ARG for an unknown format
+ */
+esp_err_t wifi_credentials_save_telemetry_format(telemetry_fmt_t fmt);
+
+/**
+ * @brief Load the telemetry payload format for this device
+ * @return Stored format, or TELEMETRY_FORMAT_DEFAULT if none is saved
+ */
+telemetry_fmt_t wifi_credentials_load_telemetry_format(void);
+
 /**
  * @brief Clear all WiFi credentials from NVS
  * @return ESP_OK on success, error code otherwise
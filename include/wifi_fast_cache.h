@@ -0,0 +1,78 @@
+#ifndef WIFI_FAST_CACHE_H
+#define WIFI_FAST_CACHE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * @brief RTC-retained fast-reconnect parameters for the WiFi station.
+ *
+ * After a good connection wifi_manager records the AP's BSSID and primary
+ * channel and the DHCP lease (address, mask, gateway, DNS). The next wake
+ * connects to that BSSID on that channel without a full scan. While the
+ * lease is less than half used (the DHCP T1 renewal point) it also sets the
+ * address statically, which skips DHCP. Any failure on the fast path drops
+ * the cache, and the next attempt does a full scan plus DHCP.
+ *
+ * The cache is keyed by a CRC of the stored SSID + password, so
+ * re-provisioning invalidates it. Addresses are kept as the 32-bit values
+ * esp_ip4_addr_t uses (network byte order). Time is seconds on the
+ * RTC-backed system clock, as in report_policy.
+ */
+
+#ifndef WIFI_FAST_LEASE_S
+#define WIFI_FAST_LEASE_S  3600     ///< Assumed lease when the DHCP client doesn't report one
+#endif
+
+#define WIFI_FAST_CACHE_MAGIC  0xFA57C0DEu
+
+/** The last good connection; ignored unless `key` matches the current credentials. */
+typedef struct {
+    uint32_t magic;
+    uint32_t key;                   ///< wifi_fast_cache_key() of the credentials
+    uint32_t ip;
+    uint32_t netmask;
+    uint32_t gw;
+    uint32_t dns;                   ///< Main DNS server (0 = none)
+    uint32_t lease_start_s;         ///< Clock when DHCP last granted `ip`
+    uint32_t lease_s;               ///< Lease length granted then
+    uint8_t  bssid[6];
+    uint8_t  channel;               ///< Primary channel, 1..14
+    uint8_t  reserved;              ///< Always 0
+    uint32_t crc;                   ///< crc32 over every field above
+} wifi_fast_cache_t;
+
+/** Identity of a credential set (CRC over SSID then password). */
+uint32_t wifi_fast_cache_key(const char *ssid, const char *password);
+
+/** True iff `c` is intact (magic + CRC). */
+bool wifi_fast_cache_valid(const wifi_fast_cache_t *c);
+
+/** Drop the cache (it fails validation until the next store). */
+void wifi_fast_cache_invalidate(wifi_fast_cache_t *c);
+
+/**
+ * @brief Record a good connection and seal.
+ *
+ * @param from_dhcp true if DHCP just granted `ip` (restarts the lease clock
+ *                  with `lease_s`, or WIFI_FAST_LEASE_S if 0); false if the
+ *                  address was reused from this cache (lease clock kept)
+ */
+void wifi_fast_cache_store(wifi_fast_cache_t *c, uint32_t key,
+                           const uint8_t bssid[6], uint8_t channel,
+                           uint32_t ip, uint32_t netmask, uint32_t gw, uint32_t dns,
+                           uint32_t now_s, bool from_dhcp, uint32_t lease_s);
+
+/** True if the cached BSSID/channel belong to `key` and may be tried. */
+bool wifi_fast_cache_use_bssid(const wifi_fast_cache_t *c, uint32_t key);
+
+/** True if the cached address may also be set statically (lease < half used). */
+bool wifi_fast_cache_use_ip(const wifi_fast_cache_t *c, uint32_t key, uint32_t now_s);
+
+#ifndef TEST_HOST
+/* Device cache in RTC_DATA_ATTR memory, plus the clock it is stamped with. */
+wifi_fast_cache_t *wifi_fast_cache(void);
+uint32_t wifi_fast_cache_now_s(void);
+#endif // TEST_HOST
+
+#endif // WIFI_FAST_CACHE_H
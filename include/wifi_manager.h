@@ -24,11 +24,25 @@ bool wifi_manager_is_connected(void);
 
 /**
  * @brief Wait for WiFi connection with timeout
+ *
+ * Returns as soon as an IP address is assigned. When init_sta() took the
+ * RTC-cached fast path (known BSSID/channel, possibly a reused address), a
+ * failure there drops the cache and falls back to a full scan + DHCP within
+ * the same timeout.
+ *
  * @param timeout_sec Maximum time to wait in seconds
  * @return true if connected within timeout, false otherwise
  */
 bool wifi_manager_wait_connected(int timeout_sec);
 
+/**
+ * @brief Report that the connection turned out unusable (e.g. broker unreachable)
+ *
+ * If this connection reused a cached address without DHCP, the cache is
+ * dropped so the next wake does a full connect; otherwise a no-op.
+ */
+void wifi_manager_forget_fast_path(void);
+
 /**
  * @brief Stop and deinitialize the WiFi station
  *
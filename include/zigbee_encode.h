@@ -15,4 +15,18 @@ uint8_t zigbee_encode_batt_voltage(float volts);
  * uint8 in 0.5% units, range 0..200. Clamps out-of-range; NaN/neg -> 0. */
 uint8_t zigbee_encode_batt_pct(float pct);
 
+/* Fixed-point encoders for the integer report path. Each matches its float
+ * counterpart above for the value the float path would have been given
+ * (pct_x100 / 100.0f, mv / 1000.0f) — rounding half away from zero. */
+
+/* Soil moisture in 0.01% -> ZCL MeasuredValue. Clamps at 10000. */
+uint16_t zigbee_encode_soil_pct_x100(uint16_t pct_x100);
+
+/* Battery mV -> ZCL BatteryVoltage (100mV units). Caps at 255; neg -> 0. */
+uint8_t zigbee_encode_batt_mv(int mv);
+
+/* Battery percent in 0.01% -> ZCL BatteryPercentageRemaining (0.5% units).
+ * Clamps at 200. */
+uint8_t zigbee_encode_batt_pct_x100(uint16_t pct_x100);
+
 #endif // ZIGBEE_ENCODE_H
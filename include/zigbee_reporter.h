@@ -2,6 +2,7 @@
 #define ZIGBEE_REPORTER_H
 
 #include <stdbool.h>
+#include <stddef.h>
 #include <stdint.h>
 #include "esp_err.h"
 
@@ -17,6 +18,11 @@ typedef void (*zigbee_report_tick_cb_t)(void);
 void zigbee_reporter_set_report_tick_cb(zigbee_report_tick_cb_t cb);
 void zigbee_reporter_set_interval_ms(uint32_t interval_ms);
 
+/* Offset of this device's report slot within the interval (ms, see
+ * report_slot.h). After the first report, ticks land on boot time + offset +
+ * a whole number of intervals. Call before zigbee_reporter_init(). */
+void zigbee_reporter_set_report_offset_ms(uint32_t offset_ms);
+
 /* Set the Basic-cluster LocationDescription (0x0010) string, surfaced by the
  * z2m converter as the `label` payload field. Must be called before
  * zigbee_reporter_init() (the value is read when the cluster is created). Names
@@ -35,8 +41,23 @@ bool zigbee_reporter_wait_ready(uint32_t timeout_ms);
 
 /* Set + report the sensor attributes from outside the stack task (takes the
  * Zigbee lock). For use from other FreeRTOS tasks only — NOT from scheduler
- * callbacks (use the no-lock path inside zigbee_reporter.c instead). */
-esp_err_t zigbee_reporter_report(float soil_pct, float battery_v, float battery_pct);
+ * callbacks (use the no-lock path inside zigbee_reporter.c instead).
+ * Fixed-point inputs: soil and battery % in 0.01% units, battery in mV.
+ * soil_pct_x100 holds one value per probe (soil_probe table order); probe n
+ * is reported on endpoint 1 + n. */
+esp_err_t zigbee_reporter_report(const uint16_t *soil_pct_x100, size_t n_probes,
+                                 int battery_mv, uint16_t battery_pct_x100);
+
+/* Publish a wake-timing summary (wake_timing_pack_zcl() output, length-prefixed,
+ * WAKE_TIMING_PACK_LEN + 1 bytes) on the Basic cluster's manufacturer-specific
+ * attribute 0xF000. Takes the Zigbee lock; same calling rules as _report(). */
+esp_err_t zigbee_reporter_set_wake_timing(const uint8_t *zcl_octets);
+
+/* Publish the energy estimate on manufacturer-specific Basic attributes 0xF001
+ * (uint32, mean nAh per cycle since the ledger reset, as MQTT's mAh_per_wake)
+ * and 0xF002 (uint16, projected days remaining x10, saturating). Takes the
+ * Zigbee lock. */
+esp_err_t zigbee_reporter_set_energy(uint32_t mean_nah, uint32_t days_left_x10);
 
 /* When paused, the periodic report tick is skipped (used during OTA download). */
 void zigbee_reporter_set_reports_paused(bool paused);
@@ -0,0 +1,46 @@
+#include "adc_frame.h"
+
+#define RESULT_DATA_MASK   0x0FFFu
+#define RESULT_CHAN_SHIFT  13
+#define RESULT_CHAN_MASK   0x7u
+#define RESULT_UNIT_SHIFT  16
+#define RESULT_UNIT_MASK   0x1u
+
+// The DMA buffer is little-endian and not guaranteed to be word-aligned once
+// the caller slices it, so assemble each result byte by byte.
+static uint32_t load_le32(const uint8_t *p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) |
+           ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+size_t adc_frame_deinterleave(const uint8_t *buf, size_t len,
+                              adc_frame_lane_t *lanes, size_t n_lanes) {
+    if (!lanes) return 0;
+    for (size_t l = 0; l < n_lanes; l++) lanes[l].count = 0;
+    if (!buf) return 0;
+
+    size_t stored = 0;
+    for (size_t off = 0; off + ADC_FRAME_RESULT_BYTES <= len; off += ADC_FRAME_RESULT_BYTES) {
+        uint32_t w = load_le32(buf + off);
+        if (((w >> RESULT_UNIT_SHIFT) & RESULT_UNIT_MASK) != 0) continue;  // ADC2
+        uint8_t chan = (uint8_t)((w >> RESULT_CHAN_SHIFT) & RESULT_CHAN_MASK);
+        for (size_t l = 0; l < n_lanes; l++) {
+            adc_frame_lane_t *lane = &lanes[l];
+            if (lane->channel != chan) continue;
+            if (lane->samples && lane->count < lane->capacity) {
+                lane->samples[lane->count++] = (int)(w & RESULT_DATA_MASK);
+                stored++;
+            }
+            break;
+        }
+    }
+    return stored;
+}
+
+bool adc_frame_lanes_full(const adc_frame_lane_t *lanes, size_t n_lanes) {
+    if (!lanes) return false;
+    for (size_t l = 0; l < n_lanes; l++) {
+        if (lanes[l].count < lanes[l].capacity) return false;
+    }
+    return true;
+}
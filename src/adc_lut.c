@@ -0,0 +1,55 @@
+#include "adc_lut.h"
+#include "crc32.h"
+#include <stddef.h>
+#include <string.h>
+
+static uint32_t knots_crc(const adc_lut_knots_t *k) {
+    return crc32_update(0, k, offsetof(adc_lut_knots_t, crc));
+}
+
+int adc_lut_knot_code(int i) {
+    int code = i << ADC_LUT_KNOT_SHIFT;
+    return code >= ADC_LUT_CODES ? ADC_LUT_CODES - 1 : code;
+}
+
+bool adc_lut_build_knots(adc_lut_knots_t *k, uint32_t cali_ver, uint32_t atten,
+                         adc_lut_convert_fn convert, void *ctx) {
+    memset(k, 0, sizeof(*k));
+    for (int i = 0; i < ADC_LUT_KNOTS; i++) {
+        int mv = 0;
+        if (!convert(adc_lut_knot_code(i), &mv, ctx)) return false;
+        if (mv < 0) mv = 0;
+        if (mv > UINT16_MAX) mv = UINT16_MAX;
+        k->knot_mv[i] = (uint16_t)mv;
+    }
+    k->magic    = ADC_LUT_MAGIC;
+    k->cali_ver = cali_ver;
+    k->atten    = atten;
+    k->crc      = knots_crc(k);
+    return true;
+}
+
+bool adc_lut_knots_valid(const adc_lut_knots_t *k, uint32_t cali_ver, uint32_t atten) {
+    return k->magic == ADC_LUT_MAGIC &&
+           k->cali_ver == cali_ver &&
+           k->atten == atten &&
+           k->crc == knots_crc(k);
+}
+
+void adc_lut_expand(const adc_lut_knots_t *k, uint16_t *table) {
+    for (int i = 0; i < ADC_LUT_KNOTS - 1; i++) {
+        int c0 = adc_lut_knot_code(i);
+        int c1 = adc_lut_knot_code(i + 1);
+        int m0 = k->knot_mv[i];
+        int m1 = k->knot_mv[i + 1];
+        int span = c1 - c0;
+        for (int c = c0; c < c1; c++) {
+            // Round to nearest; the curve is monotonic so m1 - m0 >= 0 in practice,
+            // but keep the rounding symmetric in case a knot dips.
+            int num = (m1 - m0) * (c - c0);
+            int step = (num >= 0 ? num + span / 2 : num - span / 2) / span;
+            table[c] = (uint16_t)(m0 + step);
+        }
+    }
+    table[ADC_LUT_CODES - 1] = k->knot_mv[ADC_LUT_KNOTS - 1];
+}
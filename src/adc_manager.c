@@ -14,27 +14,40 @@
  * 
  * Usage Pattern:
  * 1. Call adc_manager_init() once at startup
- * 2. Each sensor calls adc_manager_create_cali() to get calibration handle
- * 3. Each sensor calls adc_manager_get_handle() to get ADC unit handle
- * 4. Sensors configure their own channels and perform readings
+ * 2. Each sensor calls adc_manager_get_handle() to get ADC unit handle
+ * 3. Sensors configure their own channels and perform readings
+ * 4. Multi-channel reads go through adc_manager_scan(), which runs one
+ *    continuous-mode (DMA) burst over every channel instead of a oneshot loop
+ * 5. Raw codes convert via adc_manager_raw_to_mv(): a precomputed table per
+ *    attenuation (knots retained in RTC memory across deep sleep), built on
+ *    first use and falling back to the IDF curve-fitting scheme if no valid
+ *    table exists
  * 
  * @note Only supports ADC1 currently
- * @note Maximum 4 calibration handles (one per sensor typically)
+ * @note Maximum MAX_CALI_HANDLES (7) calibration handles, one per ADC1 channel
  * 
  * @author DFRobot Project
  * @date 2025
  */
 
 #include "adc_manager.h"
+#include "adc_lut.h"
 #include "esp_adc/adc_oneshot.h"
 #include "esp_adc/adc_cali.h"
 #include "esp_adc/adc_cali_scheme.h"
+#include "esp_adc/adc_continuous.h"
+#include "esp_attr.h"
+#include "esp_efuse_rtc_calib.h"
 #include "esp_log.h"
+#include "esp_timer.h"
+#include <stdlib.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
 
 static const char *TAG = "ADC_MGR";
 
 #define ADC_UNIT              ADC_UNIT_1      ///< Fixed to ADC1 for all sensors
-#define MAX_CALI_HANDLES      4               ///< Maximum calibration handles (adjust if more sensors needed)
+#define MAX_CALI_HANDLES      7               ///< One per ADC1 channel on the C6 (CH0-CH6)
 
 // Shared ADC unit handle - single instance for all sensors
 static adc_oneshot_unit_handle_t adc_handle = NULL;
@@ -56,6 +69,39 @@ typedef struct {
 // Calibration handles storage array
 static cali_entry_t cali_handles[MAX_CALI_HANDLES] = {0};
 
+#define MAX_LUTS              2               ///< Distinct attenuations with a cached table
+#define RESUME_RAIL_CODE      4000            ///< Raw code at/above which a sample counts as railed
+
+// Armed by adc_manager_resume(); the next adc_manager_scan() validates its
+// burst and rebuilds through s_on_rebuild if a lane came back railed.
+static bool s_resume_pending = false;
+static void (*s_on_rebuild)(void) = NULL;
+
+static adc_manager_resume_stats_t s_resume_stats = {0};
+
+// Knot sets survive deep sleep; only a cold boot or an eFuse calibration
+// version change forces them to be resampled from the IDF scheme.
+RTC_DATA_ATTR static adc_lut_knots_t s_lut_knots[MAX_LUTS];
+
+/**
+ * @brief Expanded raw->mV table for one attenuation.
+ *
+ * Built from s_lut_knots at first use each boot (8 KB heap). Independent of
+ * the oneshot unit, so it survives adc_manager_reinit().
+ */
+typedef struct {
+    adc_atten_t atten;
+    uint16_t *table;             ///< ADC_LUT_CODES entries, NULL = free slot
+} lut_entry_t;
+
+static lut_entry_t s_luts[MAX_LUTS] = {0};
+
+// Continuous-mode scan tuning. 20 kHz keeps a 2-channel x 10-sample burst
+// around 1 ms; the timeout only matters if the DMA engine never completes.
+#define SCAN_SAMPLE_FREQ_HZ   20000
+#define SCAN_TIMEOUT_MS       50
+#define SCAN_FRAME_BYTES      (ADC_MANAGER_SCAN_MAX_LANES * ADC_MANAGER_SCAN_MAX_SAMPLES * ADC_FRAME_RESULT_BYTES)
+
 /**
  * @brief Initialize the shared ADC manager
  * 
@@ -116,6 +162,8 @@ esp_err_t adc_manager_reinit(void) {
     ESP_LOGD(TAG, "Rebuilding ADC unit (post-light-sleep recovery)");
 
     // Drop all calibration schemes so they are recreated against the new unit.
+    // Cached conversion tables are eFuse-derived and stay valid — with them in
+    // place, the sensors' reconfigure calls no longer rebuild any scheme.
     for (int i = 0; i < MAX_CALI_HANDLES; i++) {
         if (cali_handles[i].in_use) {
             adc_cali_delete_scheme_curve_fitting(cali_handles[i].handle);
@@ -134,6 +182,38 @@ esp_err_t adc_manager_reinit(void) {
     return adc_manager_init();
 }
 
+// ============================================================================
+// Fast resume after light sleep
+// ============================================================================
+
+void adc_manager_resume(void (*on_rebuild)(void)) {
+    s_on_rebuild = on_rebuild;
+    s_resume_pending = true;
+}
+
+// When the soil pad state is lost in light sleep every conversion rails to
+// full scale, even with the probe powered. A lane whose samples are all at
+// the rail is that signature; a real reading always has some below it.
+static bool lanes_railed(const adc_frame_lane_t *lanes, size_t n_lanes) {
+    for (size_t l = 0; l < n_lanes; l++) {
+        size_t railed = 0;
+        for (size_t i = 0; i < lanes[l].count; i++) {
+            if (lanes[l].samples[i] >= RESUME_RAIL_CODE) railed++;
+        }
+        if (lanes[l].count && railed == lanes[l].count) {
+            ESP_LOGD(TAG, "Channel %d railed after resume", lanes[l].channel);
+            return true;
+        }
+    }
+    return false;
+}
+
+void adc_manager_get_resume_stats(adc_manager_resume_stats_t *out) {
+    if (out) {
+        *out = s_resume_stats;
+    }
+}
+
 /**
  * @brief Get existing calibration handle for channel/attenuation pair
  * 
@@ -160,6 +240,72 @@ adc_cali_handle_t adc_manager_get_cali_handle(adc_channel_t channel, adc_atten_t
     return NULL;
 }
 
+// ============================================================================
+// Cached conversion tables
+// ============================================================================
+
+static const uint16_t *lut_find(adc_atten_t atten) {
+    for (int i = 0; i < MAX_LUTS; i++) {
+        if (s_luts[i].table && s_luts[i].atten == atten) {
+            return s_luts[i].table;
+        }
+    }
+    return NULL;
+}
+
+// Expand a knot set into a free table slot.
+static const uint16_t *lut_install(const adc_lut_knots_t *knots, adc_atten_t atten) {
+    for (int i = 0; i < MAX_LUTS; i++) {
+        if (s_luts[i].table) continue;
+        uint16_t *table = malloc(ADC_LUT_CODES * sizeof(uint16_t));
+        if (!table) {
+            ESP_LOGW(TAG, "No memory for conversion table — using IDF scheme");
+            return NULL;
+        }
+        adc_lut_expand(knots, table);
+        s_luts[i].atten = atten;
+        s_luts[i].table = table;
+        return table;
+    }
+    return NULL;
+}
+
+// Warm wake: rebuild the table from RTC-retained knots without touching the
+// IDF scheme. Returns NULL if no intact knot set matches.
+static const uint16_t *lut_restore(adc_atten_t atten) {
+    uint32_t ver = esp_efuse_rtc_calib_get_ver();
+    for (int i = 0; i < MAX_LUTS; i++) {
+        if (adc_lut_knots_valid(&s_lut_knots[i], ver, (uint32_t)atten)) {
+            return lut_install(&s_lut_knots[i], atten);
+        }
+    }
+    return NULL;
+}
+
+static bool lut_convert(int raw, int *mv, void *ctx) {
+    return adc_cali_raw_to_voltage((adc_cali_handle_t)ctx, raw, mv) == ESP_OK;
+}
+
+// Cold boot: sample the scheme at every knot, retain the knots, expand.
+static void lut_build(adc_atten_t atten, adc_cali_handle_t handle) {
+    uint32_t ver = esp_efuse_rtc_calib_get_ver();
+    adc_lut_knots_t *slot = NULL;
+    for (int i = 0; i < MAX_LUTS && !slot; i++) {
+        if (!adc_lut_knots_valid(&s_lut_knots[i], ver, s_lut_knots[i].atten) ||
+            s_lut_knots[i].atten == (uint32_t)atten) {
+            slot = &s_lut_knots[i];
+        }
+    }
+    if (!slot) return;
+    if (!adc_lut_build_knots(slot, ver, (uint32_t)atten, lut_convert, handle)) {
+        ESP_LOGW(TAG, "Knot sampling failed for atten %d — using IDF scheme", atten);
+        return;
+    }
+    if (lut_install(slot, atten)) {
+        ESP_LOGI(TAG, "Built raw->mV table for atten %d (cali v%lu)", atten, (unsigned long)ver);
+    }
+}
+
 /**
  * @brief Create or retrieve calibration handle for sensor
  * 
@@ -171,16 +317,18 @@ adc_cali_handle_t adc_manager_get_cali_handle(adc_channel_t channel, adc_atten_t
  * 
  * @param channel ADC channel for the sensor (ADC_CHANNEL_0 to ADC_CHANNEL_4)
  * @param atten Attenuation level (ADC_ATTEN_DB_0, _2_5, _6, or _12)
- * @param[out] cali_handle Pointer to store the calibration handle
+ * @param[out] cali_handle Pointer to store the calibration handle; set to NULL
+ *                         when a cached table already serves this attenuation
  * 
  * @return ESP_OK on success
  * @return ESP_ERR_INVALID_ARG if cali_handle is NULL
  * @return ESP_ERR_NO_MEM if no free calibration slots available
  * @return Error code from ESP-IDF if calibration creation fails
  * 
- * @note Maximum MAX_CALI_HANDLES (4) different calibration handles can exist
+ * @note Maximum MAX_CALI_HANDLES (7) different calibration handles can exist
  * @note Reuses existing handle if channel+attenuation already calibrated
  * @note Call this after configuring ADC channel
+ * @note Convert readings with adc_manager_raw_to_mv(), not the handle directly
  * 
  * Extension: Increase MAX_CALI_HANDLES if more sensors with different configs needed
  */
@@ -190,6 +338,13 @@ esp_err_t adc_manager_create_cali(adc_channel_t channel, adc_atten_t atten, adc_
         return ESP_ERR_INVALID_ARG;
     }
 
+    // A cached table answers every conversion at this attenuation: no scheme
+    // construction at all on a warm wake or after adc_manager_reinit().
+    if (lut_find(atten) || lut_restore(atten)) {
+        *cali_handle = NULL;
+        return ESP_OK;
+    }
+
     // Check if already exists
     adc_cali_handle_t existing = adc_manager_get_cali_handle(channel, atten);
     if (existing) {
@@ -231,6 +386,193 @@ esp_err_t adc_manager_create_cali(adc_channel_t channel, adc_atten_t atten, adc_
     cali_handles[free_slot].in_use = true;
 
     ESP_LOGI(TAG, "Created calibration for channel %d, atten %d", channel, atten);
+
+    lut_build(atten, *cali_handle);
     
     return ESP_OK;
 }
+
+esp_err_t adc_manager_raw_to_mv(adc_channel_t channel, adc_atten_t atten, int raw, int *mv) {
+    if (!mv) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    const uint16_t *table = lut_find(atten);
+    if (table) {
+        *mv = adc_lut_lookup(table, raw);
+        return ESP_OK;
+    }
+
+    // No table (allocation or knot sampling failed): fall back to the scheme.
+    adc_cali_handle_t handle = NULL;
+    esp_err_t err = adc_manager_create_cali(channel, atten, &handle);
+    if (err != ESP_OK) {
+        return err;
+    }
+    table = lut_find(atten);
+    if (table) {
+        *mv = adc_lut_lookup(table, raw);
+        return ESP_OK;
+    }
+    return adc_cali_raw_to_voltage(handle, raw, mv);
+}
+
+// ============================================================================
+// Continuous-mode (DMA) scan
+// ============================================================================
+
+// One frame of interleaved TYPE2 results. Static: the burst is never re-entered
+// (both sensor modules read from a single task) and 512 B is too much for the
+// report task's stack.
+static uint8_t s_scan_frame[SCAN_FRAME_BYTES];
+
+// ISR: the DMA engine has filled a frame — wake the task blocked in the scan.
+static bool IRAM_ATTR scan_conv_done_cb(adc_continuous_handle_t handle,
+                                        const adc_continuous_evt_data_t *edata,
+                                        void *user_data) {
+    (void)handle; (void)edata;
+    BaseType_t hp_woken = pdFALSE;
+    vTaskNotifyGiveFromISR((TaskHandle_t)user_data, &hp_woken);
+    return hp_woken == pdTRUE;
+}
+
+// Oneshot fallback: the same lanes, filled one conversion at a time.
+static esp_err_t scan_oneshot(adc_frame_lane_t *lanes, size_t n_lanes) {
+    for (size_t l = 0; l < n_lanes; l++) {
+        lanes[l].count = 0;
+        for (size_t i = 0; i < lanes[l].capacity; i++) {
+            int raw = 0;
+            if (adc_oneshot_read(adc_handle, (adc_channel_t)lanes[l].channel, &raw) == ESP_OK) {
+                lanes[l].samples[lanes[l].count++] = raw;
+            }
+        }
+    }
+    return ESP_OK;
+}
+
+static esp_err_t scan_continuous(adc_frame_lane_t *lanes, size_t n_lanes, adc_atten_t atten) {
+    size_t per_lane = 0;
+    for (size_t l = 0; l < n_lanes; l++) {
+        if (lanes[l].capacity > per_lane) per_lane = lanes[l].capacity;
+    }
+    uint32_t frame_bytes = (uint32_t)(per_lane * n_lanes * ADC_FRAME_RESULT_BYTES);
+
+    adc_continuous_handle_t handle = NULL;
+    adc_continuous_handle_cfg_t handle_cfg = {
+        .max_store_buf_size = frame_bytes * 2,
+        .conv_frame_size    = frame_bytes,
+    };
+    esp_err_t err = adc_continuous_new_handle(&handle_cfg, &handle);
+    if (err != ESP_OK) {
+        return err;
+    }
+
+    adc_digi_pattern_config_t pattern[ADC_MANAGER_SCAN_MAX_LANES] = {0};
+    for (size_t l = 0; l < n_lanes; l++) {
+        pattern[l].atten     = atten;
+        pattern[l].channel   = lanes[l].channel;
+        pattern[l].unit      = ADC_UNIT;
+        pattern[l].bit_width = SOC_ADC_DIGI_MAX_BITWIDTH;
+    }
+    adc_continuous_config_t dig_cfg = {
+        .pattern_num    = n_lanes,
+        .adc_pattern    = pattern,
+        .sample_freq_hz = SCAN_SAMPLE_FREQ_HZ,
+        .conv_mode      = ADC_CONV_SINGLE_UNIT_1,
+        .format         = ADC_DIGI_OUTPUT_FORMAT_TYPE2,
+    };
+    adc_continuous_evt_cbs_t cbs = { .on_conv_done = scan_conv_done_cb };
+
+    err = adc_continuous_config(handle, &dig_cfg);
+    if (err == ESP_OK) {
+        err = adc_continuous_register_event_callbacks(handle, &cbs, xTaskGetCurrentTaskHandle());
+    }
+    if (err == ESP_OK) {
+        ulTaskNotifyTake(pdTRUE, 0);   // drop any stale notification
+        err = adc_continuous_start(handle);
+    }
+    if (err == ESP_OK) {
+        // Block until the frame is complete — the CPU idles instead of polling.
+        if (ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(SCAN_TIMEOUT_MS)) == 0) {
+            err = ESP_ERR_TIMEOUT;
+        } else {
+            uint32_t got = 0;
+            err = adc_continuous_read(handle, s_scan_frame, frame_bytes, &got, 0);
+            if (err == ESP_OK) {
+                adc_frame_deinterleave(s_scan_frame, got, lanes, n_lanes);
+            }
+        }
+        adc_continuous_stop(handle);
+    }
+    adc_continuous_deinit(handle);
+    return err;
+}
+
+static esp_err_t scan_once(adc_frame_lane_t *lanes, size_t n_lanes, adc_atten_t atten) {
+    if (!lanes || n_lanes == 0 || n_lanes > ADC_MANAGER_SCAN_MAX_LANES) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    for (size_t l = 0; l < n_lanes; l++) {
+        if (!lanes[l].samples || lanes[l].capacity == 0 ||
+            lanes[l].capacity > ADC_MANAGER_SCAN_MAX_SAMPLES) {
+            return ESP_ERR_INVALID_ARG;
+        }
+    }
+    if (!adc_handle) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    esp_err_t err = scan_continuous(lanes, n_lanes, atten);
+    bool starved = false;
+    for (size_t l = 0; l < n_lanes; l++) {
+        if (lanes[l].count == 0) starved = true;
+    }
+    if (err != ESP_OK || starved) {
+        ESP_LOGW(TAG, "DMA scan failed (%s) — falling back to oneshot reads",
+                 err != ESP_OK ? esp_err_to_name(err) : "empty lane");
+        scan_oneshot(lanes, n_lanes);
+    }
+
+    for (size_t l = 0; l < n_lanes; l++) {
+        if (lanes[l].count == 0) {
+            return ESP_FAIL;
+        }
+    }
+    return ESP_OK;
+}
+
+esp_err_t adc_manager_scan(adc_frame_lane_t *lanes, size_t n_lanes, adc_atten_t atten) {
+    // Timed from before the validating burst, so the fast figure is
+    // "scan + check" and the rebuild figure "scan + check + reinit + rescan".
+    int64_t t0 = esp_timer_get_time();
+    esp_err_t err = scan_once(lanes, n_lanes, atten);
+    if (!s_resume_pending || err == ESP_ERR_INVALID_ARG) {
+        return err;
+    }
+
+    // First burst since adc_manager_resume(): the caller's sensors are
+    // powered right now, so this is the only read that can tell a lost pad
+    // state from a probe that is merely resting at the rail while unpowered.
+    s_resume_pending = false;
+    if (err == ESP_OK && !lanes_railed(lanes, n_lanes)) {
+        uint32_t us = (uint32_t)(esp_timer_get_time() - t0);
+        s_resume_stats.fast_count++;
+        s_resume_stats.last_fast_us = us;
+        s_resume_stats.total_fast_us += us;
+        s_resume_stats.last_rebuilt = false;
+        return err;
+    }
+
+    err = adc_manager_reinit();
+    if (err == ESP_OK) {
+        if (s_on_rebuild) s_on_rebuild();
+        err = scan_once(lanes, n_lanes, atten);
+    } else {
+        ESP_LOGE(TAG, "ADC rebuild failed: %s", esp_err_to_name(err));
+    }
+    uint32_t us = (uint32_t)(esp_timer_get_time() - t0);
+    s_resume_stats.rebuild_count++;
+    s_resume_stats.last_rebuild_us = us;
+    s_resume_stats.total_rebuild_us += us;
+    s_resume_stats.last_rebuilt = true;
+    return err;
+}
@@ -0,0 +1,19 @@
+#include "adc_oversample.h"
+
+int32_t adc_oversample_decimate(const int *codes, size_t n, unsigned bits) {
+    if (!codes || n == 0) return -1;
+    int64_t sum = 0;
+    for (size_t i = 0; i < n; i++) sum += codes[i];
+    int64_t scaled = sum << bits;
+    return (int32_t)((scaled + (int64_t)(n / 2)) / (int64_t)n);
+}
+
+int32_t adc_oversample_interp_mv(int mv_lo, int mv_hi, uint32_t code_frac,
+                                 unsigned code_bits, unsigned mv_frac_bits) {
+    // mv_fx = (mv_lo + (mv_hi - mv_lo) * frac / 2^code_bits) * 2^mv_frac_bits
+    int64_t base = (int64_t)mv_lo << mv_frac_bits;
+    int64_t num  = (int64_t)(mv_hi - mv_lo) * (int64_t)code_frac << mv_frac_bits;
+    int64_t half = code_bits ? ((int64_t)1 << (code_bits - 1)) : 0;
+    int64_t step = num >= 0 ? (num + half) >> code_bits : -((-num + half) >> code_bits);
+    return (int32_t)(base + step);
+}
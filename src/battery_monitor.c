@@ -2,6 +2,7 @@
 #include "battery_soc.h"
 #include <math.h>
 #include <stddef.h>
+#include <stdint.h>
 
 // ============================================================================
 // Pure helpers (host-testable)
@@ -46,14 +47,54 @@ float battery_monitor_v_to_pct(float volts) {
     return 0.0f;  // unreachable given the clamps above
 }
 
+// Same curve in integer mV / 0.01 % for the fixed-point report path. Kept
+// point-for-point with SOC_LUT; test_telemetry_fx checks the two agree.
+typedef struct { uint16_t mv; uint16_t pct_x100; } soc_point_fx_t;
+
+static const soc_point_fx_t SOC_LUT_FX[] = {
+    {4200, 10000},
+    {4050,  9000},
+    {3960,  8000},
+    {3900,  7000},
+    {3850,  6000},
+    {3800,  5000},
+    {3760,  4000},
+    {3730,  3000},
+    {3700,  2000},
+    {3650,  1000},
+    {3200,     0},
+};
+#define SOC_LUT_FX_N (sizeof(SOC_LUT_FX) / sizeof(SOC_LUT_FX[0]))
+
+uint16_t battery_monitor_mv_to_pct_x100(int mv) {
+    if (mv >= SOC_LUT_FX[0].mv) return SOC_LUT_FX[0].pct_x100;
+    if (mv <= SOC_LUT_FX[SOC_LUT_FX_N - 1].mv) return SOC_LUT_FX[SOC_LUT_FX_N - 1].pct_x100;
+    // Binary search for the segment with SOC_LUT_FX[hi].mv <= mv < SOC_LUT_FX[lo].mv
+    // (table is descending in voltage).
+    size_t lo = 0;
+    size_t hi = SOC_LUT_FX_N - 1;
+    while (hi - lo > 1) {
+        size_t mid = (lo + hi) / 2;
+        if (mv >= SOC_LUT_FX[mid].mv) {
+            hi = mid;
+        } else {
+            lo = mid;
+        }
+    }
+    uint32_t span = (uint32_t)(SOC_LUT_FX[lo].mv - SOC_LUT_FX[hi].mv);
+    uint32_t num  = (uint32_t)(mv - SOC_LUT_FX[hi].mv) *
+                    (uint32_t)(SOC_LUT_FX[lo].pct_x100 - SOC_LUT_FX[hi].pct_x100);
+    return (uint16_t)(SOC_LUT_FX[hi].pct_x100 + (num + span / 2) / span);
+}
+
 bool battery_monitor_is_safe(float volts) {
     return volts >= BATTERY_LOW_CUTOFF_V;
 }
 
 #ifndef TEST_HOST
 #include "adc_manager.h"
+#include "sample_reduce.h"
 #include "esp_adc/adc_oneshot.h"
-#include "esp_adc/adc_cali.h"
 #include "esp_log.h"
 #endif
 
@@ -64,10 +105,9 @@ static const char *TAG = "BATTERY";
 // FireBeetle 2 C6 Battery is on GPIO 0 -> ADC1 Channel 0
 #define BAT_ADC_CHAN          ADC_CHANNEL_0 
 #define ADC_ATTEN             ADC_ATTEN_DB_12
-#define VOLTAGE_DIVIDER       2.0f    // Hardware divider (1M + 1M ohm resistors)
-#define SAMPLE_COUNT          10      // Number of samples to average
+#define VOLTAGE_DIVIDER       2       // Hardware divider (1M + 1M ohm resistors)
+#define SAMPLE_COUNT          8       // Samples per read, reduced with outlier rejection
 
-static adc_cali_handle_t cali_handle = NULL;
 static bool initialized = false;
 
 esp_err_t battery_monitor_init(void) {
@@ -97,13 +137,6 @@ esp_err_t battery_monitor_init(void) {
         return err;
     }
 
-    // Get or create calibration handle
-    err = adc_manager_create_cali(BAT_ADC_CHAN, ADC_ATTEN, &cali_handle);
-    if (err != ESP_OK) {
-        ESP_LOGE(TAG, "Failed to create calibration: %s", esp_err_to_name(err));
-        return err;
-    }
-
     initialized = true;
     ESP_LOGI(TAG, "Battery monitor initialized on ADC1 Channel %d", BAT_ADC_CHAN);
     
@@ -120,61 +153,69 @@ esp_err_t battery_monitor_reconfigure(void) {
     esp_err_t err = adc_oneshot_config_channel(adc_handle, BAT_ADC_CHAN, &config);
     if (err != ESP_OK) {
         ESP_LOGE(TAG, "reconfigure: channel config failed: %s", esp_err_to_name(err));
-        return err;
     }
-    return adc_manager_create_cali(BAT_ADC_CHAN, ADC_ATTEN, &cali_handle);
+    return err;
 }
 
-float battery_monitor_read_voltage(void) {
+void battery_monitor_scan_lane(adc_frame_lane_t *lane, int *buf, size_t capacity) {
+    lane->channel  = BAT_ADC_CHAN;
+    lane->samples  = buf;
+    lane->capacity = capacity;
+    lane->count    = 0;
+}
+
+int battery_monitor_mv_from_lane(adc_frame_lane_t *lane) {
     if (!initialized) {
         ESP_LOGE(TAG, "Battery monitor not initialized");
-        return 0.0f;
-    }
-
-    // Get shared ADC handle
-    adc_oneshot_unit_handle_t adc_handle = adc_manager_get_handle();
-    if (!adc_handle) {
-        ESP_LOGE(TAG, "ADC handle not available");
-        return 0.0f;
+        return 0;
     }
 
-    // Take multiple samples and average
-    uint32_t value_sum = 0;
-    int valid_samples = 0;
-    
-    for (int i = 0; i < SAMPLE_COUNT; i++) {
-        int raw_value = 0;
-        esp_err_t err = adc_oneshot_read(adc_handle, BAT_ADC_CHAN, &raw_value);
-        if (err == ESP_OK) {
-            value_sum += raw_value;
-            valid_samples++;
-        } else {
-            ESP_LOGW(TAG, "ADC read failed on sample %d: %s", i, esp_err_to_name(err));
-        }
-    }
-
-    if (valid_samples == 0) {
+    int avg_raw = sample_reduce(lane->samples, lane->count);
+    if (avg_raw < 0) {
         ESP_LOGE(TAG, "All ADC reads failed");
-        return 0.0f;
+        return 0;
     }
 
-    int avg_raw = value_sum / valid_samples;
-
     // Convert to voltage
     int voltage_mV = 0;
-    esp_err_t err = adc_cali_raw_to_voltage(cali_handle, avg_raw, &voltage_mV);
+    esp_err_t err = adc_manager_raw_to_mv(BAT_ADC_CHAN, ADC_ATTEN, avg_raw, &voltage_mV);
     if (err != ESP_OK) {
         ESP_LOGE(TAG, "Failed to convert ADC value to voltage: %s", esp_err_to_name(err));
-        return 0.0f;
+        return 0;
     }
 
     // Apply voltage divider factor
-    float battery_voltage = (float)voltage_mV * VOLTAGE_DIVIDER / 1000.0f;
+    int cell_mv = voltage_mV * VOLTAGE_DIVIDER;
+
+    ESP_LOGI(TAG, "Raw ADC: %d, Pin voltage: %d mV, Battery: %d mV",
+             avg_raw, voltage_mV, cell_mv);
 
-    ESP_LOGI(TAG, "Raw ADC: %d, Pin voltage: %d mV, Battery: %.3f V", 
-             avg_raw, voltage_mV, battery_voltage);
+    return cell_mv;
+}
+
+float battery_monitor_voltage_from_lane(adc_frame_lane_t *lane) {
+    return (float)battery_monitor_mv_from_lane(lane) / 1000.0f;
+}
 
-    return battery_voltage;
+int battery_monitor_read_mv(void) {
+    if (!initialized) {
+        ESP_LOGE(TAG, "Battery monitor not initialized");
+        return 0;
+    }
+
+    // Take multiple samples in one DMA burst and reduce them
+    int codes[SAMPLE_COUNT];
+    adc_frame_lane_t lane;
+    battery_monitor_scan_lane(&lane, codes, SAMPLE_COUNT);
+    esp_err_t err = adc_manager_scan(&lane, 1, ADC_ATTEN);
+    if (err != ESP_OK) {
+        ESP_LOGW(TAG, "ADC scan failed: %s", esp_err_to_name(err));
+    }
+    return battery_monitor_mv_from_lane(&lane);
+}
+
+float battery_monitor_read_voltage(void) {
+    return (float)battery_monitor_read_mv() / 1000.0f;
 }
 
 esp_err_t battery_monitor_deinit(void) {
@@ -184,7 +225,6 @@ esp_err_t battery_monitor_deinit(void) {
 
     ESP_LOGI(TAG, "Deinitializing battery monitor");
 
-    cali_handle = NULL;
     initialized = false;
     ESP_LOGI(TAG, "Battery monitor deinitialized");
 
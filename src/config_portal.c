@@ -11,6 +11,8 @@
 #include <stdlib.h>
 #include "soil_calibration.h"
 #include "soil_moisture.h"
+#include "soil_probe.h"
+#include "sample_reduce.h"
 #include <stdio.h>
 #include "esp_timer.h"
 
@@ -18,8 +20,8 @@ static const char *TAG = "CONFIG_PORTAL";
 static httpd_handle_t s_server = NULL;
 static esp_netif_t *s_ap_netif = NULL;
 static int  s_idle_ticks = 0;
-static int  s_pending_dry_mv = -1;
-static int  s_pending_wet_mv = -1;
+static int  s_pending_dry_mv[SOIL_PROBE_COUNT];   ///< 0 = not captured yet
+static int  s_pending_wet_mv[SOIL_PROBE_COUNT];
 
 // Minimal HTML escape for single-quoted attribute values (handles &, ', <, >).
 // out_len should be >= 6x input length + 1 for worst-case all-escape input.
@@ -41,6 +43,7 @@ static void html_escape_attr(const char *in, char *out, size_t out_len) {
 #define PROV_AP_SSID         "FireBeetle_C6_Prov"
 #define PORTAL_TIMEOUT_SEC   600
 #define IDLE_TICK_MS         1000
+#define CAPTURE_READS        5      ///< Independent probe reads per calibration capture
 
 #ifdef USE_ZIGBEE
 static const char *html_menu =
@@ -106,6 +109,7 @@ static const char *html_calibrate =
     ".captured{padding:8px;background:#dfd;border-radius:4px;text-align:center}"
     "a{display:block;text-align:center;margin-top:14px}</style></head>"
     "<body><div class='c'><h2>Calibrate Sensor</h2>"
+    "<select id='p' onchange='pick()' style='display:none;width:100%;padding:8px'></select>"
     "<div class='live' id='live'>… mV</div>"
     "<p>1. Hold sensor in <b>open air</b>, then:</p>"
     "<button onclick='cap(\"dry\")'>Capture DRY</button>"
@@ -116,13 +120,20 @@ static const char *html_calibrate =
     "<button onclick='save()'>Save &amp; Restart</button>"
     "<a href='/'>Back</a></div>"
     "<script>"
-    "async function poll(){try{let r=await fetch('/api/reading');let j=await r.json();"
+    "let p=0;"
+    "function q(){return '?p='+p;}"
+    "function pick(){p=+document.getElementById('p').value;"
+    "for(const k of['dry','wet'])document.getElementById(k).textContent='not captured';poll();}"
+    "async function poll(){try{let r=await fetch('/api/reading'+q());let j=await r.json();"
+    "let s=document.getElementById('p');"
+    "if(j.probes>1&&!s.options.length){for(let i=0;i<j.probes;i++)s.add(new Option('Probe '+(i+1),i));"
+    "s.style.display='block';}"
     "document.getElementById('live').textContent=j.raw_mv+' mV ('+j.percentage.toFixed(1)+'%)';}catch(e){}}"
     "setInterval(poll,1000);poll();"
-    "async function cap(k){let r=await fetch('/api/calibrate/'+k,{method:'POST'});"
+    "async function cap(k){let r=await fetch('/api/calibrate/'+k+q(),{method:'POST'});"
     "if(!r.ok){document.getElementById(k).textContent='read failed — check wiring';return;}"
     "let j=await r.json();document.getElementById(k).textContent='captured: '+j.mv+' mV';}"
-    "async function save(){let r=await fetch('/api/calibrate/save',{method:'POST'});"
+    "async function save(){let r=await fetch('/api/calibrate/save'+q(),{method:'POST'});"
     "if(!r.ok){alert('Capture both DRY and WET first.');return;}"
     "let j=await r.json();"
     "document.body.innerHTML=j.restart?'<h1>Saved. Restarting\xE2\x80\xA6</h1>':'<h1>Saved.</h1>';"
@@ -158,6 +169,7 @@ static esp_err_t wifi_get(httpd_req_t *req) {
     char device_id[33] = {0};
     bool has_creds      = wifi_credentials_load(ssid, sizeof(ssid), password, sizeof(password));
     bool has_device_id  = wifi_credentials_load_device_id(device_id, sizeof(device_id));
+    bool cbor           = wifi_credentials_load_telemetry_format() == TELEMETRY_FMT_CBOR;
 
     char ssid_esc[33 * 6];
     char device_id_esc[33 * 6];
@@ -169,7 +181,7 @@ static esp_err_t wifi_get(httpd_req_t *req) {
 
     // Heap-allocate body — httpd task stack is ~4 KB, and a 1.5 KB buffer
     // here plus the escape buffers above blew it (observed stack overflow).
-    const size_t body_len = 1536;
+    const size_t body_len = 1792;
     char *body = malloc(body_len);
     if (!body) { httpd_resp_send_500(req); return ESP_FAIL; }
     snprintf(body, body_len,
@@ -177,7 +189,7 @@ static esp_err_t wifi_get(httpd_req_t *req) {
         "<meta name='viewport' content='width=device-width,initial-scale=1'>"
         "<style>body{font-family:Arial;margin:40px;background:#f0f0f0}"
         ".container{background:white;padding:30px;border-radius:10px;max-width:400px;margin:auto}"
-        "input{width:100%%;padding:10px;margin:10px 0;box-sizing:border-box}"
+        "input,select{width:100%%;padding:10px;margin:10px 0;box-sizing:border-box}"
         "button{background:#4CAF50;color:white;padding:14px;border:none;width:100%%;cursor:pointer;font-size:16px}"
         "a{display:block;text-align:center;margin-top:14px}</style></head>"
         "<body><div class='container'><h2>WiFi &amp; Device ID</h2>"
@@ -185,9 +197,12 @@ static esp_err_t wifi_get(httpd_req_t *req) {
         "<label>SSID:</label><input type='text' name='ssid' value='%s' required>"
         "<label>Password:</label><input type='password' name='password' placeholder='%s'%s>"
         "<label>Device ID:</label><input type='text' name='device_id' value='%s' placeholder='moisture01' required>"
+        "<label>Payload format:</label><select name='format'>"
+        "<option value='json'%s>JSON</option><option value='cbor'%s>CBOR (topic /cbor)</option></select>"
         "<button type='submit'>Save &amp; Restart</button></form>"
         "<a href='/'>Back</a></div></body></html>",
-        ssid_esc, pw_placeholder, pw_required, device_id_esc);
+        ssid_esc, pw_placeholder, pw_required, device_id_esc,
+        cbor ? "" : " selected", cbor ? " selected" : "");
 
     httpd_resp_set_type(req, "text/html; charset=utf-8");
     esp_err_t err = httpd_resp_send(req, body, HTTPD_RESP_USE_STRLEN);
@@ -216,6 +231,10 @@ static esp_err_t wifi_post(httpd_req_t *req) {
         {"device_id", device_id, sizeof(device_id)},
     };
     bool ok = form_parser_extract(buf, fields, 3);
+    // Optional: forms cached from older firmware don't send it.
+    char format[8] = {0};
+    form_field_t format_field = {"format", format, sizeof(format)};
+    bool has_format = form_parser_extract(buf, &format_field, 1);
     free(buf);
     if (!ok) { httpd_resp_send_500(req); return ESP_FAIL; }
 
@@ -231,6 +250,8 @@ static esp_err_t wifi_post(httpd_req_t *req) {
 
     if (wifi_credentials_save(ssid, password_to_save) != ESP_OK) { httpd_resp_send_500(req); return ESP_FAIL; }
     if (wifi_credentials_save_device_id(device_id) != ESP_OK) { httpd_resp_send_500(req); return ESP_FAIL; }
+    telemetry_fmt_t fmt = strcmp(format, "cbor") == 0 ? TELEMETRY_FMT_CBOR : TELEMETRY_FMT_JSON;
+    if (has_format && wifi_credentials_save_telemetry_format(fmt) != ESP_OK) { httpd_resp_send_500(req); return ESP_FAIL; }
 
     // First-boot flow: if no calibration has been captured yet, don't restart
     // — send the user to /calibrate first. api_calibrate_save will restart
@@ -338,25 +359,57 @@ static esp_err_t calibrate_get(httpd_req_t *req) {
     return httpd_resp_send(req, html_calibrate, HTTPD_RESP_USE_STRLEN);
 }
 
+// Probe index from the "?p=N" query of the calibration API. Missing or
+// unparsable means probe 0 (the single-probe page never sends one).
+static bool req_probe(httpd_req_t *req, size_t *probe) {
+    char query[16], val[4];
+    *probe = 0;
+    if (httpd_req_get_url_query_str(req, query, sizeof(query)) != ESP_OK ||
+        httpd_query_key_value(query, "p", val, sizeof(val)) != ESP_OK) {
+        return true;
+    }
+    char *end;
+    long p = strtol(val, &end, 10);
+    if (end == val || *end || p < 0 || p >= SOIL_PROBE_COUNT) {
+        httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "bad probe");
+        return false;
+    }
+    *probe = (size_t)p;
+    return true;
+}
+
 static esp_err_t api_reading_get(httpd_req_t *req) {
     s_idle_ticks = 0;
-    int raw = soil_moisture_read_raw_mv();
-    uint32_t dry = soil_calibration_get_dry_mv();
-    uint32_t wet = soil_calibration_get_wet_mv();
+    size_t probe;
+    if (!req_probe(req, &probe)) return ESP_FAIL;
+    int raw = soil_moisture_read_probe_raw_mv(probe);
+    uint32_t dry = soil_calibration_get_probe_dry_mv(probe);
+    uint32_t wet = soil_calibration_get_probe_wet_mv(probe);
     float pct = soil_moisture_calc_percentage(raw, (int)dry, (int)wet);
 
     char body[160];
     snprintf(body, sizeof(body),
-        "{\"raw_mv\":%d,\"percentage\":%.1f,\"dry_mv\":%u,\"wet_mv\":%u}",
-        raw, pct, (unsigned)dry, (unsigned)wet);
+        "{\"raw_mv\":%d,\"percentage\":%.1f,\"dry_mv\":%u,\"wet_mv\":%u,\"probes\":%d}",
+        raw, pct, (unsigned)dry, (unsigned)wet, SOIL_PROBE_COUNT);
     httpd_resp_set_type(req, "application/json");
     return httpd_resp_send(req, body, HTTPD_RESP_USE_STRLEN);
 }
 
-static esp_err_t api_capture(httpd_req_t *req, int *target) {
+static esp_err_t api_capture(httpd_req_t *req, int *pending) {
     s_idle_ticks = 0;
-    int mv = soil_moisture_read_raw_mv();
-    // 0 mV from soil_moisture_read_raw_mv signals a hard failure
+    size_t probe;
+    if (!req_probe(req, &probe)) return ESP_FAIL;
+    // A calibration point is persisted for the life of the probe, so take
+    // several independent powered reads and keep their median — one bad
+    // read (probe bumped, glitch) can't end up baked into NVS.
+    int reads[CAPTURE_READS];
+    size_t n = 0;
+    for (int i = 0; i < CAPTURE_READS; i++) {
+        int r = soil_moisture_read_probe_raw_mv(probe);
+        if (r > 0) reads[n++] = r;
+    }
+    int mv = n ? sample_reduce_median(reads, n) : 0;
+    // 0 mV from soil_moisture_read_probe_raw_mv signals a hard failure
     // (sensor not initialised or all ADC reads failed). Don't persist that
     // as a real capture — return an error so the UI can prompt the user
     // to check wiring instead of silently saving garbage calibration.
@@ -365,7 +418,7 @@ static esp_err_t api_capture(httpd_req_t *req, int *target) {
                             "sensor read failed (check wiring)");
         return ESP_FAIL;
     }
-    *target = mv;
+    pending[probe] = mv;
     char body[40];
     snprintf(body, sizeof(body), "{\"mv\":%d}", mv);
     httpd_resp_set_type(req, "application/json");
@@ -373,28 +426,32 @@ static esp_err_t api_capture(httpd_req_t *req, int *target) {
 }
 
 static esp_err_t api_calibrate_dry(httpd_req_t *req) {
-    return api_capture(req, &s_pending_dry_mv);
+    return api_capture(req, s_pending_dry_mv);
 }
 static esp_err_t api_calibrate_wet(httpd_req_t *req) {
-    return api_capture(req, &s_pending_wet_mv);
+    return api_capture(req, s_pending_wet_mv);
 }
 
 static esp_err_t api_calibrate_save(httpd_req_t *req) {
     s_idle_ticks = 0;
-    if (s_pending_dry_mv < 0 || s_pending_wet_mv < 0) {
+    size_t probe;
+    if (!req_probe(req, &probe)) return ESP_FAIL;
+    if (s_pending_dry_mv[probe] <= 0 || s_pending_wet_mv[probe] <= 0) {
         httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "capture dry and wet first");
         return ESP_FAIL;
     }
     // First-boot detection: if no prior calibration, restart after this save
     // so the device joins WiFi and starts publishing telemetry. On re-cal
-    // trips we stay in the portal so the user can keep using it.
-    bool was_first_cal = (soil_calibration_get_cal_ts() == 0);
+    // trips we stay in the portal so the user can keep using it. Only probe
+    // 0 gates first boot (see wifi_post), so the other probes can be
+    // calibrated afterwards without bouncing the device.
+    bool was_first_cal = (probe == 0 && soil_calibration_get_cal_ts() == 0);
     // esp_timer_get_time() / 1e6 is always > 0 after init; clamp to 1 so
     // cal_ts can never collide with the "never calibrated" sentinel.
     uint32_t ts = (uint32_t)(esp_timer_get_time() / 1000000);
     if (ts == 0) ts = 1;
-    bool ok = soil_calibration_save(
-        (uint32_t)s_pending_dry_mv, (uint32_t)s_pending_wet_mv, ts);
+    bool ok = soil_calibration_save_probe(probe,
+        (uint32_t)s_pending_dry_mv[probe], (uint32_t)s_pending_wet_mv[probe], ts);
     if (!ok) { httpd_resp_send_500(req); return ESP_FAIL; }
 
     httpd_resp_set_type(req, "application/json");
@@ -450,7 +507,7 @@ static esp_err_t factory_reset_get(httpd_req_t *req) {
 static esp_err_t factory_reset_post(httpd_req_t *req) {
     s_idle_ticks = 0;
     wifi_credentials_clear();
-    soil_calibration_clear();
+    for (size_t p = 0; p < SOIL_PROBE_COUNT; p++) soil_calibration_clear_probe(p);
     httpd_resp_set_type(req, "text/html; charset=utf-8");
     httpd_resp_send(req,
         "<html><body><h1>Wiped. Restarting…</h1></body></html>",
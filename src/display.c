@@ -1,6 +1,7 @@
 /**
  * @file display.c
- * @brief Waveshare 2.13" e-paper (SSD1680) — driver + layout.
+ * @brief Waveshare 2.13" e-paper (SSD1680) — panel driver. Layouts are
+ *        composed by display_render.c.
  *
  * Pinout (matches the spec):
  *   MOSI  GPIO22   CS    GPIO1
@@ -15,11 +16,15 @@
 
 #ifndef TEST_HOST
 #include "display.h"
-#include "display_assets.h"
+#include "display_fb.h"
+#include "display_render.h"
+#include "esp_attr.h"
 #include "driver/spi_master.h"
 #include "driver/gpio.h"
 #include "esp_log.h"
+#include "esp_sleep.h"
 #include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
 #include "freertos/task.h"
 #include <string.h>
 #endif
@@ -36,6 +41,10 @@ int display_battery_v_to_pct(float v) {
     return i;
 }
 
+int display_battery_mv_to_pct(int mv) {
+    return (battery_monitor_mv_to_pct_x100(mv) + 50) / 100;
+}
+
 #ifndef TEST_HOST
 
 // ============================================================================
@@ -51,10 +60,9 @@ static const char *TAG = "DISPLAY";
 #define PIN_RST     14
 #define PIN_BUSY     8
 
-#define DISPLAY_W    122
-#define DISPLAY_H_PX 250
-#define DISPLAY_BPR  ((DISPLAY_W + 7) / 8)        // 16
-#define FB_SIZE      (DISPLAY_BPR * DISPLAY_H_PX) // 4000
+#define FB_SIZE      DISPLAY_FB_SIZE              // 4000, geometry in display_fb.h
+
+#define BUSY_TIMEOUT_MS  5000   // full refresh takes ~3 s; longer means a dead panel
 
 // SSD1680 command opcodes (only the ones we use)
 #define CMD_DRIVER_OUTPUT_CTRL    0x01
@@ -66,6 +74,7 @@ static const char *TAG = "DISPLAY";
 #define CMD_DISPLAY_UPDATE_CTRL_1 0x21
 #define CMD_DISPLAY_UPDATE_CTRL_2 0x22
 #define CMD_WRITE_RAM_BW          0x24
+#define CMD_WRITE_RAM_RED         0x26    // previous frame, for mode-2 (partial) updates
 #define CMD_BORDER_WAVEFORM       0x3C
 #define CMD_SET_RAM_X_RANGE       0x44
 #define CMD_SET_RAM_Y_RANGE       0x45
@@ -75,21 +84,83 @@ static const char *TAG = "DISPLAY";
 static spi_device_handle_t s_spi = NULL;
 static uint8_t s_fb[FB_SIZE];
 
+// The frame on the glass, kept across deep sleep (the panel's own RAM holds
+// it too, in deep sleep mode 1) so the next update can be a partial one.
+RTC_DATA_ATTR static uint8_t s_shown_fb[FB_SIZE];
+RTC_DATA_ATTR static display_shown_t s_shown;
+
+// Outcome of the reset probe, so it runs once per power-up rather than on
+// every wake. Zero (as RTC data starts after power-on, and after a BUSY
+// timeout) or any value other than the two markers means "not probed".
+#define PANEL_PRESENT  0x5Au
+#define PANEL_ABSENT   0xA5u
+RTC_DATA_ATTR static uint8_t s_panel;
+
+// Given by busy_isr when BUSY falls; NULL = fall back to polling.
+static SemaphoreHandle_t s_busy_sem = NULL;
+
 // ============================================================================
 // Low-level: SPI + DC/CS/RST/BUSY
 // ============================================================================
 
-static void wait_busy(void) {
-    // BUSY is HIGH while panel is mid-operation. Poll every 10 ms, with a
-    // generous 5-second ceiling (full refresh takes ~3 s).
-    int waited = 0;
-    while (gpio_get_level(PIN_BUSY) == 1 && waited < 500) {
-        vTaskDelay(pdMS_TO_TICKS(10));
-        waited++;
+static void IRAM_ATTR busy_isr(void *arg)
+{
+    (void)arg;
+    gpio_intr_disable(PIN_BUSY);   // level int: one give per wait
+    BaseType_t hp_woken = pdFALSE;
+    xSemaphoreGiveFromISR(s_busy_sem, &hp_woken);
+    portYIELD_FROM_ISR(hp_woken);
+}
+
+// Level interrupt (light sleep can only wake on a GPIO level) on BUSY going
+// LOW, so the caller blocks on a semaphore and the CPU can light-sleep
+// through a refresh instead of polling it.
+static void busy_irq_setup(void) {
+    if (s_busy_sem) return;
+    s_busy_sem = xSemaphoreCreateBinary();
+    if (s_busy_sem == NULL) {
+        ESP_LOGW(TAG, "BUSY sem alloc failed - polling BUSY");
+        return;
     }
-    if (waited >= 500) {
-        ESP_LOGW(TAG, "BUSY timeout after 5 s");
+    esp_err_t err = gpio_install_isr_service(0);
+    if (err != ESP_OK && err != ESP_ERR_INVALID_STATE) {
+        // INVALID_STATE just means the service was already installed elsewhere.
+        ESP_LOGW(TAG, "gpio isr service install: %s - polling BUSY", esp_err_to_name(err));
+        vSemaphoreDelete(s_busy_sem);
+        s_busy_sem = NULL;
+        return;
     }
+    gpio_set_intr_type(PIN_BUSY, GPIO_INTR_LOW_LEVEL);
+    gpio_intr_disable(PIN_BUSY);
+    gpio_isr_handler_add(PIN_BUSY, busy_isr, NULL);
+    esp_sleep_enable_gpio_wakeup();
+}
+
+// BUSY is HIGH while the panel is mid-operation. Returns false (and forgets
+// the panel, so the next wake probes it again) after BUSY_TIMEOUT_MS.
+static bool wait_busy(void) {
+    if (gpio_get_level(PIN_BUSY) == 0) return true;
+    bool idle;
+    if (s_busy_sem) {
+        xSemaphoreTake(s_busy_sem, 0);              // drop a stale give
+        gpio_wakeup_enable(PIN_BUSY, GPIO_INTR_LOW_LEVEL);
+        gpio_intr_enable(PIN_BUSY);                 // fires at once if BUSY already fell
+        idle = xSemaphoreTake(s_busy_sem, pdMS_TO_TICKS(BUSY_TIMEOUT_MS)) == pdTRUE;
+        gpio_intr_disable(PIN_BUSY);
+        gpio_wakeup_disable(PIN_BUSY);
+    } else {
+        int waited = 0;
+        while (gpio_get_level(PIN_BUSY) == 1 && waited < BUSY_TIMEOUT_MS / 10) {
+            vTaskDelay(pdMS_TO_TICKS(10));
+            waited++;
+        }
+        idle = gpio_get_level(PIN_BUSY) == 0;
+    }
+    if (!idle) {
+        ESP_LOGW(TAG, "BUSY timeout after %d ms", BUSY_TIMEOUT_MS);
+        s_panel = 0;
+    }
+    return idle;
 }
 
 static void send_cmd(uint8_t cmd) {
@@ -180,198 +251,93 @@ static void panel_init(void) {
     wait_busy();
 }
 
-static void panel_refresh_full(void) {
-    // Push framebuffer to BW RAM
-    send_cmd(CMD_WRITE_RAM_BW);
-    send_data(s_fb, FB_SIZE);
-
-    // Full-update sequence: 0xF7 = Load LUT + Display
-    send_cmd(CMD_DISPLAY_UPDATE_CTRL_2);
-    send_data_byte(0xF7);
-    send_cmd(CMD_MASTER_ACTIVATE);
-    wait_busy();
-}
-
-static void panel_sleep(void) {
-    send_cmd(CMD_DEEP_SLEEP);
-    send_data_byte(0x01);  // Deep sleep mode 1
-}
+static const display_rect_t FULL_WINDOW = {
+    .x0 = 0, .x1 = DISPLAY_BPR - 1, .y0 = 0, .y1 = DISPLAY_H_PX - 1,
+};
 
-// ============================================================================
-// Framebuffer
-// ============================================================================
-
-static void fb_clear(uint8_t fill) {
-    memset(s_fb, fill, FB_SIZE);
-}
-
-// ============================================================================
-// Drawing primitives
-// ============================================================================
-
-// Coordinate convention: (0, 0) is top-left. x in [0, 121], y in [0, 249].
-// Each byte in the framebuffer holds 8 horizontal pixels, MSB on the left.
-// Bit value 0 = black pixel (drawn), 1 = white (background).
-
-static inline void draw_pixel(int x, int y, bool on) {
-    if (x < 0 || x >= DISPLAY_W || y < 0 || y >= DISPLAY_H_PX) return;
-    uint8_t mask = 0x80 >> (x & 7);
-    size_t idx = y * DISPLAY_BPR + (x >> 3);
-    if (on) {
-        s_fb[idx] &= ~mask;  // clear bit = black
-    } else {
-        s_fb[idx] |= mask;
-    }
-}
-
-static void draw_hline(int x, int y, int w) {
-    for (int i = 0; i < w; i++) {
-        draw_pixel(x + i, y, true);
-    }
-}
-
-// Draw a 1-bit bitmap at (x, y). Bytes are MSB-first within a row.
-// A 1 bit in the bitmap means "draw black pixel" (matches the asset
-// generator's output format).
-static void draw_bitmap(int x, int y, const uint8_t *bm, int w, int h) {
-    int bpr = (w + 7) / 8;
-    for (int row = 0; row < h; row++) {
-        for (int col = 0; col < w; col++) {
-            uint8_t byte = bm[row * bpr + (col >> 3)];
-            bool on = byte & (0x80 >> (col & 7));
-            if (on) {
-                draw_pixel(x + col, y + row, true);
-            }
-        }
-    }
+// Restrict RAM writes to `r` and park the address counter at its top-left.
+static void panel_set_window(const display_rect_t *r) {
+    send_cmd(CMD_SET_RAM_X_RANGE);
+    send_data_byte(r->x0);
+    send_data_byte(r->x1);
+    send_cmd(CMD_SET_RAM_Y_RANGE);
+    send_data_byte(r->y0 & 0xFF);
+    send_data_byte((r->y0 >> 8) & 0xFF);
+    send_data_byte(r->y1 & 0xFF);
+    send_data_byte((r->y1 >> 8) & 0xFF);
+    send_cmd(CMD_SET_RAM_X_ADDR);
+    send_data_byte(r->x0);
+    send_cmd(CMD_SET_RAM_Y_ADDR);
+    send_data_byte(r->y0 & 0xFF);
+    send_data_byte((r->y0 >> 8) & 0xFF);
 }
 
-// Render one small-font glyph at (x, y). Unsupported chars render as blank.
-static void draw_glyph_small(int x, int y, char ch) {
-    int idx = (int)(unsigned char)ch - DISPLAY_FONT_SMALL_FIRST;
-    if (idx < 0 || idx >= DISPLAY_FONT_SMALL_COUNT) {
+// Write the `r` window of s_fb into one of the panel RAMs.
+static void panel_write_window(uint8_t ram_cmd, const display_rect_t *r) {
+    panel_set_window(r);
+    send_cmd(ram_cmd);
+    size_t w = (size_t)(r->x1 - r->x0 + 1);
+    if (w == DISPLAY_BPR) {
+        // Full rows are contiguous in the framebuffer: one transfer
+        send_data(&s_fb[r->y0 * DISPLAY_BPR], w * (size_t)(r->y1 - r->y0 + 1));
         return;
     }
-    int glyph_bytes = ((DISPLAY_FONT_SMALL_W + 7) / 8) * DISPLAY_FONT_SMALL_H;
-    const uint8_t *bm = &display_font_small[idx * glyph_bytes];
-    draw_bitmap(x, y, bm, DISPLAY_FONT_SMALL_W, DISPLAY_FONT_SMALL_H);
-}
-
-static void draw_text_small(int x, int y, const char *s) {
-    int cx = x;
-    for (; *s; s++) {
-        draw_glyph_small(cx, y, *s);
-        cx += DISPLAY_FONT_SMALL_W;
-    }
-}
-
-// 2x-scaled small font: pixel-double each glyph into a 12x16 cell.
-// Used for the device-name header where the 6x8 small font looks cramped.
-static void draw_glyph_small_2x(int x, int y, char ch) {
-    int idx = (int)(unsigned char)ch - DISPLAY_FONT_SMALL_FIRST;
-    if (idx < 0 || idx >= DISPLAY_FONT_SMALL_COUNT) return;
-    int bpr = (DISPLAY_FONT_SMALL_W + 7) / 8;
-    int glyph_bytes = bpr * DISPLAY_FONT_SMALL_H;
-    const uint8_t *bm = &display_font_small[idx * glyph_bytes];
-    for (int row = 0; row < DISPLAY_FONT_SMALL_H; row++) {
-        for (int col = 0; col < DISPLAY_FONT_SMALL_W; col++) {
-            uint8_t byte = bm[row * bpr + (col >> 3)];
-            if (byte & (0x80 >> (col & 7))) {
-                int px = x + col * 2;
-                int py = y + row * 2;
-                draw_pixel(px,     py,     true);
-                draw_pixel(px + 1, py,     true);
-                draw_pixel(px,     py + 1, true);
-                draw_pixel(px + 1, py + 1, true);
-            }
-        }
-    }
-}
-
-static void draw_text_small_2x(int x, int y, const char *s) {
-    int cx = x;
-    for (; *s; s++) {
-        draw_glyph_small_2x(cx, y, *s);
-        cx += DISPLAY_FONT_SMALL_W * 2;
+    for (int y = r->y0; y <= r->y1; y++) {
+        send_data(&s_fb[y * DISPLAY_BPR + r->x0], w);
     }
 }
 
-static int text_small_2x_width(const char *s) {
-    int n = 0;
-    while (*s++) n++;
-    return n * DISPLAY_FONT_SMALL_W * 2;
-}
+// Both return false if the panel never came out of BUSY.
+static bool panel_refresh_full(void) {
+    // Push framebuffer to BW RAM
+    panel_write_window(CMD_WRITE_RAM_BW, &FULL_WINDOW);
 
-static void draw_text_small_2x_centered(int x0, int x1, int y, const char *s) {
-    int w = text_small_2x_width(s);
-    int x = x0 + ((x1 - x0) - w) / 2;
-    if (x < x0) x = x0;
-    draw_text_small_2x(x, y, s);
-}
+    // Full-update sequence: 0xF7 = Load LUT + Display
+    send_cmd(CMD_BORDER_WAVEFORM);
+    send_data_byte(0x05);
+    send_cmd(CMD_DISPLAY_UPDATE_CTRL_2);
+    send_data_byte(0xF7);
+    send_cmd(CMD_MASTER_ACTIVATE);
+    if (!wait_busy()) return false;
 
-// Large-font lookup: walk DISPLAY_FONT_LARGE_CHARS to find the index.
-static int large_index_of(char ch) {
-    for (int i = 0; DISPLAY_FONT_LARGE_CHARS[i]; i++) {
-        if (DISPLAY_FONT_LARGE_CHARS[i] == ch) return i;
-    }
-    return -1;
+    // The frame shown is the base the next partial update compares against
+    panel_write_window(CMD_WRITE_RAM_RED, &FULL_WINDOW);
+    return true;
 }
 
-static void draw_glyph_large(int x, int y, char ch) {
-    int idx = large_index_of(ch);
-    if (idx < 0) return;
-    int glyph_bytes = ((DISPLAY_FONT_LARGE_W + 7) / 8) * DISPLAY_FONT_LARGE_H;
-    const uint8_t *bm = &display_font_large[idx * glyph_bytes];
-    draw_bitmap(x, y, bm, DISPLAY_FONT_LARGE_W, DISPLAY_FONT_LARGE_H);
-}
+// Mode-2 update: the panel drives only pixels whose BW RAM differs from the
+// previous-frame (RED) RAM, using the fast waveform from OTP. Both RAMs
+// already hold the shown frame, so only the changed window is sent.
+static bool panel_refresh_partial(const display_rect_t *r) {
+    panel_write_window(CMD_WRITE_RAM_BW, r);
 
-static void draw_text_large(int x, int y, const char *s) {
-    int cx = x;
-    for (; *s; s++) {
-        draw_glyph_large(cx, y, *s);
-        cx += DISPLAY_FONT_LARGE_W;
-    }
-}
+    // Border follows VCOM: a partial update must not flash it
+    send_cmd(CMD_BORDER_WAVEFORM);
+    send_data_byte(0x80);
+    // 0xFF = clock + analog on, load temperature and mode-2 LUT, display mode 2, off
+    send_cmd(CMD_DISPLAY_UPDATE_CTRL_2);
+    send_data_byte(0xFF);
+    send_cmd(CMD_MASTER_ACTIVATE);
+    if (!wait_busy()) return false;
 
-// Helper: measure small-font text width
-static int text_small_width(const char *s) {
-    int n = 0;
-    while (*s++) n++;
-    return n * DISPLAY_FONT_SMALL_W;
+    panel_write_window(CMD_WRITE_RAM_RED, r);
+    return true;
 }
 
-// Helper: draw small text centered in a horizontal range [x0, x1)
-static void draw_text_small_centered(int x0, int x1, int y, const char *s) {
-    int w = text_small_width(s);
-    int x = x0 + ((x1 - x0) - w) / 2;
-    if (x < x0) x = x0;
-    draw_text_small(x, y, s);
+static void panel_sleep(void) {
+    send_cmd(CMD_DEEP_SLEEP);
+    send_data_byte(0x01);  // Deep sleep mode 1
 }
 
 // ============================================================================
-// Layouts
+// Panel bring-up (only when the glass has to change)
 // ============================================================================
 
-static void format_pct_1dp(char *buf, size_t n, float v) {
-    if (v < 0.0f) v = 0.0f;
-    if (v > 100.0f) v = 100.0f;
-    int whole = (int)v;
-    int frac  = (int)((v - whole) * 10.0f + 0.5f);
-    if (frac >= 10) { whole++; frac = 0; }
-    // At 100% the "100.0%" string is 6 large-font glyphs = 144 px > 122 px
-    // display width. Drop the decimal in that single case.
-    if (whole >= 100) {
-        snprintf(buf, n, "%d%%", whole);
-    } else {
-        snprintf(buf, n, "%d.%d%%", whole, frac);
+// SPI bus, GPIOs, reset probe, panel out of deep sleep.
+static esp_err_t panel_open(void) {
+    if (s_panel == PANEL_ABSENT) {
+        return ESP_ERR_NOT_FOUND;       // probed since power-up: nothing there
     }
-}
-
-// ============================================================================
-// Public API (placeholders for layout — Tasks 5–7 fill the rendering in)
-// ============================================================================
-
-esp_err_t display_init(void) {
     ESP_LOGI(TAG, "Initialising e-paper display");
 
     // GPIO setup for control pins
@@ -400,6 +366,14 @@ esp_err_t display_init(void) {
     gpio_set_level(PIN_DC, 1);
     gpio_set_level(PIN_RST, 1);
 
+    // Keep the active config through light sleep during a refresh: the sleep
+    // config would float RST/DC/CS and disconnect BUSY (see soil_moisture.c).
+    gpio_sleep_sel_dis(PIN_CS);
+    gpio_sleep_sel_dis(PIN_DC);
+    gpio_sleep_sel_dis(PIN_RST);
+    gpio_sleep_sel_dis(PIN_BUSY);
+    busy_irq_setup();
+
     // SPI bus + device
     spi_bus_config_t bus = {
         .mosi_io_num = PIN_MOSI,
@@ -428,6 +402,11 @@ esp_err_t display_init(void) {
         return err;
     }
 
+    if (s_panel == PANEL_PRESENT) {
+        panel_init();
+        return ESP_OK;
+    }
+
     // Probe for the panel: pulse RST then SW_RESET, polling BUSY for a
     // HIGH transition. A real SSD1680 raises BUSY HIGH for ~10 ms while
     // processing each reset. With the internal pull-down on BUSY (set
@@ -458,138 +437,78 @@ esp_err_t display_init(void) {
                  gpio_get_level(PIN_BUSY));
         spi_bus_remove_device(s_spi);
         s_spi = NULL;
+        s_panel = PANEL_ABSENT;
         return ESP_ERR_NOT_FOUND;
     }
+    s_panel = PANEL_PRESENT;
 
     panel_init();   // does its own reset+config; slight duplication, harmless
     return ESP_OK;
 }
 
-void display_show_telemetry(const display_telemetry_t *t) {
-    fb_clear(0xFF);  // white background
-
-    // Header: device ID in 2x small font, centered. Strip the "tree-" prefix
-    // — it's the convention for all device names in this deployment and is
-    // redundant on a per-device screen. Uppercase the result because the 2x
-    // pixel-doubled small font has cramped descenders on lowercase letters.
-    const char *src = (t && t->device_id) ? t->device_id : "";
-    if (strncmp(src, "tree-", 5) == 0) src += 5;
-    char upper_name[33];
-    size_t i = 0;
-    for (; i + 1 < sizeof(upper_name) && src[i]; i++) {
-        char c = src[i];
-        if (c >= 'a' && c <= 'z') c -= 32;
-        upper_name[i] = c;
-    }
-    upper_name[i] = '\0';
-    draw_text_small_2x_centered(0, DISPLAY_W, 4, upper_name);
-    draw_hline(4, 24, DISPLAY_W - 8);
-
-    // Hero: moisture % centered. format_pct_1dp drops the decimal at 100%
-    // so the worst case is "99.9%" (5 large glyphs = 120 px, fits in 122).
-    char hero[8] = {0};
-    format_pct_1dp(hero, sizeof(hero), t ? t->moisture_pct : 0.0f);
-    int hero_w = (int)strlen(hero) * DISPLAY_FONT_LARGE_W;
-    int hero_x = (DISPLAY_W - hero_w) / 2;
-    if (hero_x < 0) hero_x = 0;
-    draw_text_large(hero_x, 36, hero);
-    draw_text_small_centered(0, DISPLAY_W, 74, "MOISTURE");
-
-    draw_hline(4, 90, DISPLAY_W - 8);
-
-    // Data rows: label on the left, value on the right.
-    char buf[20];
-    int row_y = 100;
-    int row_h = 14;
-
-    snprintf(buf, sizeof(buf), "%d mV", t ? t->raw_mv : 0);
-    draw_text_small(6, row_y, "SENSOR");
-    {
-        int w = text_small_width(buf);
-        draw_text_small(DISPLAY_W - 6 - w, row_y, buf);
-    }
-    row_y += row_h;
+// Panel back into deep sleep mode 1 (RAM kept), SPI device released.
+static void panel_close(void) {
+    if (!s_spi) return;
+    panel_sleep();
+    spi_bus_remove_device(s_spi);
+    s_spi = NULL;
+    // Leave the bus initialised — the device may add more SPI peripherals
+    // later. spi_bus_free is fine to skip; bus stays idle.
+}
 
-    snprintf(buf, sizeof(buf), "%.2f V", t ? (double)t->battery_v : 0.0);
-    draw_text_small(6, row_y, "BATTERY");
-    {
-        int w = text_small_width(buf);
-        draw_text_small(DISPLAY_W - 6 - w, row_y, buf);
+// Put s_fb on the glass the cheapest way that keeps it clean, and remember it.
+// If the glass already shows it the panel is not even woken.
+static void panel_show(display_view_t view) {
+    if (display_shown_same(&s_shown, s_fb, view)) {
+        ESP_LOGI(TAG, "Frame unchanged - panel left asleep");
+        return;
     }
-    row_y += row_h;
-
-    snprintf(buf, sizeof(buf), "%d %%", t ? t->battery_pct : 0);
-    draw_text_small(6, row_y, "BAT %");
-    {
-        int w = text_small_width(buf);
-        draw_text_small(DISPLAY_W - 6 - w, row_y, buf);
+    if (panel_open() != ESP_OK) {
+        return;
     }
-    row_y += row_h;
-
-    if (t && t->wifi_rssi_dbm != 0) {
-        snprintf(buf, sizeof(buf), "%d dBm", t->wifi_rssi_dbm);
-    } else {
-        snprintf(buf, sizeof(buf), "--");
+    display_rect_t dirty = FULL_WINDOW;
+    display_refresh_t how = display_refresh_choose(&s_shown, s_shown_fb, s_fb, view,
+                                                   DISPLAY_FULL_REFRESH_EVERY, &dirty);
+    bool ok = true;
+    switch (how) {
+    case DISPLAY_REFRESH_NONE:   // already caught by display_shown_same()
+        break;
+    case DISPLAY_REFRESH_PARTIAL:
+        ESP_LOGI(TAG, "Partial refresh %u of %u: bytes %u-%u, rows %u-%u",
+                 (unsigned)s_shown.partials + 1, (unsigned)DISPLAY_FULL_REFRESH_EVERY,
+                 dirty.x0, dirty.x1, dirty.y0, dirty.y1);
+        ok = panel_refresh_partial(&dirty);
+        break;
+    case DISPLAY_REFRESH_FULL:
+        ok = panel_refresh_full();
+        break;
     }
-    draw_text_small(6, row_y, "WIFI");
-    {
-        int w = text_small_width(buf);
-        draw_text_small(DISPLAY_W - 6 - w, row_y, buf);
+    panel_close();
+    if (!ok) {
+        display_shown_reset(&s_shown);   // glass state unknown: next one is full
+        return;
     }
-
-    panel_refresh_full();
+    memcpy(s_shown_fb, s_fb, FB_SIZE);
+    display_shown_note(&s_shown, s_shown_fb, view, how);
 }
 
-void display_show_portal(void) {
-    fb_clear(0xFF);
-
-    // Header
-    draw_text_small_centered(0, DISPLAY_W, 6, "CONFIGURE");
-    draw_hline(4, 18, DISPLAY_W - 8);
-
-    // SSID + URL, two pairs of lines, both centered.
-    // SSID and URL kept verbatim — phones do case-sensitive SSID matching.
-    draw_text_small_centered(0, DISPLAY_W, 28, "CONNECT TO:");
-    draw_text_small_centered(0, DISPLAY_W, 40, "FireBeetle_C6_Prov");
-    draw_text_small_centered(0, DISPLAY_W, 56, "OPEN IN BROWSER:");
-    draw_text_small_centered(0, DISPLAY_W, 68, "http://192.168.4.1");
-
-    // QR bitmap, centered horizontally, below the URL text.
-    int qr_x = (DISPLAY_W - DISPLAY_QR_W) / 2;
-    int qr_y = 90;
-    draw_bitmap(qr_x, qr_y, display_qr, DISPLAY_QR_W, DISPLAY_QR_H);
-
-    // Hint at the bottom
-    draw_text_small_centered(0, DISPLAY_W, qr_y + DISPLAY_QR_H + 8, "SCAN TO CONFIGURE");
+// ============================================================================
+// Public API
+// ============================================================================
 
-    panel_refresh_full();
+void display_show_telemetry(const display_telemetry_t *t) {
+    display_render_telemetry(s_fb, t);
+    panel_show(DISPLAY_VIEW_TELEMETRY);
 }
 
-void display_show_low_battery(float volts) {
-    fb_clear(0xFF);  // white background
-
-    // Header (matches the portal layout style).
-    draw_text_small_2x_centered(0, DISPLAY_W, 6, "LOW");
-    draw_text_small_2x_centered(0, DISPLAY_W, 28, "BATTERY");
-
-    // Voltage line, e.g. "3.65 V"
-    char vbuf[16];
-    snprintf(vbuf, sizeof(vbuf), "%.2f V", (double)volts);
-    draw_text_small_2x_centered(0, DISPLAY_W, 90, vbuf);
-
-    // Instruction line at the bottom.
-    draw_text_small_centered(0, DISPLAY_W, DISPLAY_H_PX - 24, "CHARGE TO RESUME");
-
-    panel_refresh_full();
+void display_show_portal(void) {
+    display_render_portal(s_fb);
+    panel_show(DISPLAY_VIEW_PORTAL);
 }
 
-void display_deinit(void) {
-    if (!s_spi) return;
-    panel_sleep();
-    spi_bus_remove_device(s_spi);
-    s_spi = NULL;
-    // Leave the bus initialised — the device may add more SPI peripherals
-    // later. spi_bus_free is fine to skip; bus stays idle.
+void display_show_low_battery(float volts) {
+    display_render_low_battery(s_fb, volts);
+    panel_show(DISPLAY_VIEW_LOW_BATTERY);
 }
 
 #endif // TEST_HOST
@@ -0,0 +1,142 @@
+#include "display_fb.h"
+#include "crc32.h"
+#include <stddef.h>
+#include <string.h>
+
+bool display_fb_dirty(const uint8_t *prev, const uint8_t *cur, display_rect_t *r) {
+    int x0 = DISPLAY_BPR, x1 = -1, y0 = -1, y1 = -1;
+    for (int y = 0; y < DISPLAY_H_PX; y++) {
+        const uint8_t *p = prev + y * DISPLAY_BPR;
+        const uint8_t *c = cur + y * DISPLAY_BPR;
+        if (memcmp(p, c, DISPLAY_BPR) == 0) continue;
+        if (y0 < 0) y0 = y;
+        y1 = y;
+        int l = 0, h = DISPLAY_BPR - 1;
+        while (p[l] == c[l]) l++;
+        while (p[h] == c[h]) h--;
+        if (l < x0) x0 = l;
+        if (h > x1) x1 = h;
+    }
+    if (y0 < 0) return false;
+    *r = (display_rect_t){ .x0 = (uint8_t)x0, .x1 = (uint8_t)x1,
+                           .y0 = (uint16_t)y0, .y1 = (uint16_t)y1 };
+    return true;
+}
+
+// A nibble with each bit doubled: 0b1011 -> 0b11001111. A source byte at
+// 2x is DOUBLE_NIBBLE[b >> 4] then DOUBLE_NIBBLE[b & 15].
+static const uint8_t DOUBLE_NIBBLE[16] = {
+    0x00, 0x03, 0x0C, 0x0F, 0x30, 0x33, 0x3C, 0x3F,
+    0xC0, 0xC3, 0xCC, 0xCF, 0xF0, 0xF3, 0xFC, 0xFF,
+};
+
+void display_fb_hline(uint8_t *fb, int x, int y, int w) {
+    int x1 = x + w;
+    if (x < 0) x = 0;
+    if (x1 > DISPLAY_W) x1 = DISPLAY_W;
+    if (y < 0 || y >= DISPLAY_H_PX || x >= x1) return;
+    uint8_t *row = fb + y * DISPLAY_BPR;
+    int b0 = x >> 3, b1 = (x1 - 1) >> 3;
+    uint8_t lmask = (uint8_t)(0xFF >> (x & 7));
+    uint8_t rmask = (uint8_t)(0xFF << (7 - ((x1 - 1) & 7)));
+    if (b0 == b1) {
+        row[b0] &= (uint8_t)~(lmask & rmask);
+        return;
+    }
+    row[b0] &= (uint8_t)~lmask;
+    memset(row + b0 + 1, 0x00, (size_t)(b1 - b0 - 1));
+    row[b1] &= (uint8_t)~rmask;
+}
+
+// Blit at scale 1 or 2. Columns and rows count panel pixels (so already
+// doubled at scale 2); byte j of a doubled row is one nibble of source byte j/2.
+static void blit(uint8_t *fb, int x, int y, const uint8_t *bm, int w, int h, int scale) {
+    int pw = w * scale, ph = h * scale;
+    int c0 = x < 0 ? -x : 0;
+    int c1 = x + pw > DISPLAY_W ? DISPLAY_W - x : pw;
+    int r0 = y < 0 ? -y : 0;
+    int r1 = y + ph > DISPLAY_H_PX ? DISPLAY_H_PX - y : ph;
+    if (c0 >= c1 || r0 >= r1) return;
+
+    int j0 = c0 >> 3, j1 = (c1 - 1) >> 3;
+    uint8_t lmask = (uint8_t)(0xFF >> (c0 & 7));
+    uint8_t rmask = (uint8_t)(0xFF << (7 - ((c1 - 1) & 7)));
+    int shift = x & 7;                  // x < 0 too: two's complement
+    int kbase = (x - shift) / 8;        // framebuffer byte under source byte 0
+    int bpr = (w + 7) / 8;
+
+    for (int r = r0; r < r1; r++) {
+        const uint8_t *src = bm + (r / scale) * bpr;
+        uint8_t *dst = fb + (y + r) * DISPLAY_BPR;
+        for (int j = j0; j <= j1; j++) {
+            uint8_t b = scale == 1 ? src[j]
+                      : DOUBLE_NIBBLE[(j & 1) ? (src[j >> 1] & 0x0F) : (src[j >> 1] >> 4)];
+            if (j == j0) b &= lmask;
+            if (j == j1) b &= rmask;
+            // Set bits are all on the panel, so a non-zero half is in range
+            uint8_t hi = (uint8_t)(b >> shift);
+            uint8_t lo = (uint8_t)(b << (8 - shift));
+            int k = kbase + j;
+            if (hi) dst[k] &= (uint8_t)~hi;
+            if (shift && lo) dst[k + 1] &= (uint8_t)~lo;
+        }
+    }
+}
+
+void display_fb_blit(uint8_t *fb, int x, int y, const uint8_t *bm, int w, int h) {
+    blit(fb, x, y, bm, w, h, 1);
+}
+
+void display_fb_blit_2x(uint8_t *fb, int x, int y, const uint8_t *bm, int w, int h) {
+    blit(fb, x, y, bm, w, h, 2);
+}
+
+static uint32_t shown_crc(const display_shown_t *h) {
+    return crc32_update(0, h, offsetof(display_shown_t, crc));
+}
+
+void display_shown_reset(display_shown_t *h) {
+    memset(h, 0, sizeof(*h));
+    h->magic = DISPLAY_SHOWN_MAGIC;
+    h->crc = shown_crc(h);
+}
+
+bool display_shown_valid(const display_shown_t *h, const uint8_t *frame) {
+    return h->magic == DISPLAY_SHOWN_MAGIC && h->crc == shown_crc(h) &&
+           h->view != DISPLAY_VIEW_NONE &&
+           h->frame_crc == crc32_update(0, frame, DISPLAY_FB_SIZE);
+}
+
+bool display_shown_same(const display_shown_t *h, const uint8_t *next, display_view_t view) {
+    return h->magic == DISPLAY_SHOWN_MAGIC && h->crc == shown_crc(h) &&
+           view != DISPLAY_VIEW_NONE && h->view == (uint32_t)view &&
+           h->frame_crc == crc32_update(0, next, DISPLAY_FB_SIZE);
+}
+
+void display_shown_note(display_shown_t *h, const uint8_t *frame, display_view_t view,
+                        display_refresh_t how) {
+    h->magic = DISPLAY_SHOWN_MAGIC;
+    h->view = view;
+    if (how == DISPLAY_REFRESH_FULL) {
+        h->partials = 0;
+    } else if (how == DISPLAY_REFRESH_PARTIAL) {
+        h->partials++;
+    }
+    h->frame_crc = crc32_update(0, frame, DISPLAY_FB_SIZE);
+    h->crc = shown_crc(h);
+}
+
+display_refresh_t display_refresh_choose(const display_shown_t *h, const uint8_t *shown,
+                                         const uint8_t *next, display_view_t view,
+                                         uint32_t full_every, display_rect_t *dirty) {
+    if (!display_shown_valid(h, shown) || h->view != (uint32_t)view) {
+        return DISPLAY_REFRESH_FULL;
+    }
+    if (!display_fb_dirty(shown, next, dirty)) {
+        return DISPLAY_REFRESH_NONE;
+    }
+    if (full_every == 0 || h->partials >= full_every) {
+        return DISPLAY_REFRESH_FULL;
+    }
+    return DISPLAY_REFRESH_PARTIAL;
+}
@@ -0,0 +1,285 @@
+/**
+ * @file display_render.c
+ * @brief Screen layouts for the e-paper: each view composed into a framebuffer.
+ *
+ * Layout: portrait 122 x 250 px. Framebuffer is 16 bytes wide
+ * (ceil(122 / 8)) by 250 tall = 4000 bytes.
+ */
+
+#include "display_render.h"
+#include "display_assets.h"
+#include "display_fb.h"
+#include <stdio.h>
+#include <string.h>
+
+// ============================================================================
+// Framebuffer
+// ============================================================================
+
+// Frame being composed by the display_render_*() call in progress.
+static uint8_t *s_fb;
+
+static void fb_clear(uint8_t fill) {
+    memset(s_fb, fill, DISPLAY_FB_SIZE);
+}
+
+// ============================================================================
+// Drawing primitives
+// ============================================================================
+
+// Coordinate convention: (0, 0) is top-left. x in [0, 121], y in [0, 249].
+// Each byte in the framebuffer holds 8 horizontal pixels, MSB on the left.
+// Bit value 0 = black pixel (drawn), 1 = white (background).
+
+static void draw_hline(int x, int y, int w) {
+    display_fb_hline(s_fb, x, y, w);
+}
+
+// Draw a 1-bit bitmap at (x, y). Bytes are MSB-first within a row.
+// A 1 bit in the bitmap means "draw black pixel" (matches the asset
+// generator's output format).
+static void draw_bitmap(int x, int y, const uint8_t *bm, int w, int h) {
+    display_fb_blit(s_fb, x, y, bm, w, h);
+}
+
+// Render one small-font glyph at (x, y). Unsupported chars render as blank.
+static void draw_glyph_small(int x, int y, char ch) {
+    int idx = (int)(unsigned char)ch - DISPLAY_FONT_SMALL_FIRST;
+    if (idx < 0 || idx >= DISPLAY_FONT_SMALL_COUNT) {
+        return;
+    }
+    int glyph_bytes = ((DISPLAY_FONT_SMALL_W + 7) / 8) * DISPLAY_FONT_SMALL_H;
+    const uint8_t *bm = &display_font_small[idx * glyph_bytes];
+    draw_bitmap(x, y, bm, DISPLAY_FONT_SMALL_W, DISPLAY_FONT_SMALL_H);
+}
+
+static void draw_text_small(int x, int y, const char *s) {
+    int cx = x;
+    for (; *s; s++) {
+        draw_glyph_small(cx, y, *s);
+        cx += DISPLAY_FONT_SMALL_W;
+    }
+}
+
+// 2x-scaled small font: pixel-double each glyph into a 12x16 cell.
+// Used for the device-name header where the 6x8 small font looks cramped.
+static void draw_glyph_small_2x(int x, int y, char ch) {
+    int idx = (int)(unsigned char)ch - DISPLAY_FONT_SMALL_FIRST;
+    if (idx < 0 || idx >= DISPLAY_FONT_SMALL_COUNT) return;
+    int glyph_bytes = ((DISPLAY_FONT_SMALL_W + 7) / 8) * DISPLAY_FONT_SMALL_H;
+    const uint8_t *bm = &display_font_small[idx * glyph_bytes];
+    display_fb_blit_2x(s_fb, x, y, bm, DISPLAY_FONT_SMALL_W, DISPLAY_FONT_SMALL_H);
+}
+
+static void draw_text_small_2x(int x, int y, const char *s) {
+    int cx = x;
+    for (; *s; s++) {
+        draw_glyph_small_2x(cx, y, *s);
+        cx += DISPLAY_FONT_SMALL_W * 2;
+    }
+}
+
+static int text_small_2x_width(const char *s) {
+    int n = 0;
+    while (*s++) n++;
+    return n * DISPLAY_FONT_SMALL_W * 2;
+}
+
+static void draw_text_small_2x_centered(int x0, int x1, int y, const char *s) {
+    int w = text_small_2x_width(s);
+    int x = x0 + ((x1 - x0) - w) / 2;
+    if (x < x0) x = x0;
+    draw_text_small_2x(x, y, s);
+}
+
+// Large-font lookup: walk DISPLAY_FONT_LARGE_CHARS to find the index.
+static int large_index_of(char ch) {
+    for (int i = 0; DISPLAY_FONT_LARGE_CHARS[i]; i++) {
+        if (DISPLAY_FONT_LARGE_CHARS[i] == ch) return i;
+    }
+    return -1;
+}
+
+static void draw_glyph_large(int x, int y, char ch) {
+    int idx = large_index_of(ch);
+    if (idx < 0) return;
+    int glyph_bytes = ((DISPLAY_FONT_LARGE_W + 7) / 8) * DISPLAY_FONT_LARGE_H;
+    const uint8_t *bm = &display_font_large[idx * glyph_bytes];
+    draw_bitmap(x, y, bm, DISPLAY_FONT_LARGE_W, DISPLAY_FONT_LARGE_H);
+}
+
+static void draw_text_large(int x, int y, const char *s) {
+    int cx = x;
+    for (; *s; s++) {
+        draw_glyph_large(cx, y, *s);
+        cx += DISPLAY_FONT_LARGE_W;
+    }
+}
+
+// Helper: measure small-font text width
+static int text_small_width(const char *s) {
+    int n = 0;
+    while (*s++) n++;
+    return n * DISPLAY_FONT_SMALL_W;
+}
+
+// Helper: draw small text centered in a horizontal range [x0, x1)
+static void draw_text_small_centered(int x0, int x1, int y, const char *s) {
+    int w = text_small_width(s);
+    int x = x0 + ((x1 - x0) - w) / 2;
+    if (x < x0) x = x0;
+    draw_text_small(x, y, s);
+}
+
+// ============================================================================
+// Layouts
+// ============================================================================
+
+// Sensor mV, battery volts and RSSI wander by a few units between wakes.
+// Drawn raw, they change the frame (and its hash) nearly every wake, so the
+// "frame unchanged" skip in display.c would almost never fire. Show them
+// rounded to a step coarser than their jitter.
+#define SENSOR_MV_STEP   50
+#define BATTERY_MV_STEP  50
+#define RSSI_DBM_STEP    5
+
+// Round to the nearest multiple of step, halves away from zero.
+static int round_to_step(int v, int step) {
+    int64_t half = step / 2;
+    return (int)((v >= 0 ? (v + half) / step : (v - half) / step) * step);
+}
+
+static void format_pct_1dp(char *buf, size_t n, float v) {
+    if (v < 0.0f) v = 0.0f;
+    if (v > 100.0f) v = 100.0f;
+    int whole = (int)v;
+    int frac  = (int)((v - whole) * 10.0f + 0.5f);
+    if (frac >= 10) { whole++; frac = 0; }
+    // At 100% the "100.0%" string is 6 large-font glyphs = 144 px > 122 px
+    // display width. Drop the decimal in that single case.
+    if (whole >= 100) {
+        snprintf(buf, n, "%d%%", whole);
+    } else {
+        snprintf(buf, n, "%d.%d%%", whole, frac);
+    }
+}
+
+void display_render_telemetry(uint8_t *fb, const display_telemetry_t *t) {
+    s_fb = fb;
+    fb_clear(0xFF);  // white background
+
+    // Header: device ID in 2x small font, centered. Strip the "tree-" prefix
+    // — it's the convention for all device names in this deployment and is
+    // redundant on a per-device screen. Uppercase the result because the 2x
+    // pixel-doubled small font has cramped descenders on lowercase letters.
+    const char *src = (t && t->device_id) ? t->device_id : "";
+    if (strncmp(src, "tree-", 5) == 0) src += 5;
+    char upper_name[33];
+    size_t i = 0;
+    for (; i + 1 < sizeof(upper_name) && src[i]; i++) {
+        char c = src[i];
+        if (c >= 'a' && c <= 'z') c -= 32;
+        upper_name[i] = c;
+    }
+    upper_name[i] = '\0';
+    draw_text_small_2x_centered(0, DISPLAY_W, 4, upper_name);
+    draw_hline(4, 24, DISPLAY_W - 8);
+
+    // Hero: moisture % centered. format_pct_1dp drops the decimal at 100%
+    // so the worst case is "99.9%" (5 large glyphs = 120 px, fits in 122).
+    char hero[8] = {0};
+    format_pct_1dp(hero, sizeof(hero), t ? t->moisture_pct : 0.0f);
+    int hero_w = (int)strlen(hero) * DISPLAY_FONT_LARGE_W;
+    int hero_x = (DISPLAY_W - hero_w) / 2;
+    if (hero_x < 0) hero_x = 0;
+    draw_text_large(hero_x, 36, hero);
+    draw_text_small_centered(0, DISPLAY_W, 74, "MOISTURE");
+
+    draw_hline(4, 90, DISPLAY_W - 8);
+
+    // Data rows: label on the left, value on the right.
+    char buf[20];
+    int row_y = 100;
+    int row_h = 14;
+
+    snprintf(buf, sizeof(buf), "%d mV", t ? round_to_step(t->raw_mv, SENSOR_MV_STEP) : 0);
+    draw_text_small(6, row_y, "SENSOR");
+    {
+        int w = text_small_width(buf);
+        draw_text_small(DISPLAY_W - 6 - w, row_y, buf);
+    }
+    row_y += row_h;
+
+    // Clamp before the int conversion: hostile input must not overflow it.
+    float bat_mv = t ? t->battery_v * 1000.0f : 0.0f;
+    if (!(bat_mv > 0.0f)) bat_mv = 0.0f;
+    if (bat_mv > 99999.0f) bat_mv = 99999.0f;
+    int bat_q = round_to_step((int)(bat_mv + 0.5f), BATTERY_MV_STEP);
+    snprintf(buf, sizeof(buf), "%d.%02d V", bat_q / 1000, (bat_q % 1000) / 10);
+    draw_text_small(6, row_y, "BATTERY");
+    {
+        int w = text_small_width(buf);
+        draw_text_small(DISPLAY_W - 6 - w, row_y, buf);
+    }
+    row_y += row_h;
+
+    snprintf(buf, sizeof(buf), "%d %%", t ? t->battery_pct : 0);
+    draw_text_small(6, row_y, "BAT %");
+    {
+        int w = text_small_width(buf);
+        draw_text_small(DISPLAY_W - 6 - w, row_y, buf);
+    }
+    row_y += row_h;
+
+    if (t && t->wifi_rssi_dbm != 0) {
+        snprintf(buf, sizeof(buf), "%d dBm", round_to_step(t->wifi_rssi_dbm, RSSI_DBM_STEP));
+    } else {
+        snprintf(buf, sizeof(buf), "--");
+    }
+    draw_text_small(6, row_y, "WIFI");
+    {
+        int w = text_small_width(buf);
+        draw_text_small(DISPLAY_W - 6 - w, row_y, buf);
+    }
+}
+
+void display_render_portal(uint8_t *fb) {
+    s_fb = fb;
+    fb_clear(0xFF);
+
+    // Header
+    draw_text_small_centered(0, DISPLAY_W, 6, "CONFIGURE");
+    draw_hline(4, 18, DISPLAY_W - 8);
+
+    // SSID + URL, two pairs of lines, both centered.
+    // SSID and URL kept verbatim — phones do case-sensitive SSID matching.
+    draw_text_small_centered(0, DISPLAY_W, 28, "CONNECT TO:");
+    draw_text_small_centered(0, DISPLAY_W, 40, "FireBeetle_C6_Prov");
+    draw_text_small_centered(0, DISPLAY_W, 56, "OPEN IN BROWSER:");
+    draw_text_small_centered(0, DISPLAY_W, 68, "http://192.168.4.1");
+
+    // QR bitmap, centered horizontally, below the URL text.
+    int qr_x = (DISPLAY_W - DISPLAY_QR_W) / 2;
+    int qr_y = 90;
+    draw_bitmap(qr_x, qr_y, display_qr, DISPLAY_QR_W, DISPLAY_QR_H);
+
+    // Hint at the bottom
+    draw_text_small_centered(0, DISPLAY_W, qr_y + DISPLAY_QR_H + 8, "SCAN TO CONFIGURE");
+}
+
+void display_render_low_battery(uint8_t *fb, float volts) {
+    s_fb = fb;
+    fb_clear(0xFF);  // white background
+
+    // Header (matches the portal layout style).
+    draw_text_small_2x_centered(0, DISPLAY_W, 6, "LOW");
+    draw_text_small_2x_centered(0, DISPLAY_W, 28, "BATTERY");
+
+    // Voltage line, e.g. "3.65 V"
+    char vbuf[16];
+    snprintf(vbuf, sizeof(vbuf), "%.2f V", (double)volts);
+    draw_text_small_2x_centered(0, DISPLAY_W, 90, vbuf);
+
+    // Instruction line at the bottom.
+    draw_text_small_centered(0, DISPLAY_W, DISPLAY_H_PX - 24, "CHARGE TO RESUME");
+}
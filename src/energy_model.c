@@ -0,0 +1,200 @@
+#include "energy_model.h"
+#include "crc32.h"
+#include <string.h>
+
+// Figures are board-level averages for the FireBeetle 2 C6 at 160 MHz,
+// including the ~5 mA soil probe while SENSE is open and the SSD1680 charge
+// pump while DISPLAY is open. Adjust per hardware revision; `ratio_x100`
+// in the ledger says how far off they are in the field.
+const energy_model_t ENERGY_MODEL_WIFI = {
+    .name = "wifi",
+    .phase_ua = {
+        [WAKE_PHASE_BOOT]    = 25000,
+        [WAKE_PHASE_INIT]    = 30000,
+        [WAKE_PHASE_OCV]     = 25000,
+        [WAKE_PHASE_NET]     = 85000,   // scan + associate + DHCP
+        [WAKE_PHASE_BROKER]  = 80000,
+        [WAKE_PHASE_CONNECT] = 80000,
+        [WAKE_PHASE_ADC]     = 25000,
+        [WAKE_PHASE_SENSE]   = 30000,
+        [WAKE_PHASE_PUBLISH] = 80000,
+        [WAKE_PHASE_DISPLAY] = 30000,
+    },
+    .idle_ua  = 25000,
+    .sleep_ua = 10,                     // deep sleep, probe held off
+};
+
+const energy_model_t ENERGY_MODEL_ZIGBEE = {
+    .name = "zigbee",
+    .phase_ua = {
+        [WAKE_PHASE_BOOT]    = 25000,
+        [WAKE_PHASE_INIT]    = 25000,
+        [WAKE_PHASE_OCV]     = 25000,
+        [WAKE_PHASE_NET]     = 75000,   // 802.15.4 rx/tx
+        [WAKE_PHASE_BROKER]  = 0,
+        [WAKE_PHASE_CONNECT] = 0,
+        [WAKE_PHASE_ADC]     = 22000,
+        [WAKE_PHASE_SENSE]   = 27000,
+        [WAKE_PHASE_PUBLISH] = 75000,
+        [WAKE_PHASE_DISPLAY] = 27000,
+    },
+    .idle_ua  = 22000,
+    .sleep_ua = 300,                    // light sleep incl. parent polls
+};
+
+// 1 nAh = 3.6e6 uA*us = 3.6 uA*s
+#define UA_US_PER_NAH  3600000ULL
+
+uint64_t energy_model_wake_nah(const energy_model_t *m, const wake_timing_record_t *r) {
+    int64_t ua_us = 0;
+    int64_t in_phases_us = 0;
+    for (int p = 0; p < WAKE_PHASE_COUNT; p++) {
+        if (!(r->phase_mask & (1u << p))) continue;
+        ua_us        += (int64_t)m->phase_ua[p] * r->phase_us[p];
+        in_phases_us += r->phase_us[p];
+    }
+    // Time the phases don't cover was spent awake between them. Where they
+    // overlap (the parallel wake pipeline) they cover more than the total:
+    // each phase figure already includes the idle draw, so take the idle
+    // current back off for the overlap rather than count it twice.
+    ua_us += (int64_t)m->idle_ua * ((int64_t)r->total_us - in_phases_us);
+    if (ua_us < 0) ua_us = 0;
+    return ((uint64_t)ua_us + UA_US_PER_NAH / 2) / UA_US_PER_NAH;
+}
+
+uint64_t energy_model_sleep_nah(const energy_model_t *m, uint32_t sleep_s) {
+    return ((uint64_t)m->sleep_ua * sleep_s * 10 + 18) / 36;
+}
+
+uint32_t energy_days_remaining_x10(uint16_t pct_x100, uint32_t capacity_mah,
+                                   uint64_t cycle_nah, uint32_t cycle_s,
+                                   uint16_t ratio_x100) {
+    if (cycle_nah == 0 || cycle_s == 0) return 0;
+    if (ratio_x100 == 0) ratio_x100 = 100;
+    if (pct_x100 > 10000) pct_x100 = 10000;
+
+    // remaining / (cycle_nah * ratio * cycles_per_day), in tenths of a day
+    uint64_t remaining_nah = (uint64_t)pct_x100 * capacity_mah * (ENERGY_NAH_PER_MAH / 10000);
+    uint64_t num = remaining_nah * 10 * cycle_s * 100;
+    uint64_t den = cycle_nah * 86400ULL * ratio_x100;
+    uint64_t days_x10 = (num + den / 2) / den;
+    return days_x10 > UINT32_MAX ? UINT32_MAX : (uint32_t)days_x10;
+}
+
+// ---- Ledger ----
+
+static uint32_t ledger_crc(const energy_ledger_t *l) {
+    return crc32_update(0, l, offsetof(energy_ledger_t, crc));
+}
+
+void energy_ledger_reset(energy_ledger_t *l, uint16_t ocv_pct_x100) {
+    memset(l, 0, sizeof(*l));
+    l->magic        = ENERGY_LEDGER_MAGIC;
+    l->ref_pct_x100 = ocv_pct_x100;
+    l->ocv_pct_x100 = ocv_pct_x100;
+    l->crc          = ledger_crc(l);
+}
+
+bool energy_ledger_valid(const energy_ledger_t *l) {
+    return l->magic == ENERGY_LEDGER_MAGIC && l->crc == ledger_crc(l);
+}
+
+void energy_ledger_add(energy_ledger_t *l, uint64_t cycle_nah, uint32_t cycle_s) {
+    l->wakes++;
+    l->total_nah   += cycle_nah;
+    l->last_nah     = cycle_nah > UINT32_MAX ? UINT32_MAX : (uint32_t)cycle_nah;
+    l->last_cycle_s = cycle_s;
+    l->total_s     += cycle_s;
+    l->crc = ledger_crc(l);
+}
+
+uint32_t energy_ledger_mean_nah(const energy_ledger_t *l) {
+    if (l->wakes == 0) return 0;
+    uint64_t mean = l->total_nah / l->wakes;
+    return mean > UINT32_MAX ? UINT32_MAX : (uint32_t)mean;
+}
+
+uint32_t energy_ledger_days_remaining_x10(const energy_ledger_t *l, uint32_t capacity_mah) {
+    if (l->wakes == 0) return 0;
+    // Mean per cycle, which keeps energy_days_remaining_x10()'s products in range.
+    return energy_days_remaining_x10(l->ocv_pct_x100, capacity_mah,
+                                     energy_ledger_mean_nah(l), l->total_s / l->wakes,
+                                     l->ratio_x100);
+}
+
+void energy_ledger_observe_ocv(energy_ledger_t *l, uint16_t ocv_pct_x100,
+                               uint32_t capacity_mah) {
+    l->ocv_pct_x100 = ocv_pct_x100;
+
+    if (ocv_pct_x100 >= l->ref_pct_x100 + ENERGY_OCV_RECHARGE_X100) {
+        // Recharged: the charge drawn so far no longer maps onto this SoC.
+        l->ref_pct_x100 = ocv_pct_x100;
+        l->ref_nah      = l->total_nah;
+    } else if (ocv_pct_x100 + ENERGY_OCV_MIN_DROP_X100 <= l->ref_pct_x100) {
+        uint64_t model_nah    = l->total_nah - l->ref_nah;
+        uint64_t observed_nah = (uint64_t)(l->ref_pct_x100 - ocv_pct_x100) * capacity_mah *
+                                (ENERGY_NAH_PER_MAH / 10000);
+        if (model_nah > 0) {
+            uint64_t ratio = (observed_nah * 100 + model_nah / 2) / model_nah;
+            l->ratio_x100 = ratio > UINT16_MAX ? UINT16_MAX : (uint16_t)ratio;
+        }
+    }
+    l->crc = ledger_crc(l);
+}
+
+void energy_ledger_encode(const energy_ledger_t *l, uint32_t capacity_mah,
+                          telemetry_enc_t *e) {
+    if (l->wakes == 0) return;
+
+    uint32_t mah_x1e4 = (uint32_t)(((uint64_t)energy_ledger_mean_nah(l) + 50) / 100);
+    telemetry_enc_fixed(e, "mAh_per_wake", (int32_t)mah_x1e4, 4);
+    telemetry_enc_fixed(e, "days_remaining",
+                        (int32_t)energy_ledger_days_remaining_x10(l, capacity_mah), 1);
+    if (l->ratio_x100) {
+        telemetry_enc_fixed(e, "model_ratio", l->ratio_x100, 2);
+    }
+}
+
+int energy_ledger_format_json(const energy_ledger_t *l, uint32_t capacity_mah,
+                              char *buf, size_t len) {
+    telemetry_enc_t e;
+    telemetry_enc_init(&e, TELEMETRY_FMT_JSON, buf, len);
+    energy_ledger_encode(l, capacity_mah, &e);
+    return telemetry_enc_finish(&e);
+}
+
+#ifndef TEST_HOST
+#include "esp_attr.h"
+
+RTC_DATA_ATTR static energy_ledger_t s_ledger;
+
+const energy_model_t *energy_model_active(void) {
+#ifdef USE_ZIGBEE
+    return &ENERGY_MODEL_ZIGBEE;
+#else
+    return &ENERGY_MODEL_WIFI;
+#endif
+}
+
+void energy_ledger_begin(uint16_t ocv_pct_x100) {
+    if (!energy_ledger_valid(&s_ledger)) {
+        energy_ledger_reset(&s_ledger, ocv_pct_x100);
+        return;
+    }
+    energy_ledger_observe_ocv(&s_ledger, ocv_pct_x100, ENERGY_BATTERY_MAH);
+}
+
+void energy_ledger_account(const wake_timing_record_t *r, uint32_t sleep_s) {
+    if (!r) return;
+    const energy_model_t *m = energy_model_active();
+    if (!energy_ledger_valid(&s_ledger)) {
+        energy_ledger_reset(&s_ledger, 0);
+    }
+    uint64_t nah = energy_model_wake_nah(m, r) + energy_model_sleep_nah(m, sleep_s);
+    energy_ledger_add(&s_ledger, nah, sleep_s + (r->total_us + 500000U) / 1000000U);
+}
+
+const energy_ledger_t *energy_ledger(void) {
+    return &s_ledger;
+}
+#endif // TEST_HOST
@@ -0,0 +1,253 @@
+#include "flash_queue.h"
+#include "crc32.h"
+#include <stdio.h>
+#include <string.h>
+
+_Static_assert(sizeof(flash_queue_record_t) == FLASH_QUEUE_SLOT, "record must fill one slot");
+
+#define DONE_PENDING  0xFFFFFFFFu
+
+/** Slot 0 of every sector in use. */
+typedef struct {
+    uint32_t magic;
+    uint32_t epoch;                         ///< Increases by one per sector written
+    uint32_t crc;                           ///< Over magic and epoch
+    uint8_t  reserved[FLASH_QUEUE_SLOT - 12];
+} sector_header_t;
+
+static uint32_t slot_offset(uint32_t sector, uint32_t slot) {
+    return sector * FLASH_SHIM_SECTOR + slot * FLASH_QUEUE_SLOT;
+}
+
+static bool is_erased(const void *p, size_t len) {
+    const uint8_t *b = p;
+    for (size_t i = 0; i < len; i++) {
+        if (b[i] != 0xFF) return false;
+    }
+    return true;
+}
+
+static uint32_t record_crc(const flash_queue_record_t *r) {
+    return crc32_update(0, r, offsetof(flash_queue_record_t, crc));
+}
+
+static uint32_t header_crc(const sector_header_t *h) {
+    return crc32_update(0, h, offsetof(sector_header_t, crc));
+}
+
+// Read a record slot. Returns false once past the last written slot.
+static bool read_slot(uint32_t sector, uint32_t slot, flash_queue_record_t *r) {
+    return flash_shim_read(slot_offset(sector, slot), r, sizeof(*r)) &&
+           !is_erased(r, sizeof(*r));
+}
+
+static bool record_ok(const flash_queue_record_t *r) {
+    return r->crc == record_crc(r);
+}
+
+// Undelivered records in a sector.
+static uint32_t count_pending(uint32_t sector) {
+    uint32_t n = 0;
+    flash_queue_record_t r;
+    for (uint32_t slot = 1; slot < FLASH_QUEUE_SLOTS && read_slot(sector, slot, &r); slot++) {
+        if (record_ok(&r) && r.done == DONE_PENDING) n++;
+    }
+    return n;
+}
+
+// Sector with the smallest epoch above `after`, or -1.
+static int next_sector(const flash_queue_t *q, uint32_t after) {
+    int best = -1;
+    for (uint32_t s = 0; s < q->n_sectors; s++) {
+        if (q->epoch[s] > after && (best < 0 || q->epoch[s] < q->epoch[best])) {
+            best = (int)s;
+        }
+    }
+    return best;
+}
+
+bool flash_queue_mount(flash_queue_t *q) {
+    uint16_t boot = q->boot;
+    memset(q, 0, sizeof(*q));
+    q->boot = boot;
+    q->next_seq = 1;
+
+    uint32_t n = flash_shim_size() / FLASH_SHIM_SECTOR;
+    if (n < 2) return false;
+    q->n_sectors = n > FLASH_QUEUE_MAX_SECTORS ? FLASH_QUEUE_MAX_SECTORS : n;
+
+    for (uint32_t s = 0; s < q->n_sectors; s++) {
+        sector_header_t h;
+        if (!flash_shim_read(slot_offset(s, 0), &h, sizeof(h))) return false;
+        if (h.magic != FLASH_QUEUE_MAGIC || h.crc != header_crc(&h) || h.epoch == 0) continue;
+        q->epoch[s] = h.epoch;
+        if (q->epoch[s] > q->epoch[q->head]) q->head = s;
+
+        flash_queue_record_t r;
+        uint32_t slot = 1;
+        for (; slot < FLASH_QUEUE_SLOTS && read_slot(s, slot, &r); slot++) {
+            if (!record_ok(&r)) continue;               // torn write
+            if (r.seq >= q->next_seq) q->next_seq = r.seq + 1;
+            if (r.boot > q->max_boot) q->max_boot = r.boot;
+            if (r.done == DONE_PENDING) q->pending++;
+        }
+        if (s == q->head) q->head_slot = slot;
+    }
+    if (q->epoch[q->head] == 0) {
+        q->head_slot = FLASH_QUEUE_SLOTS;               // unformatted: first append starts a sector
+    }
+    return true;
+}
+
+// Start the next sector round the ring, erasing whatever it held.
+static bool advance_head(flash_queue_t *q) {
+    uint32_t epoch = q->epoch[q->head] + 1;
+    uint32_t target = q->epoch[q->head] ? (q->head + 1) % q->n_sectors : q->head;
+
+    if (q->epoch[target]) {
+        uint32_t lost = count_pending(target);
+        q->pending -= lost;
+        q->dropped += lost;
+    }
+    q->epoch[target] = 0;
+    q->head = target;
+    q->head_slot = FLASH_QUEUE_SLOTS;                   // stays unusable if the erase fails
+
+    sector_header_t h;
+    memset(&h, 0xFF, sizeof(h));
+    h.magic = FLASH_QUEUE_MAGIC;
+    h.epoch = epoch;
+    h.crc   = header_crc(&h);
+    if (!flash_shim_erase_sector(slot_offset(target, 0)) ||
+        !flash_shim_write(slot_offset(target, 0), &h, sizeof(h))) {
+        return false;
+    }
+    q->epoch[target] = epoch;
+    q->head_slot = 1;
+    return true;
+}
+
+bool flash_queue_append(flash_queue_t *q, uint32_t t_s, uint16_t battery_mv,
+                        const uint16_t *soil_mv, size_t n_probes) {
+    if (q->n_sectors == 0) return false;
+    if (q->head_slot >= FLASH_QUEUE_SLOTS && !advance_head(q)) return false;
+
+    flash_queue_record_t r;
+    memset(&r, 0, sizeof(r));
+    r.seq        = q->next_seq;
+    r.t_s        = t_s;
+    r.boot       = q->boot;
+    r.battery_mv = battery_mv;
+    r.n_probes   = (uint8_t)(n_probes > SOIL_PROBE_MAX ? SOIL_PROBE_MAX : n_probes);
+    memcpy(r.soil_mv, soil_mv, r.n_probes * sizeof(r.soil_mv[0]));
+    r.crc        = record_crc(&r);
+    r.done       = DONE_PENDING;
+
+    // The slot is used up even if the write fails part-way; mount skips it.
+    uint32_t off = slot_offset(q->head, q->head_slot++);
+    if (!flash_shim_write(off, &r, sizeof(r))) return false;
+    q->next_seq++;
+    q->pending++;
+    return true;
+}
+
+size_t flash_queue_peek(const flash_queue_t *q, flash_queue_record_t *out,
+                        uint32_t *offsets, size_t max) {
+    size_t n = 0;
+    uint32_t epoch = 0;
+    int s;
+    while (n < max && (s = next_sector(q, epoch)) >= 0) {
+        epoch = q->epoch[s];
+        flash_queue_record_t r;
+        for (uint32_t slot = 1; n < max && slot < FLASH_QUEUE_SLOTS &&
+                                read_slot((uint32_t)s, slot, &r); slot++) {
+            if (!record_ok(&r) || r.done != DONE_PENDING) continue;
+            out[n] = r;
+            offsets[n] = slot_offset((uint32_t)s, slot);
+            n++;
+        }
+    }
+    return n;
+}
+
+bool flash_queue_mark_delivered(flash_queue_t *q, const uint32_t *offsets, size_t n) {
+    static const uint32_t done = 0;
+    for (size_t i = 0; i < n; i++) {
+        if (!flash_shim_write(offsets[i] + offsetof(flash_queue_record_t, done),
+                              &done, sizeof(done))) {
+            return false;
+        }
+        if (q->pending) q->pending--;
+    }
+    return true;
+}
+
+// One column: "<name>":[v0,v1,...] with col = -3 seq, -2 ages, -1 battery, else soil probe.
+static void encode_column(const flash_queue_record_t *recs, size_t n, uint16_t boot,
+                          uint32_t now_s, int col, telemetry_enc_t *e, const char *name) {
+    telemetry_enc_array_begin(e, name);
+    for (size_t i = 0; i < n; i++) {
+        const flash_queue_record_t *r = &recs[i];
+        int32_t v;
+        if (col == -3) {
+            v = (int32_t)r->seq;
+        } else if (col == -2) {
+            bool known = r->boot == boot && now_s >= r->t_s;
+            v = known ? (int32_t)(now_s - r->t_s) : -1;
+        } else if (col == -1) {
+            v = r->battery_mv;
+        } else {
+            v = col < r->n_probes ? r->soil_mv[col] : 0;
+        }
+        telemetry_enc_int(e, NULL, v);
+    }
+    telemetry_enc_array_end(e);
+}
+
+void flash_queue_encode(const flash_queue_record_t *recs, size_t n, uint16_t boot,
+                        uint32_t now_s, telemetry_enc_t *e) {
+    if (n == 0) return;
+    size_t n_probes = 0;
+    for (size_t i = 0; i < n; i++) {
+        if (recs[i].n_probes > n_probes) n_probes = recs[i].n_probes;
+    }
+
+    telemetry_enc_map_begin(e, "backlog");
+    encode_column(recs, n, boot, now_s, -3, e, "seq");
+    encode_column(recs, n, boot, now_s, -2, e, "age_s");
+    encode_column(recs, n, boot, now_s, -1, e, "battery_mv");
+    for (size_t p = 0; p < n_probes && p < SOIL_PROBE_COUNT; p++) {
+        char name[24];
+        snprintf(name, sizeof(name), "%s_mv", soil_probes[p].key);
+        encode_column(recs, n, boot, now_s, (int)p, e, name);
+    }
+    telemetry_enc_map_end(e);
+}
+
+#ifndef TEST_HOST
+#include "esp_attr.h"
+
+#define BOOT_GEN_MAGIC  0xB0071D01u
+
+// Power-cycle generation: RTC memory survives deep sleep but not a power cut,
+// which is also when the RTC clock restarts.
+RTC_DATA_ATTR static uint32_t s_boot_magic;
+RTC_DATA_ATTR static uint16_t s_boot_gen;
+
+static flash_queue_t s_queue;
+static bool s_mounted;
+
+flash_queue_t *flash_queue(void) {
+    if (!s_mounted) {
+        s_queue.boot = s_boot_gen;
+        if (!flash_queue_mount(&s_queue)) return NULL;
+        if (s_boot_magic != BOOT_GEN_MAGIC) {
+            s_boot_gen = (uint16_t)(s_queue.max_boot + 1);
+            s_boot_magic = BOOT_GEN_MAGIC;
+        }
+        s_queue.boot = s_boot_gen;
+        s_mounted = true;
+    }
+    return &s_queue;
+}
+#endif // TEST_HOST
@@ -0,0 +1,41 @@
+#include "flash_shim.h"
+#include "esp_partition.h"
+#include "esp_log.h"
+
+static const char *TAG = "FLASH_SHIM";
+
+#define FQUEUE_PARTITION_LABEL  "fqueue"
+
+static const esp_partition_t *part(void) {
+    static const esp_partition_t *p;
+    static bool looked;
+    if (!looked) {
+        looked = true;
+        p = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY,
+                                     FQUEUE_PARTITION_LABEL);
+        if (!p) {
+            ESP_LOGW(TAG, "No '%s' partition; offline queue disabled", FQUEUE_PARTITION_LABEL);
+        }
+    }
+    return p;
+}
+
+uint32_t flash_shim_size(void) {
+    const esp_partition_t *p = part();
+    return p ? (uint32_t)p->size : 0;
+}
+
+bool flash_shim_read(uint32_t offset, void *buf, size_t len) {
+    const esp_partition_t *p = part();
+    return p && esp_partition_read(p, offset, buf, len) == ESP_OK;
+}
+
+bool flash_shim_write(uint32_t offset, const void *buf, size_t len) {
+    const esp_partition_t *p = part();
+    return p && esp_partition_write(p, offset, buf, len) == ESP_OK;
+}
+
+bool flash_shim_erase_sector(uint32_t offset) {
+    const esp_partition_t *p = part();
+    return p && esp_partition_erase_range(p, offset, FLASH_SHIM_SECTOR) == ESP_OK;
+}
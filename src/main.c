@@ -17,11 +17,11 @@
  * 
  * Flow:
  * 1. Initialize system infrastructure (NVS, network, ADC)
- * 2. Setup WiFi (provisioning if needed)
- * 3. Connect to MQTT broker
- * 4. Read sensors and publish telemetry
- * 5. Enter deep sleep for configured interval
- * 6. Wake and repeat from step 2 (WiFi reconnect)
+ * 2. Read the battery before the radio loads it
+ * 3. Read the soil probes, setup WiFi, connect to MQTT, publish telemetry and
+ *    refresh the display - concurrently where they don't depend on each other
+ * 4. Enter deep sleep for configured interval
+ * 5. Wake and repeat from step 1
  * 
  * @author DFRobot Project
  * @date 2025
@@ -50,6 +50,16 @@
 #include "battery_soc.h"
 #include "soil_moisture.h"
 #include "soil_calibration.h"
+#include "soil_probe.h"
+#include "wake_timing.h"
+#include "wake_graph.h"
+#include "energy_model.h"
+#include "report_policy.h"
+#include "report_slot.h"
+#include "reading_buffer.h"
+#include "flash_queue.h"
+#include "sleep_schedule.h"
+#include "wake_stub.h"
 #include "display.h"
 #include "mqtt_publisher.h"
 #include "mqtt_credentials.h"  // MQTT broker credentials (not in git)
@@ -64,9 +74,55 @@ static const char *TAG = "MAIN";
 static char mqtt_topic_buffer[128] = {0};
 static char device_id_buffer[33] = {0};
 
-// Cached OCV captured at the very top of app_main(), reused by publish_telemetry_once().
+// JSON copy of the wake-timing / energy extras for the pre-sleep log. Static
+// to keep it off the main-task stack; only the main task formats it.
+static char s_extra_json[560];
+
+// Close the running timing record and charge it, plus the sleep that follows,
+// to the RTC energy ledger. No-op if no record is open.
+static void close_wake_record(uint32_t sleep_s) {
+    if (wake_timing_commit()) {
+        energy_ledger_account(wake_timing_log_last(wake_timing_log()), sleep_s);
+    }
+}
+
+// Telemetry extras covering the previous complete wakes (this one is still
+// running): "timing":{...} plus the energy estimate and sleep-clock drift
+// once they exist.
+static void encode_extra_members(telemetry_enc_t *e, void *ctx) {
+    (void)ctx;
+    wake_timing_encode(wake_timing_log(), e, "timing");
+    energy_ledger_encode(energy_ledger(), ENERGY_BATTERY_MAH, e);
+    sleep_schedule_encode(sleep_schedule(), sleep_schedule_now_ms(), e);
+    wake_stub_encode(wake_stub(), e);
+}
+
+// The same extras as JSON, for logging.
+static const char *format_extra_members(void) {
+    telemetry_enc_t e;
+    telemetry_enc_init(&e, TELEMETRY_FMT_JSON, s_extra_json, sizeof(s_extra_json));
+    encode_extra_members(&e, NULL);
+    telemetry_enc_finish(&e);
+    return s_extra_json;
+}
+
+// Cached OCV captured at the very top of app_main(), reused by publish_telemetry_once()
+// and show_telemetry().
 static float g_cached_battery_v = 0.0f;
 
+// This wake's soil readings, taken before the radio comes up so the report
+// policy can decide whether to bring it up at all.
+static struct {
+    int32_t  mv_fx[SOIL_PROBE_COUNT];
+    uint16_t mv[SOIL_PROBE_COUNT];
+    float    pct[SOIL_PROBE_COUNT];
+    uint16_t pct_x100[SOIL_PROBE_COUNT];
+} s_sample;
+
+// Full boot every this many timer wakes from the coming sleep on (wake_stub.h).
+// Raised only by a wake with nothing to report; the stub absorbs the rest.
+static uint32_t s_boot_every = 1;
+
 // Persists across deep sleep: latches when the low-battery warning has been drawn,
 // so we don't burn ~30 mJ refreshing the e-paper every hour while the cell is starved.
 RTC_DATA_ATTR static bool s_low_battery_shown = false;
@@ -92,8 +148,8 @@ RTC_NOINIT_ATTR static uint32_t s_config_request_magic;
 #define MQTT_KEEPALIVE_SEC   10                          ///< MQTT keepalive interval in seconds
 #define DEFAULT_DEVICE_ID    "moisture01"                ///< Fallback device ID if not provisioned
 #define WIFI_TIMEOUT_SEC     30                          ///< WiFi connection timeout before retry
-#define MQTT_WAIT_MS         3000                        ///< Time to wait for MQTT connection (milliseconds)
-#define PUBLISH_WAIT_MS      2000                        ///< Time to wait after publishing before sleep (milliseconds)
+#define MQTT_WAIT_MS         3000                        ///< Max wait for the MQTT connection (milliseconds)
+#define PUBLISH_WAIT_MS      2000                        ///< Max wait for the broker's PUBACK (milliseconds)
 
 // Deep Sleep Configuration
 #define DEEP_SLEEP_INTERVAL_SEC  3600                    ///< Deep sleep duration in seconds (3600 = 1 hour)
@@ -287,6 +343,7 @@ static esp_err_t setup_mqtt(void) {
     config.password = MQTT_PASSWORD;
     config.base_topic = mqtt_topic_buffer;  // Use static buffer
     config.keepalive_sec = MQTT_KEEPALIVE_SEC;
+    config.format = wifi_credentials_load_telemetry_format();
     
     esp_err_t err = mqtt_publisher_init(&config);
     if (err != ESP_OK) {
@@ -319,37 +376,59 @@ static esp_err_t setup_mqtt(void) {
  * - All initialization repeats
  * - RTC memory persists (could store data if needed)
  * 
- * @param seconds Sleep duration in seconds
+ * The wake is planned by sleep_schedule.h: `seconds` after the previous
+ * planned wake rather than after now (so time spent awake doesn't push
+ * every report later), corrected for the sleep clock's measured drift and,
+ * once SNTP has synced, on this device's wall-clock slot.
+ *
+ * @param seconds Wake interval in seconds
  * 
  * @note This function does not return - device goes to sleep
  * @note Device will appear to restart when it wakes
  * @note Battery life improvement: ~50x longer with 1 hour intervals
  */
 static void enter_deep_sleep(uint32_t seconds) {
+    sleep_schedule_cfg_t sched_cfg = sleep_schedule_default_cfg(seconds);
+    int64_t wake_ms = sleep_schedule_plan(sleep_schedule(), &sched_cfg, sleep_schedule_now_ms());
+    uint32_t sleep_s = (uint32_t)((wake_ms - sleep_schedule_now_ms() + 999) / 1000);
+
     ESP_LOGI(TAG, "========================================");
-    ESP_LOGI(TAG, "Entering deep sleep for %lu seconds (%lu minutes)",
-             seconds, seconds / 60);
-    ESP_LOGI(TAG, "Device will wake and publish again at next interval");
+    ESP_LOGI(TAG, "Entering deep sleep for %lu seconds (%lu minutes, interval %lu s)",
+             sleep_s, sleep_s / 60, seconds);
+    if (s_boot_every > 1) {
+        ESP_LOGI(TAG, "Readings quiet - wake stub absorbs the next %lu timer wake(s)",
+                 (unsigned long)(s_boot_every - 1));
+    } else {
+        ESP_LOGI(TAG, "Device will wake and publish again at next interval");
+    }
     ESP_LOGI(TAG, "========================================");
 
+    // The stub re-sleeps one drift-corrected interval at a time, so absorbed
+    // wakes stay on the cadence and the next full boot lands on a slot.
+    wake_stub_arm(wake_stub(), s_boot_every,
+                  (uint64_t)sleep_schedule_step_ms(sleep_schedule(), seconds) * 1000ULL);
+    wake_stub_install();
+
     // Clean radio/network teardown so we don't sleep with a half-open MQTT
     // session or with the WiFi modem still powered. Both helpers are no-ops
     // if their subsystems were never started.
     mqtt_publisher_stop();
     wifi_manager_stop();
 
-    // Isolate the analog input pins (battery on GPIO 0, soil AOUT on GPIO 2)
-    // so the digital pads don't leak through pull resistors in sleep.
+    // Isolate the analog input pins (battery on GPIO 0, soil AOUT per probe —
+    // ADC1 channel n is GPIO n on the C6) so the digital pads don't leak
+    // through pull resistors in sleep.
     rtc_gpio_isolate(GPIO_NUM_0);
-    rtc_gpio_isolate(GPIO_NUM_2);
-
-    // Configure wake timer
-    esp_sleep_enable_timer_wakeup(seconds * uS_TO_S_FACTOR);
+    for (size_t p = 0; p < SOIL_PROBE_COUNT; p++) {
+        rtc_gpio_isolate((gpio_num_t)soil_probes[p].adc_channel);
+    }
 
-    // Hold the soil-sensor power pin LOW across deep sleep so the sensor stays off.
+    // Hold the soil-sensor power pins LOW across deep sleep so the sensors stay off.
     // On C6, per-pin hold (gpio_hold_en) persists through deep sleep on its own —
     // the chip uses SOC_GPIO_SUPPORT_HOLD_SINGLE_IO_IN_DSLP, so no global enable is needed.
-    gpio_hold_en(GPIO_NUM_3);
+    for (size_t p = 0; p < SOIL_PROBE_COUNT; p++) {
+        gpio_hold_en((gpio_num_t)soil_probes[p].pwr_gpio);
+    }
 
     // GPIO7 = config-portal wake button (LP-capable, momentary push-to-GND, internal pull-up).
     gpio_config_t btn_conf = {
@@ -362,14 +441,21 @@ static void enter_deep_sleep(uint32_t seconds) {
     gpio_config(&btn_conf);
     esp_deep_sleep_enable_gpio_wakeup(BIT(GPIO_NUM_7), ESP_GPIO_WAKEUP_GPIO_LOW);
 
-    // Optional: Print wake time for debugging
-    int64_t now_us = esp_timer_get_time();
-    int64_t wake_us = now_us + (seconds * uS_TO_S_FACTOR);
-    ESP_LOGI(TAG, "Current time: %lld µs", now_us);
-    ESP_LOGI(TAG, "Wake time: %lld µs", wake_us);
+    // Close this wake's timing record; it rides along in the next wake's telemetry.
+    close_wake_record(sleep_s + (s_boot_every - 1) * seconds);
+    ESP_LOGI(TAG, "Wake timing/energy: %s", format_extra_members());
+    ESP_LOGI(TAG, "Wake at system time %lld ms", wake_ms);
     
     // Flush logs before sleeping
     vTaskDelay(pdMS_TO_TICKS(100));
+
+    // Configure wake timer last, so the teardown above comes out of the
+    // planned sleep rather than adding to it
+    int64_t sleep_ms = wake_ms - sleep_schedule_now_ms();
+    if (sleep_ms < 1000) {
+        sleep_ms = 1000;
+    }
+    esp_sleep_enable_timer_wakeup((uint64_t)sleep_ms * 1000ULL);
     
     // Enter deep sleep - does not return
     esp_deep_sleep_start();
@@ -379,83 +465,303 @@ static void enter_deep_sleep(uint32_t seconds) {
 // Telemetry Publishing
 // ============================================================================
 
+/**
+ * @brief Read every soil probe into s_sample (one shared power window)
+ */
+static void read_soil_sample(void) {
+    wake_timing_start(WAKE_PHASE_SENSE);
+    soil_moisture_read_probes_fx(s_sample.mv_fx, SOIL_PROBE_COUNT, NULL, 0);
+    for (size_t p = 0; p < SOIL_PROBE_COUNT; p++) {
+        int dry = (int)soil_calibration_get_probe_dry_mv(p);
+        int wet = (int)soil_calibration_get_probe_wet_mv(p);
+        s_sample.mv[p]       = (uint16_t)SOIL_MV_FX_TO_MV(s_sample.mv_fx[p]);
+        s_sample.pct[p]      = soil_moisture_calc_percentage_fx(s_sample.mv_fx[p], dry, wet);
+        s_sample.pct_x100[p] = soil_moisture_calc_pct_x100(s_sample.mv_fx[p], dry, wet);
+    }
+    wake_timing_stop(WAKE_PHASE_SENSE);
+}
+
+static int battery_mv(float v) {
+    return (int)(v * 1000.0f + 0.5f);
+}
+
+// Move undelivered readings from the RTC ring into the flash queue, where
+// they survive a power cut and leave the ring free for new ones.
+static void spill_readings(void) {
+    reading_buffer_t *rb = reading_buffer();
+    flash_queue_t *q = flash_queue();
+    if (!q || rb->count == 0) {
+        return;
+    }
+    size_t moved = 0;
+    for (; moved < rb->count; moved++) {
+        const reading_t *r = reading_buffer_at(rb, moved);
+        if (!flash_queue_append(q, rb->base_s + r->t_off_s, r->battery_mv,
+                                r->soil_mv, rb->n_probes)) {
+            break;
+        }
+    }
+    if (moved < rb->count) {
+        ESP_LOGE(TAG, "Flash queue write failed after %u reading(s); keeping them in RTC", (unsigned)moved);
+        return;
+    }
+    reading_buffer_clear(rb, SOIL_PROBE_COUNT);
+    ESP_LOGI(TAG, "Queued %u reading(s) in flash (%lu pending, %lu dropped)", (unsigned)moved,
+             (unsigned long)q->pending, (unsigned long)q->dropped);
+}
+
+typedef struct {
+    const flash_queue_record_t *recs;
+    size_t   n;
+    uint16_t boot;
+    uint32_t now_s;
+} backlog_batch_t;
+
+static void encode_backlog(telemetry_enc_t *e, void *ctx) {
+    const backlog_batch_t *b = ctx;
+    flash_queue_encode(b->recs, b->n, b->boot, b->now_s, e);
+}
+
+// Send queued readings while the connection is up, FLASH_QUEUE_BATCH per
+// message. Each batch is marked delivered only once acked.
+static void drain_backlog(void) {
+    flash_queue_t *q = flash_queue();
+    if (!q || q->pending == 0) {
+        return;
+    }
+    static flash_queue_record_t recs[FLASH_QUEUE_BATCH];   // static: 1 KB
+    static uint32_t offsets[FLASH_QUEUE_BATCH];
+    for (int i = 0; i < FLASH_QUEUE_DRAIN_BATCHES && q->pending; i++) {
+        backlog_batch_t b = {
+            .recs  = recs,
+            .n     = flash_queue_peek(q, recs, offsets, FLASH_QUEUE_BATCH),
+            .boot  = q->boot,
+            .now_s = report_policy_now_s(),
+        };
+        if (b.n == 0) {
+            break;
+        }
+        if (mqtt_publisher_publish_backlog(device_id_buffer, encode_backlog, &b) != ESP_OK ||
+            mqtt_publisher_wait_acked(PUBLISH_WAIT_MS) != ESP_OK) {
+            ESP_LOGW(TAG, "Backlog batch not acked - will resend next wake");
+            return;
+        }
+        flash_queue_mark_delivered(q, offsets, b.n);
+    }
+    ESP_LOGI(TAG, "Backlog sent; %lu reading(s) still queued", (unsigned long)q->pending);
+}
+
 /**
  * @brief Publish single telemetry reading
  * 
- * Performs one-time telemetry reading and publishing, then prepares for deep sleep:
+ * Publishes the readings already taken this wake, then prepares for deep sleep:
  * 1. Waits for MQTT connection (with timeout)
- * 2. Reads battery voltage
- * 3. Reads soil moisture percentage
- * 4. Publishes telemetry data to MQTT
- * 5. Waits briefly for publish to complete
+ * 2. Publishes the cached OCV and s_sample soil readings to MQTT, plus the
+ *    RTC reading buffer as a "batch" member
+ * 3. Waits for the broker's PUBACK (with timeout)
+ * 4. Clears the buffer, records the publish with the report policy and drains
+ *    any readings queued in flash by failed wakes
  * 
  * Single Responsibility: One-time telemetry collection and publishing
  * 
  * @return ESP_OK if telemetry published successfully
- * @return ESP_FAIL if MQTT not connected or publish failed
+ * @return ESP_FAIL if MQTT not connected, publish failed or was not acked
  * 
  * @note Called once per wake cycle before deep sleep
  * @note Does not loop - publishes once and returns
- * @note MQTT connection happens asynchronously, so we wait briefly
+ * @note Both waits return the moment their event arrives
  */
 static esp_err_t publish_telemetry_once(void) {
     ESP_LOGI(TAG, "Waiting for MQTT connection...");
     
     // Wait for MQTT to connect (up to MQTT_WAIT_MS)
-    int wait_count = 0;
-    int max_wait = MQTT_WAIT_MS / 100;  // Check every 100ms
+    wake_timing_start(WAKE_PHASE_CONNECT);
+    bool connected = mqtt_publisher_wait_connected(MQTT_WAIT_MS);
+    wake_timing_stop(WAKE_PHASE_CONNECT);
     
-    while (!mqtt_publisher_is_connected() && wait_count < max_wait) {
-        vTaskDelay(pdMS_TO_TICKS(100));
-        wait_count++;
-    }
-    
-    if (!mqtt_publisher_is_connected()) {
+    if (!connected) {
         ESP_LOGW(TAG, "MQTT connection timeout - will retry on next wake");
+        wifi_manager_forget_fast_path();   // a stale reused IP looks exactly like this
         return ESP_FAIL;
     }
     
-    ESP_LOGI(TAG, "MQTT connected, reading sensors...");
-    
     // Battery voltage was captured at the top of app_main() before WiFi powered up,
     // so it reflects open-circuit voltage rather than the sagging-under-load value.
+    // Soil was read there too, before the report policy decided to come online.
     float voltage = g_cached_battery_v;
     
-    // Read soil moisture
-    float soil_moisture = soil_moisture_read_percentage();
-    
     // Publish telemetry
-    ESP_LOGI(TAG, "Publishing telemetry: Battery=%.2fV, Moisture=%.1f%%", 
-             voltage, soil_moisture);
+    ESP_LOGI(TAG, "Publishing telemetry: Battery=%.2fV, Moisture=%.1f%% (%d probe%s)", 
+             voltage, s_sample.pct[0], SOIL_PROBE_COUNT, SOIL_PROBE_COUNT == 1 ? "" : "s");
     
-    esp_err_t err = mqtt_publisher_publish_telemetry(voltage, soil_moisture, device_id_buffer);
+    wake_timing_start(WAKE_PHASE_PUBLISH);
+    uint32_t now_s = report_policy_now_s();
+    esp_err_t err = mqtt_publisher_publish_telemetry(battery_mv(voltage), s_sample.pct_x100,
+                                                     SOIL_PROBE_COUNT, reading_buffer(), now_s,
+                                                     device_id_buffer, encode_extra_members, NULL);
     if (err != ESP_OK) {
+        wake_timing_stop(WAKE_PHASE_PUBLISH);
         ESP_LOGE(TAG, "Failed to publish telemetry");
         return ESP_FAIL;
     }
     
-    // Wait a bit for message to be sent
-    ESP_LOGI(TAG, "Waiting for publish to complete...");
-    vTaskDelay(pdMS_TO_TICKS(PUBLISH_WAIT_MS));
+    // Sleep as soon as the broker has it. Unacked counts as not delivered:
+    // the batch and report-policy state stay as they are for the next wake.
+    ESP_LOGI(TAG, "Waiting for PUBACK...");
+    err = mqtt_publisher_wait_acked(PUBLISH_WAIT_MS);
+    wake_timing_stop(WAKE_PHASE_PUBLISH);
+    if (err != ESP_OK) {
+        ESP_LOGW(TAG, "No PUBACK within %d ms - will resend next wake", PUBLISH_WAIT_MS);
+        return ESP_FAIL;
+    }
 
     ESP_LOGI(TAG, "Telemetry published successfully");
+    reading_buffer_clear(reading_buffer(), SOIL_PROBE_COUNT);
+    report_policy_note_published(report_policy_state(), s_sample.pct_x100, SOIL_PROBE_COUNT,
+                                 battery_mv(voltage), now_s);
+
+    // The link is proven good: catch up on readings queued by failed wakes.
+    wake_timing_start(WAKE_PHASE_PUBLISH);
+    drain_backlog();
+    wake_timing_stop(WAKE_PHASE_PUBLISH);
+
+    return ESP_OK;
+}
 
-    // Refresh the e-paper with the values we just published.
+// Refresh the e-paper with this wake's readings (probe 0).
+static void show_telemetry(void) {
+    float voltage = g_cached_battery_v;
     display_telemetry_t dt = {
         .device_id     = device_id_buffer,
-        .moisture_pct  = soil_moisture,
-        .raw_mv        = soil_moisture_read_raw_mv(),
+        .moisture_pct  = s_sample.pct[0],
+        .raw_mv        = SOIL_MV_FX_TO_MV(s_sample.mv_fx[0]),
         .battery_v     = voltage,
-        .battery_pct   = display_battery_v_to_pct(voltage),
+        .battery_pct   = display_battery_mv_to_pct(battery_mv(voltage)),
         .wifi_rssi_dbm = wifi_manager_get_rssi(),
     };
-    if (display_init() == ESP_OK) {
-        display_show_telemetry(&dt);
-        display_deinit();
+    wake_timing_start(WAKE_PHASE_DISPLAY);
+    display_show_telemetry(&dt);
+    wake_timing_stop(WAKE_PHASE_DISPLAY);
+}
+
+// ============================================================================
+// Wake Pipeline (WiFi build)
+// ============================================================================
+// The WiFi wake as a dependency graph (wake_graph.h): sensing overlaps
+// association when the report is due anyway, and the e-paper refresh runs
+// alongside the broker connect and PUBACK wait. Each node runs in its own
+// task; they share s_sample, device_id_buffer and the timing record, which
+// the graph orders (or wake_timing locks).
+
+#ifndef USE_ZIGBEE
+static const report_policy_cfg_t s_report_cfg = REPORT_POLICY_CFG_DEFAULT;
+
+typedef struct {
+    float ocv;
+    report_reason_t why;            ///< Set by the sense node
+} wake_ctx_t;
+
+// Read the probes into the RTC reading buffer and let the report policy
+// decide whether this wake is worth the radio. Unchanged readings stay
+// buffered until the batch is due; the display still shows the last report.
+static bool wake_sense(void *ctx) {
+    wake_ctx_t *w = ctx;
+    read_soil_sample();
+    uint32_t now_s = report_policy_now_s();
+    reading_buffer_t *rb = reading_buffer();
+    reading_buffer_push(rb, now_s, battery_mv(w->ocv), s_sample.mv, SOIL_PROBE_COUNT);
+    w->why = report_policy_decide(report_policy_state(), &s_report_cfg, s_sample.pct_x100,
+                                  SOIL_PROBE_COUNT, battery_mv(w->ocv), now_s);
+    if (w->why == REPORT_SKIP && !reading_buffer_due(rb)) {
+        return false;
     }
+    ESP_LOGI(TAG, "Reporting %u reading%s: %s", rb->count, rb->count == 1 ? "" : "s",
+             w->why == REPORT_SKIP ? "batch due" : report_policy_reason_name(w->why));
+    return true;
+}
 
-    return ESP_OK;
+static bool wake_net(void *ctx) {
+    (void)ctx;
+    wake_timing_start(WAKE_PHASE_NET);
+    esp_err_t err = setup_wifi();
+    wake_timing_stop(WAKE_PHASE_NET);
+    return err == ESP_OK;
+}
+
+static bool wake_broker(void *ctx) {
+    (void)ctx;
+    wake_timing_start(WAKE_PHASE_BROKER);
+    esp_err_t err = setup_mqtt();
+    wake_timing_stop(WAKE_PHASE_BROKER);
+    return err == ESP_OK;
+}
+
+static bool wake_publish(void *ctx) {
+    (void)ctx;
+    return publish_telemetry_once() == ESP_OK;
+}
+
+static bool wake_display(void *ctx) {
+    (void)ctx;
+    show_telemetry();
+    return true;
+}
+
+// Refresh the sleep schedule's wall clock when due. Never fails the wake:
+// without a sync the schedule keeps its cadence on the last drift estimate.
+static bool wake_clock(void *ctx) {
+    (void)ctx;
+    if (sleep_schedule_sync_due(sleep_schedule(), sleep_schedule_now_ms())) {
+        sleep_schedule_sync_sntp();
+    }
+    return true;
+}
+
+// Seconds until the report heartbeat is due; 0 if it already is. A quiet
+// run must end in a full boot by then.
+static uint32_t heartbeat_headroom_s(void) {
+    const report_policy_state_t *st = report_policy_state();
+    uint32_t now_s = report_policy_now_s();
+    if (!report_policy_valid(st) || now_s < st->published_s) {
+        return 0;
+    }
+    uint32_t since = now_s - st->published_s;
+    return since < s_report_cfg.heartbeat_s ? s_report_cfg.heartbeat_s - since : 0;
+}
+
+// True when the report policy will report whatever the probes read, so
+// association need not wait for them.
+static bool report_certain(float ocv) {
+    const reading_buffer_t *rb = reading_buffer();
+    if (reading_buffer_valid(rb) && rb->n_probes == SOIL_PROBE_COUNT &&
+        rb->count + 1 >= READING_BATCH_SIZE) {
+        return true;                        // this reading completes the batch
+    }
+    return report_policy_decide_early(report_policy_state(), &s_report_cfg, SOIL_PROBE_COUNT,
+                                      battery_mv(ocv), report_policy_now_s()) != REPORT_SKIP;
+}
+
+// Run one WiFi wake. Returns the nodes that succeeded (WAKE_GRAPH_DEP bits).
+static uint32_t run_wake_pipeline(wake_ctx_t *w) {
+    static const wake_graph_fn run[WAKE_NODE_COUNT] = {
+        [WAKE_NODE_SENSE]   = wake_sense,
+        [WAKE_NODE_NET]     = wake_net,
+        [WAKE_NODE_BROKER]  = wake_broker,
+        [WAKE_NODE_PUBLISH] = wake_publish,
+        [WAKE_NODE_DISPLAY] = wake_display,
+        [WAKE_NODE_CLOCK]   = wake_clock,
+    };
+    wake_graph_node_t nodes[WAKE_NODE_COUNT];
+    bool net_first = report_certain(w->ocv);
+    wake_pipeline_init(nodes, run, net_first);
+    if (net_first) {
+        ESP_LOGI(TAG, "Report due regardless of readings - WiFi starts alongside sensing");
+    }
+    const wake_graph_t g = { .node = nodes, .n = WAKE_NODE_COUNT };
+    sleep_schedule();                       // validate before the clock and publish nodes share it
+    return wake_graph_run(&g, w);
 }
+#endif /* USE_ZIGBEE */
 
 // ============================================================================
 // Portal Mode
@@ -463,10 +769,7 @@ static esp_err_t publish_telemetry_once(void) {
 
 static void run_portal_then_sleep(void) {
     ESP_LOGI(TAG, "Entering config portal");
-    if (display_init() == ESP_OK) {
-        display_show_portal();
-        display_deinit();
-    }
+    display_show_portal();
     config_portal_run();   // blocks until save or timeout
     enter_deep_sleep(DEEP_SLEEP_INTERVAL_SEC);
 }
@@ -555,7 +858,7 @@ static void setup_config_button(void)
 /* --- Periodic report task ----------------------------------------------------
  * The Zigbee reporter fires a cheap "tick" in the stack main-loop context on the
  * report schedule (zb_report_tick). Doing the work there would stall keep-alives
- * and frame handling — the soil read alone blocks ~150 ms warming the sensor, and
+ * and frame handling — the soil read alone blocks up to ~300 ms warming the sensor, and
  * the SSD1680 full refresh ~2 s. So the tick only signals this task, which:
  *   1. samples every sensor exactly ONCE — a single soil power-up yields both the
  *      raw mV and the %, so the display and the Zigbee report can't disagree;
@@ -564,6 +867,8 @@ static void setup_config_button(void)
  */
 static SemaphoreHandle_t s_report_sem = NULL;
 
+#define ZB_BATTERY_SAMPLES  8    ///< Battery codes captured in the soil burst
+
 static void zb_report_tick(void)
 {
     /* Zigbee stack task context (scheduler alarm) — keep it cheap: just wake the
@@ -573,6 +878,13 @@ static void zb_report_tick(void)
     }
 }
 
+// Re-establish both sensors on a freshly rebuilt ADC unit (resume slow path).
+static void zb_reconfigure_sensors(void)
+{
+    soil_moisture_reconfigure();
+    battery_monitor_reconfigure();
+}
+
 static void zb_report_task(void *pv)
 {
     (void)pv;
@@ -580,30 +892,53 @@ static void zb_report_task(void *pv)
         if (xSemaphoreTake(s_report_sem, portMAX_DELAY) != pdTRUE) {
             continue;
         }
-
-        // The soil ADC channel's analog state does not survive C6 light sleep
-        // (post-sleep reads rail to >4000 mV → 0%), and re-priming the channel
-        // alone doesn't recover it. Fully rebuild the shared ADC unit each cycle
-        // and re-establish both sensors on the fresh handle before sampling.
-        if (adc_manager_reinit() == ESP_OK) {
-            soil_moisture_reconfigure();
-            battery_monitor_reconfigure();
-        } else {
-            ESP_LOGE(TAG, "ADC reinit failed — readings may be invalid this cycle");
-        }
-
-        // One soil power-up: derive both raw mV and % from the same sample, so
+        wake_timing_begin(false);
+
+        // The soil ADC channel's analog state does not always survive C6 light
+        // sleep (post-sleep reads rail to >4000 mV → 0%), and re-priming the
+        // channel alone doesn't recover it. Arm a check of the powered soil
+        // burst below: only if it comes back railed is the shared unit rebuilt
+        // (and both sensors re-established on the fresh handle) and resampled.
+        wake_timing_start(WAKE_PHASE_ADC);
+        adc_manager_resume(zb_reconfigure_sensors);
+        wake_timing_stop(WAKE_PHASE_ADC);
+
+        // One power-up for every probe: derive both raw mV and % from the same sample, so
         // the reported value and the displayed value are guaranteed consistent.
-        int   raw_mv      = soil_moisture_read_raw_mv();
-        float soil_pct    = soil_moisture_calc_percentage(
-                                raw_mv,
-                                (int)soil_calibration_get_dry_mv(),
-                                (int)soil_calibration_get_wet_mv());
-        float battery_v   = battery_monitor_read_voltage();
-        float battery_pct = battery_monitor_v_to_pct(battery_v);
+        // The battery channel rides along in the same DMA burst.
+        wake_timing_start(WAKE_PHASE_SENSE);
+        int bat_codes[ZB_BATTERY_SAMPLES];
+        adc_frame_lane_t bat_lane;
+        battery_monitor_scan_lane(&bat_lane, bat_codes, ZB_BATTERY_SAMPLES);
+        int32_t  mv_fx[SOIL_PROBE_COUNT];
+        uint16_t soil_x100[SOIL_PROBE_COUNT];
+        soil_moisture_read_probes_fx(mv_fx, SOIL_PROBE_COUNT, &bat_lane, 1);
+        adc_manager_resume_stats_t rs;
+        adc_manager_get_resume_stats(&rs);
+        ESP_LOGI(TAG, "ADC resume: %s %lu us (fast %lu x avg %lu us, rebuild %lu x avg %lu us)",
+                 rs.last_rebuilt ? "rebuild" : "fast",
+                 (unsigned long)(rs.last_rebuilt ? rs.last_rebuild_us : rs.last_fast_us),
+                 (unsigned long)rs.fast_count,
+                 (unsigned long)(rs.fast_count ? rs.total_fast_us / rs.fast_count : 0),
+                 (unsigned long)rs.rebuild_count,
+                 (unsigned long)(rs.rebuild_count ? rs.total_rebuild_us / rs.rebuild_count : 0));
+        int      raw_mv    = SOIL_MV_FX_TO_MV(mv_fx[0]);
+        // Integer all the way to the ZCL attributes: no soft-float on this core.
+        for (size_t p = 0; p < SOIL_PROBE_COUNT; p++) {
+            soil_x100[p] = soil_moisture_calc_pct_x100(
+                                mv_fx[p],
+                                (int)soil_calibration_get_probe_dry_mv(p),
+                                (int)soil_calibration_get_probe_wet_mv(p));
+        }
+        int      battery_mv   = bat_lane.count ? battery_monitor_mv_from_lane(&bat_lane)
+                                               : battery_monitor_read_mv();
+        uint16_t battery_x100 = battery_monitor_mv_to_pct_x100(battery_mv);
+        wake_timing_stop(WAKE_PHASE_SENSE);
 
         // Push to Zigbee (takes the Zigbee lock — we are not the stack task).
-        zigbee_reporter_report(soil_pct, battery_v, battery_pct);
+        wake_timing_start(WAKE_PHASE_PUBLISH);
+        zigbee_reporter_report(soil_x100, SOIL_PROBE_COUNT, battery_mv, battery_x100);
+        wake_timing_stop(WAKE_PHASE_PUBLISH);
 
         // After the first good report on a freshly-OTA'd image, confirm it so
         // the bootloader keeps the new slot; otherwise it auto-reverts on reboot.
@@ -616,16 +951,28 @@ static void zb_report_task(void *pv)
         // Refresh the e-paper with the SAME sample.
         display_telemetry_t dt = {
             .device_id     = device_id_buffer,
-            .moisture_pct  = soil_pct,
+            .moisture_pct  = (float)soil_x100[0] / 100.0f,
             .raw_mv        = raw_mv,
-            .battery_v     = battery_v,
-            .battery_pct   = (int)(battery_pct + 0.5f),
+            .battery_v     = (float)battery_mv / 1000.0f,
+            .battery_pct   = (battery_x100 + 50) / 100,
             .wifi_rssi_dbm = 0,   // no WiFi in Zigbee mode
         };
-        if (display_init() == ESP_OK) {
-            display_show_telemetry(&dt);
-            display_deinit();
-        }
+        wake_timing_start(WAKE_PHASE_DISPLAY);
+        display_show_telemetry(&dt);
+        wake_timing_stop(WAKE_PHASE_DISPLAY);
+
+        // Close the cycle, charge it (plus the light sleep until the next one)
+        // to the energy ledger, and expose both summaries on the manufacturer
+        // attributes (read on demand by the z2m converter). The radio is idle
+        // by now, so this cycle's battery read stands in for the OCV.
+        close_wake_record(ZIGBEE_REPORT_INTERVAL_SEC);
+        energy_ledger_begin(battery_x100);
+        uint8_t timing_zcl[WAKE_TIMING_PACK_LEN + 1];
+        wake_timing_pack_zcl(wake_timing_log(), timing_zcl);
+        zigbee_reporter_set_wake_timing(timing_zcl);
+        const energy_ledger_t *led = energy_ledger();
+        zigbee_reporter_set_energy(energy_ledger_mean_nah(led),
+                                   energy_ledger_days_remaining_x10(led, ENERGY_BATTERY_MAH));
     }
 }
 #endif /* USE_ZIGBEE */
@@ -647,6 +994,8 @@ static void zb_report_task(void *pv)
  * 2. Connect to WiFi (credentials persist in NVS)
  * 3. Connect to MQTT broker
  * 4. Publish single telemetry reading
+ *    (steps 2-4 run with the soil read and display refresh as the wake
+ *    pipeline, run_wake_pipeline())
  * 5. Enter deep sleep for DEEP_SLEEP_INTERVAL_SEC
  * 6. Wake and repeat from step 1
  * 
@@ -666,12 +1015,15 @@ static void zb_report_task(void *pv)
  * @note WiFi credentials and device ID persist across sleep
  * 
  * Extension Guide:
- * - Add new sensors: Initialize in init_system(), read in publish_telemetry_once()
+ * - Add new sensors: Initialize in init_system(), read in read_soil_sample()
  * - Change sleep interval: Modify DEEP_SLEEP_INTERVAL_SEC
  * - Add RTC memory: Use RTC_DATA_ATTR for data persistence across sleep
  * - Disable deep sleep: Call telemetry_loop() instead of publish + sleep
  */
 void app_main(void) {
+    // Time this wake from boot; committed in enter_deep_sleep() (WiFi) or just
+    // before the Zigbee stack starts and the report task takes over the timer.
+    wake_timing_begin(true);
     ESP_LOGI(TAG, "=== DFR-MoistureTracker Starting ===");
     ESP_LOGI(TAG, "Wake from deep sleep - initializing...");
     
@@ -693,7 +1045,10 @@ void app_main(void) {
     }
     
     // Step 1: Initialize system infrastructure
-    if (init_system() != ESP_OK) {
+    wake_timing_start(WAKE_PHASE_INIT);
+    esp_err_t init_err = init_system();
+    wake_timing_stop(WAKE_PHASE_INIT);
+    if (init_err != ESP_OK) {
         ESP_LOGE(TAG, "System initialization failed, entering sleep anyway");
         enter_deep_sleep(DEEP_SLEEP_INTERVAL_SEC);
         return;  // Never reached
@@ -717,10 +1072,7 @@ void app_main(void) {
     if (s_config_request_magic == CONFIG_REQUEST_MAGIC) {
         s_config_request_magic = 0;   // clear first so a crash mid-portal returns to normal
         ESP_LOGI(TAG, "Entering config portal (button-triggered)");
-        if (display_init() == ESP_OK) {
-            display_show_portal();
-            display_deinit();
-        }
+        display_show_portal();
         config_portal_run();   // blocks until a save handler restarts, or idle timeout
         esp_restart();         // idle-timeout path: reboot back into Zigbee
     }
@@ -730,18 +1082,19 @@ void app_main(void) {
     // Zero-load battery sample: must happen before WiFi/MQTT energize.
     // init_system() only touches NVS, event loop, and ADC — no radio yet.
     // ------------------------------------------------------------------
+    wake_timing_start(WAKE_PHASE_OCV);
     float ocv = battery_monitor_read_voltage();
+    wake_timing_stop(WAKE_PHASE_OCV);
     ESP_LOGI(TAG, "OCV: %.3fV (%.0f%% SoC)", ocv, battery_monitor_v_to_pct(ocv));
+    // Cross-check the modelled charge against the OCV trend (RTC ledger).
+    energy_ledger_begin(battery_monitor_mv_to_pct_x100(battery_mv(ocv)));
 
     if (!battery_monitor_is_safe(ocv)) {
         ESP_LOGE(TAG, "*** LOW BATTERY %.2fV < %.2fV - skipping WiFi/MQTT ***",
                  ocv, BATTERY_LOW_CUTOFF_V);
         if (!s_low_battery_shown) {
             s_low_battery_shown = true;     // latch first, refresh second
-            if (display_init() == ESP_OK) {
-                display_show_low_battery(ocv);
-                display_deinit();
-            }
+            display_show_low_battery(ocv);
         }
         enter_deep_sleep(DEEP_SLEEP_INTERVAL_SEC);
         return;
@@ -772,6 +1125,11 @@ void app_main(void) {
     }
 
     zigbee_reporter_set_interval_ms((uint32_t)ZIGBEE_REPORT_INTERVAL_SEC * 1000U);
+    zigbee_reporter_set_report_offset_ms(
+        report_slot_device_offset_ms((uint32_t)ZIGBEE_REPORT_INTERVAL_SEC * 1000U));
+
+    // Boot record (boot/init/ocv) goes in before the report task starts its own.
+    close_wake_record(0);
 
     if (zigbee_reporter_init() != ESP_OK) {
         ESP_LOGE(TAG, "Zigbee init failed, sleeping");
@@ -796,36 +1154,48 @@ void app_main(void) {
      * called inside zigbee_reporter.c — no loop or sleep needed here. */
     return;
 #else
-    // Step 2: Setup WiFi (handles provisioning if needed)
-    if (setup_wifi() != ESP_OK) {
-        ESP_LOGE(TAG, "WiFi setup failed, entering sleep");
+    // Steps 2-5: sense, decide, WiFi, MQTT, publish and refresh the display,
+    // overlapped where the dependency graph allows (run_wake_pipeline()).
+    wake_ctx_t w = { .ocv = ocv };
+    uint32_t ok = run_wake_pipeline(&w);
+    if (!(ok & WAKE_GRAPH_DEP(WAKE_NODE_SENSE))) {
+        reading_buffer_t *rb = reading_buffer();
+        report_policy_note_skipped(report_policy_state());
+        ESP_LOGI(TAG, "Readings unchanged (%.1f%%, %.2fV) - buffered %u/%d, skipping report",
+                 s_sample.pct[0], ocv, rb->count, READING_BATCH_SIZE);
+        wake_stub_note_quiet(wake_stub());
+        s_boot_every = wake_stub_boot_every(wake_stub(), DEEP_SLEEP_INTERVAL_SEC,
+                                            heartbeat_headroom_s());
         enter_deep_sleep(DEEP_SLEEP_INTERVAL_SEC);
         return;  // Never reached
     }
-
-    // Step 3: Setup MQTT
-    if (setup_mqtt() != ESP_OK) {
-        ESP_LOGE(TAG, "MQTT setup failed, entering sleep");
-        enter_deep_sleep(DEEP_SLEEP_INTERVAL_SEC);
-        return;  // Never reached
+    if (w.why != REPORT_SKIP && w.why != REPORT_HEARTBEAT) {
+        wake_stub_note_change(wake_stub());     // something moved: boot every wake again
     }
-
-    ESP_LOGI(TAG, "=== Initialization Complete ===");
-
-    // Step 4: Publish telemetry once
-    esp_err_t err = publish_telemetry_once();
-    if (err != ESP_OK) {
+    if (!(ok & WAKE_GRAPH_DEP(WAKE_NODE_NET))) {
+        ESP_LOGE(TAG, "WiFi setup failed, entering sleep");
+    } else if (!(ok & WAKE_GRAPH_DEP(WAKE_NODE_BROKER))) {
+        ESP_LOGE(TAG, "MQTT setup failed, entering sleep");
+    } else if (!(ok & WAKE_GRAPH_DEP(WAKE_NODE_PUBLISH))) {
         ESP_LOGW(TAG, "Telemetry publish failed, but continuing to sleep");
     }
+    if (!(ok & WAKE_GRAPH_DEP(WAKE_NODE_PUBLISH))) {
+        spill_readings();
+    }
 
 #ifdef DISABLE_DEEP_SLEEP
     ESP_LOGW(TAG, "DISABLE_DEEP_SLEEP set - looping publish every %d ms", TEST_PUBLISH_INTERVAL_MS);
     while (1) {
+        close_wake_record(0);   // one record per publish cycle; the bench build never sleeps
         vTaskDelay(pdMS_TO_TICKS(TEST_PUBLISH_INTERVAL_MS));
-        publish_telemetry_once();
+        wake_timing_begin(false);
+        read_soil_sample();     // bench loop always publishes; no report policy
+        if (publish_telemetry_once() == ESP_OK) {
+            show_telemetry();
+        }
     }
 #else
-    // Step 5: Enter deep sleep
+    // Step 6: Enter deep sleep
     enter_deep_sleep(DEEP_SLEEP_INTERVAL_SEC);
 
     // This line is never reached - device enters deep sleep
@@ -0,0 +1,49 @@
+#include "mqtt_ack.h"
+#include <string.h>
+
+void mqtt_ack_reset(mqtt_ack_t *t) {
+    memset(t, 0, sizeof(*t));
+}
+
+// Remove ids[i] from a list of n, keeping the order.
+static void remove_at(int *ids, size_t *n, size_t i) {
+    memmove(&ids[i], &ids[i + 1], (*n - i - 1) * sizeof(ids[0]));
+    (*n)--;
+}
+
+bool mqtt_ack_add(mqtt_ack_t *t, int msg_id) {
+    if (msg_id <= 0) {
+        return true;
+    }
+    for (size_t i = 0; i < t->n_early; i++) {
+        if (t->early[i] == msg_id) {
+            remove_at(t->early, &t->n_early, i);
+            return true;
+        }
+    }
+    if (t->n_pending >= MQTT_ACK_MAX) {
+        return false;
+    }
+    t->pending[t->n_pending++] = msg_id;
+    return true;
+}
+
+bool mqtt_ack_complete(mqtt_ack_t *t, int msg_id) {
+    for (size_t i = 0; i < t->n_pending; i++) {
+        if (t->pending[i] == msg_id) {
+            remove_at(t->pending, &t->n_pending, i);
+            return true;
+        }
+    }
+    // Not added yet (or a stray/duplicate ack): remember it, dropping the
+    // oldest once full.
+    if (t->n_early == MQTT_ACK_MAX) {
+        remove_at(t->early, &t->n_early, 0);
+    }
+    t->early[t->n_early++] = msg_id;
+    return false;
+}
+
+size_t mqtt_ack_pending(const mqtt_ack_t *t) {
+    return t->n_pending;
+}
@@ -1,12 +1,51 @@
 #include "mqtt_publisher.h"
+#include "mqtt_ack.h"
+#include "soil_probe.h"
 #include "mqtt_client.h"
 #include "esp_log.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/event_groups.h"
+#include "freertos/semphr.h"
 #include <stdio.h>
 
+#define MQTT_CONNECTED_BIT  BIT0
+#define MQTT_ACKED_BIT      BIT1     ///< Set while no QoS 1 publish awaits its PUBACK
+
 static const char *TAG = "MQTT_PUB";
 static esp_mqtt_client_handle_t client = NULL;
 static bool mqtt_connected = false;
 static const char *base_topic = NULL;
+static telemetry_fmt_t s_format = TELEMETRY_FMT_JSON;
+static char s_cbor_topic[136];
+static char s_backlog_topic[144];
+
+// Shared by the telemetry and backlog publishes. Both run in sequence from
+// one task: the wake graph's publish node (wake_publish in main.c), or the
+// main task in the DISABLE_DEEP_SLEEP bench loop after the graph has finished.
+// Static: with the batch and timing/energy members this doesn't fit on a
+// WAKE_PIPELINE_STACK node task.
+static uint8_t s_payload[2048];
+static EventGroupHandle_t s_mqtt_events = NULL;
+static SemaphoreHandle_t s_ack_lock = NULL;  // guards s_acks and MQTT_ACKED_BIT together
+static mqtt_ack_t s_acks;
+
+// Apply a tracker update and keep MQTT_ACKED_BIT in step with it.
+static void ack_update(bool publish, int msg_id) {
+    xSemaphoreTake(s_ack_lock, portMAX_DELAY);
+    if (publish) {
+        if (!mqtt_ack_add(&s_acks, msg_id)) {
+            ESP_LOGW(TAG, "Too many unacked publishes; msg %d not tracked", msg_id);
+        }
+    } else {
+        mqtt_ack_complete(&s_acks, msg_id);
+    }
+    if (mqtt_ack_pending(&s_acks) == 0) {
+        xEventGroupSetBits(s_mqtt_events, MQTT_ACKED_BIT);
+    } else {
+        xEventGroupClearBits(s_mqtt_events, MQTT_ACKED_BIT);
+    }
+    xSemaphoreGive(s_ack_lock);
+}
 
 // MQTT event handler
 static void mqtt_event_handler(void *handler_args, esp_event_base_t base, 
@@ -17,11 +56,18 @@ static void mqtt_event_handler(void *handler_args, esp_event_base_t base,
         case MQTT_EVENT_CONNECTED:
             ESP_LOGI(TAG, "MQTT connected");
             mqtt_connected = true;
+            xEventGroupSetBits(s_mqtt_events, MQTT_CONNECTED_BIT);
             break;
 
         case MQTT_EVENT_DISCONNECTED:
             ESP_LOGI(TAG, "MQTT disconnected");
             mqtt_connected = false;
+            xEventGroupClearBits(s_mqtt_events, MQTT_CONNECTED_BIT);
+            break;
+
+        case MQTT_EVENT_PUBLISHED:
+            ESP_LOGD(TAG, "PUBACK for msg %d", event->msg_id);
+            ack_update(false, event->msg_id);
             break;
             
         case MQTT_EVENT_ERROR:
@@ -42,6 +88,28 @@ esp_err_t mqtt_publisher_init(const mqtt_config_t *config) {
     ESP_LOGI(TAG, "Initializing MQTT client");
     
     base_topic = config->base_topic;
+    s_format = config->format;
+    // Keep CBOR off the JSON topic so z2m-style consumers never see binary.
+    const char *cbor_suffix = s_format == TELEMETRY_FMT_CBOR ? "/cbor" : "";
+    int n = snprintf(s_cbor_topic, sizeof(s_cbor_topic), "%s/cbor", base_topic);
+    int m = snprintf(s_backlog_topic, sizeof(s_backlog_topic), "%s/backlog%s", base_topic, cbor_suffix);
+    if (n < 0 || n >= (int)sizeof(s_cbor_topic) || m < 0 || m >= (int)sizeof(s_backlog_topic)) {
+        ESP_LOGE(TAG, "Base topic too long for subtopics");
+        return ESP_ERR_INVALID_ARG;
+    }
+    ESP_LOGI(TAG, "Telemetry format: %s", telemetry_fmt_name(s_format));
+
+    if (!s_mqtt_events) {
+        s_mqtt_events = xEventGroupCreate();
+        s_ack_lock = xSemaphoreCreateMutex();
+        if (!s_mqtt_events || !s_ack_lock) {
+            ESP_LOGE(TAG, "Failed to create MQTT sync objects");
+            return ESP_ERR_NO_MEM;
+        }
+    }
+    mqtt_ack_reset(&s_acks);
+    xEventGroupClearBits(s_mqtt_events, MQTT_CONNECTED_BIT);
+    xEventGroupSetBits(s_mqtt_events, MQTT_ACKED_BIT);
     
     esp_mqtt_client_config_t mqtt_cfg = {
         .broker.address.uri = config->broker_uri,
@@ -77,6 +145,24 @@ bool mqtt_publisher_is_connected(void) {
     return mqtt_connected;
 }
 
+bool mqtt_publisher_wait_connected(uint32_t timeout_ms) {
+    if (!s_mqtt_events) {
+        return false;
+    }
+    EventBits_t bits = xEventGroupWaitBits(s_mqtt_events, MQTT_CONNECTED_BIT, pdFALSE, pdFALSE,
+                                           pdMS_TO_TICKS(timeout_ms));
+    return (bits & MQTT_CONNECTED_BIT) != 0;
+}
+
+esp_err_t mqtt_publisher_wait_acked(uint32_t timeout_ms) {
+    if (!s_mqtt_events) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    EventBits_t bits = xEventGroupWaitBits(s_mqtt_events, MQTT_ACKED_BIT, pdFALSE, pdFALSE,
+                                           pdMS_TO_TICKS(timeout_ms));
+    return (bits & MQTT_ACKED_BIT) ? ESP_OK : ESP_ERR_TIMEOUT;
+}
+
 void mqtt_publisher_stop(void) {
     if (!client) {
         return;
@@ -86,9 +172,41 @@ void mqtt_publisher_stop(void) {
     esp_mqtt_client_destroy(client);
     client = NULL;
     mqtt_connected = false;
+    if (s_mqtt_events) {
+        mqtt_ack_reset(&s_acks);
+        xEventGroupClearBits(s_mqtt_events, MQTT_CONNECTED_BIT);
+        xEventGroupSetBits(s_mqtt_events, MQTT_ACKED_BIT);
+    }
+}
+
+// Finish an encoded s_payload and publish it at QoS 1, tracking the msg_id.
+static esp_err_t publish_encoded(telemetry_enc_t *e, const char *topic) {
+    int len = telemetry_enc_finish(e);
+    if (len < 0) {
+        ESP_LOGE(TAG, "Failed to format payload");
+        return ESP_FAIL;
+    }
+    
+    if (s_format == TELEMETRY_FMT_CBOR) {
+        ESP_LOGI(TAG, "Publishing %d bytes of CBOR to %s", len, topic);
+    } else {
+        ESP_LOGI(TAG, "Publishing to %s: %s", topic, (const char *)s_payload);
+    }
+    
+    int msg_id = esp_mqtt_client_publish(client, topic, (const char *)s_payload, len, 1, 0);
+    if (msg_id < 0) {
+        ESP_LOGE(TAG, "Failed to publish message");
+        return ESP_FAIL;
+    }
+    ack_update(true, msg_id);
+    
+    return ESP_OK;
 }
 
-esp_err_t mqtt_publisher_publish_telemetry(float battery_voltage, float soil_moisture, const char *device_name) {
+esp_err_t mqtt_publisher_publish_telemetry(int battery_mv, const uint16_t *soil_pct_x100,
+                                           size_t n_probes, const reading_buffer_t *batch,
+                                           uint32_t now_s, const char *device_name,
+                                           mqtt_publisher_extra_fn extra, void *extra_ctx) {
     if (!client || !mqtt_connected) {
         ESP_LOGW(TAG, "MQTT not connected, skipping publish");
         return ESP_FAIL;
@@ -98,25 +216,47 @@ esp_err_t mqtt_publisher_publish_telemetry(float battery_voltage, float soil_moi
         ESP_LOGE(TAG, "Base topic not configured");
         return ESP_ERR_INVALID_STATE;
     }
-    
-    // Format JSON payload
-    char payload[192];
-    int len = snprintf(payload, sizeof(payload), 
-                      "{\"battery\":%.2f,\"soil_moisture\":%.1f,\"device\":\"%s\"}", 
-                      battery_voltage, soil_moisture, device_name);
-    
-    if (len < 0 || len >= sizeof(payload)) {
-        ESP_LOGE(TAG, "Failed to format payload");
-        return ESP_FAIL;
+    if (!soil_pct_x100 || n_probes == 0 || n_probes > SOIL_PROBE_COUNT) {
+        return ESP_ERR_INVALID_ARG;
     }
     
-    ESP_LOGI(TAG, "Publishing: %s", payload);
-    
-    int msg_id = esp_mqtt_client_publish(client, base_topic, payload, 0, 1, 0);
-    if (msg_id < 0) {
-        ESP_LOGE(TAG, "Failed to publish message");
+    // One field per probe, keyed from the probe table (probe 0 keeps the
+    // original "soil_moisture" key). Rounded to the precision the old %.2f /
+    // %.1f payload carried.
+    telemetry_enc_t e;
+    telemetry_enc_init(&e, s_format, s_payload, sizeof(s_payload));
+    telemetry_enc_map_begin(&e, NULL);
+    telemetry_enc_fixed(&e, "battery", (battery_mv + 5) / 10, 2);
+    for (size_t p = 0; p < n_probes; p++) {
+        telemetry_enc_fixed(&e, soil_probes[p].key, (soil_pct_x100[p] + 5) / 10, 1);
+    }
+    if (batch) {
+        reading_buffer_encode(batch, now_s, &e);
+    }
+    if (extra) {
+        extra(&e, extra_ctx);
+    }
+    telemetry_enc_str(&e, "device", device_name);
+    telemetry_enc_map_end(&e);
+    return publish_encoded(&e, s_format == TELEMETRY_FMT_CBOR ? s_cbor_topic : base_topic);
+}
+
+esp_err_t mqtt_publisher_publish_backlog(const char *device_name,
+                                         mqtt_publisher_extra_fn members, void *ctx) {
+    if (!client || !mqtt_connected) {
+        ESP_LOGW(TAG, "MQTT not connected, skipping publish");
         return ESP_FAIL;
     }
-    
-    return ESP_OK;
+    if (!base_topic) {
+        ESP_LOGE(TAG, "Base topic not configured");
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    telemetry_enc_t e;
+    telemetry_enc_init(&e, s_format, s_payload, sizeof(s_payload));
+    telemetry_enc_map_begin(&e, NULL);
+    members(&e, ctx);
+    telemetry_enc_str(&e, "device", device_name);
+    telemetry_enc_map_end(&e);
+    return publish_encoded(&e, s_backlog_topic);
 }
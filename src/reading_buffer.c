@@ -0,0 +1,117 @@
+#include "reading_buffer.h"
+#include "crc32.h"
+#include <stdio.h>
+#include <string.h>
+
+static uint32_t ring_crc(const reading_buffer_t *rb) {
+    return crc32_update(0, rb, offsetof(reading_buffer_t, crc));
+}
+
+static uint16_t clamp_u16(int v) {
+    return (uint16_t)(v < 0 ? 0 : v > UINT16_MAX ? UINT16_MAX : v);
+}
+
+void reading_buffer_clear(reading_buffer_t *rb, size_t n_probes) {
+    if (n_probes > SOIL_PROBE_MAX) n_probes = SOIL_PROBE_MAX;
+    memset(rb, 0, sizeof(*rb));
+    rb->magic    = READING_BUFFER_MAGIC;
+    rb->n_probes = (uint16_t)n_probes;
+    rb->crc      = ring_crc(rb);
+}
+
+bool reading_buffer_valid(const reading_buffer_t *rb) {
+    return rb->magic == READING_BUFFER_MAGIC &&
+           rb->head < READING_BUFFER_CAP && rb->count <= READING_BUFFER_CAP &&
+           rb->n_probes >= 1 && rb->n_probes <= SOIL_PROBE_MAX &&
+           rb->crc == ring_crc(rb);
+}
+
+void reading_buffer_push(reading_buffer_t *rb, uint32_t now_s, int battery_mv,
+                         const uint16_t *soil_mv, size_t n_probes) {
+    if (!reading_buffer_valid(rb) || rb->n_probes != n_probes ||
+        (rb->count && now_s < rb->base_s)) {
+        reading_buffer_clear(rb, n_probes);
+    }
+    if (rb->count == 0) {
+        rb->base_s = now_s;
+    }
+
+    reading_t *r = &rb->rec[rb->head];
+    memset(r, 0, sizeof(*r));
+    r->t_off_s    = now_s - rb->base_s;
+    r->battery_mv = clamp_u16(battery_mv);
+    memcpy(r->soil_mv, soil_mv, rb->n_probes * sizeof(uint16_t));
+
+    rb->head = (uint16_t)((rb->head + 1) % READING_BUFFER_CAP);
+    if (rb->count < READING_BUFFER_CAP) {
+        rb->count++;
+    } else {
+        rb->overwritten++;
+    }
+    rb->crc = ring_crc(rb);
+}
+
+bool reading_buffer_due(const reading_buffer_t *rb) {
+    return reading_buffer_valid(rb) && rb->count >= READING_BATCH_SIZE;
+}
+
+const reading_t *reading_buffer_at(const reading_buffer_t *rb, size_t i) {
+    size_t oldest = (rb->head + READING_BUFFER_CAP - rb->count) % READING_BUFFER_CAP;
+    return &rb->rec[(oldest + i) % READING_BUFFER_CAP];
+}
+
+// One column: "<name>":[v0,v1,...] with col = -2 ages, -1 battery, else soil probe.
+static void encode_column(const reading_buffer_t *rb, uint32_t now_s, int col,
+                          telemetry_enc_t *e, const char *name) {
+    telemetry_enc_array_begin(e, name);
+    for (size_t i = 0; i < rb->count; i++) {
+        const reading_t *r = reading_buffer_at(rb, i);
+        uint32_t v;
+        if (col == -2) {
+            uint32_t t = rb->base_s + r->t_off_s;
+            v = now_s > t ? now_s - t : 0;
+            if (v > INT32_MAX) v = INT32_MAX;
+        } else if (col == -1) {
+            v = r->battery_mv;
+        } else {
+            v = r->soil_mv[col];
+        }
+        telemetry_enc_int(e, NULL, (int32_t)v);
+    }
+    telemetry_enc_array_end(e);
+}
+
+void reading_buffer_encode(const reading_buffer_t *rb, uint32_t now_s, telemetry_enc_t *e) {
+    if (!reading_buffer_valid(rb) || rb->count == 0) return;
+
+    telemetry_enc_map_begin(e, "batch");
+    encode_column(rb, now_s, -2, e, "age_s");
+    encode_column(rb, now_s, -1, e, "battery_mv");
+    for (size_t p = 0; p < rb->n_probes && p < SOIL_PROBE_COUNT; p++) {
+        char name[24];
+        snprintf(name, sizeof(name), "%s_mv", soil_probes[p].key);
+        encode_column(rb, now_s, (int)p, e, name);
+    }
+    telemetry_enc_map_end(e);
+}
+
+int reading_buffer_format_json(const reading_buffer_t *rb, uint32_t now_s,
+                               char *buf, size_t len) {
+    telemetry_enc_t e;
+    telemetry_enc_init(&e, TELEMETRY_FMT_JSON, buf, len);
+    reading_buffer_encode(rb, now_s, &e);
+    return telemetry_enc_finish(&e);
+}
+
+#ifndef TEST_HOST
+#include "esp_attr.h"
+
+RTC_DATA_ATTR static reading_buffer_t s_ring;
+
+reading_buffer_t *reading_buffer(void) {
+    if (!reading_buffer_valid(&s_ring)) {
+        reading_buffer_clear(&s_ring, SOIL_PROBE_COUNT);
+    }
+    return &s_ring;
+}
+#endif // TEST_HOST
@@ -0,0 +1,114 @@
+#include "report_policy.h"
+#include "crc32.h"
+#include <string.h>
+
+static uint32_t state_crc(const report_policy_state_t *st) {
+    return crc32_update(0, st, offsetof(report_policy_state_t, crc));
+}
+
+const char *report_policy_reason_name(report_reason_t r) {
+    switch (r) {
+    case REPORT_SKIP:      return "skip";
+    case REPORT_FIRST:     return "first";
+    case REPORT_SOIL:      return "soil";
+    case REPORT_BATTERY:   return "battery";
+    case REPORT_HEARTBEAT: return "heartbeat";
+    }
+    return "?";
+}
+
+bool report_policy_valid(const report_policy_state_t *st) {
+    return st->magic == REPORT_POLICY_MAGIC &&
+           st->n_probes >= 1 && st->n_probes <= SOIL_PROBE_MAX &&
+           st->crc == state_crc(st);
+}
+
+static int absdiff(int a, int b) {
+    return a > b ? a - b : b - a;
+}
+
+// Triggers that don't depend on the readings.
+static report_reason_t decide_unread(const report_policy_state_t *st,
+                                     const report_policy_cfg_t *cfg,
+                                     size_t n_probes, uint32_t now_s) {
+    if (!report_policy_valid(st) || st->n_probes != n_probes) {
+        return REPORT_FIRST;
+    }
+    // A clock that went backwards can't vouch for the heartbeat.
+    if (now_s < st->published_s || now_s - st->published_s >= cfg->heartbeat_s) {
+        return REPORT_HEARTBEAT;
+    }
+    return REPORT_SKIP;
+}
+
+report_reason_t report_policy_decide_early(const report_policy_state_t *st,
+                                           const report_policy_cfg_t *cfg,
+                                           size_t n_probes, int battery_mv, uint32_t now_s) {
+    report_reason_t why = decide_unread(st, cfg, n_probes, now_s);
+    if (why != REPORT_SKIP) {
+        return why;
+    }
+    if (cfg->soil_delta_x100 == 0 && n_probes > 0) {
+        return REPORT_SOIL;                         // any reading will do
+    }
+    if (absdiff(battery_mv, st->battery_mv) >= cfg->battery_delta_mv) {
+        return REPORT_BATTERY;
+    }
+    return REPORT_SKIP;
+}
+
+report_reason_t report_policy_decide(const report_policy_state_t *st,
+                                     const report_policy_cfg_t *cfg,
+                                     const uint16_t *soil_pct_x100, size_t n_probes,
+                                     int battery_mv, uint32_t now_s) {
+    report_reason_t why = decide_unread(st, cfg, n_probes, now_s);
+    if (why != REPORT_SKIP) {
+        return why;
+    }
+    for (size_t p = 0; p < n_probes; p++) {
+        if (absdiff(soil_pct_x100[p], st->soil_pct_x100[p]) >= cfg->soil_delta_x100) {
+            return REPORT_SOIL;
+        }
+    }
+    if (absdiff(battery_mv, st->battery_mv) >= cfg->battery_delta_mv) {
+        return REPORT_BATTERY;
+    }
+    return REPORT_SKIP;
+}
+
+void report_policy_note_published(report_policy_state_t *st,
+                                  const uint16_t *soil_pct_x100, size_t n_probes,
+                                  int battery_mv, uint32_t now_s) {
+    if (n_probes > SOIL_PROBE_MAX) n_probes = SOIL_PROBE_MAX;
+    memset(st, 0, sizeof(*st));
+    st->magic       = REPORT_POLICY_MAGIC;
+    st->published_s = now_s;
+    memcpy(st->soil_pct_x100, soil_pct_x100, n_probes * sizeof(uint16_t));
+    st->battery_mv  = (uint16_t)(battery_mv < 0 ? 0 : battery_mv > UINT16_MAX ? UINT16_MAX : battery_mv);
+    st->n_probes    = (uint16_t)n_probes;
+    st->crc         = state_crc(st);
+}
+
+void report_policy_note_skipped(report_policy_state_t *st) {
+    if (!report_policy_valid(st)) return;
+    st->skipped++;
+    st->crc = state_crc(st);
+}
+
+#ifndef TEST_HOST
+#include <sys/time.h>
+#include "esp_attr.h"
+
+RTC_DATA_ATTR static report_policy_state_t s_state;
+
+uint32_t report_policy_now_s(void) {
+    // The system clock is kept by the RTC timer through deep sleep.
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    return (uint32_t)tv.tv_sec;
+}
+
+report_policy_state_t *report_policy_state(void) {
+    return &s_state;
+}
+#endif // TEST_HOST
@@ -0,0 +1,55 @@
+#include "report_slot.h"
+
+uint32_t report_slot_hash(const void *key, size_t len) {
+    const uint8_t *p = (const uint8_t *)key;
+    uint32_t h = 2166136261u;                       // FNV-1a
+    while (len--) {
+        h = (h ^ *p++) * 16777619u;
+    }
+    // FNV alone leaves the low bits weakly mixed for keys that differ only in
+    // their last byte; finish with the MurmurHash3 avalanche.
+    h ^= h >> 16;
+    h *= 0x85EBCA6Bu;
+    h ^= h >> 13;
+    h *= 0xC2B2AE35u;
+    h ^= h >> 16;
+    return h;
+}
+
+uint32_t report_slot_index(const void *key, size_t len, uint32_t n_slots) {
+    if (n_slots == 0) return 0;
+    // Multiply-shift rather than %: uses the high bits and has no modulo bias.
+    return (uint32_t)(((uint64_t)report_slot_hash(key, len) * n_slots) >> 32);
+}
+
+uint32_t report_slot_offset_ms(uint32_t slot, uint32_t n_slots, uint32_t interval_ms) {
+    if (n_slots == 0 || slot >= n_slots) return 0;
+    return (uint32_t)((uint64_t)interval_ms * slot / n_slots);
+}
+
+uint32_t report_slot_delay_ms(int64_t now_ms, uint32_t interval_ms, uint32_t offset_ms) {
+    if (interval_ms == 0) return 0;
+    int64_t interval = interval_ms;
+    int64_t phase = (now_ms - (int64_t)(offset_ms % interval_ms)) % interval;
+    if (phase < 0) phase += interval;
+    int64_t delay = interval - phase;               // (0, interval]
+    if (delay < interval / 2) delay += interval;
+    return (uint32_t)delay;
+}
+
+#ifndef TEST_HOST
+#include "esp_log.h"
+#include "esp_mac.h"
+
+static const char *TAG = "REPORT_SLOT";
+
+uint32_t report_slot_device_offset_ms(uint32_t interval_ms) {
+    uint8_t mac[6] = {0};
+    esp_read_mac(mac, ESP_MAC_WIFI_STA);
+    uint32_t slot = report_slot_index(mac, sizeof(mac), REPORT_SLOTS);
+    uint32_t offset = report_slot_offset_ms(slot, REPORT_SLOTS, interval_ms);
+    ESP_LOGI(TAG, "Report slot %lu/%u: +%lu ms into each %lu ms interval",
+             (unsigned long)slot, REPORT_SLOTS, (unsigned long)offset, (unsigned long)interval_ms);
+    return offset;
+}
+#endif // TEST_HOST
@@ -0,0 +1,91 @@
+#include "sample_reduce.h"
+#include <stdint.h>
+
+// Bursts are 5-32 samples: insertion sort beats anything clever at that size
+// and needs no scratch.
+static void sort_ints(int *a, size_t n) {
+    for (size_t i = 1; i < n; i++) {
+        int v = a[i];
+        size_t j = i;
+        while (j > 0 && a[j - 1] > v) {
+            a[j] = a[j - 1];
+            j--;
+        }
+        a[j] = v;
+    }
+}
+
+// Median of an already-sorted buffer; even N averages the middle pair.
+static int sorted_median(const int *a, size_t n) {
+    if (n & 1) return a[n / 2];
+    return (a[n / 2 - 1] + a[n / 2]) / 2;
+}
+
+int sample_reduce_mean(const int *buf, size_t n) {
+    if (!buf || n == 0) return -1;
+    int64_t sum = 0;
+    for (size_t i = 0; i < n; i++) sum += buf[i];
+    return (int)(sum / (int64_t)n);
+}
+
+int sample_reduce_median(int *buf, size_t n) {
+    if (!buf || n == 0) return -1;
+    sort_ints(buf, n);
+    return sorted_median(buf, n);
+}
+
+int sample_reduce_trimmed_mean(int *buf, size_t n, size_t trim) {
+    if (!buf || n == 0) return -1;
+    sort_ints(buf, n);
+    // Never trim the buffer away entirely — degrade towards the median.
+    while (trim > 0 && 2 * trim >= n) trim--;
+    return sample_reduce_mean(buf + trim, n - 2 * trim);
+}
+
+size_t sample_reduce_reject_outliers(int *buf, size_t n, int k_x10) {
+    if (!buf || n == 0) return 0;
+    if (n > SAMPLE_REDUCE_MAX_N) n = SAMPLE_REDUCE_MAX_N;
+    sort_ints(buf, n);
+    int med = sorted_median(buf, n);
+
+    int dev[SAMPLE_REDUCE_MAX_N];
+    for (size_t i = 0; i < n; i++) {
+        int d = buf[i] - med;
+        dev[i] = d < 0 ? -d : d;
+    }
+    sort_ints(dev, n);
+    int mad = sorted_median(dev, n);
+    if (mad < 1) mad = 1;   // over half the burst is identical: allow 1-LSB noise
+
+    // Keep |x - med| <= K * sigma, with sigma ~= 1.4826 * MAD, all in integers:
+    //   |x - med| * 10 * 10000 <= k_x10 * MAD * 14826
+    int64_t limit = (int64_t)k_x10 * mad * 14826;
+    size_t kept = 0;
+    for (size_t i = 0; i < n; i++) {
+        int d = buf[i] - med;
+        if (d < 0) d = -d;
+        if ((int64_t)d * 100000 <= limit) {
+            buf[kept++] = buf[i];
+        }
+    }
+    // The samples nearest the median always pass, so kept >= 1.
+    return kept;
+}
+
+int sample_reduce_mad(int *buf, size_t n, int k_x10) {
+    size_t kept = sample_reduce_reject_outliers(buf, n, k_x10);
+    if (kept == 0) return -1;
+    return sample_reduce_mean(buf, kept);
+}
+
+int sample_reduce(int *buf, size_t n) {
+#if SAMPLE_REDUCE_ALGO == SAMPLE_REDUCE_MEDIAN
+    return sample_reduce_median(buf, n);
+#elif SAMPLE_REDUCE_ALGO == SAMPLE_REDUCE_TRIMMED
+    return sample_reduce_trimmed_mean(buf, n, SAMPLE_REDUCE_TRIM);
+#elif SAMPLE_REDUCE_ALGO == SAMPLE_REDUCE_MAD
+    return sample_reduce_mad(buf, n, SAMPLE_REDUCE_MAD_K_X10);
+#else
+    return sample_reduce_mean(buf, n);
+#endif
+}
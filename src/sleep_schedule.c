@@ -0,0 +1,195 @@
+#include "sleep_schedule.h"
+#include "crc32.h"
+#include <string.h>
+
+#define PPM  1000000LL
+
+static uint32_t state_crc(const sleep_schedule_t *s) {
+    return crc32_update(0, s, offsetof(sleep_schedule_t, crc));
+}
+
+static void seal(sleep_schedule_t *s) {
+    s->crc = state_crc(s);
+}
+
+void sleep_schedule_reset(sleep_schedule_t *s) {
+    memset(s, 0, sizeof(*s));
+    s->magic = SLEEP_SCHEDULE_MAGIC;
+    seal(s);
+}
+
+bool sleep_schedule_valid(const sleep_schedule_t *s) {
+    return s->magic == SLEEP_SCHEDULE_MAGIC && s->crc == state_crc(s);
+}
+
+bool sleep_schedule_sync_due(const sleep_schedule_t *s, int64_t now_ms) {
+    if (s->try_ms && now_ms >= s->try_ms &&
+        now_ms - s->try_ms < (int64_t)SNTP_RETRY_S * 1000) {
+        return false;                               // don't hammer an unreachable server
+    }
+    return s->syncs == 0 || now_ms < s->sync_sys_ms ||
+           now_ms - s->sync_sys_ms >= (int64_t)SNTP_SYNC_INTERVAL_S * 1000;
+}
+
+void sleep_schedule_note_try(sleep_schedule_t *s, int64_t now_ms) {
+    s->try_ms = now_ms;
+    seal(s);
+}
+
+void sleep_schedule_note_sync(sleep_schedule_t *s, int64_t now_ms, int64_t wall_ms) {
+    int64_t span = now_ms - s->sync_sys_ms;
+    if (s->syncs > 0 && span >= (int64_t)SLEEP_DRIFT_MIN_SPAN_S * 1000) {
+        int64_t ppm = ((wall_ms - s->sync_wall_ms) - span) * PPM / span;
+        if (ppm > SLEEP_DRIFT_MAX_PPM)  ppm = SLEEP_DRIFT_MAX_PPM;
+        if (ppm < -SLEEP_DRIFT_MAX_PPM) ppm = -SLEEP_DRIFT_MAX_PPM;
+        // Average with the last estimate: SNTP jitter and a day's
+        // temperature swing both move single measurements about.
+        s->drift_ppm = s->drifts ? (int32_t)((s->drift_ppm + ppm) / 2) : (int32_t)ppm;
+        s->drifts++;
+    }
+    s->sync_sys_ms  = now_ms;
+    s->sync_wall_ms = wall_ms;
+    s->syncs++;
+    seal(s);
+}
+
+bool sleep_schedule_wall_ms(const sleep_schedule_t *s, int64_t now_ms, int64_t *wall_ms) {
+    if (s->syncs == 0) return false;
+    int64_t elapsed = now_ms - s->sync_sys_ms;
+    *wall_ms = s->sync_wall_ms + elapsed + elapsed * s->drift_ppm / PPM;
+    return true;
+}
+
+// Real-time milliseconds as system-clock milliseconds.
+static int64_t to_sys(const sleep_schedule_t *s, int64_t real_ms) {
+    return real_ms * PPM / (PPM + s->drift_ppm);
+}
+
+int64_t sleep_schedule_step_ms(const sleep_schedule_t *s, uint32_t interval_s) {
+    return to_sys(s, (int64_t)interval_s * 1000);
+}
+
+static int64_t floor_div(int64_t a, int64_t b) {
+    int64_t q = a / b;
+    return (a % b != 0 && (a < 0) != (b < 0)) ? q - 1 : q;
+}
+
+int64_t sleep_schedule_plan(sleep_schedule_t *s, const sleep_schedule_cfg_t *cfg,
+                            int64_t now_ms) {
+    int64_t interval = (int64_t)cfg->interval_s * 1000;
+    int64_t min      = (int64_t)cfg->min_sleep_s * 1000;
+    int64_t wall;
+    int64_t target;
+
+    if (cfg->align && interval > 0) {
+        // Next slot boundary (plus this device's offset) at least `min` away.
+        // Until the first sync the slots are on the system clock: still a
+        // fixed cadence, and still spread across a fleet powered up together.
+        if (!sleep_schedule_wall_ms(s, now_ms, &wall)) {
+            wall = now_ms;
+        }
+        int64_t phase = (int64_t)(cfg->jitter_s % cfg->interval_s) * 1000;
+        int64_t slot  = (floor_div(wall + min - phase, interval) + 1) * interval + phase;
+        target = now_ms + to_sys(s, slot - wall);
+    } else {
+        // Keep the cadence of the last plan. A planned wake still ahead (an
+        // early button wake) stands; one already past rolls on by whole
+        // intervals; one too far out means the clock moved, so restart.
+        int64_t step = to_sys(s, interval);
+        target = s->next_ms;
+        if (target == 0 || target - now_ms > step + min) {
+            target = now_ms + step;
+        }
+        if (step > 0 && target - now_ms < min) {
+            target += (floor_div(now_ms + min - target, step) + 1) * step;
+        }
+    }
+    s->next_ms = target;
+    seal(s);
+    return target;
+}
+
+void sleep_schedule_encode(const sleep_schedule_t *s, int64_t now_ms, telemetry_enc_t *e) {
+    if (s->syncs == 0) return;
+    int64_t age = (now_ms - s->sync_sys_ms) / 1000;
+    telemetry_enc_map_begin(e, "clock");
+    telemetry_enc_int(e, "drift_ppm", s->drift_ppm);
+    telemetry_enc_int(e, "sync_age_s", age < 0 ? -1 : age > INT32_MAX ? INT32_MAX : (int32_t)age);
+    telemetry_enc_map_end(e);
+}
+
+#ifndef TEST_HOST
+#include <sys/time.h>
+#include "esp_attr.h"
+#include "esp_log.h"
+#include "esp_netif_sntp.h"
+#include "esp_sntp.h"
+#include "report_slot.h"
+
+static const char *TAG = "SLEEP_SCHED";
+
+RTC_DATA_ATTR static sleep_schedule_t s_sched;
+
+// Filled by sntp_sync_time() from the lwIP task, read after the sync wait.
+static volatile int64_t s_sntp_wall_ms;
+static volatile int64_t s_sntp_sys_ms;
+
+static bool s_checked;
+
+// Checked once per boot: afterwards a sync on one wake task may be
+// mid-update while another reads the drift for telemetry.
+sleep_schedule_t *sleep_schedule(void) {
+    if (!s_checked) {
+        if (!sleep_schedule_valid(&s_sched)) {
+            sleep_schedule_reset(&s_sched);
+        }
+        s_checked = true;
+    }
+    return &s_sched;
+}
+
+int64_t sleep_schedule_now_ms(void) {
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    return (int64_t)tv.tv_sec * 1000 + tv.tv_usec / 1000;
+}
+
+sleep_schedule_cfg_t sleep_schedule_default_cfg(uint32_t interval_s) {
+    return (sleep_schedule_cfg_t){
+        .interval_s  = interval_s,
+        .min_sleep_s = SLEEP_MIN_S < interval_s ? SLEEP_MIN_S : interval_s / 2,
+        .align       = SLEEP_ALIGN_TO_SLOTS,
+        .jitter_s    = report_slot_device_offset_ms(interval_s * 1000u) / 1000u,
+    };
+}
+
+// Replaces ESP-IDF's weak default, which would settimeofday(): the system
+// clock must stay continuous for report_policy and reading_buffer, so the
+// SNTP time is only captured here.
+void sntp_sync_time(struct timeval *tv) {
+    s_sntp_sys_ms  = sleep_schedule_now_ms();
+    s_sntp_wall_ms = (int64_t)tv->tv_sec * 1000 + tv->tv_usec / 1000;
+    sntp_set_sync_status(SNTP_SYNC_STATUS_COMPLETED);
+}
+
+bool sleep_schedule_sync_sntp(void) {
+    esp_sntp_config_t config = ESP_NETIF_SNTP_DEFAULT_CONFIG(SNTP_SERVER);
+    sleep_schedule_note_try(sleep_schedule(), sleep_schedule_now_ms());
+    s_sntp_wall_ms = 0;
+    if (esp_netif_sntp_init(&config) != ESP_OK) {
+        return false;
+    }
+    bool ok = esp_netif_sntp_sync_wait(pdMS_TO_TICKS(SNTP_TIMEOUT_MS)) == ESP_OK &&
+              s_sntp_wall_ms != 0;
+    esp_netif_sntp_deinit();
+    if (!ok) {
+        ESP_LOGW(TAG, "No SNTP reply from %s within %d ms", SNTP_SERVER, SNTP_TIMEOUT_MS);
+        return false;
+    }
+    sleep_schedule_t *s = sleep_schedule();
+    sleep_schedule_note_sync(s, s_sntp_sys_ms, s_sntp_wall_ms);
+    ESP_LOGI(TAG, "SNTP sync %lu: sleep clock drift %ld ppm",
+             (unsigned long)s->syncs, (long)s->drift_ppm);
+    return true;
+}
+#endif // TEST_HOST
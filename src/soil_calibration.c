@@ -1,7 +1,7 @@
 #include "soil_calibration.h"
+#include "soil_probe.h"
 #include "nvs_shim.h"
 
-#define NS          "soil_cal"
 #define KEY_DRY     "dry_mv"
 #define KEY_WET     "wet_mv"
 #define KEY_TS      "cal_ts"
@@ -10,32 +10,56 @@
 #define DEFAULT_WET 0
 #define DEFAULT_TS  0
 
-static uint32_t s_dry = DEFAULT_DRY;
-static uint32_t s_wet = DEFAULT_WET;
-static uint32_t s_ts  = DEFAULT_TS;
+typedef struct { uint32_t dry; uint32_t wet; uint32_t ts; } cal_t;
+
+static cal_t s_cal[SOIL_PROBE_COUNT];
 
 void soil_calibration_init(void) {
-    uint32_t v;
-    s_dry = nvs_shim_get_u32(NS, KEY_DRY, &v) ? v : DEFAULT_DRY;
-    s_wet = nvs_shim_get_u32(NS, KEY_WET, &v) ? v : DEFAULT_WET;
-    s_ts  = nvs_shim_get_u32(NS, KEY_TS,  &v) ? v : DEFAULT_TS;
+    for (size_t p = 0; p < SOIL_PROBE_COUNT; p++) {
+        const char *ns = soil_probes[p].cal_ns;
+        uint32_t v;
+        s_cal[p].dry = nvs_shim_get_u32(ns, KEY_DRY, &v) ? v : DEFAULT_DRY;
+        s_cal[p].wet = nvs_shim_get_u32(ns, KEY_WET, &v) ? v : DEFAULT_WET;
+        s_cal[p].ts  = nvs_shim_get_u32(ns, KEY_TS,  &v) ? v : DEFAULT_TS;
+    }
+}
+
+uint32_t soil_calibration_get_probe_dry_mv(size_t probe) {
+    return probe < SOIL_PROBE_COUNT ? s_cal[probe].dry : DEFAULT_DRY;
+}
+uint32_t soil_calibration_get_probe_wet_mv(size_t probe) {
+    return probe < SOIL_PROBE_COUNT ? s_cal[probe].wet : DEFAULT_WET;
+}
+uint32_t soil_calibration_get_probe_cal_ts(size_t probe) {
+    return probe < SOIL_PROBE_COUNT ? s_cal[probe].ts : DEFAULT_TS;
 }
 
-uint32_t soil_calibration_get_dry_mv(void) { return s_dry; }
-uint32_t soil_calibration_get_wet_mv(void) { return s_wet; }
-uint32_t soil_calibration_get_cal_ts(void) { return s_ts;  }
+uint32_t soil_calibration_get_dry_mv(void) { return soil_calibration_get_probe_dry_mv(0); }
+uint32_t soil_calibration_get_wet_mv(void) { return soil_calibration_get_probe_wet_mv(0); }
+uint32_t soil_calibration_get_cal_ts(void) { return soil_calibration_get_probe_cal_ts(0); }
 
 // Not atomic across the three keys — a mid-save NVS failure leaves the
 // namespace partially updated, and the in-RAM cache stays stale until the
 // next init re-reads NVS and defaults whichever keys are missing.
-bool soil_calibration_save(uint32_t dry_mv, uint32_t wet_mv, uint32_t cal_ts) {
-    if (!nvs_shim_set_u32(NS, KEY_DRY, dry_mv)) return false;
-    if (!nvs_shim_set_u32(NS, KEY_WET, wet_mv)) return false;
-    if (!nvs_shim_set_u32(NS, KEY_TS,  cal_ts)) return false;
-    s_dry = dry_mv; s_wet = wet_mv; s_ts = cal_ts;
+bool soil_calibration_save_probe(size_t probe, uint32_t dry_mv, uint32_t wet_mv, uint32_t cal_ts) {
+    if (probe >= SOIL_PROBE_COUNT) return false;
+    const char *ns = soil_probes[probe].cal_ns;
+    if (!nvs_shim_set_u32(ns, KEY_DRY, dry_mv)) return false;
+    if (!nvs_shim_set_u32(ns, KEY_WET, wet_mv)) return false;
+    if (!nvs_shim_set_u32(ns, KEY_TS,  cal_ts)) return false;
+    s_cal[probe].dry = dry_mv; s_cal[probe].wet = wet_mv; s_cal[probe].ts = cal_ts;
     return true;
 }
 
+bool soil_calibration_save(uint32_t dry_mv, uint32_t wet_mv, uint32_t cal_ts) {
+    return soil_calibration_save_probe(0, dry_mv, wet_mv, cal_ts);
+}
+
+bool soil_calibration_clear_probe(size_t probe) {
+    if (probe >= SOIL_PROBE_COUNT) return false;
+    return nvs_shim_erase_namespace(soil_probes[probe].cal_ns);
+}
+
 bool soil_calibration_clear(void) {
-    return nvs_shim_erase_namespace(NS);
+    return soil_calibration_clear_probe(0);
 }
@@ -21,22 +21,29 @@
  * 1. Call soil_moisture_init() after adc_manager_init()
  * 2. Call soil_moisture_read_percentage() for 0-100% reading
  * 3. Call soil_moisture_read_voltage() for raw voltage
+ * 4. Call soil_moisture_read_probes_fx() to sample every probe in
+ *    soil_probe.c in one power window (SOIL_PROBE_COUNT > 1)
  * 
  * Calibration:
  * - Captured at runtime via the config portal (see CONFIG_PORTAL.md)
- * - Stored in NVS namespace "soil_cal" and read via soil_calibration_get_*
+ * - Stored in NVS namespace "soil_cal" (probe 0; one namespace per probe, see
+ *   soil_probe.c) and read via soil_calibration_get_*
  * - Defaults if NVS is empty: dry=2800 mV, wet=0 mV
  * 
  * @author DFRobot Project
  * @date 2025
  */
 
-#ifndef TEST_HOST
 #include "soil_moisture.h"
+
+#ifndef TEST_HOST
 #include "adc_manager.h"
+#include "adc_oversample.h"
 #include "soil_calibration.h"
+#include "soil_probe.h"
+#include "soil_settle.h"
+#include "sample_reduce.h"
 #include "esp_adc/adc_oneshot.h"
-#include "esp_adc/adc_cali.h"
 #include "esp_log.h"
 #include "esp_pm.h"
 #include "driver/gpio.h"
@@ -57,6 +64,33 @@ float soil_moisture_calc_percentage(int raw_mv, int dry_mv, int wet_mv) {
     return pct;
 }
 
+// Fixed-point variant: the sub-mV fraction from an oversampled read carries
+// into the percentage instead of being truncated away first.
+float soil_moisture_calc_percentage_fx(int32_t raw_mv_fx, int dry_mv, int wet_mv) {
+    int32_t dry_fx = (int32_t)dry_mv << SOIL_MV_FRAC_BITS;
+    int32_t wet_fx = (int32_t)wet_mv << SOIL_MV_FRAC_BITS;
+    if (raw_mv_fx >= dry_fx) return 0.0f;
+    if (raw_mv_fx <= wet_fx) return 100.0f;
+    float span = (float)(dry_fx - wet_fx);
+    if (span <= 0.0f) return 0.0f;
+    float pct = 100.0f * (float)(dry_fx - raw_mv_fx) / span;
+    if (pct < 0.0f) return 0.0f;
+    if (pct > 100.0f) return 100.0f;
+    return pct;
+}
+
+// Integer twin of the above for the report path: 0.01 % units (the ZCL
+// MeasuredValue format), rounded to nearest, with no float work at all.
+uint16_t soil_moisture_calc_pct_x100(int32_t raw_mv_fx, int dry_mv, int wet_mv) {
+    int32_t dry_fx = (int32_t)dry_mv << SOIL_MV_FRAC_BITS;
+    int32_t wet_fx = (int32_t)wet_mv << SOIL_MV_FRAC_BITS;
+    if (raw_mv_fx >= dry_fx) return 0;
+    if (raw_mv_fx <= wet_fx) return 10000;
+    uint32_t span = (uint32_t)(dry_fx - wet_fx);
+    uint64_t num  = (uint64_t)(uint32_t)(dry_fx - raw_mv_fx) * 10000u;
+    return (uint16_t)((num + span / 2) / span);
+}
+
 #ifndef TEST_HOST
 
 static const char *TAG = "SOIL_MOISTURE";
@@ -64,40 +98,82 @@ static const char *TAG = "SOIL_MOISTURE";
 // ============================================================================
 // Configuration Constants
 // ============================================================================
-// Adjust these values based on your hardware setup and calibration
+// Adjust these values based on your hardware setup and calibration.
+// Probe pins (AOUT channel + switched VCC) live in the soil_probe table.
 
-#define SOIL_ADC_CHAN         ADC_CHANNEL_2    ///< GPIO2 = ADC1_CH2 (AOUT / yellow)
 #define ADC_ATTEN             ADC_ATTEN_DB_12  ///< 12dB attenuation for 0-3.1V range
-#define SAMPLE_COUNT          10               ///< Number of ADC samples to average (noise reduction)
-#define SOIL_PWR_GPIO         GPIO_NUM_3       ///< GPIO3 = sensor VCC (red) — driven HIGH only during read
-#define SOIL_WARMUP_MS        150              ///< Settle time after powering sensor before sampling
+#define SAMPLE_COUNT          ADC_OVERSAMPLE_COUNT(SOIL_OVERSAMPLE_BITS) ///< 16 samples → 2 extra bits
+
+#define PROBE_CHAN(p)         ((adc_channel_t)soil_probes[p].adc_channel)
+#define PROBE_PWR(p)          ((gpio_num_t)soil_probes[p].pwr_gpio)
+
+// Every probe plus the battery companion fits one scan pattern.
+_Static_assert(SOIL_PROBE_COUNT + 1 <= ADC_MANAGER_SCAN_MAX_LANES,
+               "probe table exceeds the scan lanes");
+// adc_manager_scan() rejects a lane longer than this, so a larger
+// SOIL_OVERSAMPLE_BITS would fail every read at run time.
+_Static_assert(SAMPLE_COUNT <= ADC_MANAGER_SCAN_MAX_SAMPLES,
+               "SOIL_OVERSAMPLE_BITS burst exceeds the scan buffer");
 
 // Static module state
-static adc_cali_handle_t cali_handle = NULL;  ///< ADC calibration handle from adc_manager
 static bool initialized = false;              ///< Initialization flag
+static int s_last_settle_ms = 0;              ///< Measured warm-up of the latest read
+
+// Sample buffers for one burst. Static rather than on the report task's stack;
+// reads only ever run from one task at a time.
+static int s_codes[SOIL_PROBE_COUNT][SAMPLE_COUNT];
+
+// Warm-up: poll the probe every step and start sampling once it settles,
+// instead of a fixed 150 ms wait. The ceiling covers slow cold-soil starts.
+static const soil_settle_cfg_t s_settle_cfg = SOIL_SETTLE_CFG_DEFAULT;
 
 // Held across each read to block automatic light sleep. Without it, the Zigbee
-// build's tickless light sleep fires during the 150 ms warmup vTaskDelay and the
+// build's tickless light sleep fires during the warmup vTaskDelay and the
 // GPIO3 switched-power pin stops driving (a plain digital GPIO does not retain its
 // level through C6 light sleep), so the sensor is unpowered when we sample → 0.0.
 // NULL on the WiFi build (PM disabled): create returns an error and reads run as before.
 static esp_pm_lock_handle_t s_no_light_sleep_lock = NULL;
 
+// Drives the power pins of probes [0, n). Probes may share a pin; setting it
+// twice is harmless.
+static void set_probe_power(size_t n, int level) {
+    for (size_t p = 0; p < n; p++) {
+        gpio_set_level(PROBE_PWR(p), level);
+    }
+}
+
 // ============================================================================
 // Initialization
 // ============================================================================
 
+// Channel config for every probe on the (current) shared unit. Codes convert
+// through adc_manager_raw_to_mv(), which owns the calibration.
+static esp_err_t configure_channels(adc_oneshot_unit_handle_t adc_handle) {
+    adc_oneshot_chan_cfg_t config = {
+        .atten = ADC_ATTEN,
+        .bitwidth = ADC_BITWIDTH_DEFAULT,
+    };
+    for (size_t p = 0; p < SOIL_PROBE_COUNT; p++) {
+        esp_err_t err = adc_oneshot_config_channel(adc_handle, PROBE_CHAN(p), &config);
+        if (err != ESP_OK) {
+            ESP_LOGE(TAG, "Failed to configure ADC channel %d: %s", PROBE_CHAN(p), esp_err_to_name(err));
+            return err;
+        }
+    }
+    return ESP_OK;
+}
+
 /**
  * @brief Initialize soil moisture sensor
  * 
- * Sets up ADC channel for the sensor and obtains calibration handle from
- * the shared ADC manager. Must be called after adc_manager_init().
+ * Sets up the ADC channel of every probe in the soil_probe table on the
+ * shared ADC unit. Must be called after adc_manager_init().
  * 
  * Initialization steps:
  * 1. Check if already initialized (idempotent)
- * 2. Get shared ADC handle from manager
- * 3. Configure ADC channel (GPIO, attenuation, bit width)
- * 4. Create/get calibration handle for voltage conversion
+ * 2. Configure the probe power pins (idle LOW)
+ * 3. Get shared ADC handle from manager
+ * 4. Configure each ADC channel (GPIO, attenuation, bit width)
  * 5. Log calibration values for verification
  * 
  * @return ESP_OK on success
@@ -115,14 +191,18 @@ esp_err_t soil_moisture_init(void) {
         return ESP_OK;
     }
 
-    ESP_LOGI(TAG, "Initializing soil moisture sensor");
-
-    // Release any deep-sleep hold left on the power pin from the previous wake
-    gpio_hold_dis(SOIL_PWR_GPIO);
+    ESP_LOGI(TAG, "Initializing soil moisture sensor (%d probe%s)",
+             SOIL_PROBE_COUNT, SOIL_PROBE_COUNT == 1 ? "" : "s");
 
-    // Configure sensor power pin as output, idle LOW (sensor off)
+    // Configure sensor power pins as outputs, idle LOW (sensors off)
+    uint64_t pwr_mask = 0;
+    for (size_t p = 0; p < SOIL_PROBE_COUNT; p++) {
+        // Release any deep-sleep hold left on the power pin from the previous wake
+        gpio_hold_dis(PROBE_PWR(p));
+        pwr_mask |= 1ULL << PROBE_PWR(p);
+    }
     gpio_config_t pwr_conf = {
-        .pin_bit_mask = (1ULL << SOIL_PWR_GPIO),
+        .pin_bit_mask = pwr_mask,
         .mode = GPIO_MODE_OUTPUT,
         .pull_up_en = GPIO_PULLUP_DISABLE,
         .pull_down_en = GPIO_PULLDOWN_DISABLE,
@@ -130,10 +210,10 @@ esp_err_t soil_moisture_init(void) {
     };
     esp_err_t pwr_err = gpio_config(&pwr_conf);
     if (pwr_err != ESP_OK) {
-        ESP_LOGE(TAG, "Failed to configure power GPIO %d: %s", SOIL_PWR_GPIO, esp_err_to_name(pwr_err));
+        ESP_LOGE(TAG, "Failed to configure power GPIOs: %s", esp_err_to_name(pwr_err));
         return pwr_err;
     }
-    gpio_set_level(SOIL_PWR_GPIO, 0);
+    set_probe_power(SOIL_PROBE_COUNT, 0);
 
     // Keep the soil pins in their ACTIVE config through automatic light sleep.
     // By default SLP_SEL is enabled, so the C6 swaps these pads to a sleep-mode
@@ -143,9 +223,11 @@ esp_err_t soil_moisture_init(void) {
     // SLP_SEL pins the active config across sleep. No-op on the WiFi build (never
     // light-sleeps). This is the real fix; the read-time PM lock guarded the wrong
     // window (corruption happens during idle sleep BETWEEN reads, not during one).
-    gpio_sleep_sel_dis(SOIL_PWR_GPIO);   // GPIO3 — switched VCC (output)
-    // NOTE: do NOT touch sleep-sel on GPIO2 — it is an analog ADC input; forcing
-    // a digital sleep config on it produces over-range garbage conversions.
+    for (size_t p = 0; p < SOIL_PROBE_COUNT; p++) {
+        gpio_sleep_sel_dis(PROBE_PWR(p));   // switched VCC (output)
+    }
+    // NOTE: do NOT touch sleep-sel on the AOUT pins — they are analog ADC inputs;
+    // forcing a digital sleep config on them produces over-range garbage conversions.
 
     // Get shared ADC handle
     adc_oneshot_unit_handle_t adc_handle = adc_manager_get_handle();
@@ -154,22 +236,8 @@ esp_err_t soil_moisture_init(void) {
         return ESP_ERR_INVALID_STATE;
     }
 
-    // Configure ADC channel
-    adc_oneshot_chan_cfg_t config = {
-        .atten = ADC_ATTEN,
-        .bitwidth = ADC_BITWIDTH_DEFAULT,
-    };
-    
-    esp_err_t err = adc_oneshot_config_channel(adc_handle, SOIL_ADC_CHAN, &config);
-    if (err != ESP_OK) {
-        ESP_LOGE(TAG, "Failed to configure ADC channel: %s", esp_err_to_name(err));
-        return err;
-    }
-
-    // Get or create calibration handle
-    err = adc_manager_create_cali(SOIL_ADC_CHAN, ADC_ATTEN, &cali_handle);
+    esp_err_t err = configure_channels(adc_handle);
     if (err != ESP_OK) {
-        ESP_LOGE(TAG, "Failed to create calibration: %s", esp_err_to_name(err));
         return err;
     }
 
@@ -185,10 +253,12 @@ esp_err_t soil_moisture_init(void) {
     }
 
     initialized = true;
-    ESP_LOGI(TAG, "Soil moisture sensor initialized on ADC1 Channel %d", SOIL_ADC_CHAN);
-    ESP_LOGI(TAG, "Calibration (runtime): Dry=%u mV, Wet=%u mV",
-             (unsigned)soil_calibration_get_dry_mv(),
-             (unsigned)soil_calibration_get_wet_mv());
+    for (size_t p = 0; p < SOIL_PROBE_COUNT; p++) {
+        ESP_LOGI(TAG, "Probe %u on ADC1 Channel %d, power GPIO %d — Calibration (runtime): Dry=%u mV, Wet=%u mV",
+                 (unsigned)p, PROBE_CHAN(p), PROBE_PWR(p),
+                 (unsigned)soil_calibration_get_probe_dry_mv(p),
+                 (unsigned)soil_calibration_get_probe_wet_mv(p));
+    }
     
     return ESP_OK;
 }
@@ -199,59 +269,133 @@ esp_err_t soil_moisture_reconfigure(void) {
         ESP_LOGE(TAG, "reconfigure: ADC handle not available");
         return ESP_ERR_INVALID_STATE;
     }
-    adc_oneshot_chan_cfg_t config = { .atten = ADC_ATTEN, .bitwidth = ADC_BITWIDTH_DEFAULT };
-    esp_err_t err = adc_oneshot_config_channel(adc_handle, SOIL_ADC_CHAN, &config);
-    if (err != ESP_OK) {
-        ESP_LOGE(TAG, "reconfigure: channel config failed: %s", esp_err_to_name(err));
-        return err;
-    }
-    // Refresh the calibration handle against the rebuilt unit.
-    return adc_manager_create_cali(SOIL_ADC_CHAN, ADC_ATTEN, &cali_handle);
+    // Refreshes the channel config against the rebuilt unit.
+    return configure_channels(adc_handle);
 }
 
 // ============================================================================
 // Voltage Reading
 // ============================================================================
 
-// Returns averaged sensor mV, or -1 on hard failure.
-static int sample_raw_mv(void) {
+// Waits for the freshly powered probes [0, n) to settle; returns the ms the
+// shared window took — the slowest probe's settle time, not the sum.
+// A failed probe read feeds -1 — far from any real level, so it never counts
+// as calm and the ceiling still bounds the wait.
+static int wait_probes_settled(adc_oneshot_unit_handle_t adc_handle, size_t n) {
+    soil_settle_t settle[SOIL_PROBE_COUNT];
+    soil_settle_state_t st[SOIL_PROBE_COUNT];
+    for (size_t p = 0; p < n; p++) {
+        soil_settle_begin(&settle[p]);
+        st[p] = SOIL_SETTLE_WAIT;
+    }
+    int window_ms = 0;
+    bool done = false;
+    while (!done) {
+        vTaskDelay(pdMS_TO_TICKS(s_settle_cfg.step_ms));
+        window_ms += s_settle_cfg.step_ms;
+        int mv[SOIL_PROBE_COUNT];
+        for (size_t p = 0; p < n; p++) {
+            int raw = 0;
+            mv[p] = 0;
+            if (st[p] != SOIL_SETTLE_WAIT) continue;   // settled: skip the read
+            if (adc_oneshot_read(adc_handle, PROBE_CHAN(p), &raw) != ESP_OK ||
+                adc_manager_raw_to_mv(PROBE_CHAN(p), ADC_ATTEN, raw, &mv[p]) != ESP_OK) {
+                mv[p] = -1;
+            }
+        }
+        done = soil_settle_feed_all(settle, st, n, &s_settle_cfg, mv);
+    }
+    for (size_t p = 0; p < n; p++) {
+        if (st[p] == SOIL_SETTLE_TIMEOUT) {
+            ESP_LOGW(TAG, "Probe %u did not settle within %d ms — sampling anyway",
+                     (unsigned)p, s_settle_cfg.max_ms);
+        } else {
+            ESP_LOGD(TAG, "Probe %u settled in %d ms", (unsigned)p, settle[p].elapsed_ms);
+        }
+    }
+    return window_ms;
+}
+
+// Reduces one probe's burst to oversampled mV in Q SOIL_MV_FRAC_BITS, or -1.
+static int32_t lane_mv_fx(size_t probe, adc_frame_lane_t *lane) {
+    // Drop MAD outliers first so one ADC glitch cannot skew the sum, then
+    // decimate the survivors: the ADC's own noise dithers the extra bits.
+    size_t kept = sample_reduce_reject_outliers(lane->samples, lane->count,
+                                                SAMPLE_REDUCE_MAD_K_X10);
+    int32_t code_fx = adc_oversample_decimate(lane->samples, kept, SOIL_OVERSAMPLE_BITS);
+    if (code_fx < 0) return -1;
+
+    // Calibrate the two integer codes around the fractional one and
+    // interpolate: the cali curve is near-linear over a single code.
+    int code = (int)(code_fx >> SOIL_OVERSAMPLE_BITS);
+    int next = code < 4095 ? code + 1 : code;
+    int mv_lo = 0;
+    int mv_hi = 0;
+    if (adc_manager_raw_to_mv(PROBE_CHAN(probe), ADC_ATTEN, code, &mv_lo) != ESP_OK ||
+        adc_manager_raw_to_mv(PROBE_CHAN(probe), ADC_ATTEN, next, &mv_hi) != ESP_OK) {
+        return -1;
+    }
+    uint32_t frac = (uint32_t)code_fx & ((1u << SOIL_OVERSAMPLE_BITS) - 1u);
+    return adc_oversample_interp_mv(mv_lo, mv_hi, frac, SOIL_OVERSAMPLE_BITS, SOIL_MV_FRAC_BITS);
+}
+
+// Powers probes [0, n_probes) together, waits out one shared warm-up and
+// samples every probe plus the companion lanes (other ADC1 channels at the
+// same attenuation) in the same DMA burst. mv_fx[p] is -1 for a failed probe.
+static esp_err_t sample_probes_fx(int32_t *mv_fx, size_t n_probes,
+                                  adc_frame_lane_t *companions, size_t n_companions) {
     if (!initialized) {
         ESP_LOGE(TAG, "Sensor not initialized");
-        return -1;
+        return ESP_ERR_INVALID_STATE;
+    }
+    if (n_probes == 0 || n_probes > SOIL_PROBE_COUNT ||
+        n_probes + n_companions > ADC_MANAGER_SCAN_MAX_LANES || (n_companions && !companions)) {
+        return ESP_ERR_INVALID_ARG;
     }
     adc_oneshot_unit_handle_t adc_handle = adc_manager_get_handle();
     if (!adc_handle) {
         ESP_LOGE(TAG, "ADC handle not available");
-        return -1;
+        return ESP_ERR_INVALID_STATE;
     }
+
+    adc_frame_lane_t lanes[ADC_MANAGER_SCAN_MAX_LANES];
+    for (size_t p = 0; p < n_probes; p++) {
+        lanes[p] = (adc_frame_lane_t){
+            .channel = PROBE_CHAN(p), .samples = s_codes[p], .capacity = SAMPLE_COUNT,
+        };
+    }
+    for (size_t i = 0; i < n_companions; i++) {
+        lanes[n_probes + i] = companions[i];
+    }
+
     // Block light sleep for the whole powered window: otherwise the CPU sleeps
     // during the warmup delay and GPIO3 stops driving, unpowering the sensor.
     if (s_no_light_sleep_lock) {
         esp_pm_lock_acquire(s_no_light_sleep_lock);
     }
 
-    gpio_set_level(SOIL_PWR_GPIO, 1);
-    vTaskDelay(pdMS_TO_TICKS(SOIL_WARMUP_MS));
+    set_probe_power(n_probes, 1);
+    s_last_settle_ms = wait_probes_settled(adc_handle, n_probes);
 
-    uint32_t sum = 0;
-    int n = 0;
-    for (int i = 0; i < SAMPLE_COUNT; i++) {
-        int raw = 0;
-        if (adc_oneshot_read(adc_handle, SOIL_ADC_CHAN, &raw) == ESP_OK) {
-            sum += raw; n++;
-        }
-    }
-    gpio_set_level(SOIL_PWR_GPIO, 0);
+    // One burst for every channel: the DMA engine interleaves the conversions
+    // while this task blocks, instead of a oneshot loop per sensor.
+    adc_manager_scan(lanes, n_probes + n_companions, ADC_ATTEN);
+    set_probe_power(n_probes, 0);
 
-    // Sensor is off again; the cali math below needs no sleep protection.
+    // Sensors are off again; the cali math below needs no sleep protection.
     if (s_no_light_sleep_lock) {
         esp_pm_lock_release(s_no_light_sleep_lock);
     }
-    if (n == 0) return -1;
+    for (size_t i = 0; i < n_companions; i++) {
+        companions[i].count = lanes[n_probes + i].count;
+    }
 
-    int mv = 0;
-    if (adc_cali_raw_to_voltage(cali_handle, (int)(sum / n), &mv) != ESP_OK) return -1;
-    return mv;
+    esp_err_t ret = ESP_OK;
+    for (size_t p = 0; p < n_probes; p++) {
+        mv_fx[p] = lanes[p].count ? lane_mv_fx(p, &lanes[p]) : -1;
+        if (mv_fx[p] < 0) ret = ESP_FAIL;
+    }
+    return ret;
 }
 
 /**
@@ -262,9 +406,9 @@ static int sample_raw_mv(void) {
  *
  * Reading Process:
  * 1. Verify sensor is initialized
- * 2. Take SAMPLE_COUNT (10) ADC readings
- * 3. Average the readings
- * 4. Apply calibration to convert to millivolts
+ * 2. Take SAMPLE_COUNT (16) ADC readings in one DMA burst
+ * 3. Drop MAD outliers and decimate to a code with 2 extra bits
+ * 4. Apply calibration to convert to fixed-point millivolts
  * 5. Convert to volts and return
  *
  * @return float Sensor voltage in volts (e.g., 1.85V)
@@ -276,15 +420,44 @@ static int sample_raw_mv(void) {
  */
 
 float soil_moisture_read_voltage(void) {
-    int mv = sample_raw_mv();
-    if (mv < 0) return 0.0f;
-    ESP_LOGD(TAG, "Raw mV: %d", mv);
-    return (float)mv / 1000.0f;
+    int32_t mv_fx = soil_moisture_read_mv_fx(NULL, 0);
+    ESP_LOGD(TAG, "Raw mV: %d", SOIL_MV_FX_TO_MV(mv_fx));
+    return (float)mv_fx / (float)(1000 << SOIL_MV_FRAC_BITS);
 }
 
 int soil_moisture_read_raw_mv(void) {
-    int mv = sample_raw_mv();
-    return mv < 0 ? 0 : mv;
+    return SOIL_MV_FX_TO_MV(soil_moisture_read_mv_fx(NULL, 0));
+}
+
+int soil_moisture_read_probe_raw_mv(size_t probe) {
+    if (probe >= SOIL_PROBE_COUNT) return 0;
+    int32_t mv_fx[SOIL_PROBE_COUNT];
+    soil_moisture_read_probes_fx(mv_fx, probe + 1, NULL, 0);
+    return SOIL_MV_FX_TO_MV(mv_fx[probe]);
+}
+
+int soil_moisture_get_last_settle_ms(void) {
+    return s_last_settle_ms;
+}
+
+int32_t soil_moisture_read_mv_fx(adc_frame_lane_t *companions, size_t n_companions) {
+    int32_t mv_fx = -1;
+    sample_probes_fx(&mv_fx, 1, companions, n_companions);
+    return mv_fx < 0 ? 0 : mv_fx;
+}
+
+esp_err_t soil_moisture_read_probes_fx(int32_t *mv_fx, size_t n_probes,
+                                       adc_frame_lane_t *companions, size_t n_companions) {
+    if (!mv_fx) return ESP_ERR_INVALID_ARG;
+    esp_err_t err = sample_probes_fx(mv_fx, n_probes, companions, n_companions);
+    if (err == ESP_ERR_INVALID_ARG || err == ESP_ERR_INVALID_STATE) {
+        for (size_t p = 0; p < n_probes; p++) mv_fx[p] = 0;
+        return err;
+    }
+    for (size_t p = 0; p < n_probes; p++) {
+        if (mv_fx[p] < 0) mv_fx[p] = 0;
+    }
+    return err;
 }
 
 // ============================================================================
@@ -298,11 +471,10 @@ int soil_moisture_read_raw_mv(void) {
  * to an intuitive 0-100% scale using linear interpolation between calibration points.
  * 
  * Conversion Process:
- * 1. Read raw voltage using soil_moisture_read_voltage()
- * 2. Convert volts to millivolts
- * 3. Apply linear interpolation against runtime dry/wet thresholds
+ * 1. Read oversampled fixed-point mV using soil_moisture_read_mv_fx()
+ * 2. Apply linear interpolation against runtime dry/wet thresholds
  *    fetched from soil_calibration (see soil_moisture_calc_percentage)
- * 4. Clamp result to 0-100% range
+ * 3. Clamp result to 0-100% range
  * 
  * Linear Interpolation Formula:
  *   percentage = 100 * (dry_voltage - current_voltage) / (dry_voltage - wet_voltage)
@@ -331,17 +503,16 @@ float soil_moisture_read_percentage(void) {
         return 0.0f;
     }
 
-    // Read sensor voltage in mV
-    float voltage = soil_moisture_read_voltage();
-    int voltage_mV = (int)(voltage * 1000.0f);
+    // Read oversampled sensor mV (fixed point, sub-mV resolution)
+    int32_t mv_fx = soil_moisture_read_mv_fx(NULL, 0);
 
-    // Convert voltage to percentage using pure math function
-    float percentage = soil_moisture_calc_percentage(
-        voltage_mV,
+    // Convert to percentage using pure math function
+    float percentage = soil_moisture_calc_percentage_fx(
+        mv_fx,
         (int)soil_calibration_get_dry_mv(),
         (int)soil_calibration_get_wet_mv());
 
-    ESP_LOGI(TAG, "Moisture: %.1f%% (%.3f V, %d mV)", percentage, voltage, voltage_mV);
+    ESP_LOGI(TAG, "Moisture: %.1f%% (%d mV)", percentage, SOIL_MV_FX_TO_MV(mv_fx));
 
     return percentage;
 }
@@ -353,14 +524,14 @@ float soil_moisture_read_percentage(void) {
 /**
  * @brief Deinitialize soil moisture sensor
  * 
- * Releases sensor resources. In current implementation, calibration handle
- * is managed by adc_manager, so this just clears the local reference.
+ * Marks the sensor uninitialised. The ADC unit and the raw->mV conversion
+ * belong to adc_manager, so there is nothing else to release.
  * 
  * @return ESP_OK always succeeds
  * 
  * @note Safe to call even if not initialized
  * @note After calling this, sensor must be reinitialized before reading
- * @note ADC manager and calibration handles persist (shared resource)
+ * @note ADC manager and its conversion tables persist (shared resource)
  */
 
 esp_err_t soil_moisture_deinit(void) {
@@ -370,7 +541,6 @@ esp_err_t soil_moisture_deinit(void) {
 
     ESP_LOGI(TAG, "Deinitializing soil moisture sensor");
 
-    cali_handle = NULL;
     initialized = false;
     ESP_LOGI(TAG, "Soil moisture sensor deinitialized");
 
@@ -0,0 +1,19 @@
+#include "soil_probe.h"
+
+// Extra probes default to the free ADC1 pins and share probe 0's switched
+// supply: one probe draws ~5 mA, so GPIO3 can feed all four. Give a probe its
+// own pwr_gpio if its supply must be switched separately. The fourth probe
+// uses GPIO4, which older e-paper wiring used for BUSY (display.c now uses
+// GPIO8) — check the board before enabling it.
+const soil_probe_t soil_probes[SOIL_PROBE_COUNT] = {
+    { .adc_channel = 2, .pwr_gpio = 3, .cal_ns = "soil_cal",  .key = "soil_moisture"   },
+#if SOIL_PROBE_COUNT >= 2
+    { .adc_channel = 5, .pwr_gpio = 3, .cal_ns = "soil_cal1", .key = "soil_moisture_2" },
+#endif
+#if SOIL_PROBE_COUNT >= 3
+    { .adc_channel = 6, .pwr_gpio = 3, .cal_ns = "soil_cal2", .key = "soil_moisture_3" },
+#endif
+#if SOIL_PROBE_COUNT >= 4
+    { .adc_channel = 4, .pwr_gpio = 3, .cal_ns = "soil_cal3", .key = "soil_moisture_4" },
+#endif
+};
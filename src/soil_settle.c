@@ -0,0 +1,52 @@
+#include "soil_settle.h"
+
+void soil_settle_begin(soil_settle_t *s) {
+    s->elapsed_ms = 0;
+    s->last_mv    = 0;
+    s->calm       = 0;
+    s->have_last  = false;
+}
+
+soil_settle_state_t soil_settle_feed(soil_settle_t *s, const soil_settle_cfg_t *cfg, int mv) {
+    s->elapsed_ms += cfg->step_ms;
+
+    if (s->have_last) {
+        int delta = mv - s->last_mv;
+        if (delta < 0) delta = -delta;
+        s->calm = (delta <= cfg->slope_mv) ? s->calm + 1 : 0;
+    }
+    s->last_mv   = mv;
+    s->have_last = true;
+
+    if (s->calm >= cfg->stable_steps && s->elapsed_ms >= cfg->min_ms) {
+        return SOIL_SETTLE_DONE;
+    }
+    if (s->elapsed_ms >= cfg->max_ms) {
+        return SOIL_SETTLE_TIMEOUT;
+    }
+    return SOIL_SETTLE_WAIT;
+}
+
+bool soil_settle_feed_all(soil_settle_t *s, soil_settle_state_t *st, size_t n,
+                          const soil_settle_cfg_t *cfg, const int *mv) {
+    bool all_done = true;
+    for (size_t i = 0; i < n; i++) {
+        if (st[i] == SOIL_SETTLE_WAIT) {
+            st[i] = soil_settle_feed(&s[i], cfg, mv[i]);
+        }
+        if (st[i] == SOIL_SETTLE_WAIT) all_done = false;
+    }
+    return all_done;
+}
+
+int soil_settle_run(const soil_settle_cfg_t *cfg, const int *trace, size_t n,
+                    soil_settle_state_t *state) {
+    soil_settle_t s;
+    soil_settle_begin(&s);
+    soil_settle_state_t st = SOIL_SETTLE_WAIT;
+    for (size_t i = 0; i < n && st == SOIL_SETTLE_WAIT; i++) {
+        st = soil_settle_feed(&s, cfg, trace[i]);
+    }
+    if (state) *state = st;
+    return s.elapsed_ms;
+}
@@ -0,0 +1,223 @@
+#include "telemetry_enc.h"
+#include <string.h>
+
+// CBOR major types (RFC 8949 §3.1), already shifted into the top 3 bits.
+#define CBOR_UINT      0x00
+#define CBOR_NEGINT    0x20
+#define CBOR_TEXT      0x60
+#define CBOR_TAG       0xC0
+#define CBOR_ARRAY_2   0x82
+#define CBOR_ARRAY_IND 0x9F
+#define CBOR_MAP_IND   0xBF
+#define CBOR_BREAK     0xFF
+#define CBOR_TAG_DECIMAL_FRACTION  4
+
+void telemetry_enc_init(telemetry_enc_t *e, telemetry_fmt_t fmt, void *buf, size_t cap) {
+    memset(e, 0, sizeof(*e));
+    e->buf = buf;
+    e->fmt = fmt;
+    if (fmt == TELEMETRY_FMT_JSON) {
+        if (cap == 0) {
+            e->overflow = true;
+        } else {
+            e->buf[0] = '\0';
+            cap--;
+        }
+    }
+    e->cap = cap;
+}
+
+static void put(telemetry_enc_t *e, const void *p, size_t n) {
+    if (e->overflow || n > e->cap - e->len) {
+        e->overflow = true;
+        return;
+    }
+    memcpy(e->buf + e->len, p, n);
+    e->len += n;
+}
+
+static void put_byte(telemetry_enc_t *e, uint8_t b) {
+    put(e, &b, 1);
+}
+
+// ---- CBOR ----
+
+static void cbor_head(telemetry_enc_t *e, uint8_t major, uint32_t arg) {
+    uint8_t h[5];
+    size_t n;
+    if (arg < 24) {
+        h[0] = (uint8_t)(major | arg);
+        n = 1;
+    } else if (arg <= 0xFF) {
+        h[0] = (uint8_t)(major | 24);
+        h[1] = (uint8_t)arg;
+        n = 2;
+    } else if (arg <= 0xFFFF) {
+        h[0] = (uint8_t)(major | 25);
+        h[1] = (uint8_t)(arg >> 8);
+        h[2] = (uint8_t)arg;
+        n = 3;
+    } else {
+        h[0] = (uint8_t)(major | 26);
+        h[1] = (uint8_t)(arg >> 24);
+        h[2] = (uint8_t)(arg >> 16);
+        h[3] = (uint8_t)(arg >> 8);
+        h[4] = (uint8_t)arg;
+        n = 5;
+    }
+    put(e, h, n);
+}
+
+static void cbor_int(telemetry_enc_t *e, int32_t v) {
+    if (v >= 0) {
+        cbor_head(e, CBOR_UINT, (uint32_t)v);
+    } else {
+        cbor_head(e, CBOR_NEGINT, (uint32_t)(-(v + 1)));   // -1 - arg, no overflow at INT32_MIN
+    }
+}
+
+static void cbor_text(telemetry_enc_t *e, const char *s) {
+    size_t n = strlen(s);
+    cbor_head(e, CBOR_TEXT, (uint32_t)n);
+    put(e, s, n);
+}
+
+// ---- JSON ----
+
+static void json_str(telemetry_enc_t *e, const char *s) {
+    static const char hex[] = "0123456789abcdef";
+    put_byte(e, '"');
+    for (; *s; s++) {
+        uint8_t c = (uint8_t)*s;
+        if (c == '"' || c == '\\') {
+            uint8_t esc[2] = { '\\', c };
+            put(e, esc, 2);
+        } else if (c < 0x20) {
+            uint8_t esc[6] = { '\\', 'u', '0', '0', (uint8_t)hex[c >> 4], (uint8_t)hex[c & 0xF] };
+            put(e, esc, 6);
+        } else {
+            put_byte(e, c);
+        }
+    }
+    put_byte(e, '"');
+}
+
+// Decimal digits of `v` / 10^decimals with exactly `decimals` places.
+static void json_fixed(telemetry_enc_t *e, int32_t v, uint8_t decimals) {
+    char digits[12];                        // up to 10 digits of a uint32, plus room for "0."
+    uint32_t mag = v < 0 ? 0u - (uint32_t)v : (uint32_t)v;
+    size_t n = 0;
+    do {
+        digits[n++] = (char)('0' + mag % 10);
+        mag /= 10;
+    } while (mag && n < sizeof(digits));
+    while (n <= decimals && n < sizeof(digits)) {
+        digits[n++] = '0';                  // leading zeros so there's an integer digit
+    }
+
+    if (v < 0) put_byte(e, '-');
+    while (n > 0) {
+        if (n == decimals) put_byte(e, '.');
+        put_byte(e, (uint8_t)digits[--n]);
+    }
+}
+
+// Separator and "key": for the next value at this level.
+static void json_prefix(telemetry_enc_t *e, const char *key) {
+    if (e->has_item[e->depth]) put_byte(e, ',');
+    e->has_item[e->depth] = true;
+    if (key) {
+        json_str(e, key);
+        put_byte(e, ':');
+    }
+}
+
+// ---- API ----
+
+static void prefix(telemetry_enc_t *e, const char *key) {
+    if (e->fmt == TELEMETRY_FMT_JSON) {
+        json_prefix(e, key);
+    } else if (key) {
+        cbor_text(e, key);
+    }
+}
+
+static void open_container(telemetry_enc_t *e, const char *key, bool map) {
+    prefix(e, key);
+    if (e->depth >= TELEMETRY_ENC_MAX_DEPTH) {
+        e->overflow = true;
+        return;
+    }
+    if (e->fmt == TELEMETRY_FMT_JSON) {
+        put_byte(e, map ? '{' : '[');
+    } else {
+        put_byte(e, map ? CBOR_MAP_IND : CBOR_ARRAY_IND);
+    }
+    e->has_item[++e->depth] = false;
+}
+
+static void close_container(telemetry_enc_t *e, bool map) {
+    if (e->depth == 0) {
+        e->overflow = true;                 // unbalanced
+        return;
+    }
+    e->depth--;
+    if (e->fmt == TELEMETRY_FMT_JSON) {
+        put_byte(e, map ? '}' : ']');
+    } else {
+        put_byte(e, CBOR_BREAK);
+    }
+}
+
+void telemetry_enc_map_begin(telemetry_enc_t *e, const char *key)   { open_container(e, key, true); }
+void telemetry_enc_map_end(telemetry_enc_t *e)                      { close_container(e, true); }
+void telemetry_enc_array_begin(telemetry_enc_t *e, const char *key) { open_container(e, key, false); }
+void telemetry_enc_array_end(telemetry_enc_t *e)                    { close_container(e, false); }
+
+void telemetry_enc_int(telemetry_enc_t *e, const char *key, int32_t value) {
+    telemetry_enc_fixed(e, key, value, 0);
+}
+
+void telemetry_enc_fixed(telemetry_enc_t *e, const char *key, int32_t value, uint8_t decimals) {
+    if (decimals > 9) {
+        e->overflow = true;
+        return;
+    }
+    prefix(e, key);
+    if (e->fmt == TELEMETRY_FMT_JSON) {
+        json_fixed(e, value, decimals);
+    } else if (decimals == 0) {
+        cbor_int(e, value);
+    } else {
+        cbor_head(e, CBOR_TAG, CBOR_TAG_DECIMAL_FRACTION);
+        put_byte(e, CBOR_ARRAY_2);
+        cbor_int(e, -(int32_t)decimals);
+        cbor_int(e, value);
+    }
+}
+
+void telemetry_enc_str(telemetry_enc_t *e, const char *key, const char *s) {
+    prefix(e, key);
+    if (e->fmt == TELEMETRY_FMT_JSON) {
+        json_str(e, s);
+    } else {
+        cbor_text(e, s);
+    }
+}
+
+int telemetry_enc_finish(telemetry_enc_t *e) {
+    bool ok = !e->overflow && e->depth == 0;
+    if (e->fmt == TELEMETRY_FMT_JSON && e->buf) {
+        // init kept one byte back, so the terminator always fits.
+        if (ok) {
+            e->buf[e->len] = '\0';
+        } else if (e->cap || e->len) {
+            e->buf[0] = '\0';
+        }
+    }
+    return ok ? (int)e->len : -1;
+}
+
+const char *telemetry_fmt_name(telemetry_fmt_t fmt) {
+    return fmt == TELEMETRY_FMT_CBOR ? "cbor" : "json";
+}
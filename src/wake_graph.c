@@ -0,0 +1,160 @@
+#include "wake_graph.h"
+
+static uint32_t all_nodes(const wake_graph_t *g) {
+    return g->n >= 32 ? 0xFFFFFFFFu : (1u << g->n) - 1;
+}
+
+bool wake_graph_valid(const wake_graph_t *g) {
+    if (g->n == 0 || g->n > WAKE_GRAPH_MAX_NODES) return false;
+    for (size_t i = 0; i < g->n; i++) {
+        if (g->node[i].deps & ~all_nodes(g)) return false;
+    }
+    // Peel off nodes whose dependencies are all peeled; a cycle never peels.
+    uint32_t placed = 0;
+    for (size_t round = 0; round < g->n; round++) {
+        for (size_t i = 0; i < g->n; i++) {
+            if (!(placed & WAKE_GRAPH_DEP(i)) && (g->node[i].deps & ~placed) == 0) {
+                placed |= WAKE_GRAPH_DEP(i);
+            }
+        }
+    }
+    return placed == all_nodes(g);
+}
+
+uint32_t wake_graph_next(const wake_graph_t *g, wake_graph_state_t *st) {
+    // Skips cascade: repeat until no more nodes are cut off.
+    uint32_t dead;
+    do {
+        dead = 0;
+        uint32_t failed = st->done & ~st->ok;
+        for (size_t i = 0; i < g->n; i++) {
+            if (!(st->started & WAKE_GRAPH_DEP(i)) && (g->node[i].deps & failed)) {
+                dead |= WAKE_GRAPH_DEP(i);
+            }
+        }
+        st->started |= dead;
+        st->done    |= dead;
+    } while (dead);
+
+    uint32_t ready = 0;
+    for (size_t i = 0; i < g->n; i++) {
+        uint32_t deps = g->node[i].deps;
+        if (!(st->started & WAKE_GRAPH_DEP(i)) && (deps & st->ok) == deps) {
+            ready |= WAKE_GRAPH_DEP(i);
+        }
+    }
+    st->started |= ready;
+    return ready;
+}
+
+void wake_graph_complete(wake_graph_state_t *st, size_t node, bool ok) {
+    st->done |= WAKE_GRAPH_DEP(node);
+    if (ok) st->ok |= WAKE_GRAPH_DEP(node);
+}
+
+bool wake_graph_finished(const wake_graph_t *g, const wake_graph_state_t *st) {
+    return (st->done & all_nodes(g)) == all_nodes(g);
+}
+
+uint32_t wake_graph_critical_path(const wake_graph_t *g, const uint32_t *dur) {
+    // Earliest finish per node; n passes settle any valid graph.
+    uint32_t finish[WAKE_GRAPH_MAX_NODES] = {0};
+    uint32_t longest = 0;
+    for (size_t pass = 0; pass < g->n; pass++) {
+        for (size_t i = 0; i < g->n; i++) {
+            uint32_t start = 0;
+            for (size_t d = 0; d < g->n; d++) {
+                if ((g->node[i].deps & WAKE_GRAPH_DEP(d)) && finish[d] > start) start = finish[d];
+            }
+            finish[i] = start + dur[i];
+            if (finish[i] > longest) longest = finish[i];
+        }
+    }
+    return longest;
+}
+
+void wake_pipeline_init(wake_graph_node_t node[WAKE_NODE_COUNT],
+                        const wake_graph_fn run[WAKE_NODE_COUNT], bool net_first) {
+    static const char *const names[WAKE_NODE_COUNT] = {
+        [WAKE_NODE_SENSE]   = "wake_sense",
+        [WAKE_NODE_NET]     = "wake_net",
+        [WAKE_NODE_BROKER]  = "wake_broker",
+        [WAKE_NODE_PUBLISH] = "wake_publish",
+        [WAKE_NODE_DISPLAY] = "wake_display",
+        [WAKE_NODE_CLOCK]   = "wake_clock",
+    };
+    const uint32_t sense = WAKE_GRAPH_DEP(WAKE_NODE_SENSE);
+    const uint32_t deps[WAKE_NODE_COUNT] = {
+        [WAKE_NODE_SENSE]   = 0,
+        [WAKE_NODE_NET]     = net_first ? 0 : sense,
+        [WAKE_NODE_BROKER]  = WAKE_GRAPH_DEP(WAKE_NODE_NET),
+        [WAKE_NODE_PUBLISH] = sense | WAKE_GRAPH_DEP(WAKE_NODE_BROKER),
+        [WAKE_NODE_DISPLAY] = sense | WAKE_GRAPH_DEP(WAKE_NODE_BROKER),
+        [WAKE_NODE_CLOCK]   = WAKE_GRAPH_DEP(WAKE_NODE_NET),
+    };
+    for (size_t i = 0; i < WAKE_NODE_COUNT; i++) {
+        node[i] = (wake_graph_node_t){
+            .name = names[i], .deps = deps[i], .run = run[i], .stack = WAKE_PIPELINE_STACK,
+        };
+    }
+}
+
+#ifndef TEST_HOST
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include "esp_log.h"
+
+static const char *TAG = "WAKE_GRAPH";
+
+typedef struct {
+    const wake_graph_t *g;
+    void *ctx;
+    size_t index;
+    QueueHandle_t done_q;
+} node_task_t;
+
+#define DONE_OK  0x80u
+
+static void node_task(void *pv) {
+    node_task_t *t = pv;
+    bool ok = t->g->node[t->index].run(t->ctx);
+    uint8_t msg = (uint8_t)(t->index | (ok ? DONE_OK : 0));
+    xQueueSend(t->done_q, &msg, portMAX_DELAY);
+    vTaskDelete(NULL);
+}
+
+uint32_t wake_graph_run(const wake_graph_t *g, void *ctx) {
+    wake_graph_state_t st = {0};
+    if (!wake_graph_valid(g)) {
+        ESP_LOGE(TAG, "Invalid wake graph");
+        return 0;
+    }
+    node_task_t args[WAKE_GRAPH_MAX_NODES];
+    QueueHandle_t done_q = WAKE_PIPELINE_PARALLEL ? xQueueCreate(g->n, sizeof(uint8_t)) : NULL;
+    size_t running = 0;
+
+    while (!wake_graph_finished(g, &st)) {
+        uint32_t ready = wake_graph_next(g, &st);
+        for (size_t i = 0; i < g->n; i++) {
+            if (!(ready & WAKE_GRAPH_DEP(i))) continue;
+            const wake_graph_node_t *node = &g->node[i];
+            args[i] = (node_task_t){ .g = g, .ctx = ctx, .index = i, .done_q = done_q };
+            if (done_q && xTaskCreate(node_task, node->name, node->stack, &args[i],
+                                      uxTaskPriorityGet(NULL), NULL) == pdPASS) {
+                running++;
+                continue;
+            }
+            // Serial build, or no memory for the task: run it here.
+            wake_graph_complete(&st, i, node->run(ctx));
+        }
+        if (running == 0) continue;
+        uint8_t msg;
+        xQueueReceive(done_q, &msg, portMAX_DELAY);
+        running--;
+        wake_graph_complete(&st, msg & ~DONE_OK, (msg & DONE_OK) != 0);
+    }
+    if (done_q) vQueueDelete(done_q);
+    return st.ok;
+}
+#endif // TEST_HOST
@@ -0,0 +1,84 @@
+#include "wake_stub.h"
+#include <string.h>
+
+static void seal(wake_stub_t *s) {
+    s->check = wake_stub_check(s);
+}
+
+void wake_stub_reset(wake_stub_t *s) {
+    memset(s, 0, sizeof(*s));
+    s->magic = WAKE_STUB_MAGIC;
+    s->boot_every = 1;
+    seal(s);
+}
+
+void wake_stub_note_quiet(wake_stub_t *s) {
+    if (s->quiet < UINT16_MAX) {
+        s->quiet++;
+    }
+}
+
+void wake_stub_note_change(wake_stub_t *s) {
+    s->quiet = 0;
+}
+
+uint32_t wake_stub_boot_every(const wake_stub_t *s, uint32_t interval_s, uint32_t headroom_s) {
+    uint32_t n = 1u + (s->quiet < WAKE_STUB_MAX_SKIP ? s->quiet : WAKE_STUB_MAX_SKIP);
+    if (interval_s > 0 && headroom_s / interval_s < n) {
+        n = headroom_s / interval_s;
+    }
+    return n ? n : 1;
+}
+
+void wake_stub_arm(wake_stub_t *s, uint32_t boot_every, uint64_t step_us) {
+    s->countdown  = boot_every ? boot_every : 1;
+    s->step_us    = step_us;
+    s->boot_every = (uint16_t)(s->countdown < UINT16_MAX ? s->countdown : UINT16_MAX);
+    seal(s);
+}
+
+void wake_stub_encode(const wake_stub_t *s, telemetry_enc_t *e) {
+    if (s->wakes == 0) return;
+    telemetry_enc_map_begin(e, "stub");
+    telemetry_enc_int(e, "wakes", (int32_t)(s->wakes & INT32_MAX));
+    telemetry_enc_int(e, "absorbed", (int32_t)(s->absorbed & INT32_MAX));
+    telemetry_enc_map_end(e);
+}
+
+#ifndef TEST_HOST
+#include "esp_attr.h"
+#include "esp_sleep.h"
+#include "esp_wake_stub.h"
+#include "soc/rtc.h"
+
+RTC_DATA_ATTR static wake_stub_t s_stub;
+
+static bool s_checked;
+
+wake_stub_t *wake_stub(void) {
+    if (!s_checked) {
+        if (!wake_stub_valid(&s_stub)) {
+            wake_stub_reset(&s_stub);
+        }
+        s_checked = true;
+    }
+    return &s_stub;
+}
+
+// Runs from RTC fast memory before the bootloader has done anything: only
+// RTC code and data, and the ROM, are usable here.
+static void RTC_IRAM_ATTR wake_stub_entry(void) {
+    bool timer = (esp_wake_stub_get_wakeup_cause() & RTC_TIMER_TRIG_EN) != 0;
+    if (wake_stub_absorb(&s_stub, timer)) {
+        esp_wake_stub_set_wakeup_time(s_stub.step_us);
+        esp_wake_stub_sleep(&wake_stub_entry);      // does not return
+    }
+    esp_default_wake_deep_sleep();
+}
+
+void wake_stub_install(void) {
+#if WAKE_STUB_MAX_SKIP > 0
+    esp_set_deep_sleep_wake_stub(&wake_stub_entry);
+#endif
+}
+#endif // TEST_HOST
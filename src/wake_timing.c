@@ -0,0 +1,220 @@
+#include "wake_timing.h"
+#include "crc32.h"
+#include <string.h>
+
+static const char *const PHASE_NAMES[WAKE_PHASE_COUNT] = {
+    [WAKE_PHASE_BOOT]    = "boot",
+    [WAKE_PHASE_INIT]    = "init",
+    [WAKE_PHASE_OCV]     = "ocv",
+    [WAKE_PHASE_NET]     = "net",
+    [WAKE_PHASE_BROKER]  = "broker",
+    [WAKE_PHASE_CONNECT] = "conn",
+    [WAKE_PHASE_ADC]     = "adc",
+    [WAKE_PHASE_SENSE]   = "sense",
+    [WAKE_PHASE_PUBLISH] = "pub",
+    [WAKE_PHASE_DISPLAY] = "disp",
+};
+
+_Static_assert(WAKE_PHASE_COUNT <= 16, "phase_mask is 16 bits");
+
+const char *wake_timing_phase_name(wake_phase_t phase) {
+    return (unsigned)phase < WAKE_PHASE_COUNT ? PHASE_NAMES[phase] : "?";
+}
+
+static uint32_t clamp_us(int64_t us) {
+    if (us < 0) return 0;
+    if (us > (int64_t)UINT32_MAX) return UINT32_MAX;
+    return (uint32_t)us;
+}
+
+static uint32_t add_sat(uint32_t a, uint32_t b) {
+    return (a > UINT32_MAX - b) ? UINT32_MAX : a + b;
+}
+
+// ---- Record ----
+
+void wake_timing_begin_at(wake_timing_t *t, int64_t now_us, bool since_boot) {
+    memset(&t->rec, 0, sizeof(t->rec));
+    for (int i = 0; i < WAKE_PHASE_COUNT; i++) t->start_us[i] = -1;
+    t->begin_us = since_boot ? 0 : now_us;
+    if (since_boot) {
+        t->rec.phase_us[WAKE_PHASE_BOOT] = clamp_us(now_us);
+        t->rec.phase_mask |= 1u << WAKE_PHASE_BOOT;
+    }
+}
+
+void wake_timing_start_at(wake_timing_t *t, wake_phase_t phase, int64_t now_us) {
+    if ((unsigned)phase >= WAKE_PHASE_COUNT || t->start_us[phase] >= 0) return;
+    t->start_us[phase] = now_us;
+    t->rec.phase_mask |= (uint16_t)(1u << phase);
+}
+
+void wake_timing_stop_at(wake_timing_t *t, wake_phase_t phase, int64_t now_us) {
+    if ((unsigned)phase >= WAKE_PHASE_COUNT || t->start_us[phase] < 0) return;
+    t->rec.phase_us[phase] = add_sat(t->rec.phase_us[phase],
+                                     clamp_us(now_us - t->start_us[phase]));
+    t->start_us[phase] = -1;
+}
+
+void wake_timing_finish_at(wake_timing_t *t, int64_t now_us) {
+    for (int i = 0; i < WAKE_PHASE_COUNT; i++) {
+        wake_timing_stop_at(t, (wake_phase_t)i, now_us);
+    }
+    t->rec.total_us = clamp_us(now_us - t->begin_us);
+}
+
+// ---- RTC ring ----
+
+static uint32_t log_crc(const wake_timing_log_t *log) {
+    return crc32_update(0, log, offsetof(wake_timing_log_t, crc));
+}
+
+void wake_timing_log_reset(wake_timing_log_t *log) {
+    memset(log, 0, sizeof(*log));
+    log->magic = WAKE_TIMING_MAGIC;
+    log->crc   = log_crc(log);
+}
+
+bool wake_timing_log_valid(const wake_timing_log_t *log) {
+    return log->magic == WAKE_TIMING_MAGIC &&
+           log->count <= WAKE_TIMING_RECORDS &&
+           log->head < WAKE_TIMING_RECORDS &&
+           log->crc == log_crc(log);
+}
+
+void wake_timing_log_push(wake_timing_log_t *log, const wake_timing_record_t *rec) {
+    log->rec[log->head] = *rec;
+    log->rec[log->head].reserved = 0;
+    log->head = (log->head + 1) % WAKE_TIMING_RECORDS;
+    if (log->count < WAKE_TIMING_RECORDS) log->count++;
+    log->seq++;
+    log->crc = log_crc(log);
+}
+
+const wake_timing_record_t *wake_timing_log_last(const wake_timing_log_t *log) {
+    if (log->count == 0) return NULL;
+    return &log->rec[(log->head + WAKE_TIMING_RECORDS - 1) % WAKE_TIMING_RECORDS];
+}
+
+// ---- Summary ----
+
+void wake_timing_log_stats(const wake_timing_log_t *log, int phase,
+                           wake_timing_stats_t *out) {
+    memset(out, 0, sizeof(*out));
+    uint64_t sum = 0;
+    // Oldest to newest, so `last` ends on the most recent record that counts.
+    for (uint32_t i = 0; i < log->count; i++) {
+        uint32_t slot = (log->head + WAKE_TIMING_RECORDS - log->count + i) % WAKE_TIMING_RECORDS;
+        const wake_timing_record_t *r = &log->rec[slot];
+        uint32_t us;
+        if (phase >= 0 && phase < WAKE_PHASE_COUNT) {
+            if (!(r->phase_mask & (1u << phase))) continue;
+            us = r->phase_us[phase];
+        } else {
+            us = r->total_us;
+        }
+        if (out->n == 0 || us < out->min_us) out->min_us = us;
+        if (us > out->max_us) out->max_us = us;
+        out->last_us = us;
+        sum += us;
+        out->n++;
+    }
+    if (out->n) out->mean_us = (uint32_t)(sum / out->n);
+}
+
+static uint32_t us_to_ms(uint32_t us) {
+    return (uint32_t)(((uint64_t)us + 500) / 1000);
+}
+
+void wake_timing_encode(const wake_timing_log_t *log, telemetry_enc_t *e, const char *key) {
+    telemetry_enc_map_begin(e, key);
+    telemetry_enc_int(e, "n", (int32_t)log->count);
+    for (int p = -1; p < WAKE_PHASE_COUNT; p++) {
+        wake_timing_stats_t s;
+        wake_timing_log_stats(log, p < 0 ? WAKE_PHASE_COUNT : p, &s);
+        if (s.n == 0) continue;
+        telemetry_enc_array_begin(e, p < 0 ? "total" : PHASE_NAMES[p]);
+        telemetry_enc_int(e, NULL, (int32_t)us_to_ms(s.last_us));
+        telemetry_enc_int(e, NULL, (int32_t)us_to_ms(s.mean_us));
+        telemetry_enc_int(e, NULL, (int32_t)us_to_ms(s.max_us));
+        telemetry_enc_array_end(e);
+    }
+    telemetry_enc_map_end(e);
+}
+
+int wake_timing_format_json(const wake_timing_log_t *log, char *buf, size_t len) {
+    telemetry_enc_t e;
+    telemetry_enc_init(&e, TELEMETRY_FMT_JSON, buf, len);
+    wake_timing_encode(log, &e, NULL);
+    return telemetry_enc_finish(&e);
+}
+
+static uint8_t *put_u16_ms(uint8_t *p, uint32_t us, bool present) {
+    uint32_t ms = present ? us_to_ms(us) : 0xFFFFu;
+    if (ms > 0xFFFFu) ms = 0xFFFFu;
+    p[0] = (uint8_t)(ms & 0xFF);
+    p[1] = (uint8_t)(ms >> 8);
+    return p + 2;
+}
+
+void wake_timing_pack_zcl(const wake_timing_log_t *log, uint8_t *out) {
+    uint8_t *p = out;
+    *p++ = WAKE_TIMING_PACK_LEN;            // ZCL octet-string length prefix
+    *p++ = WAKE_TIMING_PACK_VERSION;
+    *p++ = (uint8_t)log->count;
+    for (int i = -1; i < WAKE_PHASE_COUNT; i++) {
+        wake_timing_stats_t s;
+        wake_timing_log_stats(log, i < 0 ? WAKE_PHASE_COUNT : i, &s);
+        p = put_u16_ms(p, s.last_us, s.n > 0);
+        p = put_u16_ms(p, s.mean_us, s.n > 0);
+    }
+}
+
+#ifndef TEST_HOST
+#include "esp_attr.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+
+RTC_DATA_ATTR static wake_timing_log_t s_log;
+static wake_timing_t s_cur;
+static bool s_active = false;   // markers outside begin..commit are ignored
+static portMUX_TYPE s_lock = portMUX_INITIALIZER_UNLOCKED;   // wake pipeline tasks mark concurrently
+
+void wake_timing_begin(bool since_boot) {
+    if (!wake_timing_log_valid(&s_log)) {
+        wake_timing_log_reset(&s_log);
+    }
+    wake_timing_begin_at(&s_cur, esp_timer_get_time(), since_boot);
+    s_active = true;
+}
+
+void wake_timing_start(wake_phase_t phase) {
+    portENTER_CRITICAL(&s_lock);
+    if (s_active) wake_timing_start_at(&s_cur, phase, esp_timer_get_time());
+    portEXIT_CRITICAL(&s_lock);
+}
+
+void wake_timing_stop(wake_phase_t phase) {
+    portENTER_CRITICAL(&s_lock);
+    if (s_active) wake_timing_stop_at(&s_cur, phase, esp_timer_get_time());
+    portEXIT_CRITICAL(&s_lock);
+}
+
+bool wake_timing_commit(void) {
+    if (!s_active) return false;
+    s_active = false;
+    wake_timing_finish_at(&s_cur, esp_timer_get_time());
+    if (!wake_timing_log_valid(&s_log)) {
+        wake_timing_log_reset(&s_log);
+    }
+    wake_timing_log_push(&s_log, &s_cur.rec);
+    return true;
+}
+
+const wake_timing_log_t *wake_timing_log(void) {
+    if (!wake_timing_log_valid(&s_log)) {
+        wake_timing_log_reset(&s_log);
+    }
+    return &s_log;
+}
+#endif // TEST_HOST
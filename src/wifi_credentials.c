@@ -12,6 +12,7 @@ static const char *TAG = "WIFI_CREDS";
 #define NVS_KEY_PASSWORD      "password"
 #define NVS_KEY_PROVISIONED   "provisioned"
 #define NVS_KEY_DEVICE_ID     "device_id"
+#define NVS_KEY_TELEMETRY_FMT "telem_fmt"
 
 bool wifi_credentials_is_provisioned(void) {
     nvs_handle_t nvs_handle;
@@ -152,6 +153,46 @@ bool wifi_credentials_load_device_id(char *device_id, size_t device_id_len) {
     return true;
 }
 
+esp_err_t wifi_credentials_save_telemetry_format(telemetry_fmt_t fmt) {
+    if (fmt != TELEMETRY_FMT_JSON && fmt != TELEMETRY_FMT_CBOR) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    nvs_handle_t nvs_handle;
+    esp_err_t err = nvs_open(NVS_NAMESPACE, NVS_READWRITE, &nvs_handle);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to open NVS for writing telemetry format");
+        return err;
+    }
+
+    err = nvs_set_u8(nvs_handle, NVS_KEY_TELEMETRY_FMT, (uint8_t)fmt);
+    if (err == ESP_OK) {
+        err = nvs_commit(nvs_handle);
+    }
+    nvs_close(nvs_handle);
+
+    if (err == ESP_OK) {
+        ESP_LOGI(TAG, "Telemetry format saved: %s", telemetry_fmt_name(fmt));
+    } else {
+        ESP_LOGE(TAG, "Failed to save telemetry format");
+    }
+    return err;
+}
+
+telemetry_fmt_t wifi_credentials_load_telemetry_format(void) {
+    nvs_handle_t nvs_handle;
+    if (nvs_open(NVS_NAMESPACE, NVS_READONLY, &nvs_handle) != ESP_OK) {
+        return TELEMETRY_FORMAT_DEFAULT;
+    }
+    uint8_t v = 0;
+    esp_err_t err = nvs_get_u8(nvs_handle, NVS_KEY_TELEMETRY_FMT, &v);
+    nvs_close(nvs_handle);
+
+    if (err != ESP_OK || (v != TELEMETRY_FMT_JSON && v != TELEMETRY_FMT_CBOR)) {
+        return TELEMETRY_FORMAT_DEFAULT;
+    }
+    return (telemetry_fmt_t)v;
+}
+
 esp_err_t wifi_credentials_clear(void) {
     nvs_handle_t nvs_handle;
     esp_err_t err = nvs_open(NVS_NAMESPACE, NVS_READWRITE, &nvs_handle);
@@ -0,0 +1,83 @@
+#include "wifi_fast_cache.h"
+#include "crc32.h"
+#include <stddef.h>
+#include <string.h>
+
+static uint32_t cache_crc(const wifi_fast_cache_t *c) {
+    return crc32_update(0, c, offsetof(wifi_fast_cache_t, crc));
+}
+
+uint32_t wifi_fast_cache_key(const char *ssid, const char *password) {
+    uint32_t k = crc32_update(0, ssid, strlen(ssid) + 1);   // NUL keeps "ab"+"c" != "a"+"bc"
+    return crc32_update(k, password, strlen(password));
+}
+
+bool wifi_fast_cache_valid(const wifi_fast_cache_t *c) {
+    return c->magic == WIFI_FAST_CACHE_MAGIC && c->crc == cache_crc(c);
+}
+
+void wifi_fast_cache_invalidate(wifi_fast_cache_t *c) {
+    memset(c, 0, sizeof(*c));
+}
+
+void wifi_fast_cache_store(wifi_fast_cache_t *c, uint32_t key,
+                           const uint8_t bssid[6], uint8_t channel,
+                           uint32_t ip, uint32_t netmask, uint32_t gw, uint32_t dns,
+                           uint32_t now_s, bool from_dhcp, uint32_t lease_s) {
+    uint32_t lease_start = now_s;
+    if (!from_dhcp) {
+        // Reused address: keep the clock from the grant, unless there is no
+        // grant on record for it (then the next wake goes through DHCP).
+        if (!wifi_fast_cache_valid(c) || c->key != key || c->ip != ip) {
+            lease_s = 0;
+        } else {
+            lease_start = c->lease_start_s;
+            lease_s     = c->lease_s;
+        }
+    } else if (lease_s == 0) {
+        lease_s = WIFI_FAST_LEASE_S;
+    }
+
+    memset(c, 0, sizeof(*c));
+    c->magic         = WIFI_FAST_CACHE_MAGIC;
+    c->key           = key;
+    c->ip            = ip;
+    c->netmask       = netmask;
+    c->gw            = gw;
+    c->dns           = dns;
+    c->lease_start_s = lease_start;
+    c->lease_s       = lease_s;
+    memcpy(c->bssid, bssid, sizeof(c->bssid));
+    c->channel       = channel;
+    c->crc           = cache_crc(c);
+}
+
+bool wifi_fast_cache_use_bssid(const wifi_fast_cache_t *c, uint32_t key) {
+    return wifi_fast_cache_valid(c) && c->key == key &&
+           c->channel >= 1 && c->channel <= 14;
+}
+
+bool wifi_fast_cache_use_ip(const wifi_fast_cache_t *c, uint32_t key, uint32_t now_s) {
+    if (!wifi_fast_cache_use_bssid(c, key) || c->ip == 0 || c->lease_s == 0) {
+        return false;
+    }
+    // A clock behind the grant can't say how much of the lease is left.
+    return now_s >= c->lease_start_s && now_s - c->lease_start_s < c->lease_s / 2;
+}
+
+#ifndef TEST_HOST
+#include <sys/time.h>
+#include "esp_attr.h"
+
+RTC_DATA_ATTR static wifi_fast_cache_t s_cache;
+
+wifi_fast_cache_t *wifi_fast_cache(void) {
+    return &s_cache;
+}
+
+uint32_t wifi_fast_cache_now_s(void) {
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    return (uint32_t)tv.tv_sec;
+}
+#endif // TEST_HOST
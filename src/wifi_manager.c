@@ -1,14 +1,59 @@
 #include "wifi_manager.h"
 #include "wifi_credentials.h"
+#include "wifi_fast_cache.h"
 #include "esp_wifi.h"
 #include "esp_event.h"
+#include "esp_netif.h"
+#include "esp_netif_net_stack.h"
 #include "esp_log.h"
 #include "freertos/FreeRTOS.h"
+#include "freertos/event_groups.h"
 #include "freertos/task.h"
+#include "lwip/dhcp.h"
 #include <string.h>
 
+#ifndef WIFI_FAST_CONNECT_MS
+#define WIFI_FAST_CONNECT_MS  3000   ///< Budget for the cached BSSID/IP before a full scan
+#endif
+
+#ifndef WIFI_DISCONNECT_WAIT_MS
+#define WIFI_DISCONNECT_WAIT_MS  1000   ///< Wait for STA_DISCONNECTED before reconfiguring the station
+#endif
+
+#define WIFI_CONNECTED_BIT  BIT0     ///< IP_EVENT_STA_GOT_IP
+#define WIFI_FAST_FAIL_BIT  BIT1     ///< Disconnected while on the cached fast path (or falling back)
+
 static const char *TAG = "WIFI_MGR";
 static bool wifi_connected = false;
+static EventGroupHandle_t s_wifi_events = NULL;
+static esp_netif_t *s_sta_netif = NULL;
+static wifi_config_t s_wifi_config;
+static uint32_t s_cache_key = 0;
+static volatile bool s_fast_path = false;    // connecting with the cached BSSID/channel
+static volatile bool s_fast_ip = false;      // ... and the cached address (no DHCP)
+static volatile bool s_falling_back = false; // fall_back_to_full_connect() owns the reconnect
+
+// Lease the DHCP client was granted, in seconds; 0 if it isn't known.
+static uint32_t dhcp_lease_s(esp_netif_t *netif) {
+    struct netif *lwip_netif = esp_netif_get_netif_impl(netif);
+    struct dhcp *dhcp = lwip_netif ? netif_dhcp_data(lwip_netif) : NULL;
+    return dhcp ? dhcp->offered_t0_lease : 0;
+}
+
+// Remember the AP and address of a good connection for the next wake.
+static void store_fast_cache(const ip_event_got_ip_t *event) {
+    wifi_ap_record_t ap;
+    if (esp_wifi_sta_get_ap_info(&ap) != ESP_OK) {
+        return;
+    }
+    esp_netif_dns_info_t dns = {0};
+    esp_netif_get_dns_info(event->esp_netif, ESP_NETIF_DNS_MAIN, &dns);
+    wifi_fast_cache_store(wifi_fast_cache(), s_cache_key, ap.bssid, ap.primary,
+                          event->ip_info.ip.addr, event->ip_info.netmask.addr,
+                          event->ip_info.gw.addr, dns.ip.u_addr.ip4.addr,
+                          wifi_fast_cache_now_s(), !s_fast_ip,
+                          s_fast_ip ? 0 : dhcp_lease_s(event->esp_netif));
+}
 
 // WiFi event handler
 static void wifi_event_handler(void* arg, esp_event_base_t event_base,
@@ -18,21 +63,115 @@ static void wifi_event_handler(void* arg, esp_event_base_t event_base,
         ESP_LOGI(TAG, "WiFi STA started");
         esp_wifi_connect();
     } else if (event_base == WIFI_EVENT && event_id == WIFI_EVENT_STA_DISCONNECTED) {
-        ESP_LOGI(TAG, "WiFi disconnected, retrying...");
         wifi_connected = false;
-        esp_wifi_connect();
+        xEventGroupClearBits(s_wifi_events, WIFI_CONNECTED_BIT);
+        if (s_fast_path || s_falling_back) {
+            // Let wifi_manager_wait_connected() fall back to a full scan now
+            // rather than retrying a BSSID that just failed. During the
+            // fallback itself this only signals that the station is idle.
+            if (s_fast_path) ESP_LOGW(TAG, "Cached AP connect failed");
+            xEventGroupSetBits(s_wifi_events, WIFI_FAST_FAIL_BIT);
+        } else {
+            ESP_LOGI(TAG, "WiFi disconnected, retrying...");
+            esp_wifi_connect();
+        }
     } else if (event_base == IP_EVENT && event_id == IP_EVENT_STA_GOT_IP) {
         ip_event_got_ip_t* event = (ip_event_got_ip_t*) event_data;
-        ESP_LOGI(TAG, "Got IP address: " IPSTR, IP2STR(&event->ip_info.ip));
+        ESP_LOGI(TAG, "Got IP address: " IPSTR "%s", IP2STR(&event->ip_info.ip),
+                 s_fast_ip ? " (cached)" : "");
+        store_fast_cache(event);
+        s_fast_path = false;         // connected: later drops retry as usual
         wifi_connected = true;
+        xEventGroupSetBits(s_wifi_events, WIFI_CONNECTED_BIT);
+    }
+}
+
+// Point the station at the cached AP (and address) if the cache allows it.
+static void apply_fast_cache(void) {
+    const wifi_fast_cache_t *c = wifi_fast_cache();
+    s_fast_path = wifi_fast_cache_use_bssid(c, s_cache_key);
+    s_fast_ip = s_fast_path && wifi_fast_cache_use_ip(c, s_cache_key, wifi_fast_cache_now_s());
+    if (!s_fast_path) {
+        return;
+    }
+
+    s_wifi_config.sta.bssid_set = true;
+    memcpy(s_wifi_config.sta.bssid, c->bssid, sizeof(s_wifi_config.sta.bssid));
+    s_wifi_config.sta.channel = c->channel;
+
+    if (s_fast_ip) {
+        esp_netif_ip_info_t ip = {
+            .ip.addr = c->ip, .netmask.addr = c->netmask, .gw.addr = c->gw,
+        };
+        esp_netif_dhcpc_stop(s_sta_netif);
+        if (esp_netif_set_ip_info(s_sta_netif, &ip) != ESP_OK) {
+            esp_netif_dhcpc_start(s_sta_netif);
+            s_fast_ip = false;
+        } else if (c->dns) {
+            esp_netif_dns_info_t dns = {
+                .ip.u_addr.ip4.addr = c->dns, .ip.type = ESP_IPADDR_TYPE_V4,
+            };
+            esp_netif_set_dns_info(s_sta_netif, ESP_NETIF_DNS_MAIN, &dns);
+        }
     }
+    ESP_LOGI(TAG, "Fast connect: cached AP on channel %u%s", c->channel,
+             s_fast_ip ? ", cached IP" : "");
+}
+
+// Fast path failed: drop the cache and retry with a full scan and DHCP.
+// `idle` is true when STA_DISCONNECTED already ended the cached attempt;
+// otherwise it is still in flight and is stopped first. esp_wifi_disconnect()
+// is asynchronous and the station refuses a new config until it has
+// actually disconnected, so wait for the event before reconfiguring. The
+// event handler stays out of the way meanwhile: only this function issues
+// the one esp_wifi_connect(). Returns false if no full connect was started.
+static bool fall_back_to_full_connect(bool idle) {
+    ESP_LOGW(TAG, "Falling back to full scan + DHCP");
+    wifi_fast_cache_invalidate(wifi_fast_cache());
+    s_falling_back = true;
+    s_fast_path = false;
+    if (!idle) {
+        xEventGroupClearBits(s_wifi_events, WIFI_FAST_FAIL_BIT);
+        if (esp_wifi_disconnect() == ESP_OK) {
+            EventBits_t bits = xEventGroupWaitBits(s_wifi_events, WIFI_FAST_FAIL_BIT, pdFALSE,
+                                                   pdFALSE, pdMS_TO_TICKS(WIFI_DISCONNECT_WAIT_MS));
+            if (!(bits & WIFI_FAST_FAIL_BIT)) {
+                ESP_LOGW(TAG, "No disconnect event within %d ms", WIFI_DISCONNECT_WAIT_MS);
+            }
+        }
+    }
+    if (s_fast_ip) {
+        esp_netif_dhcpc_start(s_sta_netif);
+        s_fast_ip = false;
+    }
+    s_wifi_config.sta.bssid_set = false;
+    s_wifi_config.sta.channel = 0;
+    esp_err_t err = esp_wifi_set_config(WIFI_IF_STA, &s_wifi_config);
+    xEventGroupClearBits(s_wifi_events, WIFI_FAST_FAIL_BIT);
+    s_falling_back = false;
+    if (err != ESP_OK) {
+        // Connecting now would retry the stale BSSID/channel. The cache is
+        // already invalidated, so the next wake starts with a full scan.
+        ESP_LOGE(TAG, "Failed to clear cached AP: %s", esp_err_to_name(err));
+        return false;
+    }
+    esp_wifi_connect();
+    return true;
 }
 
 esp_err_t wifi_manager_init_sta(void) {
     ESP_LOGI(TAG, "Initializing WiFi in station mode");
     
+    if (!s_wifi_events) {
+        s_wifi_events = xEventGroupCreate();
+        if (!s_wifi_events) {
+            return ESP_ERR_NO_MEM;
+        }
+    }
+    xEventGroupClearBits(s_wifi_events, WIFI_CONNECTED_BIT | WIFI_FAST_FAIL_BIT);
+
     // Create default network interface for WiFi station
-    esp_netif_create_default_wifi_sta();
+    s_sta_netif = esp_netif_create_default_wifi_sta();
     
     // Initialize WiFi with default config
     wifi_init_config_t cfg = WIFI_INIT_CONFIG_DEFAULT();
@@ -56,7 +195,6 @@ esp_err_t wifi_manager_init_sta(void) {
     }
 
     // Load credentials
-    wifi_config_t wifi_config = {0};
     char ssid[33] = {0};
     char password[65] = {0};
     
@@ -65,8 +203,14 @@ esp_err_t wifi_manager_init_sta(void) {
         return ESP_FAIL;
     }
     
-    strncpy((char*)wifi_config.sta.ssid, ssid, sizeof(wifi_config.sta.ssid) - 1);
-    strncpy((char*)wifi_config.sta.password, password, sizeof(wifi_config.sta.password) - 1);
+    memset(&s_wifi_config, 0, sizeof(s_wifi_config));
+    strncpy((char*)s_wifi_config.sta.ssid, ssid, sizeof(s_wifi_config.sta.ssid) - 1);
+    strncpy((char*)s_wifi_config.sta.password, password, sizeof(s_wifi_config.sta.password) - 1);
+
+    // Skip the scan (and DHCP while the lease is fresh) using the last good
+    // connection, if it was made with these credentials.
+    s_cache_key = wifi_fast_cache_key(ssid, password);
+    apply_fast_cache();
     
     err = esp_wifi_set_mode(WIFI_MODE_STA);
     if (err != ESP_OK) {
@@ -74,7 +218,7 @@ esp_err_t wifi_manager_init_sta(void) {
         return err;
     }
     
-    err = esp_wifi_set_config(WIFI_IF_STA, &wifi_config);
+    err = esp_wifi_set_config(WIFI_IF_STA, &s_wifi_config);
     if (err != ESP_OK) {
         ESP_LOGE(TAG, "Failed to set WiFi config");
         return err;
@@ -102,18 +246,47 @@ void wifi_manager_stop(void) {
     esp_wifi_stop();
     esp_wifi_deinit();
     wifi_connected = false;
+    s_fast_path = false;
+    s_fast_ip = false;
+}
+
+void wifi_manager_forget_fast_path(void) {
+    if (s_fast_ip) {
+        ESP_LOGW(TAG, "Cached IP unusable - next wake does a full connect");
+        wifi_fast_cache_invalidate(wifi_fast_cache());
+    }
 }
 
 bool wifi_manager_wait_connected(int timeout_sec) {
     ESP_LOGI(TAG, "Waiting for WiFi connection (timeout: %d seconds)", timeout_sec);
 
-    int elapsed = 0;
-    while (!wifi_connected && elapsed < timeout_sec) {
-        vTaskDelay(pdMS_TO_TICKS(1000));
-        elapsed++;
+    if (!s_wifi_events) {
+        return false;
+    }
+
+    // Returns the instant IP_EVENT_STA_GOT_IP fires. The cached fast path gets
+    // WIFI_FAST_CONNECT_MS of the budget; on failure it falls back to a full
+    // scan + DHCP for the rest.
+    TickType_t start = xTaskGetTickCount();
+    TickType_t budget = pdMS_TO_TICKS((uint32_t)timeout_sec * 1000U);
+    EventBits_t bits = 0;
+    if (s_fast_path) {
+        TickType_t fast = pdMS_TO_TICKS(WIFI_FAST_CONNECT_MS);
+        bits = xEventGroupWaitBits(s_wifi_events, WIFI_CONNECTED_BIT | WIFI_FAST_FAIL_BIT,
+                                   pdFALSE, pdFALSE, fast < budget ? fast : budget);
+        if (!(bits & WIFI_CONNECTED_BIT) &&
+            !fall_back_to_full_connect((bits & WIFI_FAST_FAIL_BIT) != 0)) {
+            ESP_LOGE(TAG, "WiFi connection failed");
+            return false;
+        }
+    }
+    if (!(bits & WIFI_CONNECTED_BIT)) {
+        TickType_t spent = xTaskGetTickCount() - start;
+        bits = xEventGroupWaitBits(s_wifi_events, WIFI_CONNECTED_BIT, pdFALSE, pdFALSE,
+                                   spent < budget ? budget - spent : 0);
     }
 
-    if (wifi_connected) {
+    if (bits & WIFI_CONNECTED_BIT) {
         ESP_LOGI(TAG, "WiFi connected successfully");
         return true;
     } else {
@@ -19,3 +19,19 @@ uint8_t zigbee_encode_batt_pct(float pct) {
     if (pct >= 100.0f) return 200;
     return (uint8_t)lroundf(pct * 2.0f);
 }
+
+uint16_t zigbee_encode_soil_pct_x100(uint16_t pct_x100) {
+    return pct_x100 > 10000 ? 10000 : pct_x100;
+}
+
+uint8_t zigbee_encode_batt_mv(int mv) {
+    if (mv <= 0) return 0;
+    int units = (mv + 50) / 100;
+    if (units > 255) return 255;
+    return (uint8_t)units;
+}
+
+uint8_t zigbee_encode_batt_pct_x100(uint16_t pct_x100) {
+    if (pct_x100 >= 10000) return 200;
+    return (uint8_t)((pct_x100 + 25) / 50);
+}
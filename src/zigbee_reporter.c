@@ -11,7 +11,11 @@
 
 #include "zigbee_reporter.h"
 #include "zigbee_encode.h"
+#include "soil_probe.h"
+#include "wake_timing.h"
 #include "ota_client.h"
+#include "ota_ids.h"
+#include "report_slot.h"
 
 /* Classic esp_zb_* API, native to esp-zigbee-lib 1.6.x (headers at the
  * include root; no compat/ prefix). Matched pair with esp-zboss-lib 1.6.x. */
@@ -48,6 +52,7 @@
 
 #include "esp_log.h"
 #include "esp_pm.h"               /* esp_pm_config_t, esp_pm_configure */
+#include "esp_timer.h"            /* esp_timer_get_time: report-slot phase */
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 #include "aps/esp_zigbee_aps.h"  /* ESP_ZB_APS_ADDR_MODE_16_ENDP_PRESENT */
@@ -61,6 +66,7 @@ static volatile bool s_joined = false;
 /* Managed-sleep / periodic-report state. */
 static zigbee_report_tick_cb_t s_report_tick_cb     = NULL;
 static uint32_t                s_report_interval_ms = 900000U; /* 15 min default */
+static uint32_t                s_report_offset_ms   = 0;       /* report slot, see report_slot.h */
 static volatile bool           s_reports_paused     = false;   /* skip tick during OTA */
 
 /* Basic cluster LocationDescription (0x0010): ZCL character string —
@@ -78,6 +84,11 @@ void zigbee_reporter_set_interval_ms(uint32_t interval_ms)
     s_report_interval_ms = interval_ms;
 }
 
+void zigbee_reporter_set_report_offset_ms(uint32_t offset_ms)
+{
+    s_report_offset_ms = offset_ms;
+}
+
 void zigbee_reporter_set_reports_paused(bool paused)
 {
     s_reports_paused = paused;
@@ -163,8 +174,23 @@ static uint8_t  s_batt_voltage = 0;    /* 0x0020: BatteryVoltage, uint8, units o
 static uint8_t  s_batt_pct     = 0;    /* 0x0021: BatteryPercentageRemaining, uint8, units of 0.5% */
 
 /* Soil moisture, carried on the Relative Humidity Measurement cluster (0x0405).
- * MeasuredValue, uint16, units of 0.01% — same format as soil moisture %. */
-static uint16_t s_soil_measured = 0;
+ * MeasuredValue, uint16, units of 0.01% — same format as soil moisture %.
+ * One per probe: probe 0 on APP_ENDPOINT, probe n on APP_ENDPOINT + n. */
+static uint16_t s_soil_measured[SOIL_PROBE_COUNT] = {0};
+
+/* Wake-timing summary (wake_timing_pack_zcl), a manufacturer-specific octet
+ * string on the Basic cluster under OTA_MANUFACTURER_CODE. Read on demand —
+ * not configured for reporting. */
+#define ZB_ATTR_WAKE_TIMING  0xF000U
+static uint8_t  s_wake_timing_zcl[WAKE_TIMING_PACK_LEN + 1] = {0};
+
+/* Energy estimate (energy_model ledger), same cluster and manufacturer code:
+ * mean charge per cycle since the ledger reset in nAh, and projected days
+ * remaining x10. */
+#define ZB_ATTR_MEAN_NAH      0xF001U
+#define ZB_ATTR_DAYS_LEFT_X10 0xF002U
+static uint32_t s_mean_nah       = 0;
+static uint16_t s_days_left_x10  = 0;
 
 /* ============================================================
  * Required application signal callback (called by the stack).
@@ -241,26 +267,28 @@ void esp_zb_app_signal_handler(esp_zb_app_signal_t *signal_struct)
  * No-lock attribute update helper (caller must already hold the Zigbee lock)
  * ============================================================ */
 
-/* Update the three ZCL attributes WITHOUT taking the Zigbee lock. The caller
+/* Update the sensor ZCL attributes WITHOUT taking the Zigbee lock. The caller
  * must already hold it — either by running in the Zigbee stack task context, or
  * by wrapping the call in esp_zb_lock_acquire()/release() (see
  * zigbee_reporter_report()). Taking the lock here would deadlock the former. */
-static void update_attributes_no_lock(float soil_pct, float battery_v, float battery_pct)
+static void update_attributes_no_lock(const uint16_t *soil_pct_x100, size_t n_probes,
+                                      int battery_mv, uint16_t battery_pct_x100)
 {
-    uint16_t soil = zigbee_encode_soil_pct(soil_pct);
-    uint8_t  volt = zigbee_encode_batt_voltage(battery_v);
-    uint8_t  pct  = zigbee_encode_batt_pct(battery_pct);
+    uint8_t  volt = zigbee_encode_batt_mv(battery_mv);
+    uint8_t  pct  = zigbee_encode_batt_pct_x100(battery_pct_x100);
 
-    s_soil_measured = soil;
     s_batt_voltage  = volt;
     s_batt_pct      = pct;
 
-    esp_zb_zcl_set_attribute_val(APP_ENDPOINT,
-                                 ESP_ZB_ZCL_CLUSTER_ID_REL_HUMIDITY_MEASUREMENT,
-                                 ESP_ZB_ZCL_CLUSTER_SERVER_ROLE,
-                                 ESP_ZB_ZCL_ATTR_REL_HUMIDITY_MEASUREMENT_VALUE_ID,
-                                 &s_soil_measured,
-                                 false);
+    for (size_t p = 0; p < n_probes && p < SOIL_PROBE_COUNT; p++) {
+        s_soil_measured[p] = zigbee_encode_soil_pct_x100(soil_pct_x100[p]);
+        esp_zb_zcl_set_attribute_val((uint8_t)(APP_ENDPOINT + p),
+                                     ESP_ZB_ZCL_CLUSTER_ID_REL_HUMIDITY_MEASUREMENT,
+                                     ESP_ZB_ZCL_CLUSTER_SERVER_ROLE,
+                                     ESP_ZB_ZCL_ATTR_REL_HUMIDITY_MEASUREMENT_VALUE_ID,
+                                     &s_soil_measured[p],
+                                     false);
+    }
 
     esp_zb_zcl_set_attribute_val(APP_ENDPOINT,
                                  ESP_ZB_ZCL_CLUSTER_ID_POWER_CONFIG,
@@ -291,15 +319,19 @@ static void periodic_report_cb(uint8_t param)
         ESP_LOGD(TAG, "periodic_report_cb: paused (OTA in progress) — skipping tick");
     } else if (s_report_tick_cb) {
         /* Runs in the Zigbee stack task context — must stay cheap. Hand the actual
-         * sample + report + e-paper work to the app task: doing the ~150 ms soil read
-         * (or the ~2 s display refresh) here would stall keep-alives and frame
+         * sample + report + e-paper work to the app task: doing the soil read (up to
+         * ~300 ms warm-up) or the ~2 s display refresh here would stall keep-alives and frame
          * handling. The task pushes its sample back via zigbee_reporter_report(). */
         s_report_tick_cb();
     } else {
         ESP_LOGW(TAG, "periodic_report_cb: no report-tick callback registered");
     }
-    /* Re-arm the alarm for the next cycle. */
-    esp_zb_scheduler_alarm(periodic_report_cb, 0, s_report_interval_ms);
+    /* Re-arm the alarm for this device's slot in the next cycle. Timed from
+     * boot rather than from this callback, so nodes powered up together stay
+     * spread out and the cadence doesn't creep by the callback latency. */
+    esp_zb_scheduler_alarm(periodic_report_cb, 0,
+                           report_slot_delay_ms(esp_timer_get_time() / 1000,
+                                                s_report_interval_ms, s_report_offset_ms));
 }
 
 /* ============================================================
@@ -309,11 +341,11 @@ static void periodic_report_cb(uint8_t param)
 /* Register device-side (server) reporting for one attribute so the stack
  * auto-sends a report when the value changes. delta is the reportable change
  * (in the attribute's native units). */
-static void config_reporting(uint16_t cluster_id, uint16_t attr_id, uint16_t delta)
+static void config_reporting(uint8_t ep, uint16_t cluster_id, uint16_t attr_id, uint16_t delta)
 {
     esp_zb_zcl_reporting_info_t info = {
         .direction    = ESP_ZB_ZCL_REPORT_DIRECTION_SEND,
-        .ep           = APP_ENDPOINT,
+        .ep           = ep,
         .cluster_id   = cluster_id,
         .cluster_role = ESP_ZB_ZCL_CLUSTER_SERVER_ROLE,
         .attr_id      = attr_id,
@@ -388,6 +420,28 @@ static void esp_zb_task(void *pv)
                                   ESP_ZB_ZCL_ATTR_BASIC_LOCATION_DESCRIPTION_ID,
                                   (void *)s_location_zcl);
 
+    /* Wake timing (0xF000, manufacturer-specific) — summary of the RTC-retained
+     * cycle records, decoded by the z2m converter as `wake_timing`. A
+     * manufacturer attr on the standard Basic cluster, for the same reason as
+     * above. Seeded from the retained ring so a read before the first report
+     * cycle returns valid data. */
+    wake_timing_pack_zcl(wake_timing_log(), s_wake_timing_zcl);
+    esp_zb_cluster_add_manufacturer_attr(basic_attrs, ESP_ZB_ZCL_CLUSTER_ID_BASIC,
+                                         ZB_ATTR_WAKE_TIMING, OTA_MANUFACTURER_CODE,
+                                         ESP_ZB_ZCL_ATTR_TYPE_OCTET_STRING,
+                                         ESP_ZB_ZCL_ATTR_ACCESS_READ_ONLY,
+                                         s_wake_timing_zcl);
+    esp_zb_cluster_add_manufacturer_attr(basic_attrs, ESP_ZB_ZCL_CLUSTER_ID_BASIC,
+                                         ZB_ATTR_MEAN_NAH, OTA_MANUFACTURER_CODE,
+                                         ESP_ZB_ZCL_ATTR_TYPE_U32,
+                                         ESP_ZB_ZCL_ATTR_ACCESS_READ_ONLY,
+                                         &s_mean_nah);
+    esp_zb_cluster_add_manufacturer_attr(basic_attrs, ESP_ZB_ZCL_CLUSTER_ID_BASIC,
+                                         ZB_ATTR_DAYS_LEFT_X10, OTA_MANUFACTURER_CODE,
+                                         ESP_ZB_ZCL_ATTR_TYPE_U16,
+                                         ESP_ZB_ZCL_ATTR_ACCESS_READ_ONLY,
+                                         &s_days_left_x10);
+
     /* ---- Identify cluster ---- */
     esp_zb_identify_cluster_cfg_t identify_cfg = { .identify_time = 0 };
     esp_zb_attribute_list_t *identify_attrs = esp_zb_identify_cluster_create(&identify_cfg);
@@ -442,6 +496,25 @@ static void esp_zb_task(void *pv)
         .app_device_version  = 0,
     };
     esp_zb_ep_list_add_ep(ep_list, clusters, ep_cfg);
+
+    /* Extra soil probes: one endpoint each, carrying only a humidity-measurement
+     * cluster, so every depth shows up as its own soil_moisture in z2m. Adding
+     * endpoints changes the simple descriptors — re-interview after changing
+     * SOIL_PROBE_COUNT. */
+    for (size_t p = 1; p < SOIL_PROBE_COUNT; p++) {
+        esp_zb_humidity_meas_cluster_cfg_t probe_cfg = {
+            .measured_value = 0,
+            .min_value      = 0,
+            .max_value      = 10000,
+        };
+        esp_zb_cluster_list_t *probe_clusters = esp_zb_zcl_cluster_list_create();
+        esp_zb_cluster_list_add_humidity_meas_cluster(probe_clusters,
+                                                      esp_zb_humidity_meas_cluster_create(&probe_cfg),
+                                                      ESP_ZB_ZCL_CLUSTER_SERVER_ROLE);
+        esp_zb_endpoint_config_t probe_ep_cfg = ep_cfg;
+        probe_ep_cfg.endpoint = (uint8_t)(APP_ENDPOINT + p);
+        esp_zb_ep_list_add_ep(ep_list, probe_clusters, probe_ep_cfg);
+    }
     esp_zb_device_register(ep_list);
 
     /* Configure device-side reporting so the stack auto-emits reports on value
@@ -449,11 +522,14 @@ static void esp_zb_task(void *pv)
      * device, and the explicit report command asserts in this SDK — so the
      * stack's own reporting engine is the only working push. min_interval=1s,
      * max_interval=0 (report on change only), with a small reportable delta. */
-    config_reporting(ESP_ZB_ZCL_CLUSTER_ID_REL_HUMIDITY_MEASUREMENT,
-                     ESP_ZB_ZCL_ATTR_REL_HUMIDITY_MEASUREMENT_VALUE_ID, 10);  /* 0.1% */
-    config_reporting(ESP_ZB_ZCL_CLUSTER_ID_POWER_CONFIG,
+    for (size_t p = 0; p < SOIL_PROBE_COUNT; p++) {
+        config_reporting((uint8_t)(APP_ENDPOINT + p),
+                         ESP_ZB_ZCL_CLUSTER_ID_REL_HUMIDITY_MEASUREMENT,
+                         ESP_ZB_ZCL_ATTR_REL_HUMIDITY_MEASUREMENT_VALUE_ID, 10);  /* 0.1% */
+    }
+    config_reporting(APP_ENDPOINT, ESP_ZB_ZCL_CLUSTER_ID_POWER_CONFIG,
                      ESP_ZB_ZCL_ATTR_POWER_CONFIG_BATTERY_VOLTAGE_ID, 1);
-    config_reporting(ESP_ZB_ZCL_CLUSTER_ID_POWER_CONFIG,
+    config_reporting(APP_ENDPOINT, ESP_ZB_ZCL_CLUSTER_ID_POWER_CONFIG,
                      ESP_ZB_ZCL_ATTR_POWER_CONFIG_BATTERY_PERCENTAGE_REMAINING_ID, 1);
 
     /* Scan all 2.4 GHz channels (11–26). */
@@ -517,7 +593,8 @@ bool zigbee_reporter_wait_ready(uint32_t timeout_ms)
     return s_joined;
 }
 
-esp_err_t zigbee_reporter_report(float soil_pct, float battery_v, float battery_pct)
+esp_err_t zigbee_reporter_report(const uint16_t *soil_pct_x100, size_t n_probes,
+                                 int battery_mv, uint16_t battery_pct_x100)
 {
     /* Caller is an external FreeRTOS task (not the Zigbee stack task), so we
      * must take the Zigbee lock before touching ZCL data structures. */
@@ -526,7 +603,7 @@ esp_err_t zigbee_reporter_report(float soil_pct, float battery_v, float battery_
         return ESP_FAIL;
     }
 
-    update_attributes_no_lock(soil_pct, battery_v, battery_pct);
+    update_attributes_no_lock(soil_pct_x100, n_probes, battery_mv, battery_pct_x100);
 
     /* NOTE: esp_zb_zcl_report_attr_cmd_req() asserts in this SDK version
      * (zcl_general_commands.c:612) for both custom AND standard clusters, so we
@@ -536,10 +613,50 @@ esp_err_t zigbee_reporter_report(float soil_pct, float battery_v, float battery_
 
     esp_zb_lock_release();
 
-    ESP_LOGI(TAG, "reported (external) soil=%.1f%% batt=%.2fV (%.0f%%)",
-             soil_pct, battery_v, battery_pct);
+    ESP_LOGI(TAG, "reported (external) soil=%u.%02u%% (%u probe%s) batt=%d mV (%u.%02u%%)",
+             soil_pct_x100[0] / 100U, soil_pct_x100[0] % 100U,
+             (unsigned)n_probes, n_probes == 1 ? "" : "s", battery_mv,
+             battery_pct_x100 / 100U, battery_pct_x100 % 100U);
 
     return ESP_OK;
 }
 
+esp_err_t zigbee_reporter_set_wake_timing(const uint8_t *zcl_octets)
+{
+    if (!esp_zb_lock_acquire(portMAX_DELAY)) {
+        ESP_LOGE(TAG, "Failed to acquire Zigbee lock");
+        return ESP_FAIL;
+    }
+    memcpy(s_wake_timing_zcl, zcl_octets, sizeof(s_wake_timing_zcl));
+    esp_zb_zcl_set_manufacturer_attribute_val(APP_ENDPOINT,
+                                              ESP_ZB_ZCL_CLUSTER_ID_BASIC,
+                                              ESP_ZB_ZCL_CLUSTER_SERVER_ROLE,
+                                              OTA_MANUFACTURER_CODE,
+                                              ZB_ATTR_WAKE_TIMING,
+                                              s_wake_timing_zcl,
+                                              false);
+    esp_zb_lock_release();
+    return ESP_OK;
+}
+
+esp_err_t zigbee_reporter_set_energy(uint32_t mean_nah, uint32_t days_left_x10)
+{
+    if (!esp_zb_lock_acquire(portMAX_DELAY)) {
+        ESP_LOGE(TAG, "Failed to acquire Zigbee lock");
+        return ESP_FAIL;
+    }
+    s_mean_nah      = mean_nah;
+    s_days_left_x10 = days_left_x10 > UINT16_MAX ? UINT16_MAX : (uint16_t)days_left_x10;
+    esp_zb_zcl_set_manufacturer_attribute_val(APP_ENDPOINT, ESP_ZB_ZCL_CLUSTER_ID_BASIC,
+                                              ESP_ZB_ZCL_CLUSTER_SERVER_ROLE,
+                                              OTA_MANUFACTURER_CODE, ZB_ATTR_MEAN_NAH,
+                                              &s_mean_nah, false);
+    esp_zb_zcl_set_manufacturer_attribute_val(APP_ENDPOINT, ESP_ZB_ZCL_CLUSTER_ID_BASIC,
+                                              ESP_ZB_ZCL_CLUSTER_SERVER_ROLE,
+                                              OTA_MANUFACTURER_CODE, ZB_ATTR_DAYS_LEFT_X10,
+                                              &s_days_left_x10, false);
+    esp_zb_lock_release();
+    return ESP_OK;
+}
+
 #endif /* USE_ZIGBEE */
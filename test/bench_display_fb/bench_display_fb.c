@@ -0,0 +1,103 @@
+#define _POSIX_C_SOURCE 199309L   // clock_gettime under -std=c11
+// Host micro-benchmark: display_fb blitters against the per-pixel renderer
+// they replaced. Not in the default native test_filter (timings are
+// machine-dependent); run explicitly with:
+//   pio test -e native -f bench_display_fb -v
+#include <unity.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#define TEST_HOST 1
+#include "../../src/crc32.c"
+#include "../../src/display_fb.c"
+#include "../display_fb_ref.h"
+#include "display_assets.h"
+
+#define ITERATIONS 2000
+
+static uint8_t fb[DISPLAY_FB_SIZE];
+
+void setUp(void) {}
+void tearDown(void) {}
+
+static double now_us(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e6 + ts.tv_nsec / 1e3;
+}
+
+typedef void (*blit_fn)(uint8_t *, int, int, const uint8_t *, int, int);
+typedef void (*hline_fn)(uint8_t *, int, int, int);
+
+static const uint8_t *small_glyph(char c) {
+    return &display_font_small[(c - DISPLAY_FONT_SMALL_FIRST) * DISPLAY_FONT_SMALL_H];
+}
+
+static void text(blit_fn blit, int x, int y, const char *s) {
+    for (; *s; s++, x += DISPLAY_FONT_SMALL_W) {
+        blit(fb, x, y, small_glyph(*s), DISPLAY_FONT_SMALL_W, DISPLAY_FONT_SMALL_H);
+    }
+}
+
+// Roughly the telemetry view: 2x header, three hero digits, rules, six
+// small-font lines and both icons. Off-byte x positions, as the layout has.
+static void compose(blit_fn blit, blit_fn blit_2x, hline_fn hline) {
+    int large = ((DISPLAY_FONT_LARGE_W + 7) / 8) * DISPLAY_FONT_LARGE_H;
+    memset(fb, 0xFF, sizeof(fb));
+    for (int i = 0; i < 8; i++) {
+        blit_2x(fb, 13 + i * 12, 4, small_glyph("GREENBED"[i]),
+                DISPLAY_FONT_SMALL_W, DISPLAY_FONT_SMALL_H);
+    }
+    hline(fb, 4, 24, DISPLAY_W - 8);
+    for (int i = 0; i < 5; i++) {
+        blit(fb, 1 + i * DISPLAY_FONT_LARGE_W, 36, &display_font_large[(i % 10) * large],
+             DISPLAY_FONT_LARGE_W, DISPLAY_FONT_LARGE_H);
+    }
+    hline(fb, 4, 80, DISPLAY_W - 8);
+    static const char *lines[] = { "RAW", "1843 mV", "BATTERY", "3.87 V  74%", "WIFI", "-61 dBm" };
+    for (int i = 0; i < 6; i++) {
+        text(blit, 6 + (i & 1) * 40, 96 + i * 14, lines[i]);
+    }
+    hline(fb, 4, 190, DISPLAY_W - 8);
+    blit(fb, 6, 200, display_icon_battery, DISPLAY_ICON_BATTERY_W, DISPLAY_ICON_BATTERY_H);
+    blit(fb, 31, 200, display_icon_wifi, DISPLAY_ICON_WIFI_W, DISPLAY_ICON_WIFI_H);
+}
+
+static double bench_compose(blit_fn blit, blit_fn blit_2x, hline_fn hline) {
+    double t0 = now_us();
+    for (int it = 0; it < ITERATIONS; it++) {
+        compose(blit, blit_2x, hline);
+    }
+    return (now_us() - t0) / ITERATIONS;
+}
+
+static double bench_qr(blit_fn blit) {
+    double t0 = now_us();
+    for (int it = 0; it < ITERATIONS; it++) {
+        blit(fb, 23, 60, display_qr, DISPLAY_QR_W, DISPLAY_QR_H);
+    }
+    return (now_us() - t0) / ITERATIONS;
+}
+
+static void report(const char *what, double ref_us, double fast_us) {
+    char msg[96];
+    snprintf(msg, sizeof(msg), "%-10s per-pixel %7.2f us   blitter %6.2f us   x%.1f",
+             what, ref_us, fast_us, ref_us / fast_us);
+    TEST_MESSAGE(msg);
+}
+
+static void test_bench_all(void) {
+    double ref = bench_compose(ref_blit, ref_blit_2x, ref_hline);
+    uint32_t ref_crc = crc32_update(0, fb, sizeof(fb));
+    double fast = bench_compose(display_fb_blit, display_fb_blit_2x, display_fb_hline);
+    TEST_ASSERT_EQUAL_UINT32(ref_crc, crc32_update(0, fb, sizeof(fb)));
+    report("telemetry", ref, fast);
+    report("qr 75x75", bench_qr(ref_blit), bench_qr(display_fb_blit));
+}
+
+int main(void) {
+    UNITY_BEGIN();
+    RUN_TEST(test_bench_all);
+    return UNITY_END();
+}
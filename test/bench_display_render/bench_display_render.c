@@ -0,0 +1,82 @@
+#define _POSIX_C_SOURCE 199309L   // clock_gettime under -std=c11
+// Host micro-benchmark: time to compose each e-paper view. Not in the
+// default native test_filter (timings are machine-dependent); run
+// explicitly with:
+//   pio test -e native -f bench_display_render -v
+#include <unity.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#define TEST_HOST 1
+#include "../../src/display_fb.c"
+#include "../../src/crc32.c"
+#include "../../src/display_render.c"
+
+#define ITERATIONS 5000
+
+static uint8_t fb[DISPLAY_FB_SIZE];
+static volatile int sink;
+
+static const display_telemetry_t SAMPLE = {
+    .device_id     = "tree-bed-3",
+    .moisture_pct  = 41.25f,
+    .raw_mv        = 1843,
+    .battery_v     = 3.87f,
+    .battery_pct   = 74,
+    .wifi_rssi_dbm = -61,
+};
+
+void setUp(void) {}
+void tearDown(void) {}
+
+static double now_us(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e6 + ts.tv_nsec / 1e3;
+}
+
+static void report(const char *view, double t0) {
+    char msg[96];
+    snprintf(msg, sizeof(msg), "%-12s %7.2f us/composition  (crc %08x)",
+             view, (now_us() - t0) / ITERATIONS, (unsigned)crc32_update(0, fb, sizeof(fb)));
+    TEST_MESSAGE(msg);
+}
+
+static void test_bench_all(void) {
+    double t0 = now_us();
+    for (int it = 0; it < ITERATIONS; it++) {
+        display_render_telemetry(fb, &SAMPLE);
+    }
+    report("telemetry", t0);
+
+    t0 = now_us();
+    for (int it = 0; it < ITERATIONS; it++) {
+        display_render_portal(fb);
+    }
+    report("portal", t0);
+
+    t0 = now_us();
+    for (int it = 0; it < ITERATIONS; it++) {
+        display_render_low_battery(fb, 3.21f);
+    }
+    report("low_battery", t0);
+
+    // Composition plus the unchanged-frame check display_show_*() makes
+    // before touching the panel.
+    display_shown_t h;
+    display_shown_reset(&h);
+    display_shown_note(&h, fb, DISPLAY_VIEW_TELEMETRY, DISPLAY_REFRESH_FULL);
+    t0 = now_us();
+    for (int it = 0; it < ITERATIONS; it++) {
+        display_render_telemetry(fb, &SAMPLE);
+        sink = display_shown_same(&h, fb, DISPLAY_VIEW_TELEMETRY);
+    }
+    report("tel.+hash", t0);
+}
+
+int main(void) {
+    UNITY_BEGIN();
+    RUN_TEST(test_bench_all);
+    return UNITY_END();
+}
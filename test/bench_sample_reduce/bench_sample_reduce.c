@@ -0,0 +1,68 @@
+#define _POSIX_C_SOURCE 199309L   // clock_gettime under -std=c11
+// Host micro-benchmark for the sample reducers. Not in the default native
+// test_filter (timings are machine-dependent); run explicitly with:
+//   pio test -e native -f bench_sample_reduce -v
+#include <unity.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#define TEST_HOST 1
+#include "../../src/sample_reduce.c"
+
+#define ITERATIONS 200000
+
+void setUp(void) {}
+void tearDown(void) {}
+
+// Deterministic noisy burst (LCG) with one glitch, like a real soil read.
+static void make_burst(int *b, size_t n, uint32_t seed) {
+    for (size_t i = 0; i < n; i++) {
+        seed = seed * 1664525u + 1013904223u;
+        b[i] = 1850 + (int)((seed >> 24) % 9) - 4;
+    }
+    b[n / 3] = 4095;
+}
+
+static double now_us(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e6 + ts.tv_nsec / 1e3;
+}
+
+static volatile int sink;
+
+static void bench(const char *name, int algo, size_t n) {
+    int src[SAMPLE_REDUCE_MAX_N], b[SAMPLE_REDUCE_MAX_N];
+    make_burst(src, n, 12345u);
+    double t0 = now_us();
+    for (int it = 0; it < ITERATIONS; it++) {
+        memcpy(b, src, n * sizeof(int));
+        switch (algo) {
+        case SAMPLE_REDUCE_MEAN:    sink = sample_reduce_mean(b, n); break;
+        case SAMPLE_REDUCE_MEDIAN:  sink = sample_reduce_median(b, n); break;
+        case SAMPLE_REDUCE_TRIMMED: sink = sample_reduce_trimmed_mean(b, n, SAMPLE_REDUCE_TRIM); break;
+        default:                    sink = sample_reduce_mad(b, n, SAMPLE_REDUCE_MAD_K_X10); break;
+        }
+    }
+    double ns = (now_us() - t0) * 1000.0 / ITERATIONS;
+    char msg[96];
+    snprintf(msg, sizeof(msg), "%-8s n=%2zu  %8.1f ns/reduce  -> %d", name, n, ns, sink);
+    TEST_MESSAGE(msg);
+}
+
+static void test_bench_all(void) {
+    static const size_t sizes[] = { 5, 8, 10, 32 };
+    for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+        bench("mean",    SAMPLE_REDUCE_MEAN,    sizes[i]);
+        bench("median",  SAMPLE_REDUCE_MEDIAN,  sizes[i]);
+        bench("trimmed", SAMPLE_REDUCE_TRIMMED, sizes[i]);
+        bench("mad",     SAMPLE_REDUCE_MAD,     sizes[i]);
+    }
+}
+
+int main(void) {
+    UNITY_BEGIN();
+    RUN_TEST(test_bench_all);
+    return UNITY_END();
+}
@@ -0,0 +1,50 @@
+// Per-pixel reference renderer: the drawing code display.c used before the
+// blitter, kept for the golden tests and the benchmark. Output of the
+// display_fb_* blitters must match it byte for byte.
+#ifndef DISPLAY_FB_REF_H
+#define DISPLAY_FB_REF_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "display_fb.h"
+
+static inline void ref_pixel(uint8_t *fb, int x, int y) {
+    if (x < 0 || x >= DISPLAY_W || y < 0 || y >= DISPLAY_H_PX) return;
+    fb[y * DISPLAY_BPR + (x >> 3)] &= (uint8_t)~(0x80 >> (x & 7));
+}
+
+static void ref_hline(uint8_t *fb, int x, int y, int w) {
+    for (int i = 0; i < w; i++) {
+        ref_pixel(fb, x + i, y);
+    }
+}
+
+static void ref_blit(uint8_t *fb, int x, int y, const uint8_t *bm, int w, int h) {
+    int bpr = (w + 7) / 8;
+    for (int row = 0; row < h; row++) {
+        for (int col = 0; col < w; col++) {
+            if (bm[row * bpr + (col >> 3)] & (0x80 >> (col & 7))) {
+                ref_pixel(fb, x + col, y + row);
+            }
+        }
+    }
+}
+
+static void ref_blit_2x(uint8_t *fb, int x, int y, const uint8_t *bm, int w, int h) {
+    int bpr = (w + 7) / 8;
+    for (int row = 0; row < h; row++) {
+        for (int col = 0; col < w; col++) {
+            if (bm[row * bpr + (col >> 3)] & (0x80 >> (col & 7))) {
+                int px = x + col * 2;
+                int py = y + row * 2;
+                ref_pixel(fb, px,     py);
+                ref_pixel(fb, px + 1, py);
+                ref_pixel(fb, px,     py + 1);
+                ref_pixel(fb, px + 1, py + 1);
+            }
+        }
+    }
+}
+
+#endif // DISPLAY_FB_REF_H
@@ -0,0 +1,124 @@
+// Host lifetime simulator over the firmware's energy model. Not in the default
+// native test_filter (it prints a planning table rather than checking
+// behaviour); run explicitly with:
+//   pio test -e native -f sim_lifetime -v
+//
+// Each scenario replays wakes with phase durations drawn around a measured
+// profile (the "timing" telemetry is the source for these), charges them with
+// the same energy_model tables the device uses, and discharges a cell down to
+// the low-battery cutoff SoC.
+#include <unity.h>
+#include <stdio.h>
+#include <string.h>
+
+#define TEST_HOST 1
+#include "../../src/crc32.c"
+#include "../../src/telemetry_enc.c"
+#include "../../src/wake_timing.c"
+#include "../../src/energy_model.c"
+
+#define CUTOFF_PCT_X100  2000          // BATTERY_LOW_CUTOFF_V sits at the 20 % knee
+#define SITE_NODES       400
+
+void setUp(void) {}
+void tearDown(void) {}
+
+typedef struct {
+    const char *name;
+    const energy_model_t *model;
+    uint32_t interval_s;
+    uint32_t phase_ms[WAKE_PHASE_COUNT];   // typical duration; 0 = phase not entered
+    uint32_t jitter_pct;                   // +/- spread applied to NET/CONNECT
+    uint32_t report_every;                 // radio on one wake in N (report_policy); 0/1 = all
+} scenario_t;
+
+static const scenario_t SCENARIOS[] = {
+    { "wifi, good signal", &ENERGY_MODEL_WIFI, 3600,
+      { [WAKE_PHASE_BOOT] = 85, [WAKE_PHASE_INIT] = 140, [WAKE_PHASE_OCV] = 10,
+        [WAKE_PHASE_NET] = 1800, [WAKE_PHASE_BROKER] = 30, [WAKE_PHASE_CONNECT] = 300,
+        [WAKE_PHASE_SENSE] = 60, [WAKE_PHASE_PUBLISH] = 500, [WAKE_PHASE_DISPLAY] = 600 }, 20, 1 },
+    { "wifi, change-driven", &ENERGY_MODEL_WIFI, 3600,
+      { [WAKE_PHASE_BOOT] = 85, [WAKE_PHASE_INIT] = 140, [WAKE_PHASE_OCV] = 10,
+        [WAKE_PHASE_NET] = 1800, [WAKE_PHASE_BROKER] = 30, [WAKE_PHASE_CONNECT] = 300,
+        [WAKE_PHASE_SENSE] = 60, [WAKE_PHASE_PUBLISH] = 500, [WAKE_PHASE_DISPLAY] = 600 }, 20, 4 },
+    { "wifi, weak signal", &ENERGY_MODEL_WIFI, 3600,
+      { [WAKE_PHASE_BOOT] = 85, [WAKE_PHASE_INIT] = 140, [WAKE_PHASE_OCV] = 10,
+        [WAKE_PHASE_NET] = 4500, [WAKE_PHASE_BROKER] = 30, [WAKE_PHASE_CONNECT] = 900,
+        [WAKE_PHASE_SENSE] = 60, [WAKE_PHASE_PUBLISH] = 500, [WAKE_PHASE_DISPLAY] = 600 }, 60, 1 },
+    { "zigbee, 15 min", &ENERGY_MODEL_ZIGBEE, 900,
+      { [WAKE_PHASE_ADC] = 1, [WAKE_PHASE_SENSE] = 60, [WAKE_PHASE_PUBLISH] = 20,
+        [WAKE_PHASE_DISPLAY] = 600 }, 0, 1 },
+};
+
+static uint32_t lcg(uint32_t *s) {
+    *s = *s * 1664525u + 1013904223u;
+    return *s >> 8;
+}
+
+// Phases a suppressed wake never enters: it sleeps straight after SENSE.
+#define RADIO_PHASES ((1u << WAKE_PHASE_NET) | (1u << WAKE_PHASE_BROKER) | \
+                      (1u << WAKE_PHASE_CONNECT) | (1u << WAKE_PHASE_PUBLISH) | \
+                      (1u << WAKE_PHASE_DISPLAY))
+
+static void make_record(const scenario_t *sc, uint32_t *seed, bool radio,
+                        wake_timing_record_t *r) {
+    memset(r, 0, sizeof(*r));
+    for (int p = 0; p < WAKE_PHASE_COUNT; p++) {
+        if (!sc->phase_ms[p]) continue;
+        if (!radio && (RADIO_PHASES & (1u << p))) continue;
+        uint32_t us = sc->phase_ms[p] * 1000u;
+        if (sc->jitter_pct && (p == WAKE_PHASE_NET || p == WAKE_PHASE_CONNECT)) {
+            uint32_t span = us / 100u * sc->jitter_pct;
+            us = us - span + lcg(seed) % (2 * span + 1);
+        }
+        r->phase_us[p]  = us;
+        r->phase_mask  |= (uint16_t)(1u << p);
+        r->total_us    += us;
+    }
+    r->total_us += 50000;                  // logging / glue between phases at idle
+}
+
+// Days until the cell reaches the cutoff, replaying one cycle at a time.
+static double simulate_days(const scenario_t *sc, uint32_t seed, double *mah_per_wake) {
+    const uint64_t usable_nah = (uint64_t)(10000 - CUTOFF_PCT_X100) * ENERGY_BATTERY_MAH *
+                                (ENERGY_NAH_PER_MAH / 10000);
+    energy_ledger_t led;
+    energy_ledger_reset(&led, 10000);
+    uint64_t elapsed_s = 0;
+    while (led.total_nah < usable_nah) {
+        wake_timing_record_t r;
+        make_record(sc, &seed, sc->report_every <= 1 || led.wakes % sc->report_every == 0, &r);
+        uint64_t nah = energy_model_wake_nah(sc->model, &r) +
+                       energy_model_sleep_nah(sc->model, sc->interval_s);
+        energy_ledger_add(&led, nah, sc->interval_s);
+        elapsed_s += sc->interval_s;
+    }
+    *mah_per_wake = (double)led.total_nah / led.wakes / (double)ENERGY_NAH_PER_MAH;
+    return elapsed_s / 86400.0;
+}
+
+static void test_simulate_scenarios(void) {
+    double good = 0, weak = 0, driven = 0;
+    for (size_t i = 0; i < sizeof(SCENARIOS) / sizeof(SCENARIOS[0]); i++) {
+        const scenario_t *sc = &SCENARIOS[i];
+        double per_wake;
+        double days = simulate_days(sc, 0xC0FFEEu + (uint32_t)i, &per_wake);
+        double site_mah_day = per_wake * (86400.0 / sc->interval_s) * SITE_NODES;
+        char msg[160];
+        snprintf(msg, sizeof(msg),
+                 "%-19s %7.4f mAh/wake  %6.0f days to %d%%  site(%d): %7.0f mAh/day",
+                 sc->name, per_wake, days, CUTOFF_PCT_X100 / 100, SITE_NODES, site_mah_day);
+        TEST_MESSAGE(msg);
+        if (i == 0) good = days;
+        if (i == 1) driven = days;
+        if (i == 2) weak = days;
+    }
+    TEST_ASSERT_TRUE(weak < good);
+    TEST_ASSERT_TRUE(driven > good);
+}
+
+int main(void) {
+    UNITY_BEGIN();
+    RUN_TEST(test_simulate_scenarios);
+    return UNITY_END();
+}
@@ -0,0 +1,93 @@
+#include <unity.h>
+
+#define TEST_HOST 1
+#include "../../src/adc_frame.c"
+
+void setUp(void) {}
+void tearDown(void) {}
+
+// Pack one TYPE2 result the way the C6 DMA engine writes it (little-endian).
+static void put_result(uint8_t *p, int unit, int chan, int code) {
+    uint32_t w = ((uint32_t)code & 0xFFF) | ((uint32_t)chan << 13) | ((uint32_t)unit << 16);
+    p[0] = (uint8_t)w; p[1] = (uint8_t)(w >> 8); p[2] = (uint8_t)(w >> 16); p[3] = (uint8_t)(w >> 24);
+}
+
+static void test_deinterleaves_two_channels(void) {
+    uint8_t buf[6 * 4];
+    put_result(buf +  0, 0, 0, 2100);
+    put_result(buf +  4, 0, 2, 1500);
+    put_result(buf +  8, 0, 0, 2101);
+    put_result(buf + 12, 0, 2, 1501);
+    put_result(buf + 16, 0, 0, 2102);
+    put_result(buf + 20, 0, 2, 1502);
+
+    int bat[3], soil[3];
+    adc_frame_lane_t lanes[] = {
+        { .channel = 0, .samples = bat,  .capacity = 3 },
+        { .channel = 2, .samples = soil, .capacity = 3 },
+    };
+    TEST_ASSERT_EQUAL_INT(6, adc_frame_deinterleave(buf, sizeof(buf), lanes, 2));
+    TEST_ASSERT_EQUAL_INT(3, lanes[0].count);
+    TEST_ASSERT_EQUAL_INT(3, lanes[1].count);
+    TEST_ASSERT_EQUAL_INT(2100, bat[0]);
+    TEST_ASSERT_EQUAL_INT(2102, bat[2]);
+    TEST_ASSERT_EQUAL_INT(1500, soil[0]);
+    TEST_ASSERT_EQUAL_INT(1502, soil[2]);
+    TEST_ASSERT_TRUE(adc_frame_lanes_full(lanes, 2));
+}
+
+static void test_full_scale_code_survives(void) {
+    uint8_t buf[4];
+    put_result(buf, 0, 2, 4095);
+    int soil[1];
+    adc_frame_lane_t lane = { .channel = 2, .samples = soil, .capacity = 1 };
+    adc_frame_deinterleave(buf, sizeof(buf), &lane, 1);
+    TEST_ASSERT_EQUAL_INT(4095, soil[0]);
+}
+
+static void test_skips_adc2_and_unknown_channels(void) {
+    uint8_t buf[3 * 4];
+    put_result(buf + 0, 1, 2, 111);   // ADC2 — never ours
+    put_result(buf + 4, 0, 5, 222);   // no lane for CH5
+    put_result(buf + 8, 0, 2, 333);
+    int soil[4];
+    adc_frame_lane_t lane = { .channel = 2, .samples = soil, .capacity = 4 };
+    TEST_ASSERT_EQUAL_INT(1, adc_frame_deinterleave(buf, sizeof(buf), &lane, 1));
+    TEST_ASSERT_EQUAL_INT(333, soil[0]);
+    TEST_ASSERT_FALSE(adc_frame_lanes_full(&lane, 1));
+}
+
+static void test_drops_overflow_beyond_capacity(void) {
+    uint8_t buf[3 * 4];
+    for (int i = 0; i < 3; i++) put_result(buf + 4 * i, 0, 0, 10 + i);
+    int bat[2];
+    adc_frame_lane_t lane = { .channel = 0, .samples = bat, .capacity = 2 };
+    TEST_ASSERT_EQUAL_INT(2, adc_frame_deinterleave(buf, sizeof(buf), &lane, 1));
+    TEST_ASSERT_EQUAL_INT(11, bat[1]);
+}
+
+static void test_ignores_trailing_partial_result(void) {
+    uint8_t buf[4 + 3] = {0};
+    put_result(buf, 0, 0, 42);
+    int bat[2];
+    adc_frame_lane_t lane = { .channel = 0, .samples = bat, .capacity = 2 };
+    TEST_ASSERT_EQUAL_INT(1, adc_frame_deinterleave(buf, sizeof(buf), &lane, 1));
+}
+
+static void test_resets_counts_and_handles_null_buffer(void) {
+    int bat[2];
+    adc_frame_lane_t lane = { .channel = 0, .samples = bat, .capacity = 2, .count = 2 };
+    TEST_ASSERT_EQUAL_INT(0, adc_frame_deinterleave(NULL, 8, &lane, 1));
+    TEST_ASSERT_EQUAL_INT(0, lane.count);
+}
+
+int main(void) {
+    UNITY_BEGIN();
+    RUN_TEST(test_deinterleaves_two_channels);
+    RUN_TEST(test_full_scale_code_survives);
+    RUN_TEST(test_skips_adc2_and_unknown_channels);
+    RUN_TEST(test_drops_overflow_beyond_capacity);
+    RUN_TEST(test_ignores_trailing_partial_result);
+    RUN_TEST(test_resets_counts_and_handles_null_buffer);
+    return UNITY_END();
+}
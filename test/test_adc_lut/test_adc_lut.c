@@ -0,0 +1,122 @@
+#include <unity.h>
+#include <string.h>
+
+#define TEST_HOST 1
+#include "../../src/crc32.c"
+#include "../../src/adc_lut.c"
+
+void setUp(void) {}
+void tearDown(void) {}
+
+// Stand-in for the C6 12 dB curve-fitting scheme: near-linear with a gentle
+// second-order bow, ~0-3100 mV over the code range.
+static int fake_curve_mv(int raw) {
+    return (raw * 3100) / 4095 + (raw * (4095 - raw)) / 40000;
+}
+
+static bool fake_convert(int raw, int *mv, void *ctx) {
+    (void)ctx;
+    *mv = fake_curve_mv(raw);
+    return true;
+}
+
+static bool failing_convert(int raw, int *mv, void *ctx) {
+    (void)ctx; (void)mv;
+    return raw < 1000;
+}
+
+static adc_lut_knots_t knots;
+static uint16_t table[ADC_LUT_CODES];
+
+// ---- crc32 ----
+
+static void test_crc32_check_value(void) {
+    TEST_ASSERT_EQUAL_HEX32(0xCBF43926u, crc32_update(0, "123456789", 9));
+}
+
+static void test_crc32_chains(void) {
+    uint32_t c = crc32_update(0, "1234", 4);
+    TEST_ASSERT_EQUAL_HEX32(0xCBF43926u, crc32_update(c, "56789", 5));
+}
+
+// ---- knot layout ----
+
+static void test_knot_codes_cover_full_range(void) {
+    TEST_ASSERT_EQUAL_INT(65, ADC_LUT_KNOTS);
+    TEST_ASSERT_EQUAL_INT(0, adc_lut_knot_code(0));
+    TEST_ASSERT_EQUAL_INT(64, adc_lut_knot_code(1));
+    TEST_ASSERT_EQUAL_INT(4095, adc_lut_knot_code(ADC_LUT_KNOTS - 1));
+}
+
+// ---- build / validate ----
+
+static void test_built_knots_validate(void) {
+    TEST_ASSERT_TRUE(adc_lut_build_knots(&knots, 2, 3, fake_convert, NULL));
+    TEST_ASSERT_TRUE(adc_lut_knots_valid(&knots, 2, 3));
+}
+
+static void test_wrong_version_or_atten_rejected(void) {
+    adc_lut_build_knots(&knots, 2, 3, fake_convert, NULL);
+    TEST_ASSERT_FALSE(adc_lut_knots_valid(&knots, 1, 3));
+    TEST_ASSERT_FALSE(adc_lut_knots_valid(&knots, 2, 0));
+}
+
+static void test_corrupt_knot_rejected(void) {
+    adc_lut_build_knots(&knots, 2, 3, fake_convert, NULL);
+    knots.knot_mv[17] ^= 0x0004;
+    TEST_ASSERT_FALSE(adc_lut_knots_valid(&knots, 2, 3));
+}
+
+static void test_uninitialised_rtc_rejected(void) {
+    memset(&knots, 0, sizeof(knots));
+    TEST_ASSERT_FALSE(adc_lut_knots_valid(&knots, 0, 0));
+}
+
+static void test_failed_conversion_leaves_set_invalid(void) {
+    TEST_ASSERT_FALSE(adc_lut_build_knots(&knots, 2, 3, failing_convert, NULL));
+    TEST_ASSERT_FALSE(adc_lut_knots_valid(&knots, 2, 3));
+}
+
+// ---- expanded table ----
+
+static void test_table_hits_knots_exactly(void) {
+    adc_lut_build_knots(&knots, 2, 3, fake_convert, NULL);
+    adc_lut_expand(&knots, table);
+    for (int i = 0; i < ADC_LUT_KNOTS; i++) {
+        int c = adc_lut_knot_code(i);
+        TEST_ASSERT_EQUAL_INT(fake_curve_mv(c), adc_lut_lookup(table, c));
+    }
+}
+
+// The fake curve itself truncates to whole mV, so interpolating between
+// truncated knots can land up to 2 mV from it.
+static void test_table_within_two_mv_everywhere(void) {
+    adc_lut_build_knots(&knots, 2, 3, fake_convert, NULL);
+    adc_lut_expand(&knots, table);
+    for (int raw = 0; raw < ADC_LUT_CODES; raw++) {
+        TEST_ASSERT_INT_WITHIN(2, fake_curve_mv(raw), adc_lut_lookup(table, raw));
+    }
+}
+
+static void test_lookup_clamps_out_of_range(void) {
+    adc_lut_build_knots(&knots, 2, 3, fake_convert, NULL);
+    adc_lut_expand(&knots, table);
+    TEST_ASSERT_EQUAL_INT(table[0], adc_lut_lookup(table, -5));
+    TEST_ASSERT_EQUAL_INT(table[4095], adc_lut_lookup(table, 5000));
+}
+
+int main(void) {
+    UNITY_BEGIN();
+    RUN_TEST(test_crc32_check_value);
+    RUN_TEST(test_crc32_chains);
+    RUN_TEST(test_knot_codes_cover_full_range);
+    RUN_TEST(test_built_knots_validate);
+    RUN_TEST(test_wrong_version_or_atten_rejected);
+    RUN_TEST(test_corrupt_knot_rejected);
+    RUN_TEST(test_uninitialised_rtc_rejected);
+    RUN_TEST(test_failed_conversion_leaves_set_invalid);
+    RUN_TEST(test_table_hits_knots_exactly);
+    RUN_TEST(test_table_within_two_mv_everywhere);
+    RUN_TEST(test_lookup_clamps_out_of_range);
+    return UNITY_END();
+}
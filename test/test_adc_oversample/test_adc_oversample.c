@@ -0,0 +1,93 @@
+#include <unity.h>
+
+#define TEST_HOST 1
+#include "../../src/adc_oversample.c"
+
+void setUp(void) {}
+void tearDown(void) {}
+
+// ---- sample counts ----
+
+static void test_counts_are_powers_of_four(void) {
+    TEST_ASSERT_EQUAL_UINT32(1,  ADC_OVERSAMPLE_COUNT(0));
+    TEST_ASSERT_EQUAL_UINT32(4,  ADC_OVERSAMPLE_COUNT(1));
+    TEST_ASSERT_EQUAL_UINT32(16, ADC_OVERSAMPLE_COUNT(2));
+    TEST_ASSERT_EQUAL_UINT32(64, ADC_OVERSAMPLE_COUNT(3));
+}
+
+// ---- decimation ----
+
+static void test_zero_bits_is_rounded_mean(void) {
+    int b[] = { 100, 101, 101 };
+    TEST_ASSERT_EQUAL_INT(101, adc_oversample_decimate(b, 3, 0));
+}
+
+static void test_matches_classic_sum_shift(void) {
+    // 16 samples dithering between 1000 and 1001: classic decimation is sum >> 2.
+    int b[16];
+    int sum = 0;
+    for (int i = 0; i < 16; i++) { b[i] = 1000 + (i % 4 == 0); sum += b[i]; }
+    TEST_ASSERT_EQUAL_INT(sum >> 2, adc_oversample_decimate(b, 16, 2));
+    TEST_ASSERT_EQUAL_INT(4001, adc_oversample_decimate(b, 16, 2));   // 1000.25 in Q2
+}
+
+static void test_recovers_sub_lsb_level(void) {
+    // True level 1234.5 codes: half the samples read 1234, half 1235.
+    int b[16];
+    for (int i = 0; i < 16; i++) b[i] = 1234 + (i & 1);
+    int32_t q = adc_oversample_decimate(b, 16, 2);
+    TEST_ASSERT_EQUAL_INT(1234 * 4 + 2, q);
+    TEST_ASSERT_EQUAL_INT(1234, q >> 2);
+    TEST_ASSERT_EQUAL_INT(2, q & 3);
+}
+
+static void test_short_burst_still_averages(void) {
+    // After outlier rejection fewer than 4^n samples may remain.
+    int b[] = { 1000, 1001, 1001 };
+    TEST_ASSERT_EQUAL_INT(4003, adc_oversample_decimate(b, 3, 2));    // 1000.67 -> 4002.67 -> 4003
+}
+
+static void test_empty_burst_fails(void) {
+    int b[1] = {0};
+    TEST_ASSERT_EQUAL_INT(-1, adc_oversample_decimate(b, 0, 2));
+    TEST_ASSERT_EQUAL_INT(-1, adc_oversample_decimate(NULL, 4, 2));
+}
+
+// ---- fixed-point mV interpolation ----
+
+static void test_interp_zero_fraction_is_lower_code(void) {
+    TEST_ASSERT_EQUAL_INT(1500 * 16, adc_oversample_interp_mv(1500, 1501, 0, 2, 4));
+}
+
+static void test_interp_quarter_steps(void) {
+    // Codes 0.25 apart on a 1 mV/code slope -> 0.25 mV = 4 in Q4.
+    TEST_ASSERT_EQUAL_INT(1500 * 16 + 4,  adc_oversample_interp_mv(1500, 1501, 1, 2, 4));
+    TEST_ASSERT_EQUAL_INT(1500 * 16 + 8,  adc_oversample_interp_mv(1500, 1501, 2, 2, 4));
+    TEST_ASSERT_EQUAL_INT(1500 * 16 + 12, adc_oversample_interp_mv(1500, 1501, 3, 2, 4));
+}
+
+static void test_interp_rounds_to_nearest(void) {
+    // A quarter code on a 1 mV/code slope is 0.25 mV = 0.5 in Q1 -> rounds up to 1.
+    TEST_ASSERT_EQUAL_INT(100 * 2 + 1, adc_oversample_interp_mv(100, 101, 1, 2, 1));
+    // Flat segment: no change regardless of fraction.
+    TEST_ASSERT_EQUAL_INT(100 * 16, adc_oversample_interp_mv(100, 100, 3, 2, 4));
+}
+
+static void test_interp_handles_descending_segment(void) {
+    TEST_ASSERT_EQUAL_INT(200 * 16 - 8, adc_oversample_interp_mv(200, 199, 2, 2, 4));
+}
+
+int main(void) {
+    UNITY_BEGIN();
+    RUN_TEST(test_counts_are_powers_of_four);
+    RUN_TEST(test_zero_bits_is_rounded_mean);
+    RUN_TEST(test_matches_classic_sum_shift);
+    RUN_TEST(test_recovers_sub_lsb_level);
+    RUN_TEST(test_short_burst_still_averages);
+    RUN_TEST(test_empty_burst_fails);
+    RUN_TEST(test_interp_zero_fraction_is_lower_code);
+    RUN_TEST(test_interp_quarter_steps);
+    RUN_TEST(test_interp_rounds_to_nearest);
+    RUN_TEST(test_interp_handles_descending_segment);
+    return UNITY_END();
+}
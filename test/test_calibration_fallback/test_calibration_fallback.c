@@ -43,7 +43,9 @@ bool nvs_shim_erase_namespace(const char *ns) {
     return true;
 }
 
-// SUT
+// SUT — two probes, so the per-probe namespaces are exercised too
+#define SOIL_PROBE_COUNT 2
+#include "../../src/soil_probe.c"
 #include "../../src/soil_calibration.c"
 
 void setUp(void) { store_reset(); soil_calibration_init(); }
@@ -71,10 +73,37 @@ static void test_clear_returns_to_defaults(void) {
     TEST_ASSERT_EQUAL_UINT32(0,    soil_calibration_get_wet_mv());
 }
 
+static void test_probes_keep_separate_namespaces(void) {
+    TEST_ASSERT_TRUE(soil_calibration_save_probe(1, 2600, 1100, 7));
+    soil_calibration_init();
+    TEST_ASSERT_EQUAL_UINT32(2800, soil_calibration_get_dry_mv());
+    TEST_ASSERT_EQUAL_UINT32(2600, soil_calibration_get_probe_dry_mv(1));
+    TEST_ASSERT_EQUAL_UINT32(1100, soil_calibration_get_probe_wet_mv(1));
+    TEST_ASSERT_EQUAL_UINT32(7,    soil_calibration_get_probe_cal_ts(1));
+}
+
+static void test_clear_probe_leaves_others(void) {
+    soil_calibration_save(2950, 850, 1);
+    soil_calibration_save_probe(1, 2600, 1100, 2);
+    TEST_ASSERT_TRUE(soil_calibration_clear_probe(1));
+    soil_calibration_init();
+    TEST_ASSERT_EQUAL_UINT32(2950, soil_calibration_get_dry_mv());
+    TEST_ASSERT_EQUAL_UINT32(2800, soil_calibration_get_probe_dry_mv(1));
+}
+
+static void test_out_of_range_probe(void) {
+    TEST_ASSERT_FALSE(soil_calibration_save_probe(SOIL_PROBE_COUNT, 1, 2, 3));
+    TEST_ASSERT_FALSE(soil_calibration_clear_probe(SOIL_PROBE_COUNT));
+    TEST_ASSERT_EQUAL_UINT32(2800, soil_calibration_get_probe_dry_mv(SOIL_PROBE_COUNT));
+}
+
 int main(void) {
     UNITY_BEGIN();
     RUN_TEST(test_defaults_when_empty);
     RUN_TEST(test_save_then_reinit_returns_saved_values);
     RUN_TEST(test_clear_returns_to_defaults);
+    RUN_TEST(test_probes_keep_separate_namespaces);
+    RUN_TEST(test_clear_probe_leaves_others);
+    RUN_TEST(test_out_of_range_probe);
     return UNITY_END();
 }
@@ -0,0 +1,235 @@
+#include <unity.h>
+#include <string.h>
+
+#define TEST_HOST 1
+#include "../../src/crc32.c"
+#include "../../src/display_fb.c"
+#include "../display_fb_ref.h"
+#include "display_assets.h"
+
+static uint8_t shown[DISPLAY_FB_SIZE];
+static uint8_t next[DISPLAY_FB_SIZE];
+static display_shown_t h;
+
+void setUp(void) {
+    memset(shown, 0xFF, sizeof(shown));
+    memset(next, 0xFF, sizeof(next));
+    display_shown_reset(&h);
+}
+void tearDown(void) {}
+
+static void set_black(uint8_t *fb, int x, int y) {
+    fb[y * DISPLAY_BPR + (x >> 3)] &= (uint8_t)~(0x80 >> (x & 7));
+}
+
+static uint8_t ref[DISPLAY_FB_SIZE];
+
+static uint32_t lcg(uint32_t *seed) {
+    *seed = *seed * 1664525u + 1013904223u;
+    return *seed >> 8;
+}
+
+// Both framebuffers start from the same noise, so a blit that clears or
+// sets a bit it shouldn't is caught, not only one that misses a pixel.
+static void noise(uint32_t seed) {
+    for (int i = 0; i < DISPLAY_FB_SIZE; i++) {
+        next[i] = ref[i] = (uint8_t)(lcg(&seed) | lcg(&seed));
+    }
+}
+
+// ---- Blitter vs per-pixel reference ----
+
+static void test_hline_matches_reference(void) {
+    noise(1);
+    for (int x = -20; x < DISPLAY_W + 4; x++) {
+        for (int w = 0; w < DISPLAY_W + 24; w += 3) {
+            int y = (x + 20) * 2 + (w & 1) - 2;     // rows -2.., some off the panel
+            display_fb_hline(next, x, y, w);
+            ref_hline(ref, x, y, w);
+        }
+    }
+    TEST_ASSERT_EQUAL_MEMORY(ref, next, DISPLAY_FB_SIZE);
+}
+
+static void test_blit_matches_reference(void) {
+    uint8_t bm[10 * 40];
+    uint32_t seed = 7;
+    for (int i = 0; i < 3000; i++) {
+        int w = 1 + (int)(lcg(&seed) % 70), h = 1 + (int)(lcg(&seed) % 40);
+        int x = (int)(lcg(&seed) % (DISPLAY_W + 2 * w)) - w;
+        int y = (int)(lcg(&seed) % (DISPLAY_H_PX + 2 * h)) - h;
+        for (size_t b = 0; b < sizeof(bm); b++) bm[b] = (uint8_t)lcg(&seed);
+        noise(i);
+        display_fb_blit(next, x, y, bm, w, h);
+        ref_blit(ref, x, y, bm, w, h);
+        TEST_ASSERT_EQUAL_MEMORY(ref, next, DISPLAY_FB_SIZE);
+
+        noise(i);
+        display_fb_blit_2x(next, x, y, bm, w, h);
+        ref_blit_2x(ref, x, y, bm, w, h);
+        TEST_ASSERT_EQUAL_MEMORY(ref, next, DISPLAY_FB_SIZE);
+    }
+}
+
+// Every glyph and icon the layouts draw, at every bit alignment and across
+// both edges.
+static void test_assets_match_reference(void) {
+    int small = ((DISPLAY_FONT_SMALL_W + 7) / 8) * DISPLAY_FONT_SMALL_H;
+    int large = ((DISPLAY_FONT_LARGE_W + 7) / 8) * DISPLAY_FONT_LARGE_H;
+    int n_large = (int)sizeof(DISPLAY_FONT_LARGE_CHARS) - 1;
+    static const int xs[] = { -5, 0, 1, 2, 3, 4, 5, 6, 7, 61, 110, 119 };
+    memset(next, 0xFF, sizeof(next));
+    memset(ref, 0xFF, sizeof(ref));
+    for (size_t i = 0; i < sizeof(xs) / sizeof(xs[0]); i++) {
+        int x = xs[i];
+        for (int c = 0; c < DISPLAY_FONT_SMALL_COUNT; c++) {
+            const uint8_t *g = &display_font_small[c * small];
+            int y = (c * 3) % 240 - 4;
+            display_fb_blit(next, x, y, g, DISPLAY_FONT_SMALL_W, DISPLAY_FONT_SMALL_H);
+            ref_blit(ref, x, y, g, DISPLAY_FONT_SMALL_W, DISPLAY_FONT_SMALL_H);
+            display_fb_blit_2x(next, x + 3, y + 8, g, DISPLAY_FONT_SMALL_W, DISPLAY_FONT_SMALL_H);
+            ref_blit_2x(ref, x + 3, y + 8, g, DISPLAY_FONT_SMALL_W, DISPLAY_FONT_SMALL_H);
+        }
+        for (int c = 0; c < n_large; c++) {
+            const uint8_t *g = &display_font_large[c * large];
+            display_fb_blit(next, x, c * 20, g, DISPLAY_FONT_LARGE_W, DISPLAY_FONT_LARGE_H);
+            ref_blit(ref, x, c * 20, g, DISPLAY_FONT_LARGE_W, DISPLAY_FONT_LARGE_H);
+        }
+        display_fb_blit(next, x, 100, display_qr, DISPLAY_QR_W, DISPLAY_QR_H);
+        ref_blit(ref, x, 100, display_qr, DISPLAY_QR_W, DISPLAY_QR_H);
+        display_fb_blit(next, x, 200, display_icon_battery, DISPLAY_ICON_BATTERY_W, DISPLAY_ICON_BATTERY_H);
+        ref_blit(ref, x, 200, display_icon_battery, DISPLAY_ICON_BATTERY_W, DISPLAY_ICON_BATTERY_H);
+        display_fb_blit(next, x, 230, display_icon_wifi, DISPLAY_ICON_WIFI_W, DISPLAY_ICON_WIFI_H);
+        ref_blit(ref, x, 230, display_icon_wifi, DISPLAY_ICON_WIFI_W, DISPLAY_ICON_WIFI_H);
+        TEST_ASSERT_EQUAL_MEMORY(ref, next, DISPLAY_FB_SIZE);
+    }
+}
+
+// ---- Dirty window ----
+
+static void test_identical_frames_are_clean(void) {
+    display_rect_t r = { 1, 2, 3, 4 };
+    TEST_ASSERT_FALSE(display_fb_dirty(shown, next, &r));
+    TEST_ASSERT_EQUAL_UINT16(3, r.y0);                // untouched
+}
+
+static void test_single_pixel(void) {
+    display_rect_t r;
+    set_black(next, 61, 140);
+    TEST_ASSERT_TRUE(display_fb_dirty(shown, next, &r));
+    TEST_ASSERT_EQUAL_UINT8(7, r.x0);
+    TEST_ASSERT_EQUAL_UINT8(7, r.x1);
+    TEST_ASSERT_EQUAL_UINT16(140, r.y0);
+    TEST_ASSERT_EQUAL_UINT16(140, r.y1);
+}
+
+static void test_window_bounds_every_change(void) {
+    display_rect_t r;
+    set_black(next, 20, 36);                          // hero digits, top left
+    set_black(next, 100, 67);                         // hero digits, bottom right
+    set_black(next, 90, 142);                         // battery % value
+    TEST_ASSERT_TRUE(display_fb_dirty(shown, next, &r));
+    TEST_ASSERT_EQUAL_UINT8(2, r.x0);
+    TEST_ASSERT_EQUAL_UINT8(12, r.x1);
+    TEST_ASSERT_EQUAL_UINT16(36, r.y0);
+    TEST_ASSERT_EQUAL_UINT16(142, r.y1);
+
+    set_black(next, 0, 0);
+    set_black(next, DISPLAY_W - 1, DISPLAY_H_PX - 1);
+    TEST_ASSERT_TRUE(display_fb_dirty(shown, next, &r));
+    TEST_ASSERT_EQUAL_UINT8(0, r.x0);
+    TEST_ASSERT_EQUAL_UINT8(DISPLAY_BPR - 1, r.x1);
+    TEST_ASSERT_EQUAL_UINT16(0, r.y0);
+    TEST_ASSERT_EQUAL_UINT16(DISPLAY_H_PX - 1, r.y1);
+}
+
+// ---- Refresh choice ----
+
+static void test_unknown_glass_refreshes_in_full(void) {
+    display_rect_t r;
+    TEST_ASSERT_EQUAL_INT(DISPLAY_REFRESH_FULL,
+                          display_refresh_choose(&h, shown, next, DISPLAY_VIEW_TELEMETRY, 20, &r));
+}
+
+static void test_same_view_updates_partially(void) {
+    display_rect_t r;
+    display_shown_note(&h, shown, DISPLAY_VIEW_TELEMETRY, DISPLAY_REFRESH_FULL);
+    TEST_ASSERT_EQUAL_INT(DISPLAY_REFRESH_NONE,
+                          display_refresh_choose(&h, shown, next, DISPLAY_VIEW_TELEMETRY, 20, &r));
+    set_black(next, 50, 50);
+    TEST_ASSERT_EQUAL_INT(DISPLAY_REFRESH_PARTIAL,
+                          display_refresh_choose(&h, shown, next, DISPLAY_VIEW_TELEMETRY, 20, &r));
+    TEST_ASSERT_EQUAL_UINT16(50, r.y0);
+    TEST_ASSERT_EQUAL_INT(DISPLAY_REFRESH_FULL,
+                          display_refresh_choose(&h, shown, next, DISPLAY_VIEW_PORTAL, 20, &r));
+    TEST_ASSERT_EQUAL_INT(DISPLAY_REFRESH_FULL,
+                          display_refresh_choose(&h, shown, next, DISPLAY_VIEW_TELEMETRY, 0, &r));
+}
+
+static void test_full_refresh_every_n_partials(void) {
+    display_rect_t r;
+    int full = 0, partial = 0;
+    for (int i = 0; i < 63; i++) {
+        next[(i * 37) % DISPLAY_FB_SIZE] ^= 0x10;     // every update changes something
+        display_refresh_t how = display_refresh_choose(&h, shown, next, DISPLAY_VIEW_TELEMETRY, 20, &r);
+        TEST_ASSERT_TRUE(how != DISPLAY_REFRESH_NONE);
+        if (how == DISPLAY_REFRESH_FULL) {
+            TEST_ASSERT_EQUAL_INT(0, i % 21);         // first, then after each 20 partials
+            full++;
+        } else {
+            partial++;
+        }
+        memcpy(shown, next, sizeof(shown));
+        display_shown_note(&h, shown, DISPLAY_VIEW_TELEMETRY, how);
+    }
+    TEST_ASSERT_EQUAL_INT(3, full);
+    TEST_ASSERT_EQUAL_INT(60, partial);
+}
+
+static void test_corrupt_history_refreshes_in_full(void) {
+    display_rect_t r;
+    set_black(next, 50, 50);
+    display_shown_note(&h, shown, DISPLAY_VIEW_TELEMETRY, DISPLAY_REFRESH_FULL);
+    shown[100] ^= 1;                                  // retained frame damaged
+    TEST_ASSERT_EQUAL_INT(DISPLAY_REFRESH_FULL,
+                          display_refresh_choose(&h, shown, next, DISPLAY_VIEW_TELEMETRY, 20, &r));
+    shown[100] ^= 1;
+    h.partials = 3;                                   // record damaged
+    TEST_ASSERT_EQUAL_INT(DISPLAY_REFRESH_FULL,
+                          display_refresh_choose(&h, shown, next, DISPLAY_VIEW_TELEMETRY, 20, &r));
+}
+
+// ---- Skip-if-unchanged ----
+
+static void test_unchanged_frame_needs_no_panel(void) {
+    TEST_ASSERT_FALSE(display_shown_same(&h, next, DISPLAY_VIEW_TELEMETRY));   // nothing shown yet
+    display_shown_note(&h, shown, DISPLAY_VIEW_TELEMETRY, DISPLAY_REFRESH_FULL);
+    TEST_ASSERT_TRUE(display_shown_same(&h, next, DISPLAY_VIEW_TELEMETRY));
+    TEST_ASSERT_FALSE(display_shown_same(&h, next, DISPLAY_VIEW_PORTAL));
+    TEST_ASSERT_FALSE(display_shown_same(&h, next, DISPLAY_VIEW_NONE));
+
+    set_black(next, 70, 60);                          // 41.2% -> 41.3%
+    TEST_ASSERT_FALSE(display_shown_same(&h, next, DISPLAY_VIEW_TELEMETRY));
+    memset(shown, 0, sizeof(shown));                  // RTC copy lost: the hash alone decides
+    display_shown_note(&h, next, DISPLAY_VIEW_TELEMETRY, DISPLAY_REFRESH_PARTIAL);
+    TEST_ASSERT_TRUE(display_shown_same(&h, next, DISPLAY_VIEW_TELEMETRY));
+
+    h.view = DISPLAY_VIEW_PORTAL;                     // record damaged
+    TEST_ASSERT_FALSE(display_shown_same(&h, next, DISPLAY_VIEW_PORTAL));
+}
+
+int main(void) {
+    UNITY_BEGIN();
+    RUN_TEST(test_hline_matches_reference);
+    RUN_TEST(test_blit_matches_reference);
+    RUN_TEST(test_assets_match_reference);
+    RUN_TEST(test_identical_frames_are_clean);
+    RUN_TEST(test_single_pixel);
+    RUN_TEST(test_window_bounds_every_change);
+    RUN_TEST(test_unknown_glass_refreshes_in_full);
+    RUN_TEST(test_same_view_updates_partially);
+    RUN_TEST(test_full_refresh_every_n_partials);
+    RUN_TEST(test_corrupt_history_refreshes_in_full);
+    RUN_TEST(test_unchanged_frame_needs_no_panel);
+    return UNITY_END();
+}
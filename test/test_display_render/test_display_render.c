@@ -0,0 +1,222 @@
+#include <unity.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define TEST_HOST 1
+#include "../../src/display_fb.c"
+#include "../../src/crc32.c"
+#include "../../src/display_render.c"
+
+// Golden frames are PBM (P4) files in golden/, viewable in any image viewer.
+// To inspect a change, set DISPLAY_RENDER_DUMP=<dir> to write every render
+// there. After an intended layout change, run once with DISPLAY_RENDER_UPDATE=1
+// to rewrite the goldens, look at them, and commit them with the change.
+
+#define GUARD 64
+
+static uint8_t buf[GUARD + DISPLAY_FB_SIZE + GUARD];
+static uint8_t *const fb = buf + GUARD;
+static uint8_t other[DISPLAY_FB_SIZE];
+
+static const display_telemetry_t SAMPLE = {
+    .device_id     = "tree-bed-3",
+    .moisture_pct  = 41.25f,
+    .raw_mv        = 1843,
+    .battery_v     = 3.87f,
+    .battery_pct   = 74,
+    .wifi_rssi_dbm = -61,
+};
+
+void setUp(void) {
+    memset(buf, 0xA5, sizeof(buf));
+}
+void tearDown(void) {}
+
+static void assert_guards(void) {
+    for (int i = 0; i < GUARD; i++) {
+        TEST_ASSERT_EQUAL_HEX8(0xA5, buf[i]);
+        TEST_ASSERT_EQUAL_HEX8(0xA5, buf[GUARD + DISPLAY_FB_SIZE + i]);
+    }
+}
+
+// ---- PBM snapshots ----
+
+static const char *golden_dirs[] = {
+    "golden",                               // run from the test directory
+    "test/test_display_render/golden",      // run from the project root
+};
+
+static FILE *open_golden(const char *name, const char *mode) {
+    char path[256];
+    for (size_t i = 0; i < sizeof(golden_dirs) / sizeof(golden_dirs[0]); i++) {
+        snprintf(path, sizeof(path), "%s/%s.pbm", golden_dirs[i], name);
+        FILE *f = fopen(path, mode);
+        if (f) return f;
+    }
+    return NULL;
+}
+
+// PBM bits are 1 = black, the framebuffer's are 0 = black.
+static void pbm_write(FILE *f, const uint8_t *frame) {
+    fprintf(f, "P4\n%d %d\n", DISPLAY_W, DISPLAY_H_PX);
+    for (int i = 0; i < DISPLAY_FB_SIZE; i++) {
+        fputc((uint8_t)~frame[i], f);
+    }
+}
+
+static bool pbm_read(FILE *f, uint8_t *frame) {
+    int w = 0, h = 0;
+    if (fscanf(f, "P4 %d %d", &w, &h) != 2 || w != DISPLAY_W || h != DISPLAY_H_PX) return false;
+    fgetc(f);                               // the one whitespace before the raster
+    for (int i = 0; i < DISPLAY_FB_SIZE; i++) {
+        int c = fgetc(f);
+        if (c == EOF) return false;
+        frame[i] = (uint8_t)~c;
+    }
+    return true;
+}
+
+static void dump(const char *name, const uint8_t *frame) {
+    const char *dir = getenv("DISPLAY_RENDER_DUMP");
+    if (!dir) return;
+    char path[256];
+    snprintf(path, sizeof(path), "%s/%s.pbm", dir, name);
+    FILE *f = fopen(path, "wb");
+    if (f) {
+        pbm_write(f, frame);
+        fclose(f);
+    }
+}
+
+static void assert_golden(const char *name, const uint8_t *frame) {
+    dump(name, frame);
+    if (getenv("DISPLAY_RENDER_UPDATE")) {
+        FILE *f = open_golden(name, "wb");
+        TEST_ASSERT_NOT_NULL(f);
+        pbm_write(f, frame);
+        fclose(f);
+        return;
+    }
+    FILE *f = open_golden(name, "rb");
+    TEST_ASSERT_NOT_NULL_MESSAGE(f, name);
+    bool ok = pbm_read(f, other);
+    fclose(f);
+    TEST_ASSERT_TRUE_MESSAGE(ok, name);
+    TEST_ASSERT_EQUAL_MEMORY_MESSAGE(other, frame, DISPLAY_FB_SIZE, name);
+}
+
+// ---- Golden frames ----
+
+static void test_telemetry_golden(void) {
+    display_render_telemetry(fb, &SAMPLE);
+    assert_guards();
+    assert_golden("telemetry", fb);
+}
+
+static void test_telemetry_no_wifi_golden(void) {
+    display_telemetry_t t = SAMPLE;
+    t.device_id     = "tree-zb-07";
+    t.moisture_pct  = 100.0f;               // "100%": no decimal, fits the width
+    t.wifi_rssi_dbm = 0;
+    display_render_telemetry(fb, &t);
+    assert_guards();
+    assert_golden("telemetry_zigbee", fb);
+}
+
+static void test_portal_golden(void) {
+    display_render_portal(fb);
+    assert_guards();
+    assert_golden("portal", fb);
+}
+
+static void test_low_battery_golden(void) {
+    display_render_low_battery(fb, 3.21f);
+    assert_guards();
+    assert_golden("low_battery", fb);
+}
+
+// ---- Layout properties ----
+
+static void test_render_replaces_previous_frame(void) {
+    display_render_telemetry(other, &SAMPLE);
+    display_render_portal(fb);
+    display_render_telemetry(fb, &SAMPLE);
+    TEST_ASSERT_EQUAL_MEMORY(other, fb, DISPLAY_FB_SIZE);
+}
+
+static void test_tree_prefix_is_dropped(void) {
+    display_telemetry_t t = SAMPLE;
+    display_render_telemetry(other, &t);
+    t.device_id = "bed-3";
+    display_render_telemetry(fb, &t);
+    TEST_ASSERT_EQUAL_MEMORY(other, fb, DISPLAY_FB_SIZE);
+}
+
+static void test_hostile_input_stays_in_frame(void) {
+    display_telemetry_t t = {
+        .device_id     = "an-unreasonably-long-device-name-\x01\x7f\xff",
+        .moisture_pct  = -12.0f,
+        .raw_mv        = -2147483647,
+        .battery_v     = 1e9f,
+        .battery_pct   = 100000,
+        .wifi_rssi_dbm = -2147483647,
+    };
+    display_render_telemetry(fb, &t);
+    assert_guards();
+    display_render_telemetry(fb, NULL);
+    assert_guards();
+    display_render_low_battery(fb, -1e12f);
+    assert_guards();
+}
+
+// The moisture digits are the only thing that moves between most reports:
+// the changed window stays inside the hero number.
+static void test_moisture_change_is_a_small_window(void) {
+    display_telemetry_t t = SAMPLE;
+    display_render_telemetry(other, &t);
+    t.moisture_pct = 47.6f;
+    display_render_telemetry(fb, &t);
+    display_rect_t r;
+    TEST_ASSERT_TRUE(display_fb_dirty(other, fb, &r));
+    TEST_ASSERT_GREATER_OR_EQUAL(30, r.y0);
+    TEST_ASSERT_LESS_THAN(72, r.y1);
+}
+
+// Sensor mV, battery volts and RSSI jitter between wakes; as long as that
+// stays inside the rounding step the frame hash matches and display.c leaves
+// the panel asleep.
+static void test_jittered_readings_hash_the_same(void) {
+    display_shown_t shown;
+    display_telemetry_t t = SAMPLE;
+    display_render_telemetry(other, &t);
+    display_shown_reset(&shown);
+    display_shown_note(&shown, other, DISPLAY_VIEW_TELEMETRY, DISPLAY_REFRESH_FULL);
+
+    t.raw_mv = SAMPLE.raw_mv + 14;
+    t.wifi_rssi_dbm = SAMPLE.wifi_rssi_dbm - 1;
+    t.battery_v = SAMPLE.battery_v - 0.008f;     // 2 mV ADC steps, doubled by the divider
+    display_render_telemetry(fb, &t);
+    TEST_ASSERT_EQUAL_HEX32(crc32_update(0, other, DISPLAY_FB_SIZE),
+                            crc32_update(0, fb, DISPLAY_FB_SIZE));
+    TEST_ASSERT_TRUE(display_shown_same(&shown, fb, DISPLAY_VIEW_TELEMETRY));
+
+    // A real move of the probe voltage still redraws.
+    t.raw_mv = SAMPLE.raw_mv + 200;
+    display_render_telemetry(fb, &t);
+    TEST_ASSERT_FALSE(display_shown_same(&shown, fb, DISPLAY_VIEW_TELEMETRY));
+}
+
+int main(void) {
+    UNITY_BEGIN();
+    RUN_TEST(test_telemetry_golden);
+    RUN_TEST(test_telemetry_no_wifi_golden);
+    RUN_TEST(test_portal_golden);
+    RUN_TEST(test_low_battery_golden);
+    RUN_TEST(test_render_replaces_previous_frame);
+    RUN_TEST(test_tree_prefix_is_dropped);
+    RUN_TEST(test_hostile_input_stays_in_frame);
+    RUN_TEST(test_moisture_change_is_a_small_window);
+    RUN_TEST(test_jittered_readings_hash_the_same);
+    return UNITY_END();
+}
@@ -0,0 +1,175 @@
+#include <unity.h>
+#include <string.h>
+
+#define TEST_HOST 1
+#include "../../src/crc32.c"
+#include "../../src/telemetry_enc.c"
+#include "../../src/wake_timing.c"
+#include "../../src/energy_model.c"
+
+void setUp(void) {}
+void tearDown(void) {}
+
+static wake_timing_record_t rec_with(wake_phase_t p, uint32_t us, uint32_t total_us) {
+    wake_timing_record_t r;
+    memset(&r, 0, sizeof(r));
+    r.phase_us[p] = us;
+    r.phase_mask  = (uint16_t)(1u << p);
+    r.total_us    = total_us;
+    return r;
+}
+
+// ---- Model ----
+
+static void test_phase_charge(void) {
+    // 1 s of WiFi association at 85 mA = 85 mAh / 3600 = 23.611 uAh
+    wake_timing_record_t r = rec_with(WAKE_PHASE_NET, 1000000, 1000000);
+    TEST_ASSERT_EQUAL_UINT64(23611, energy_model_wake_nah(&ENERGY_MODEL_WIFI, &r));
+}
+
+static void test_unaccounted_time_runs_at_idle_current(void) {
+    // 0.36 s NET + 0.36 s outside any phase: 85 mA and 25 mA for 100 us-hours each
+    wake_timing_record_t r = rec_with(WAKE_PHASE_NET, 360000, 720000);
+    TEST_ASSERT_EQUAL_UINT64(8500 + 2500, energy_model_wake_nah(&ENERGY_MODEL_WIFI, &r));
+}
+
+static void test_overlapping_phases_share_the_idle_draw(void) {
+    // 0.36 s of SENSE entirely inside 0.36 s of NET: 85 + 30 - 25 = 90 mA
+    wake_timing_record_t r = rec_with(WAKE_PHASE_NET, 360000, 360000);
+    r.phase_us[WAKE_PHASE_SENSE] = 360000;
+    r.phase_mask |= 1u << WAKE_PHASE_SENSE;
+    TEST_ASSERT_EQUAL_UINT64(9000, energy_model_wake_nah(&ENERGY_MODEL_WIFI, &r));
+}
+
+static void test_unmarked_phases_are_ignored(void) {
+    wake_timing_record_t r = rec_with(WAKE_PHASE_NET, 360000, 360000);
+    r.phase_us[WAKE_PHASE_DISPLAY] = 999999;          // stale value, mask bit clear
+    TEST_ASSERT_EQUAL_UINT64(8500, energy_model_wake_nah(&ENERGY_MODEL_WIFI, &r));
+}
+
+static void test_sleep_charge(void) {
+    // One hour at 10 uA = 10 uAh
+    TEST_ASSERT_EQUAL_UINT64(10000, energy_model_sleep_nah(&ENERGY_MODEL_WIFI, 3600));
+    // Fifteen minutes at 300 uA = 75 uAh
+    TEST_ASSERT_EQUAL_UINT64(75000, energy_model_sleep_nah(&ENERGY_MODEL_ZIGBEE, 900));
+}
+
+static void test_models_cover_every_phase_they_use(void) {
+    for (int p = 0; p < WAKE_PHASE_COUNT; p++) {
+        if (p == WAKE_PHASE_BROKER || p == WAKE_PHASE_CONNECT) continue;   // WiFi-only
+        TEST_ASSERT_TRUE(ENERGY_MODEL_ZIGBEE.phase_ua[p] > 0);
+    }
+    for (int p = 0; p < WAKE_PHASE_COUNT; p++) {
+        TEST_ASSERT_TRUE(ENERGY_MODEL_WIFI.phase_ua[p] > 0);
+    }
+}
+
+// ---- Projection ----
+
+static void test_days_remaining(void) {
+    // Full 2000 mAh cell, 0.128 mAh per hourly cycle: 3.072 mAh/day -> 651.0 days
+    TEST_ASSERT_EQUAL_UINT32(6510, energy_days_remaining_x10(10000, 2000, 128000, 3600, 0));
+    // Half full and the field says we draw twice the model: a quarter of that
+    TEST_ASSERT_EQUAL_UINT32(1628, energy_days_remaining_x10(5000, 2000, 128000, 3600, 200));
+    TEST_ASSERT_EQUAL_UINT32(0, energy_days_remaining_x10(5000, 2000, 0, 3600, 0));
+    TEST_ASSERT_EQUAL_UINT32(0, energy_days_remaining_x10(5000, 2000, 128000, 0, 0));
+}
+
+// ---- Ledger ----
+
+static energy_ledger_t led;
+
+static void test_ledger_reset_valid_and_crc(void) {
+    energy_ledger_reset(&led, 8000);
+    TEST_ASSERT_TRUE(energy_ledger_valid(&led));
+    energy_ledger_add(&led, 120000, 3605);
+    TEST_ASSERT_TRUE(energy_ledger_valid(&led));
+    TEST_ASSERT_EQUAL_UINT32(1, led.wakes);
+    TEST_ASSERT_EQUAL_UINT32(120000, led.last_nah);
+    led.total_nah ^= 1;
+    TEST_ASSERT_FALSE(energy_ledger_valid(&led));
+    memset(&led, 0, sizeof(led));
+    TEST_ASSERT_FALSE(energy_ledger_valid(&led));
+}
+
+static void test_ocv_cross_check(void) {
+    energy_ledger_reset(&led, 8000);
+    for (int i = 0; i < 500; i++) energy_ledger_add(&led, 120000, 3600);   // 60 mAh modelled
+
+    energy_ledger_observe_ocv(&led, 7800, 2000);     // 2 % drop: too small to judge
+    TEST_ASSERT_EQUAL_UINT16(0, led.ratio_x100);
+
+    energy_ledger_observe_ocv(&led, 7700, 2000);     // 3 % of 2000 mAh = 60 mAh observed
+    TEST_ASSERT_EQUAL_UINT16(100, led.ratio_x100);
+
+    energy_ledger_observe_ocv(&led, 7400, 2000);     // 120 mAh observed vs 60 modelled
+    TEST_ASSERT_EQUAL_UINT16(200, led.ratio_x100);
+    TEST_ASSERT_TRUE(energy_ledger_valid(&led));
+}
+
+static void test_recharge_restarts_reference(void) {
+    energy_ledger_reset(&led, 3000);
+    for (int i = 0; i < 10; i++) energy_ledger_add(&led, 120000, 3600);
+    energy_ledger_observe_ocv(&led, 9500, 2000);
+    TEST_ASSERT_EQUAL_UINT16(9500, led.ref_pct_x100);
+    TEST_ASSERT_EQUAL_UINT64(led.total_nah, led.ref_nah);
+    // OCV noise after a recharge doesn't move the reference
+    energy_ledger_observe_ocv(&led, 9700, 2000);
+    TEST_ASSERT_EQUAL_UINT16(9500, led.ref_pct_x100);
+}
+
+static void test_json(void) {
+    char buf[128];
+    energy_ledger_reset(&led, 10000);
+    TEST_ASSERT_EQUAL_INT(0, energy_ledger_format_json(&led, 2000, buf, sizeof(buf)));
+    TEST_ASSERT_EQUAL_STRING("", buf);
+
+    energy_ledger_add(&led, 128000, 3600);
+    int n = energy_ledger_format_json(&led, 2000, buf, sizeof(buf));
+    TEST_ASSERT_EQUAL_STRING("\"mAh_per_wake\":0.1280,\"days_remaining\":651.0", buf);
+    TEST_ASSERT_EQUAL_INT((int)strlen(buf), n);
+
+    led.ratio_x100 = 108;
+    energy_ledger_format_json(&led, 2000, buf, sizeof(buf));
+    TEST_ASSERT_EQUAL_STRING(
+        "\"mAh_per_wake\":0.1280,\"days_remaining\":602.8,\"model_ratio\":1.08", buf);
+    TEST_ASSERT_EQUAL_INT(-1, energy_ledger_format_json(&led, 2000, buf, 20));
+}
+
+static void test_projection_uses_mean_cycle(void) {
+    // One radio wake in four: 0.5 mAh, then three 0.01 mAh skipped wakes.
+    // Mean 0.1325 mAh per hourly cycle: 3.18 mAh/day -> 628.9 days.
+    energy_ledger_reset(&led, 10000);
+    energy_ledger_add(&led, 500000, 3600);
+    for (int i = 0; i < 3; i++) energy_ledger_add(&led, 10000, 3600);
+    TEST_ASSERT_EQUAL_UINT32(4 * 3600, led.total_s);
+    TEST_ASSERT_EQUAL_UINT32(6289, energy_ledger_days_remaining_x10(&led, 2000));
+    // The Zigbee attribute carries the same mean, not the last (skipped) cycle.
+    TEST_ASSERT_EQUAL_UINT32(132500, energy_ledger_mean_nah(&led));
+    TEST_ASSERT_EQUAL_UINT32(10000, led.last_nah);
+
+    char buf[128];
+    energy_ledger_format_json(&led, 2000, buf, sizeof(buf));
+    TEST_ASSERT_EQUAL_STRING("\"mAh_per_wake\":0.1325,\"days_remaining\":628.9", buf);
+
+    energy_ledger_reset(&led, 10000);
+    TEST_ASSERT_EQUAL_UINT32(0, energy_ledger_days_remaining_x10(&led, 2000));
+    TEST_ASSERT_EQUAL_UINT32(0, energy_ledger_mean_nah(&led));
+}
+
+int main(void) {
+    UNITY_BEGIN();
+    RUN_TEST(test_phase_charge);
+    RUN_TEST(test_unaccounted_time_runs_at_idle_current);
+    RUN_TEST(test_overlapping_phases_share_the_idle_draw);
+    RUN_TEST(test_unmarked_phases_are_ignored);
+    RUN_TEST(test_sleep_charge);
+    RUN_TEST(test_models_cover_every_phase_they_use);
+    RUN_TEST(test_days_remaining);
+    RUN_TEST(test_ledger_reset_valid_and_crc);
+    RUN_TEST(test_ocv_cross_check);
+    RUN_TEST(test_recharge_restarts_reference);
+    RUN_TEST(test_json);
+    RUN_TEST(test_projection_uses_mean_cycle);
+    return UNITY_END();
+}
@@ -0,0 +1,227 @@
+#include <unity.h>
+#include <string.h>
+
+#define TEST_HOST 1
+#include "../../src/crc32.c"
+#include "../../src/telemetry_enc.c"
+#include "../../src/soil_probe.c"
+#include "../../src/flash_queue.c"
+
+// ---- RAM flash emulator ----
+// NOR semantics: erase sets a sector to 0xFF, writes can only clear bits.
+// `budget` simulates a power cut: once that many more bytes have been
+// programmed, the rest of the write (and every later one) is lost.
+#define EMU_SECTORS  4
+#define PER_SECTOR   (FLASH_QUEUE_SLOTS - 1)
+static uint8_t  flash[EMU_SECTORS * FLASH_SHIM_SECTOR];
+static uint32_t flash_size;
+static long     budget;
+static unsigned erases[EMU_SECTORS];
+
+uint32_t flash_shim_size(void) { return flash_size; }
+
+bool flash_shim_read(uint32_t offset, void *buf, size_t len) {
+    if (offset + len > flash_size) return false;
+    memcpy(buf, flash + offset, len);
+    return true;
+}
+
+bool flash_shim_write(uint32_t offset, const void *buf, size_t len) {
+    if (offset + len > flash_size) return false;
+    const uint8_t *b = buf;
+    for (size_t i = 0; i < len; i++) {
+        if (budget == 0) return false;
+        if (budget > 0) budget--;
+        flash[offset + i] &= b[i];
+    }
+    return true;
+}
+
+bool flash_shim_erase_sector(uint32_t offset) {
+    if (budget == 0 || offset % FLASH_SHIM_SECTOR || offset >= flash_size) return false;
+    memset(flash + offset, 0xFF, FLASH_SHIM_SECTOR);
+    erases[offset / FLASH_SHIM_SECTOR]++;
+    return true;
+}
+
+static flash_queue_t q;
+static flash_queue_record_t recs[PER_SECTOR * EMU_SECTORS];
+static uint32_t offs[PER_SECTOR * EMU_SECTORS];
+
+void setUp(void) {
+    memset(flash, 0xFF, sizeof(flash));
+    memset(erases, 0, sizeof(erases));
+    flash_size = sizeof(flash);
+    budget = -1;
+    memset(&q, 0, sizeof(q));
+    q.boot = 1;
+    TEST_ASSERT_TRUE(flash_queue_mount(&q));
+}
+void tearDown(void) {}
+
+static void append_n(uint32_t n) {
+    for (uint32_t i = 0; i < n; i++) {
+        uint16_t soil[1] = { (uint16_t)(1800 + i % 100) };
+        TEST_ASSERT_TRUE(flash_queue_append(&q, 1000 + i * 3600, 4100, soil, 1));
+    }
+}
+
+static void remount(void) {
+    budget = -1;                            // power back on
+    uint16_t boot = q.boot;
+    memset(&q, 0xA5, sizeof(q));            // nothing survives but the flash
+    q.boot = boot;
+    TEST_ASSERT_TRUE(flash_queue_mount(&q));
+}
+
+static void test_empty_partition(void) {
+    TEST_ASSERT_EQUAL_UINT(0, q.pending);
+    TEST_ASSERT_EQUAL_UINT(0, flash_queue_peek(&q, recs, offs, 8));
+    TEST_ASSERT_EQUAL_UINT(0, erases[0]);   // nothing is erased until the first append
+}
+
+static void test_append_peek_in_order(void) {
+    append_n(3);
+    TEST_ASSERT_EQUAL_UINT(3, q.pending);
+    TEST_ASSERT_EQUAL_UINT(3, flash_queue_peek(&q, recs, offs, 8));
+    for (uint32_t i = 0; i < 3; i++) {
+        TEST_ASSERT_EQUAL_UINT32(i + 1, recs[i].seq);
+        TEST_ASSERT_EQUAL_UINT32(1000 + i * 3600, recs[i].t_s);
+        TEST_ASSERT_EQUAL_UINT16(1800 + i, recs[i].soil_mv[0]);
+    }
+}
+
+static void test_remount_restores_state(void) {
+    append_n(5);
+    remount();
+    TEST_ASSERT_EQUAL_UINT(5, q.pending);
+    TEST_ASSERT_EQUAL_UINT32(6, q.next_seq);
+    append_n(1);
+    TEST_ASSERT_EQUAL_UINT(6, flash_queue_peek(&q, recs, offs, 8));
+    TEST_ASSERT_EQUAL_UINT32(6, recs[5].seq);
+    TEST_ASSERT_EQUAL_UINT(1, erases[0]);
+}
+
+static void test_delivered_are_skipped_and_persist(void) {
+    append_n(10);
+    TEST_ASSERT_EQUAL_UINT(4, flash_queue_peek(&q, recs, offs, 4));
+    TEST_ASSERT_TRUE(flash_queue_mark_delivered(&q, offs, 4));
+    TEST_ASSERT_EQUAL_UINT(6, q.pending);
+    remount();
+    TEST_ASSERT_EQUAL_UINT(6, q.pending);
+    TEST_ASSERT_EQUAL_UINT(6, flash_queue_peek(&q, recs, offs, 32));
+    TEST_ASSERT_EQUAL_UINT32(5, recs[0].seq);
+}
+
+// Draining in batches crosses sector boundaries in sequence order.
+static void test_batches_span_sectors(void) {
+    append_n(PER_SECTOR * 2 + 10);
+    uint32_t expect = 1;
+    size_t n;
+    while ((n = flash_queue_peek(&q, recs, offs, 32)) > 0) {
+        for (size_t i = 0; i < n; i++) TEST_ASSERT_EQUAL_UINT32(expect++, recs[i].seq);
+        TEST_ASSERT_TRUE(flash_queue_mark_delivered(&q, offs, n));
+    }
+    TEST_ASSERT_EQUAL_UINT32(PER_SECTOR * 2 + 11, expect);
+    TEST_ASSERT_EQUAL_UINT(0, q.pending);
+}
+
+static void test_full_ring_drops_oldest_sector(void) {
+    append_n(PER_SECTOR * EMU_SECTORS + 1);
+    TEST_ASSERT_EQUAL_UINT(PER_SECTOR, q.dropped);
+    TEST_ASSERT_EQUAL_UINT(PER_SECTOR * (EMU_SECTORS - 1) + 1, q.pending);
+    TEST_ASSERT_EQUAL_UINT(1, flash_queue_peek(&q, recs, offs, 1));
+    TEST_ASSERT_EQUAL_UINT32(PER_SECTOR + 1, recs[0].seq);
+
+    remount();                               // seq keeps counting after the wrap
+    TEST_ASSERT_EQUAL_UINT32(PER_SECTOR * EMU_SECTORS + 2, q.next_seq);
+}
+
+// Steady state (append, deliver) erases every sector in turn.
+static void test_wear_is_even(void) {
+    for (int round = 0; round < 40; round++) {
+        append_n(50);
+        size_t n;
+        while ((n = flash_queue_peek(&q, recs, offs, 32)) > 0) {
+            flash_queue_mark_delivered(&q, offs, n);
+        }
+    }
+    TEST_ASSERT_EQUAL_UINT(0, q.dropped);
+    for (int s = 1; s < EMU_SECTORS; s++) {
+        TEST_ASSERT_INT_WITHIN(1, erases[0], erases[s]);
+    }
+}
+
+static void test_torn_record_is_skipped(void) {
+    append_n(3);
+    budget = 10;                             // power fails inside the 4th record
+    uint16_t soil[1] = { 1 };
+    TEST_ASSERT_FALSE(flash_queue_append(&q, 0, 0, soil, 1));
+    remount();
+    TEST_ASSERT_EQUAL_UINT(3, q.pending);
+    append_n(1);
+    TEST_ASSERT_EQUAL_UINT(4, flash_queue_peek(&q, recs, offs, 8));
+    TEST_ASSERT_EQUAL_UINT32(3, recs[2].seq);
+    TEST_ASSERT_EQUAL_UINT32(4, recs[3].seq);   // the torn one never counted
+}
+
+static void test_torn_sector_header_recovers(void) {
+    append_n(PER_SECTOR);                    // sector 0 full
+    budget = 6;                              // power fails writing sector 1's header
+    uint16_t soil[1] = { 1 };
+    TEST_ASSERT_FALSE(flash_queue_append(&q, 0, 0, soil, 1));
+    remount();
+    TEST_ASSERT_EQUAL_UINT(PER_SECTOR, q.pending);
+    append_n(1);
+    TEST_ASSERT_EQUAL_UINT(PER_SECTOR + 1, flash_queue_peek(&q, recs, offs, PER_SECTOR + 1));
+    TEST_ASSERT_EQUAL_UINT32(PER_SECTOR + 1, recs[PER_SECTOR].seq);
+}
+
+static void test_foreign_contents(void) {
+    for (size_t i = 0; i < sizeof(flash); i++) flash[i] = (uint8_t)(i * 131 + 7);
+    remount();
+    TEST_ASSERT_EQUAL_UINT(0, q.pending);
+    append_n(2);
+    remount();
+    TEST_ASSERT_EQUAL_UINT(2, q.pending);
+    TEST_ASSERT_EQUAL_UINT(2, flash_queue_peek(&q, recs, offs, 8));
+}
+
+static void test_partition_too_small(void) {
+    flash_size = FLASH_SHIM_SECTOR;
+    TEST_ASSERT_FALSE(flash_queue_mount(&q));
+    TEST_ASSERT_FALSE(flash_queue_append(&q, 0, 0, NULL, 0));
+}
+
+static void test_encode_backlog(void) {
+    append_n(2);
+    q.boot = 2;                              // after a power cycle...
+    append_n(1);
+    size_t n = flash_queue_peek(&q, recs, offs, 8);
+    char buf[256];
+    telemetry_enc_t e;
+    telemetry_enc_init(&e, TELEMETRY_FMT_JSON, buf, sizeof(buf));
+    flash_queue_encode(recs, n, 2, 1100, &e);
+    TEST_ASSERT_GREATER_THAN(0, telemetry_enc_finish(&e));
+    // ...only the new cycle's reading has a known age.
+    TEST_ASSERT_EQUAL_STRING("\"backlog\":{\"seq\":[1,2,3],\"age_s\":[-1,-1,100],"
+                             "\"battery_mv\":[4100,4100,4100],\"soil_moisture_mv\":[1800,1801,1800]}",
+                             buf);
+}
+
+int main(void) {
+    UNITY_BEGIN();
+    RUN_TEST(test_empty_partition);
+    RUN_TEST(test_append_peek_in_order);
+    RUN_TEST(test_remount_restores_state);
+    RUN_TEST(test_delivered_are_skipped_and_persist);
+    RUN_TEST(test_batches_span_sectors);
+    RUN_TEST(test_full_ring_drops_oldest_sector);
+    RUN_TEST(test_wear_is_even);
+    RUN_TEST(test_torn_record_is_skipped);
+    RUN_TEST(test_torn_sector_header_recovers);
+    RUN_TEST(test_foreign_contents);
+    RUN_TEST(test_partition_too_small);
+    RUN_TEST(test_encode_backlog);
+    return UNITY_END();
+}
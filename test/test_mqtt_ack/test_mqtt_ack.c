@@ -0,0 +1,94 @@
+#include <unity.h>
+#include <string.h>
+
+#define TEST_HOST 1
+#include "../../src/mqtt_ack.c"
+
+// ---- fake MQTT client ----
+// Hands out msg_ids like esp_mqtt_client_publish() and delivers PUBACKs
+// (MQTT_EVENT_PUBLISHED) whenever the test says, in any order.
+static mqtt_ack_t acks;
+static int next_msg_id;
+
+static int fake_publish(int qos) {
+    if (qos == 0) return 0;                 // esp-mqtt returns 0 for QoS 0
+    int id = ++next_msg_id;
+    mqtt_ack_add(&acks, id);
+    return id;
+}
+
+static void fake_puback(int msg_id) {
+    mqtt_ack_complete(&acks, msg_id);
+}
+
+void setUp(void) { mqtt_ack_reset(&acks); next_msg_id = 0; }
+void tearDown(void) {}
+
+static void test_single_publish_waits_for_its_ack(void) {
+    int id = fake_publish(1);
+    TEST_ASSERT_EQUAL_UINT(1, mqtt_ack_pending(&acks));
+    fake_puback(id);
+    TEST_ASSERT_EQUAL_UINT(0, mqtt_ack_pending(&acks));
+}
+
+static void test_out_of_order_acks(void) {
+    int a = fake_publish(1), b = fake_publish(1), c = fake_publish(1);
+    fake_puback(c);
+    fake_puback(a);
+    TEST_ASSERT_EQUAL_UINT(1, mqtt_ack_pending(&acks));
+    fake_puback(b);
+    TEST_ASSERT_EQUAL_UINT(0, mqtt_ack_pending(&acks));
+}
+
+static void test_qos0_and_failed_publish_add_nothing(void) {
+    fake_publish(0);
+    TEST_ASSERT_TRUE(mqtt_ack_add(&acks, -1));
+    TEST_ASSERT_EQUAL_UINT(0, mqtt_ack_pending(&acks));
+}
+
+static void test_ack_before_add_is_not_lost(void) {
+    // The MQTT task handles the PUBACK before the publishing task tracks it.
+    fake_puback(42);
+    TEST_ASSERT_EQUAL_UINT(0, mqtt_ack_pending(&acks));
+    TEST_ASSERT_TRUE(mqtt_ack_add(&acks, 42));
+    TEST_ASSERT_EQUAL_UINT(0, mqtt_ack_pending(&acks));
+    // ... and is consumed, so the id can be tracked again later.
+    mqtt_ack_add(&acks, 42);
+    TEST_ASSERT_EQUAL_UINT(1, mqtt_ack_pending(&acks));
+}
+
+static void test_duplicate_ack_does_not_complete_another(void) {
+    int a = fake_publish(1);
+    int b = fake_publish(1);
+    fake_puback(a);
+    fake_puback(a);                          // retransmitted PUBACK
+    TEST_ASSERT_EQUAL_UINT(1, mqtt_ack_pending(&acks));
+    fake_puback(b);
+    TEST_ASSERT_EQUAL_UINT(0, mqtt_ack_pending(&acks));
+}
+
+static void test_table_full(void) {
+    for (int i = 0; i < MQTT_ACK_MAX; i++) fake_publish(1);
+    TEST_ASSERT_FALSE(mqtt_ack_add(&acks, 1000));
+    TEST_ASSERT_EQUAL_UINT(MQTT_ACK_MAX, mqtt_ack_pending(&acks));
+}
+
+static void test_early_list_drops_oldest(void) {
+    for (int i = 0; i < MQTT_ACK_MAX + 1; i++) fake_puback(100 + i);
+    mqtt_ack_add(&acks, 100);                // oldest stray ack was dropped
+    TEST_ASSERT_EQUAL_UINT(1, mqtt_ack_pending(&acks));
+    mqtt_ack_add(&acks, 100 + MQTT_ACK_MAX); // newest is still remembered
+    TEST_ASSERT_EQUAL_UINT(1, mqtt_ack_pending(&acks));
+}
+
+int main(void) {
+    UNITY_BEGIN();
+    RUN_TEST(test_single_publish_waits_for_its_ack);
+    RUN_TEST(test_out_of_order_acks);
+    RUN_TEST(test_qos0_and_failed_publish_add_nothing);
+    RUN_TEST(test_ack_before_add_is_not_lost);
+    RUN_TEST(test_duplicate_ack_does_not_complete_another);
+    RUN_TEST(test_table_full);
+    RUN_TEST(test_early_list_drops_oldest);
+    return UNITY_END();
+}
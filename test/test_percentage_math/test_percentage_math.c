@@ -34,6 +34,31 @@ static void test_handles_nonzero_wet_baseline(void) {
     TEST_ASSERT_FLOAT_WITHIN(0.01f, 50.0f, soil_moisture_calc_percentage(1900, 2950, 850));
 }
 
+static void test_fx_matches_integer_on_whole_mv(void) {
+    for (int mv = 800; mv <= 3000; mv += 50) {
+        TEST_ASSERT_EQUAL_FLOAT(soil_moisture_calc_percentage(mv, 2950, 850),
+                                soil_moisture_calc_percentage_fx(mv << SOIL_MV_FRAC_BITS, 2950, 850));
+    }
+}
+
+static void test_fx_keeps_sub_mv_resolution(void) {
+    // Half a mV above 1400 on a 2800 mV span moves the result by 1/56 %.
+    int32_t half_mv_fx = (1400 << SOIL_MV_FRAC_BITS) + (1 << (SOIL_MV_FRAC_BITS - 1));
+    float pct = soil_moisture_calc_percentage_fx(half_mv_fx, 2800, 0);
+    TEST_ASSERT_FLOAT_WITHIN(0.0005f, 50.0f - 100.0f / 5600.0f, pct);
+    TEST_ASSERT_TRUE(pct < 50.0f);
+}
+
+static void test_fx_clamps(void) {
+    TEST_ASSERT_EQUAL_FLOAT(0.0f,   soil_moisture_calc_percentage_fx(3500 << SOIL_MV_FRAC_BITS, 2800, 0));
+    TEST_ASSERT_EQUAL_FLOAT(100.0f, soil_moisture_calc_percentage_fx(0, 2800, 0));
+}
+
+static void test_fx_to_mv_rounds(void) {
+    TEST_ASSERT_EQUAL_INT(1400, SOIL_MV_FX_TO_MV((1400 << SOIL_MV_FRAC_BITS) + 7));
+    TEST_ASSERT_EQUAL_INT(1401, SOIL_MV_FX_TO_MV((1400 << SOIL_MV_FRAC_BITS) + 8));
+}
+
 int main(void) {
     UNITY_BEGIN();
     RUN_TEST(test_at_dry_returns_zero);
@@ -42,5 +67,9 @@ int main(void) {
     RUN_TEST(test_above_dry_clamps_to_zero);
     RUN_TEST(test_below_wet_clamps_to_hundred);
     RUN_TEST(test_handles_nonzero_wet_baseline);
+    RUN_TEST(test_fx_matches_integer_on_whole_mv);
+    RUN_TEST(test_fx_keeps_sub_mv_resolution);
+    RUN_TEST(test_fx_clamps);
+    RUN_TEST(test_fx_to_mv_rounds);
     return UNITY_END();
 }
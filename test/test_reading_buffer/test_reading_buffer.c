@@ -0,0 +1,141 @@
+#include <unity.h>
+#include <string.h>
+
+#define TEST_HOST 1
+#include "../../src/crc32.c"
+#include "../../src/telemetry_enc.c"
+#include "../../src/soil_probe.c"
+#include "../../src/reading_buffer.c"
+
+void setUp(void) {}
+void tearDown(void) {}
+
+static reading_buffer_t rb;
+
+static void push(uint32_t now_s, int battery_mv, uint16_t soil_mv) {
+    reading_buffer_push(&rb, now_s, battery_mv, &soil_mv, 1);
+}
+
+// ---- Ring ----
+
+static void test_cold_boot_contents_are_rejected(void) {
+    memset(&rb, 0xA5, sizeof(rb));                    // garbage RTC after brown-out
+    TEST_ASSERT_FALSE(reading_buffer_valid(&rb));
+    TEST_ASSERT_FALSE(reading_buffer_due(&rb));
+    push(5000, 3900, 1800);                           // first push starts a clean ring
+    TEST_ASSERT_TRUE(reading_buffer_valid(&rb));
+    TEST_ASSERT_EQUAL_UINT16(1, rb.count);
+    TEST_ASSERT_EQUAL_UINT32(5000, rb.base_s);
+}
+
+static void test_corruption_invalidates_ring(void) {
+    reading_buffer_clear(&rb, 1);
+    push(0, 3900, 1800);
+    push(3600, 3895, 1805);
+    TEST_ASSERT_TRUE(reading_buffer_valid(&rb));
+    rb.rec[1].soil_mv[0] ^= 0x40;
+    TEST_ASSERT_FALSE(reading_buffer_valid(&rb));
+
+    push(7200, 3890, 1810);                           // corrupt backlog is dropped
+    TEST_ASSERT_EQUAL_UINT16(1, rb.count);
+    TEST_ASSERT_EQUAL_UINT16(1810, reading_buffer_at(&rb, 0)->soil_mv[0]);
+}
+
+static void test_due_at_batch_size(void) {
+    reading_buffer_clear(&rb, 1);
+    for (int i = 0; i < READING_BATCH_SIZE - 1; i++) {
+        push((uint32_t)i * 3600, 3900, 1800);
+        TEST_ASSERT_FALSE(reading_buffer_due(&rb));
+    }
+    push((uint32_t)READING_BATCH_SIZE * 3600, 3900, 1800);
+    TEST_ASSERT_TRUE(reading_buffer_due(&rb));
+}
+
+static void test_full_ring_overwrites_oldest(void) {
+    reading_buffer_clear(&rb, 1);
+    for (int i = 0; i < READING_BUFFER_CAP + 2; i++) {
+        push(1000 + (uint32_t)i * 3600, 3900, (uint16_t)(1000 + i));
+    }
+    TEST_ASSERT_TRUE(reading_buffer_valid(&rb));
+    TEST_ASSERT_EQUAL_UINT16(READING_BUFFER_CAP, rb.count);
+    TEST_ASSERT_EQUAL_UINT16(2, rb.overwritten);
+    TEST_ASSERT_EQUAL_UINT16(1002, reading_buffer_at(&rb, 0)->soil_mv[0]);
+    TEST_ASSERT_EQUAL_UINT16(1000 + READING_BUFFER_CAP + 1,
+                             reading_buffer_at(&rb, READING_BUFFER_CAP - 1)->soil_mv[0]);
+}
+
+static void test_clock_restart_or_probe_change_clears(void) {
+    reading_buffer_clear(&rb, 1);
+    push(90000, 3900, 1800);
+    push(93600, 3900, 1800);
+    push(10, 3900, 1801);                             // clock went back behind base_s
+    TEST_ASSERT_EQUAL_UINT16(1, rb.count);
+    TEST_ASSERT_EQUAL_UINT32(10, rb.base_s);
+
+    uint16_t two[2] = { 1800, 2100 };
+    reading_buffer_push(&rb, 3610, 3900, two, 2);
+    TEST_ASSERT_EQUAL_UINT16(1, rb.count);
+    TEST_ASSERT_EQUAL_UINT16(2, rb.n_probes);
+    TEST_ASSERT_EQUAL_UINT16(2100, reading_buffer_at(&rb, 0)->soil_mv[1]);
+}
+
+// ---- JSON ----
+
+static void test_json_columns_oldest_first(void) {
+    char buf[256];
+    reading_buffer_clear(&rb, 1);
+    push(1000, 3912, 1800);
+    push(4600, 3905, 1790);
+    push(8200, 3899, 1785);
+    int n = reading_buffer_format_json(&rb, 8201, buf, sizeof(buf));
+    TEST_ASSERT_EQUAL_STRING(
+        "\"batch\":{\"age_s\":[7201,3601,1],\"battery_mv\":[3912,3905,3899],"
+        "\"soil_moisture_mv\":[1800,1790,1785]}", buf);
+    TEST_ASSERT_EQUAL_INT((int)strlen(buf), n);
+}
+
+static void test_json_empty_and_too_small(void) {
+    char buf[256];
+    reading_buffer_clear(&rb, 1);
+    TEST_ASSERT_EQUAL_INT(0, reading_buffer_format_json(&rb, 0, buf, sizeof(buf)));
+    TEST_ASSERT_EQUAL_STRING("", buf);
+
+    for (int i = 0; i < READING_BUFFER_CAP; i++) push((uint32_t)i * 3600, 3900, 1800);
+    int full = reading_buffer_format_json(&rb, 99999, buf, sizeof(buf));
+    TEST_ASSERT_TRUE(full > 0);
+    TEST_ASSERT_EQUAL_INT(-1, reading_buffer_format_json(&rb, 99999, buf, (size_t)full));
+    TEST_ASSERT_EQUAL_STRING("", buf);
+    TEST_ASSERT_EQUAL_INT(full, reading_buffer_format_json(&rb, 99999, buf, (size_t)full + 1));
+}
+
+// ---- Replayed trace ----
+
+static void test_trace_hourly_batches(void) {
+    // A day of hourly wakes, flushing (and clearing) whenever due: one
+    // connection per READING_BATCH_SIZE readings, none lost.
+    int flushes = 0, flushed_readings = 0;
+    reading_buffer_clear(&rb, 1);
+    for (int h = 0; h < 24; h++) {
+        push((uint32_t)h * 3600, 3900 - h, (uint16_t)(1800 + h));
+        if (reading_buffer_due(&rb)) {
+            flushes++;
+            flushed_readings += rb.count;
+            reading_buffer_clear(&rb, 1);
+        }
+    }
+    TEST_ASSERT_EQUAL_INT(24 / READING_BATCH_SIZE, flushes);
+    TEST_ASSERT_EQUAL_INT(24 - rb.count, flushed_readings);
+}
+
+int main(void) {
+    UNITY_BEGIN();
+    RUN_TEST(test_cold_boot_contents_are_rejected);
+    RUN_TEST(test_corruption_invalidates_ring);
+    RUN_TEST(test_due_at_batch_size);
+    RUN_TEST(test_full_ring_overwrites_oldest);
+    RUN_TEST(test_clock_restart_or_probe_change_clears);
+    RUN_TEST(test_json_columns_oldest_first);
+    RUN_TEST(test_json_empty_and_too_small);
+    RUN_TEST(test_trace_hourly_batches);
+    return UNITY_END();
+}
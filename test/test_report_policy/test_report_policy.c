@@ -0,0 +1,193 @@
+#include <unity.h>
+#include <string.h>
+
+#define TEST_HOST 1
+#include "../../src/crc32.c"
+#include "../../src/report_policy.c"
+
+void setUp(void) {}
+void tearDown(void) {}
+
+static const report_policy_cfg_t CFG = { .soil_delta_x100 = 100, .battery_delta_mv = 50,
+                                         .heartbeat_s = 6 * 3600 };
+static report_policy_state_t st;
+
+// ---- Single decisions ----
+
+static void test_cold_boot_reports_first(void) {
+    uint16_t soil[1] = { 4200 };
+    memset(&st, 0, sizeof(st));                       // cold-boot RTC contents
+    TEST_ASSERT_FALSE(report_policy_valid(&st));
+    TEST_ASSERT_EQUAL_INT(REPORT_FIRST, report_policy_decide(&st, &CFG, soil, 1, 3900, 0));
+}
+
+static void test_small_changes_skip(void) {
+    uint16_t soil[2] = { 4200, 3100 };
+    report_policy_note_published(&st, soil, 2, 3900, 1000);
+    TEST_ASSERT_TRUE(report_policy_valid(&st));
+    soil[0] = 4299;                                   // 0.99 %
+    soil[1] = 3001;
+    TEST_ASSERT_EQUAL_INT(REPORT_SKIP, report_policy_decide(&st, &CFG, soil, 2, 3851, 4600));
+}
+
+static void test_each_trigger(void) {
+    uint16_t base[2] = { 4200, 3100 };
+    uint16_t soil[2] = { 4200, 3100 };
+    report_policy_note_published(&st, base, 2, 3900, 1000);
+
+    soil[1] = 3200;                                   // second probe +1.00 %
+    TEST_ASSERT_EQUAL_INT(REPORT_SOIL, report_policy_decide(&st, &CFG, soil, 2, 3900, 1001));
+    TEST_ASSERT_EQUAL_INT(REPORT_BATTERY, report_policy_decide(&st, &CFG, base, 2, 3850, 1001));
+    TEST_ASSERT_EQUAL_INT(REPORT_HEARTBEAT,
+                          report_policy_decide(&st, &CFG, base, 2, 3900, 1000 + 6 * 3600));
+    TEST_ASSERT_EQUAL_INT(REPORT_SKIP,
+                          report_policy_decide(&st, &CFG, base, 2, 3900, 999 + 6 * 3600));
+}
+
+static void test_clock_going_backwards_reports(void) {
+    uint16_t soil[1] = { 4200 };
+    report_policy_note_published(&st, soil, 1, 3900, 50000);
+    TEST_ASSERT_EQUAL_INT(REPORT_HEARTBEAT, report_policy_decide(&st, &CFG, soil, 1, 3900, 10));
+}
+
+static void test_probe_count_change_reports_first(void) {
+    uint16_t soil[2] = { 4200, 3100 };
+    report_policy_note_published(&st, soil, 1, 3900, 1000);
+    TEST_ASSERT_EQUAL_INT(REPORT_FIRST, report_policy_decide(&st, &CFG, soil, 2, 3900, 1001));
+}
+
+static void test_zero_delta_always_reports(void) {
+    const report_policy_cfg_t always = { .soil_delta_x100 = 0, .battery_delta_mv = 50,
+                                         .heartbeat_s = 6 * 3600 };
+    uint16_t soil[1] = { 4200 };
+    report_policy_note_published(&st, soil, 1, 3900, 1000);
+    TEST_ASSERT_EQUAL_INT(REPORT_SOIL, report_policy_decide(&st, &always, soil, 1, 3900, 1001));
+}
+
+// Whatever decide_early commits to, decide agrees with for every reading.
+static void test_early_decision_holds_for_any_reading(void) {
+    const report_policy_cfg_t always = { .soil_delta_x100 = 0, .battery_delta_mv = 50,
+                                         .heartbeat_s = 6 * 3600 };
+    uint16_t base[2] = { 4200, 3100 };
+    report_policy_note_published(&st, base, 2, 3900, 1000);
+
+    TEST_ASSERT_EQUAL_INT(REPORT_SKIP, report_policy_decide_early(&st, &CFG, 2, 3900, 1001));
+    TEST_ASSERT_EQUAL_INT(REPORT_BATTERY, report_policy_decide_early(&st, &CFG, 2, 3850, 1001));
+    TEST_ASSERT_EQUAL_INT(REPORT_HEARTBEAT,
+                          report_policy_decide_early(&st, &CFG, 2, 3900, 1000 + 6 * 3600));
+    TEST_ASSERT_EQUAL_INT(REPORT_FIRST, report_policy_decide_early(&st, &CFG, 1, 3900, 1001));
+    TEST_ASSERT_EQUAL_INT(REPORT_SOIL, report_policy_decide_early(&st, &always, 2, 3900, 1001));
+
+    static const int battery[] = { 3900, 3850, 3960 };
+    static const uint32_t now[] = { 1001, 1000 + 6 * 3600, 5 };
+    for (size_t b = 0; b < 3; b++) {
+        for (size_t t = 0; t < 3; t++) {
+            if (report_policy_decide_early(&st, &CFG, 2, battery[b], now[t]) == REPORT_SKIP) {
+                continue;
+            }
+            for (uint16_t soil = 3000; soil <= 5000; soil += 50) {
+                uint16_t reading[2] = { soil, base[1] };
+                TEST_ASSERT_TRUE(report_policy_decide(&st, &CFG, reading, 2, battery[b],
+                                                      now[t]) != REPORT_SKIP);
+            }
+        }
+    }
+}
+
+static void test_skip_counter_and_corruption(void) {
+    uint16_t soil[1] = { 4200 };
+    report_policy_note_published(&st, soil, 1, 3900, 1000);
+    report_policy_note_skipped(&st);
+    report_policy_note_skipped(&st);
+    TEST_ASSERT_TRUE(report_policy_valid(&st));
+    TEST_ASSERT_EQUAL_UINT32(2, st.skipped);
+
+    st.soil_pct_x100[0] ^= 1;
+    TEST_ASSERT_FALSE(report_policy_valid(&st));
+    TEST_ASSERT_EQUAL_INT(REPORT_FIRST, report_policy_decide(&st, &CFG, soil, 1, 3900, 1001));
+    report_policy_note_skipped(&st);                  // does not reseal a corrupt state
+    TEST_ASSERT_FALSE(report_policy_valid(&st));
+}
+
+// ---- Replayed traces ----
+
+// Replays hourly wakes, publishing whenever the policy says so, and returns
+// how many wakes published.
+static int replay(const uint16_t *soil, const uint16_t *batt, int n, uint32_t interval_s,
+                  report_reason_t *reasons) {
+    int published = 0;
+    memset(&st, 0, sizeof(st));
+    for (int i = 0; i < n; i++) {
+        uint32_t now = (uint32_t)i * interval_s;
+        report_reason_t r = report_policy_decide(&st, &CFG, &soil[i], 1, batt[i], now);
+        if (reasons) reasons[i] = r;
+        if (r == REPORT_SKIP) {
+            report_policy_note_skipped(&st);
+        } else {
+            report_policy_note_published(&st, &soil[i], 1, batt[i], now);
+            published++;
+        }
+    }
+    return published;
+}
+
+static void test_trace_slow_drying_day(void) {
+    // A day of 0.3 %/h drying: reports on boot and every ~4 h as the delta
+    // accumulates, not every wake.
+    uint16_t soil[24], batt[24];
+    for (int i = 0; i < 24; i++) {
+        soil[i] = (uint16_t)(6000 - 30 * i);
+        batt[i] = 3950;
+    }
+    report_reason_t why[24];
+    int published = replay(soil, batt, 24, 3600, why);
+    TEST_ASSERT_EQUAL_INT(REPORT_FIRST, why[0]);
+    TEST_ASSERT_EQUAL_INT(REPORT_SKIP, why[1]);
+    TEST_ASSERT_EQUAL_INT(REPORT_SOIL, why[4]);       // 1.20 % after 4 h
+    TEST_ASSERT_EQUAL_INT(6, published);              // 0, 4, 8, 12, 16, 20
+}
+
+static void test_trace_flat_reading_keeps_heartbeat(void) {
+    // Nothing moves for two days: only the boot report and the 6 h heartbeat.
+    uint16_t soil[48], batt[48];
+    for (int i = 0; i < 48; i++) {
+        soil[i] = (uint16_t)(4200 + (i & 1) * 20);    // 0.2 % ADC noise
+        batt[i] = (uint16_t)(3900 - (i & 2) * 5);
+    }
+    report_reason_t why[48];
+    TEST_ASSERT_EQUAL_INT(8, replay(soil, batt, 48, 3600, why));
+    TEST_ASSERT_EQUAL_INT(REPORT_HEARTBEAT, why[6]);
+    TEST_ASSERT_EQUAL_INT(REPORT_HEARTBEAT, why[42]);
+}
+
+static void test_trace_watering_event_reports_immediately(void) {
+    uint16_t soil[6] = { 3000, 3010, 3020, 7400, 7390, 7380 };
+    uint16_t batt[6] = { 3900, 3900, 3900, 3900, 3900, 3900 };
+    report_reason_t why[6];
+    TEST_ASSERT_EQUAL_INT(2, replay(soil, batt, 6, 3600, why));
+    TEST_ASSERT_EQUAL_INT(REPORT_SOIL, why[3]);
+    TEST_ASSERT_EQUAL_UINT32(2, st.skipped);          // 4 and 5 since the watering report
+}
+
+static void test_reason_names(void) {
+    TEST_ASSERT_EQUAL_STRING("skip", report_policy_reason_name(REPORT_SKIP));
+    TEST_ASSERT_EQUAL_STRING("heartbeat", report_policy_reason_name(REPORT_HEARTBEAT));
+    TEST_ASSERT_EQUAL_STRING("?", report_policy_reason_name((report_reason_t)99));
+}
+
+int main(void) {
+    UNITY_BEGIN();
+    RUN_TEST(test_cold_boot_reports_first);
+    RUN_TEST(test_small_changes_skip);
+    RUN_TEST(test_each_trigger);
+    RUN_TEST(test_clock_going_backwards_reports);
+    RUN_TEST(test_probe_count_change_reports_first);
+    RUN_TEST(test_zero_delta_always_reports);
+    RUN_TEST(test_early_decision_holds_for_any_reading);
+    RUN_TEST(test_skip_counter_and_corruption);
+    RUN_TEST(test_trace_slow_drying_day);
+    RUN_TEST(test_trace_flat_reading_keeps_heartbeat);
+    RUN_TEST(test_trace_watering_event_reports_immediately);
+    RUN_TEST(test_reason_names);
+    return UNITY_END();
+}
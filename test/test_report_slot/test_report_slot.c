@@ -0,0 +1,145 @@
+#include <unity.h>
+#include <stdio.h>
+#include <string.h>
+
+#define TEST_HOST 1
+#include "../../src/report_slot.c"
+
+void setUp(void) {}
+void tearDown(void) {}
+
+#define HOUR_MS  3600000u
+#define FLEET    600
+
+// Pearson's chi-squared of `count[n]` against a uniform spread of `total`.
+static double chi2(const int *count, int n, int total) {
+    double expect = (double)total / n, x = 0;
+    for (int i = 0; i < n; i++) {
+        double d = count[i] - expect;
+        x += d * d / expect;
+    }
+    return x;
+}
+
+// ---- Distribution ----
+
+// A batch of boards from one reel: consecutive MACs.
+static void test_consecutive_macs_spread_evenly(void) {
+    int per_slot[60] = {0};
+    for (int n = 0; n < FLEET; n++) {
+        uint8_t mac[6] = { 0x54, 0x32, 0x04, 0x01, (uint8_t)(n >> 8), (uint8_t)n };
+        uint32_t slot = report_slot_index(mac, sizeof(mac), 60);
+        TEST_ASSERT_TRUE(slot < 60);
+        per_slot[slot]++;
+    }
+    int busiest = 0;
+    for (int i = 0; i < 60; i++) {
+        TEST_ASSERT_GREATER_THAN(0, per_slot[i]);
+        if (per_slot[i] > busiest) busiest = per_slot[i];
+    }
+    TEST_ASSERT_LESS_THAN(22, busiest);                         // mean 10
+    TEST_ASSERT_LESS_THAN(98, (int)chi2(per_slot, 60, FLEET));  // 59 dof, p = 0.001
+}
+
+static void test_device_ids_spread_evenly(void) {
+    int per_slot[16] = {0};
+    char id[16];
+    for (int n = 0; n < FLEET; n++) {
+        snprintf(id, sizeof(id), "moisture%03d", n);
+        per_slot[report_slot_index(id, strlen(id), 16)]++;
+    }
+    TEST_ASSERT_LESS_THAN(38, (int)chi2(per_slot, 16, FLEET));  // 15 dof, p = 0.001
+}
+
+// Every slot count gets used evenly, not just powers of two.
+static void test_any_slot_count(void) {
+    static const uint32_t counts[] = { 7, 12, 45, 100 };
+    for (size_t c = 0; c < sizeof(counts) / sizeof(counts[0]); c++) {
+        int per_slot[100] = {0};
+        for (int n = 0; n < 40 * (int)counts[c]; n++) {
+            uint8_t mac[6] = { 0x40, 0x4C, 0xCA, (uint8_t)(n >> 16), (uint8_t)(n >> 8), (uint8_t)n };
+            per_slot[report_slot_index(mac, sizeof(mac), counts[c])]++;
+        }
+        for (uint32_t i = 0; i < counts[c]; i++) {
+            TEST_ASSERT_INT_WITHIN(20, 40, per_slot[i]);
+        }
+    }
+}
+
+static void test_index_is_stable(void) {
+    const uint8_t mac[6] = { 0x54, 0x32, 0x04, 0x01, 0x00, 0x2A };
+    uint32_t slot = report_slot_index(mac, sizeof(mac), REPORT_SLOTS);
+    for (int i = 0; i < 3; i++) {
+        TEST_ASSERT_EQUAL_UINT32(slot, report_slot_index(mac, sizeof(mac), REPORT_SLOTS));
+    }
+    TEST_ASSERT_EQUAL_UINT32(0, report_slot_index(mac, sizeof(mac), 1));
+    TEST_ASSERT_EQUAL_UINT32(0, report_slot_index(mac, sizeof(mac), 0));
+}
+
+// ---- Offsets ----
+
+static void test_offsets_cut_interval_evenly(void) {
+    TEST_ASSERT_EQUAL_UINT32(0, report_slot_offset_ms(0, 60, HOUR_MS));
+    TEST_ASSERT_EQUAL_UINT32(60000, report_slot_offset_ms(1, 60, HOUR_MS));
+    TEST_ASSERT_EQUAL_UINT32(HOUR_MS - 60000, report_slot_offset_ms(59, 60, HOUR_MS));
+    TEST_ASSERT_EQUAL_UINT32(128571, report_slot_offset_ms(1, 7, 900000));
+    TEST_ASSERT_EQUAL_UINT32(0, report_slot_offset_ms(60, 60, HOUR_MS));
+    TEST_ASSERT_EQUAL_UINT32(0, report_slot_offset_ms(0, 0, HOUR_MS));
+}
+
+// A fleet woken in lock-step: at most a slot's share reports in any minute.
+static void test_lockstep_burst_is_flattened(void) {
+    int per_minute[60] = {0};
+    for (int n = 0; n < 120; n++) {
+        uint8_t mac[6] = { 0x54, 0x32, 0x04, 0x01, 0x10, (uint8_t)n };
+        uint32_t slot = report_slot_index(mac, sizeof(mac), REPORT_SLOTS);
+        per_minute[report_slot_offset_ms(slot, REPORT_SLOTS, HOUR_MS) / 60000]++;
+    }
+    for (int m = 0; m < 60; m++) {
+        TEST_ASSERT_LESS_THAN(8, per_minute[m]);                 // all 120 without slots
+    }
+}
+
+// ---- Timer re-arm ----
+
+static void test_delay_to_next_slot(void) {
+    const uint32_t I = 900000, off = 135000;
+    // Half way through interval 0: slot 1 starts at I + off
+    TEST_ASSERT_EQUAL_UINT32(I / 2 + off, report_slot_delay_ms(I / 2, I, off));
+    // Under half an interval away: the slot after
+    TEST_ASSERT_EQUAL_UINT32(I + off, report_slot_delay_ms(0, I, off));
+    TEST_ASSERT_EQUAL_UINT32(I, report_slot_delay_ms(5 * (int64_t)I + off, I, off));
+    TEST_ASSERT_EQUAL_UINT32(I - 40, report_slot_delay_ms(5 * (int64_t)I + off + 40, I, off));
+    // Fired 30 ms early: the next slot, not the one just reached
+    TEST_ASSERT_EQUAL_UINT32(I + 30, report_slot_delay_ms(5 * (int64_t)I + off - 30, I, off));
+    // Offsets past the interval wrap; clocks before zero still work
+    TEST_ASSERT_EQUAL_UINT32(I, report_slot_delay_ms(off, I, off + I));
+    TEST_ASSERT_EQUAL_UINT32(I, report_slot_delay_ms(off - (int64_t)I, I, off));
+    TEST_ASSERT_EQUAL_UINT32(0, report_slot_delay_ms(1234, 0, off));
+}
+
+// Re-armed from its own callback with a little scheduling jitter, the
+// timer stays on its slot instead of creeping later each cycle.
+static void test_rearm_holds_phase(void) {
+    const uint32_t I = 900000, off = 135000;
+    int64_t now = 1000;
+    now += report_slot_delay_ms(now, I, off);
+    for (int i = 0; i < 1000; i++) {
+        int64_t fired = now + (i % 7) * 11 - 30;        // -30 .. +36 ms late
+        now = fired + report_slot_delay_ms(fired, I, off);
+        TEST_ASSERT_EQUAL_INT64(off, now % I);
+    }
+}
+
+int main(void) {
+    UNITY_BEGIN();
+    RUN_TEST(test_consecutive_macs_spread_evenly);
+    RUN_TEST(test_device_ids_spread_evenly);
+    RUN_TEST(test_any_slot_count);
+    RUN_TEST(test_index_is_stable);
+    RUN_TEST(test_offsets_cut_interval_evenly);
+    RUN_TEST(test_lockstep_burst_is_flattened);
+    RUN_TEST(test_delay_to_next_slot);
+    RUN_TEST(test_rearm_holds_phase);
+    return UNITY_END();
+}
@@ -0,0 +1,131 @@
+#include <unity.h>
+#include <string.h>
+
+#define TEST_HOST 1
+#include "../../src/sample_reduce.c"
+
+void setUp(void) {}
+void tearDown(void) {}
+
+// ---- empty / degenerate input ----
+
+static void test_empty_returns_minus_one(void) {
+    int b[1] = {0};
+    TEST_ASSERT_EQUAL_INT(-1, sample_reduce_mean(b, 0));
+    TEST_ASSERT_EQUAL_INT(-1, sample_reduce_median(b, 0));
+    TEST_ASSERT_EQUAL_INT(-1, sample_reduce_trimmed_mean(b, 0, 2));
+    TEST_ASSERT_EQUAL_INT(-1, sample_reduce_mad(b, 0, 30));
+    TEST_ASSERT_EQUAL_INT(-1, sample_reduce(NULL, 4));
+}
+
+static void test_single_sample_passes_through(void) {
+    int a[] = { 1234 }, b[] = { 1234 }, c[] = { 1234 };
+    TEST_ASSERT_EQUAL_INT(1234, sample_reduce_median(a, 1));
+    TEST_ASSERT_EQUAL_INT(1234, sample_reduce_trimmed_mean(b, 1, 2));
+    TEST_ASSERT_EQUAL_INT(1234, sample_reduce_mad(c, 1, 30));
+}
+
+// ---- mean matches the legacy sensor averaging (truncating) ----
+
+static void test_mean_truncates(void) {
+    int b[] = { 100, 101, 101 };
+    TEST_ASSERT_EQUAL_INT(100, sample_reduce_mean(b, 3));
+}
+
+// ---- median ----
+
+static void test_median_odd(void) {
+    int b[] = { 9, 1, 5, 3, 7 };
+    TEST_ASSERT_EQUAL_INT(5, sample_reduce_median(b, 5));
+}
+
+static void test_median_even_averages_middle_pair(void) {
+    int b[] = { 40, 10, 30, 20 };
+    TEST_ASSERT_EQUAL_INT(25, sample_reduce_median(b, 4));
+}
+
+static void test_median_sorts_in_place(void) {
+    int b[] = { 3, 1, 2 };
+    sample_reduce_median(b, 3);
+    TEST_ASSERT_EQUAL_INT(1, b[0]);
+    TEST_ASSERT_EQUAL_INT(3, b[2]);
+}
+
+// ---- trimmed mean ----
+
+static void test_trimmed_drops_both_tails(void) {
+    int b[] = { 0, 2000, 2001, 2002, 2003, 2004, 4095, 2005 };
+    // sorted: 0 2000 2001 2002 2003 2004 2005 4095 -> trim 1 -> mean(2000..2005) = 2002
+    TEST_ASSERT_EQUAL_INT(2002, sample_reduce_trimmed_mean(b, 8, 1));
+}
+
+static void test_trimmed_over_trim_degrades_to_median(void) {
+    int b[] = { 10, 20, 30 };
+    TEST_ASSERT_EQUAL_INT(20, sample_reduce_trimmed_mean(b, 3, 5));
+}
+
+// ---- MAD rejection ----
+
+static void test_mad_rejects_single_glitch(void) {
+    // One rail-high glitch would drag the plain mean up by ~200 codes.
+    int glitch[] = { 1850, 1852, 1849, 1851, 1850, 4095, 1848, 1852, 1851, 1850 };
+    int copy[10];
+    memcpy(copy, glitch, sizeof(glitch));
+    TEST_ASSERT_TRUE(sample_reduce_mean(copy, 10) > 2000);
+    TEST_ASSERT_EQUAL_INT(1850, sample_reduce_mad(glitch, 10, 30));
+}
+
+static void test_mad_rejects_low_dropout(void) {
+    int b[] = { 2100, 2102, 0, 2101, 2099, 2100, 2103, 2098 };
+    TEST_ASSERT_EQUAL_INT(2100, sample_reduce_mad(b, 8, 30));
+}
+
+static void test_mad_keeps_normal_spread(void) {
+    int b[] = { 1000, 1010, 990, 1005, 995, 1002, 998, 1000 };
+    int m[8];
+    memcpy(m, b, sizeof(b));
+    TEST_ASSERT_EQUAL_INT(sample_reduce_mean(m, 8), sample_reduce_mad(b, 8, 30));
+}
+
+static void test_mad_zero_spread_keeps_one_lsb_noise(void) {
+    int b[] = { 500, 500, 500, 500, 501, 500, 499, 900 };
+    // MAD == 0 is floored to 1 LSB, so 499/501 stay and 900 goes.
+    TEST_ASSERT_EQUAL_INT(500, sample_reduce_mad(b, 8, 30));
+}
+
+static void test_reject_outliers_compacts_survivors(void) {
+    int b[] = { 2100, 4095, 2102, 2101, 0, 2099 };
+    size_t kept = sample_reduce_reject_outliers(b, 6, 30);
+    TEST_ASSERT_EQUAL_INT(4, kept);
+    TEST_ASSERT_EQUAL_INT(2099, b[0]);
+    TEST_ASSERT_EQUAL_INT(2102, b[3]);
+    TEST_ASSERT_EQUAL_INT(0, sample_reduce_reject_outliers(b, 0, 30));
+}
+
+// ---- compile-time selection ----
+
+static void test_default_algorithm_is_mad(void) {
+    TEST_ASSERT_EQUAL_INT(SAMPLE_REDUCE_MAD, SAMPLE_REDUCE_ALGO);
+    int b[] = { 1850, 1852, 4095, 1848 };
+    int c[] = { 1850, 1852, 4095, 1848 };
+    TEST_ASSERT_EQUAL_INT(sample_reduce_mad(c, 4, SAMPLE_REDUCE_MAD_K_X10), sample_reduce(b, 4));
+}
+
+int main(void) {
+    UNITY_BEGIN();
+    RUN_TEST(test_empty_returns_minus_one);
+    RUN_TEST(test_single_sample_passes_through);
+    RUN_TEST(test_mean_truncates);
+    RUN_TEST(test_median_odd);
+    RUN_TEST(test_median_even_averages_middle_pair);
+    RUN_TEST(test_median_sorts_in_place);
+    RUN_TEST(test_trimmed_drops_both_tails);
+    RUN_TEST(test_trimmed_over_trim_degrades_to_median);
+    RUN_TEST(test_mad_rejects_single_glitch);
+    RUN_TEST(test_mad_rejects_low_dropout);
+    RUN_TEST(test_mad_keeps_normal_spread);
+    RUN_TEST(test_mad_zero_spread_keeps_one_lsb_noise);
+    RUN_TEST(test_reject_outliers_compacts_survivors);
+    RUN_TEST(test_default_algorithm_is_mad);
+    return UNITY_END();
+}
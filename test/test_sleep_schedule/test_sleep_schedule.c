@@ -0,0 +1,209 @@
+#include <unity.h>
+#include <string.h>
+
+#define TEST_HOST 1
+#include "../../src/crc32.c"
+#include "../../src/telemetry_enc.c"
+#include "../../src/sleep_schedule.c"
+
+#define HOUR_MS   3600000LL
+#define DAY_MS    (24 * HOUR_MS)
+#define WALL0_MS  1790000000000LL                   // some Unix time in 2026
+
+static sleep_schedule_t s;
+static const sleep_schedule_cfg_t HOURLY = { .interval_s = 3600, .min_sleep_s = 60 };
+
+void setUp(void) {
+    sleep_schedule_reset(&s);
+}
+void tearDown(void) {}
+
+// ---- Cadence ----
+
+static void test_first_plan_sleeps_one_interval(void) {
+    TEST_ASSERT_TRUE(sleep_schedule_valid(&s));
+    TEST_ASSERT_EQUAL_INT64(5000 + HOUR_MS, sleep_schedule_plan(&s, &HOURLY, 5000));
+    TEST_ASSERT_TRUE(sleep_schedule_valid(&s));
+}
+
+static void test_awake_time_is_absorbed(void) {
+    int64_t wake = sleep_schedule_plan(&s, &HOURLY, 1000);
+    for (int i = 0; i < 48; i++) {
+        int64_t awake = 300 + (i * 7919) % 9000;   // 0.3 .. 9.3 s
+        int64_t next = sleep_schedule_plan(&s, &HOURLY, wake + awake);
+        TEST_ASSERT_EQUAL_INT64(wake + HOUR_MS, next);
+        wake = next;
+    }
+    TEST_ASSERT_EQUAL_INT64(1000 + 49 * HOUR_MS, wake);
+}
+
+static void test_overrun_skips_to_next_slot(void) {
+    int64_t wake = sleep_schedule_plan(&s, &HOURLY, 0);
+    // Woke on time but stayed up 1.5 intervals (portal session): the missed
+    // slot is dropped, the cadence is kept.
+    TEST_ASSERT_EQUAL_INT64(wake + 2 * HOUR_MS,
+                            sleep_schedule_plan(&s, &HOURLY, wake + HOUR_MS + HOUR_MS / 2));
+    // Less than min_sleep_s before a slot: take the one after.
+    TEST_ASSERT_EQUAL_INT64(wake + 4 * HOUR_MS,
+                            sleep_schedule_plan(&s, &HOURLY, wake + 3 * HOUR_MS - 30000));
+}
+
+static void test_early_wake_keeps_planned_slot(void) {
+    int64_t planned = sleep_schedule_plan(&s, &HOURLY, 0);
+    // Button wake 20 min in: the hourly wake stays where it was.
+    TEST_ASSERT_EQUAL_INT64(planned, sleep_schedule_plan(&s, &HOURLY, 20 * 60000));
+}
+
+static void test_clock_jump_restarts_cadence(void) {
+    sleep_schedule_plan(&s, &HOURLY, 10 * HOUR_MS);
+    TEST_ASSERT_EQUAL_INT64(1000 + HOUR_MS, sleep_schedule_plan(&s, &HOURLY, 1000));
+}
+
+// ---- SNTP and drift ----
+
+static void test_sync_due_and_backoff(void) {
+    TEST_ASSERT_TRUE(sleep_schedule_sync_due(&s, 1000));
+    sleep_schedule_note_try(&s, 1000);               // no answer
+    TEST_ASSERT_FALSE(sleep_schedule_sync_due(&s, HOUR_MS));
+    TEST_ASSERT_TRUE(sleep_schedule_sync_due(&s, 1000 + SNTP_RETRY_S * 1000LL));
+
+    sleep_schedule_note_try(&s, 7 * HOUR_MS);
+    sleep_schedule_note_sync(&s, 7 * HOUR_MS, WALL0_MS);
+    TEST_ASSERT_FALSE(sleep_schedule_sync_due(&s, 7 * HOUR_MS + DAY_MS - 1));
+    TEST_ASSERT_TRUE(sleep_schedule_sync_due(&s, 7 * HOUR_MS + DAY_MS));
+}
+
+static void test_drift_is_measured_between_syncs(void) {
+    int64_t wall;
+    TEST_ASSERT_FALSE(sleep_schedule_wall_ms(&s, 0, &wall));
+    sleep_schedule_note_sync(&s, 0, WALL0_MS);
+    TEST_ASSERT_EQUAL_INT32(0, s.drift_ppm);
+
+    // The system clock counted 86227.5 s over a real day: 2000 ppm slow.
+    int64_t sys = 86227500;
+    sleep_schedule_note_sync(&s, sys, WALL0_MS + DAY_MS);
+    TEST_ASSERT_INT_WITHIN(1, 2000, s.drift_ppm);
+
+    // An hour later by the system clock is 3607.2 s of real time...
+    TEST_ASSERT_TRUE(sleep_schedule_wall_ms(&s, sys + HOUR_MS, &wall));
+    TEST_ASSERT_INT_WITHIN(1, WALL0_MS + DAY_MS + 3607200, wall);
+    // ...so a real hour is a shorter sleep.
+    sleep_schedule_plan(&s, &HOURLY, sys);
+    TEST_ASSERT_INT_WITHIN(1, sys + 3592814, s.next_ms);
+    TEST_ASSERT_INT_WITHIN(1, 3592814, sleep_schedule_step_ms(&s, 3600));
+}
+
+static void test_short_span_keeps_drift(void) {
+    sleep_schedule_note_sync(&s, 0, WALL0_MS);
+    sleep_schedule_note_sync(&s, DAY_MS, WALL0_MS + DAY_MS + 86400);    // +1000 ppm
+    TEST_ASSERT_INT_WITHIN(1, 1000, s.drift_ppm);
+    sleep_schedule_note_sync(&s, DAY_MS + HOUR_MS, WALL0_MS + DAY_MS);  // nonsense, 1 h span
+    TEST_ASSERT_INT_WITHIN(1, 1000, s.drift_ppm);
+    TEST_ASSERT_EQUAL_UINT16(1, s.drifts);
+}
+
+static void test_drift_is_clamped(void) {
+    sleep_schedule_note_sync(&s, 0, WALL0_MS);
+    sleep_schedule_note_sync(&s, DAY_MS, WALL0_MS + 2 * DAY_MS);
+    TEST_ASSERT_EQUAL_INT32(SLEEP_DRIFT_MAX_PPM, s.drift_ppm);
+}
+
+// ---- Slots ----
+
+static void test_aligned_to_jittered_slot(void) {
+    sleep_schedule_cfg_t cfg = HOURLY;
+    cfg.align = true;
+    cfg.jitter_s = 1234;
+    int64_t wall0 = (WALL0_MS / HOUR_MS) * HOUR_MS + 10 * 60000;   // hh:10:00
+    sleep_schedule_note_sync(&s, 5000, wall0);
+    // Next hh:20:34 is 10:34 away
+    TEST_ASSERT_EQUAL_INT64(5000 + 634000, sleep_schedule_plan(&s, &cfg, 5000));
+    // At hh:20:00, 34 s before the slot (< min_sleep_s): the following hour
+    TEST_ASSERT_EQUAL_INT64(5000 + 600000 + 34000 + HOUR_MS,
+                            sleep_schedule_plan(&s, &cfg, 5000 + 600000));
+}
+
+// Before the first sync the slots are on the system clock: nodes powered
+// up together still wake apart, and keep their cadence.
+static void test_unsynced_slots_use_system_clock(void) {
+    sleep_schedule_cfg_t cfg = HOURLY;
+    cfg.align = true;
+    cfg.jitter_s = 1234;
+    TEST_ASSERT_EQUAL_INT64(1234000, sleep_schedule_plan(&s, &cfg, 7));
+    TEST_ASSERT_EQUAL_INT64(1234000 + HOUR_MS, sleep_schedule_plan(&s, &cfg, 1234000 + 4500));
+    cfg.jitter_s = 2000;
+    TEST_ASSERT_EQUAL_INT64(2000000, sleep_schedule_plan(&s, &cfg, 7));
+}
+
+// A week on a sleep clock 1.5 % slow, with a daily sync: once the drift is
+// known, every wake lands within a second of its slot.
+static void test_week_on_drifting_clock(void) {
+    const int64_t true_ppm = 15000;
+    sleep_schedule_cfg_t cfg = HOURLY;
+    cfg.align = true;
+    cfg.jitter_s = 1234;
+    int64_t sys = 0, real = WALL0_MS + 777777;
+    int64_t worst_after_day2 = 0;
+    for (int wake = 0; wake < 7 * 24; wake++) {
+        if (sleep_schedule_sync_due(&s, sys)) {
+            sleep_schedule_note_try(&s, sys);
+            sleep_schedule_note_sync(&s, sys, real);
+        }
+        if (wake > 48) {
+            int64_t err = (real - 1234000) % HOUR_MS;
+            if (err > HOUR_MS / 2) err -= HOUR_MS;
+            if (err < 0) err = -err;
+            if (err > worst_after_day2) worst_after_day2 = err;
+        }
+        sys += 2500;                                 // awake (crystal clock)
+        real += 2500;
+        int64_t sleep = sleep_schedule_plan(&s, &cfg, sys) - sys;
+        TEST_ASSERT_TRUE(sleep > 0);
+        sys += sleep;
+        real += sleep + sleep * true_ppm / PPM;
+    }
+    TEST_ASSERT_INT_WITHIN(200, true_ppm, s.drift_ppm);
+    TEST_ASSERT_LESS_THAN(1000, worst_after_day2);
+}
+
+// ---- Telemetry and integrity ----
+
+static void test_encode(void) {
+    char buf[96];
+    telemetry_enc_t e;
+    telemetry_enc_init(&e, TELEMETRY_FMT_JSON, buf, sizeof(buf));
+    sleep_schedule_encode(&s, 0, &e);                 // never synced: nothing
+    TEST_ASSERT_EQUAL_INT(0, telemetry_enc_finish(&e));
+
+    sleep_schedule_note_sync(&s, 0, WALL0_MS);
+    sleep_schedule_note_sync(&s, DAY_MS, WALL0_MS + DAY_MS - 86400);
+    telemetry_enc_init(&e, TELEMETRY_FMT_JSON, buf, sizeof(buf));
+    sleep_schedule_encode(&s, DAY_MS + 90000, &e);
+    TEST_ASSERT_GREATER_THAN(0, telemetry_enc_finish(&e));
+    TEST_ASSERT_EQUAL_STRING("\"clock\":{\"drift_ppm\":-1000,\"sync_age_s\":90}", buf);
+}
+
+static void test_corruption_detected(void) {
+    sleep_schedule_note_sync(&s, 0, WALL0_MS);
+    s.sync_wall_ms ^= 1;
+    TEST_ASSERT_FALSE(sleep_schedule_valid(&s));
+}
+
+int main(void) {
+    UNITY_BEGIN();
+    RUN_TEST(test_first_plan_sleeps_one_interval);
+    RUN_TEST(test_awake_time_is_absorbed);
+    RUN_TEST(test_overrun_skips_to_next_slot);
+    RUN_TEST(test_early_wake_keeps_planned_slot);
+    RUN_TEST(test_clock_jump_restarts_cadence);
+    RUN_TEST(test_sync_due_and_backoff);
+    RUN_TEST(test_drift_is_measured_between_syncs);
+    RUN_TEST(test_short_span_keeps_drift);
+    RUN_TEST(test_drift_is_clamped);
+    RUN_TEST(test_aligned_to_jittered_slot);
+    RUN_TEST(test_unsynced_slots_use_system_clock);
+    RUN_TEST(test_week_on_drifting_clock);
+    RUN_TEST(test_encode);
+    RUN_TEST(test_corruption_detected);
+    return UNITY_END();
+}
@@ -0,0 +1,33 @@
+#ifndef SETTLE_TRACES_H
+#define SETTLE_TRACES_H
+
+// Probe AOUT after power-up, one mV read per 10 ms step (first entry = 10 ms).
+
+// Warm soil: output snaps to its level within ~30 ms.
+static const int TRACE_FAST[] = {
+    2410, 1980, 1862, 1858, 1855, 1856, 1854, 1855, 1856, 1855,
+};
+
+// Cold soil: slow exponential approach, still moving past the old 150 ms window.
+static const int TRACE_COLD[] = {
+    2650, 2520, 2410, 2318, 2240, 2175, 2121, 2076, 2038, 2007,
+    1981, 1960, 1942, 1927, 1915, 1905, 1897, 1890, 1885, 1881,
+    1878, 1876, 1874, 1873, 1872, 1872, 1871, 1871, 1871, 1870,
+};
+
+// Dry air: rises to the rail-side dry level; flat within noise after ~50 ms.
+static const int TRACE_DRY_AIR[] = {
+    1500, 2300, 2710, 2790, 2801, 2797, 2803, 2799, 2800, 2802,
+};
+
+// Intermittent contact: never settles — must hit the ceiling.
+static const int TRACE_UNSTABLE[] = {
+    1900, 1960, 1890, 1975, 1880, 1990, 1870, 1965, 1885, 1970,
+    1895, 1960, 1880, 1985, 1875, 1990, 1870, 1960, 1890, 1975,
+    1880, 1990, 1875, 1960, 1885, 1970, 1895, 1960, 1880, 1985,
+    1875, 1990, 1870, 1960, 1890, 1975,
+};
+
+#define TRACE_LEN(t) (sizeof(t) / sizeof((t)[0]))
+
+#endif // SETTLE_TRACES_H
@@ -0,0 +1,114 @@
+#include <unity.h>
+
+#define TEST_HOST 1
+#include "../../src/soil_settle.c"
+#include "settle_traces.h"
+
+void setUp(void) {}
+void tearDown(void) {}
+
+static const soil_settle_cfg_t CFG = SOIL_SETTLE_CFG_DEFAULT;
+
+static void test_fast_trace_settles_well_before_fixed_warmup(void) {
+    soil_settle_state_t st;
+    int ms = soil_settle_run(&CFG, TRACE_FAST, TRACE_LEN(TRACE_FAST), &st);
+    TEST_ASSERT_EQUAL_INT(SOIL_SETTLE_DONE, st);
+    TEST_ASSERT_EQUAL_INT(50, ms);
+}
+
+static void test_cold_trace_waits_past_fixed_warmup(void) {
+    soil_settle_state_t st;
+    int ms = soil_settle_run(&CFG, TRACE_COLD, TRACE_LEN(TRACE_COLD), &st);
+    TEST_ASSERT_EQUAL_INT(SOIL_SETTLE_DONE, st);
+    TEST_ASSERT_TRUE(ms > 150);
+    TEST_ASSERT_TRUE(ms < CFG.max_ms);
+}
+
+static void test_dry_air_settles_inside_noise_band(void) {
+    soil_settle_state_t st;
+    int ms = soil_settle_run(&CFG, TRACE_DRY_AIR, TRACE_LEN(TRACE_DRY_AIR), &st);
+    TEST_ASSERT_EQUAL_INT(SOIL_SETTLE_DONE, st);
+    TEST_ASSERT_EQUAL_INT(70, ms);
+}
+
+static void test_unstable_trace_hits_ceiling(void) {
+    soil_settle_state_t st;
+    int ms = soil_settle_run(&CFG, TRACE_UNSTABLE, TRACE_LEN(TRACE_UNSTABLE), &st);
+    TEST_ASSERT_EQUAL_INT(SOIL_SETTLE_TIMEOUT, st);
+    TEST_ASSERT_EQUAL_INT(CFG.max_ms, ms);
+}
+
+static void test_min_ms_holds_off_a_flat_start(void) {
+    soil_settle_cfg_t cfg = CFG;
+    cfg.min_ms = 60;
+    static const int flat[] = { 1800, 1800, 1800, 1800, 1800, 1800, 1800, 1800 };
+    soil_settle_state_t st;
+    TEST_ASSERT_EQUAL_INT(60, soil_settle_run(&cfg, flat, TRACE_LEN(flat), &st));
+    TEST_ASSERT_EQUAL_INT(SOIL_SETTLE_DONE, st);
+}
+
+static void test_single_spike_resets_calm_count(void) {
+    soil_settle_t s;
+    soil_settle_begin(&s);
+    TEST_ASSERT_EQUAL_INT(SOIL_SETTLE_WAIT, soil_settle_feed(&s, &CFG, 1800));
+    TEST_ASSERT_EQUAL_INT(SOIL_SETTLE_WAIT, soil_settle_feed(&s, &CFG, 1802));   // calm 1
+    TEST_ASSERT_EQUAL_INT(SOIL_SETTLE_WAIT, soil_settle_feed(&s, &CFG, 1850));   // spike
+    TEST_ASSERT_EQUAL_INT(SOIL_SETTLE_WAIT, soil_settle_feed(&s, &CFG, 1851));   // calm 1
+    TEST_ASSERT_EQUAL_INT(SOIL_SETTLE_DONE, soil_settle_feed(&s, &CFG, 1849));   // calm 2
+}
+
+static void test_trace_running_out_reports_wait(void) {
+    soil_settle_state_t st;
+    soil_settle_run(&CFG, TRACE_COLD, 5, &st);
+    TEST_ASSERT_EQUAL_INT(SOIL_SETTLE_WAIT, st);
+}
+
+// Three probes on one power window: the shared warm-up lasts as long as the
+// slowest probe, and each settled probe keeps its own settle time.
+static void test_shared_window_costs_the_slowest_probe(void) {
+    const int *traces[] = { TRACE_FAST, TRACE_COLD, TRACE_DRY_AIR };
+    const size_t lens[] = { TRACE_LEN(TRACE_FAST), TRACE_LEN(TRACE_COLD), TRACE_LEN(TRACE_DRY_AIR) };
+    soil_settle_t s[3];
+    soil_settle_state_t st[3];
+    for (int p = 0; p < 3; p++) {
+        soil_settle_begin(&s[p]);
+        st[p] = SOIL_SETTLE_WAIT;
+    }
+
+    int window_ms = 0;
+    bool done = false;
+    for (size_t step = 0; !done; step++) {
+        int mv[3];
+        for (int p = 0; p < 3; p++) {
+            mv[p] = traces[p][step < lens[p] ? step : lens[p] - 1];
+        }
+        done = soil_settle_feed_all(s, st, 3, &CFG, mv);
+        window_ms += CFG.step_ms;
+    }
+
+    int slowest = 0;
+    int sum = 0;
+    for (int p = 0; p < 3; p++) {
+        soil_settle_state_t solo;
+        int ms = soil_settle_run(&CFG, traces[p], lens[p], &solo);
+        TEST_ASSERT_EQUAL_INT(solo, st[p]);
+        TEST_ASSERT_EQUAL_INT(ms, s[p].elapsed_ms);
+        if (ms > slowest) slowest = ms;
+        sum += ms;
+    }
+    TEST_ASSERT_EQUAL_INT(slowest, window_ms);
+    TEST_ASSERT_TRUE(window_ms < sum);
+}
+
+int main(void) {
+    UNITY_BEGIN();
+    RUN_TEST(test_fast_trace_settles_well_before_fixed_warmup);
+    RUN_TEST(test_cold_trace_waits_past_fixed_warmup);
+    RUN_TEST(test_dry_air_settles_inside_noise_band);
+    RUN_TEST(test_unstable_trace_hits_ceiling);
+    RUN_TEST(test_min_ms_holds_off_a_flat_start);
+    RUN_TEST(test_single_spike_resets_calm_count);
+    RUN_TEST(test_trace_running_out_reports_wait);
+    RUN_TEST(test_shared_window_costs_the_slowest_probe);
+    return UNITY_END();
+}
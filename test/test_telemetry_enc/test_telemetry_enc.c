@@ -0,0 +1,168 @@
+#include <unity.h>
+#include <string.h>
+
+#define TEST_HOST 1
+#include "../../src/telemetry_enc.c"
+
+static uint8_t buf[256];
+static telemetry_enc_t e;
+
+void setUp(void) { memset(buf, 0xAA, sizeof(buf)); }
+void tearDown(void) {}
+
+// The same payload shape mqtt_publisher sends.
+static void encode_sample(telemetry_fmt_t fmt, size_t cap) {
+    telemetry_enc_init(&e, fmt, buf, cap);
+    telemetry_enc_map_begin(&e, NULL);
+    telemetry_enc_fixed(&e, "battery", 415, 2);
+    telemetry_enc_fixed(&e, "soil_moisture", 425, 1);
+    telemetry_enc_array_begin(&e, "total");
+    telemetry_enc_int(&e, NULL, 812);
+    telemetry_enc_int(&e, NULL, 790);
+    telemetry_enc_array_end(&e);
+    telemetry_enc_str(&e, "device", "moisture01");
+    telemetry_enc_map_end(&e);
+}
+
+static const char SAMPLE_JSON[] =
+    "{\"battery\":4.15,\"soil_moisture\":42.5,\"total\":[812,790],\"device\":\"moisture01\"}";
+
+static void test_json_payload(void) {
+    encode_sample(TELEMETRY_FMT_JSON, sizeof(buf));
+    int n = telemetry_enc_finish(&e);
+    TEST_ASSERT_EQUAL_STRING(SAMPLE_JSON, (char *)buf);
+    TEST_ASSERT_EQUAL_INT((int)strlen(SAMPLE_JSON), n);
+}
+
+// Matches what printf("%.2f") / ("%.1f") gave for the same values.
+static void test_json_fixed_point(void) {
+    telemetry_enc_init(&e, TELEMETRY_FMT_JSON, buf, sizeof(buf));
+    telemetry_enc_array_begin(&e, NULL);
+    telemetry_enc_fixed(&e, NULL, 5, 2);
+    telemetry_enc_fixed(&e, NULL, -5, 1);
+    telemetry_enc_fixed(&e, NULL, 0, 1);
+    telemetry_enc_fixed(&e, NULL, 1000, 0);
+    telemetry_enc_fixed(&e, NULL, 1183, 4);
+    telemetry_enc_fixed(&e, NULL, INT32_MIN, 0);
+    telemetry_enc_array_end(&e);
+    TEST_ASSERT_GREATER_THAN(0, telemetry_enc_finish(&e));
+    TEST_ASSERT_EQUAL_STRING("[0.05,-0.5,0.0,1000,0.1183,-2147483648]", (char *)buf);
+}
+
+static void test_json_escapes_strings(void) {
+    telemetry_enc_init(&e, TELEMETRY_FMT_JSON, buf, sizeof(buf));
+    telemetry_enc_str(&e, "device", "a\"b\\c\n");
+    TEST_ASSERT_GREATER_THAN(0, telemetry_enc_finish(&e));
+    TEST_ASSERT_EQUAL_STRING("\"device\":\"a\\\"b\\\\c\\u000a\"", (char *)buf);
+}
+
+// Top-level members without a map: a fragment to splice into a payload.
+static void test_json_member_fragment(void) {
+    telemetry_enc_init(&e, TELEMETRY_FMT_JSON, buf, sizeof(buf));
+    telemetry_enc_int(&e, "a", 1);
+    telemetry_enc_map_begin(&e, "b");
+    telemetry_enc_int(&e, "n", 2);
+    telemetry_enc_map_end(&e);
+    TEST_ASSERT_GREATER_THAN(0, telemetry_enc_finish(&e));
+    TEST_ASSERT_EQUAL_STRING("\"a\":1,\"b\":{\"n\":2}", (char *)buf);
+}
+
+static void test_cbor_payload_bytes(void) {
+    telemetry_enc_init(&e, TELEMETRY_FMT_CBOR, buf, sizeof(buf));
+    telemetry_enc_map_begin(&e, NULL);
+    telemetry_enc_int(&e, "a", 1);
+    telemetry_enc_fixed(&e, "b", 415, 2);
+    telemetry_enc_array_begin(&e, "c");
+    telemetry_enc_str(&e, NULL, "x");
+    telemetry_enc_array_end(&e);
+    telemetry_enc_map_end(&e);
+    static const uint8_t expect[] = {
+        0xBF,                                   // map (indefinite)
+        0x61, 'a', 0x01,                        // "a": 1
+        0x61, 'b', 0xC4, 0x82, 0x21, 0x19, 0x01, 0x9F, // "b": 4([-2, 415])
+        0x61, 'c', 0x9F, 0x61, 'x', 0xFF,       // "c": ["x"]
+        0xFF,
+    };
+    TEST_ASSERT_EQUAL_INT((int)sizeof(expect), telemetry_enc_finish(&e));
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(expect, buf, sizeof(expect));
+}
+
+static void test_cbor_integer_widths(void) {
+    static const int32_t v[] = { 23, 24, 256, 65536, -1, -25, INT32_MIN };
+    static const uint8_t expect[] = {
+        0x17,
+        0x18, 0x18,
+        0x19, 0x01, 0x00,
+        0x1A, 0x00, 0x01, 0x00, 0x00,
+        0x20,
+        0x38, 0x18,
+        0x3A, 0x7F, 0xFF, 0xFF, 0xFF,
+    };
+    telemetry_enc_init(&e, TELEMETRY_FMT_CBOR, buf, sizeof(buf));
+    for (size_t i = 0; i < sizeof(v) / sizeof(v[0]); i++) {
+        telemetry_enc_int(&e, NULL, v[i]);
+    }
+    TEST_ASSERT_EQUAL_INT((int)sizeof(expect), telemetry_enc_finish(&e));
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(expect, buf, sizeof(expect));
+}
+
+static void test_cbor_is_smaller(void) {
+    encode_sample(TELEMETRY_FMT_CBOR, sizeof(buf));
+    int n = telemetry_enc_finish(&e);
+    TEST_ASSERT_GREATER_THAN(0, n);
+    TEST_ASSERT_LESS_THAN((int)strlen(SAMPLE_JSON), n);
+}
+
+static void test_overflow_exact_fit(void) {
+    size_t full = strlen(SAMPLE_JSON);
+    encode_sample(TELEMETRY_FMT_JSON, full + 1);    // + NUL
+    TEST_ASSERT_EQUAL_INT((int)full, telemetry_enc_finish(&e));
+
+    encode_sample(TELEMETRY_FMT_JSON, full);
+    TEST_ASSERT_EQUAL_INT(-1, telemetry_enc_finish(&e));
+    TEST_ASSERT_EQUAL_STRING("", (char *)buf);
+
+    encode_sample(TELEMETRY_FMT_CBOR, sizeof(buf));
+    int n = telemetry_enc_finish(&e);
+    memset(buf, 0xAA, sizeof(buf));
+    encode_sample(TELEMETRY_FMT_CBOR, (size_t)n - 1);
+    TEST_ASSERT_EQUAL_INT(-1, telemetry_enc_finish(&e));
+    TEST_ASSERT_EQUAL_HEX8(0xAA, buf[n - 1]);          // nothing past cap
+}
+
+static void test_overflow_is_sticky(void) {
+    telemetry_enc_init(&e, TELEMETRY_FMT_JSON, buf, 6);
+    telemetry_enc_str(&e, NULL, "too long");
+    telemetry_enc_int(&e, NULL, 1);                    // would fit on its own
+    TEST_ASSERT_EQUAL_INT(-1, telemetry_enc_finish(&e));
+}
+
+static void test_unbalanced_nesting_fails(void) {
+    telemetry_enc_init(&e, TELEMETRY_FMT_JSON, buf, sizeof(buf));
+    telemetry_enc_map_begin(&e, NULL);
+    TEST_ASSERT_EQUAL_INT(-1, telemetry_enc_finish(&e));
+
+    telemetry_enc_init(&e, TELEMETRY_FMT_CBOR, buf, sizeof(buf));
+    telemetry_enc_array_end(&e);
+    TEST_ASSERT_EQUAL_INT(-1, telemetry_enc_finish(&e));
+
+    telemetry_enc_init(&e, TELEMETRY_FMT_CBOR, buf, sizeof(buf));
+    for (int i = 0; i <= TELEMETRY_ENC_MAX_DEPTH; i++) telemetry_enc_array_begin(&e, NULL);
+    for (int i = 0; i <= TELEMETRY_ENC_MAX_DEPTH; i++) telemetry_enc_array_end(&e);
+    TEST_ASSERT_EQUAL_INT(-1, telemetry_enc_finish(&e));
+}
+
+int main(void) {
+    UNITY_BEGIN();
+    RUN_TEST(test_json_payload);
+    RUN_TEST(test_json_fixed_point);
+    RUN_TEST(test_json_escapes_strings);
+    RUN_TEST(test_json_member_fragment);
+    RUN_TEST(test_cbor_payload_bytes);
+    RUN_TEST(test_cbor_integer_widths);
+    RUN_TEST(test_cbor_is_smaller);
+    RUN_TEST(test_overflow_exact_fit);
+    RUN_TEST(test_overflow_is_sticky);
+    RUN_TEST(test_unbalanced_nesting_fails);
+    return UNITY_END();
+}
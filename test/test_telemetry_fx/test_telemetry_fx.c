@@ -0,0 +1,168 @@
+#include <unity.h>
+#include <math.h>
+#include <stdio.h>
+
+// Exhaustive agreement between the fixed-point report path and the float
+// functions it replaces. Pull all four pure modules in directly.
+#define TEST_HOST 1
+#include "../../src/battery_monitor.c"
+#include "../../src/zigbee_encode.c"
+#include "../../src/soil_moisture.c"
+#include "../../src/display.c"
+
+void setUp(void) {}
+void tearDown(void) {}
+
+// The float path loses the last bit at exact rounding ties (e.g. 3761 mV is
+// exactly 40.25 %, float says 40.249981 %) and then rounds the wrong way.
+// A mismatch is only acceptable there, and only if the integer path gave the
+// correctly rounded (half away from zero) answer.
+static bool float_tie_miss(double exact_units, long fixed) {
+    double frac = exact_units - floor(exact_units);
+    if (fabs(frac - 0.5) > 1e-3) return false;
+    return fixed == (long)floor(exact_units + 0.5);
+}
+
+// Exact SoC in 0.01 % units, straight from the integer curve.
+static double exact_soc_x100(int mv) {
+    if (mv >= SOC_LUT_FX[0].mv) return SOC_LUT_FX[0].pct_x100;
+    if (mv <= SOC_LUT_FX[SOC_LUT_FX_N - 1].mv) return SOC_LUT_FX[SOC_LUT_FX_N - 1].pct_x100;
+    for (size_t i = 0; i < SOC_LUT_FX_N - 1; i++) {
+        const soc_point_fx_t *a = &SOC_LUT_FX[i], *b = &SOC_LUT_FX[i + 1];
+        if (mv <= a->mv && mv >= b->mv) {
+            return b->pct_x100 +
+                   (double)(mv - b->mv) * (a->pct_x100 - b->pct_x100) / (a->mv - b->mv);
+        }
+    }
+    return -1.0;
+}
+
+static double exact_soil_x100(int32_t fx, int dry, int wet) {
+    int32_t d = dry << SOIL_MV_FRAC_BITS, w = wet << SOIL_MV_FRAC_BITS;
+    if (fx >= d) return 0.0;
+    if (fx <= w) return 10000.0;
+    return 10000.0 * (double)(d - fx) / (double)(d - w);
+}
+
+static void fail_at(const char *what, long at, long flt, long fixed) {
+    char msg[96];
+    snprintf(msg, sizeof msg, "%s at %ld: float %ld, fixed %ld", what, at, flt, fixed);
+    TEST_FAIL_MESSAGE(msg);
+}
+
+// ---- curve tables ----
+
+static void test_fx_curve_matches_float_curve(void) {
+    TEST_ASSERT_EQUAL_INT((int)SOC_LUT_N, (int)SOC_LUT_FX_N);
+    for (size_t i = 0; i < SOC_LUT_N; i++) {
+        TEST_ASSERT_EQUAL_INT((int)lroundf(SOC_LUT[i].v * 1000.0f), SOC_LUT_FX[i].mv);
+        TEST_ASSERT_EQUAL_INT((int)lroundf(SOC_LUT[i].pct * 100.0f), SOC_LUT_FX[i].pct_x100);
+    }
+}
+
+static void test_soc_hits_every_knot(void) {
+    for (size_t i = 0; i < SOC_LUT_FX_N; i++) {
+        TEST_ASSERT_EQUAL_UINT16(SOC_LUT_FX[i].pct_x100,
+                                 battery_monitor_mv_to_pct_x100(SOC_LUT_FX[i].mv));
+    }
+}
+
+static void test_soc_clamps(void) {
+    TEST_ASSERT_EQUAL_UINT16(0,     battery_monitor_mv_to_pct_x100(-5));
+    TEST_ASSERT_EQUAL_UINT16(0,     battery_monitor_mv_to_pct_x100(3000));
+    TEST_ASSERT_EQUAL_UINT16(10000, battery_monitor_mv_to_pct_x100(4500));
+}
+
+// ---- exhaustive battery path ----
+
+static void test_soc_x100_matches_float_every_mv(void) {
+    for (int mv = 0; mv <= 5000; mv++) {
+        long flt = lroundf(battery_monitor_v_to_pct((float)mv / 1000.0f) * 100.0f);
+        long fixed = battery_monitor_mv_to_pct_x100(mv);
+        if (flt != fixed && !float_tie_miss(exact_soc_x100(mv), fixed)) {
+            fail_at("soc_x100", mv, flt, fixed);
+        }
+    }
+}
+
+static void test_zcl_batt_pct_matches_float_every_mv(void) {
+    for (int mv = 0; mv <= 5000; mv++) {
+        long flt = zigbee_encode_batt_pct(battery_monitor_v_to_pct((float)mv / 1000.0f));
+        long fixed = zigbee_encode_batt_pct_x100(battery_monitor_mv_to_pct_x100(mv));
+        if (flt != fixed && !float_tie_miss(exact_soc_x100(mv) / 50.0, fixed)) {
+            fail_at("batt_pct", mv, flt, fixed);
+        }
+    }
+}
+
+static void test_zcl_batt_pct_exact_on_divider_mv(void) {
+    // The 1:1 divider makes every real cell reading an even mV; there the
+    // two paths agree bit for bit.
+    for (int mv = 0; mv <= 5000; mv += 2) {
+        TEST_ASSERT_EQUAL_UINT8(
+            zigbee_encode_batt_pct(battery_monitor_v_to_pct((float)mv / 1000.0f)),
+            zigbee_encode_batt_pct_x100(battery_monitor_mv_to_pct_x100(mv)));
+    }
+}
+
+static void test_zcl_batt_voltage_matches_float_every_mv(void) {
+    for (int mv = -100; mv <= 30000; mv++) {
+        long flt = zigbee_encode_batt_voltage((float)mv / 1000.0f);
+        long fixed = zigbee_encode_batt_mv(mv);
+        if (flt != fixed) fail_at("batt_voltage", mv, flt, fixed);
+    }
+}
+
+static void test_display_pct_matches_float_every_mv(void) {
+    for (int mv = 0; mv <= 5000; mv++) {
+        long flt = display_battery_v_to_pct((float)mv / 1000.0f);
+        long fixed = display_battery_mv_to_pct(mv);
+        if (flt != fixed && !float_tie_miss(exact_soc_x100(mv) / 100.0, fixed)) {
+            fail_at("display_pct", mv, flt, fixed);
+        }
+    }
+}
+
+// ---- exhaustive soil path ----
+
+static void check_soil_pair(int dry, int wet) {
+    for (int32_t fx = 0; fx <= (3300 << SOIL_MV_FRAC_BITS); fx++) {
+        long flt = zigbee_encode_soil_pct(soil_moisture_calc_percentage_fx(fx, dry, wet));
+        long fixed = zigbee_encode_soil_pct_x100(soil_moisture_calc_pct_x100(fx, dry, wet));
+        if (flt != fixed && !float_tie_miss(exact_soil_x100(fx, dry, wet), fixed)) {
+            fail_at("soil_pct", fx, flt, fixed);
+        }
+    }
+}
+
+static void test_soil_matches_float_default_cal(void)  { check_soil_pair(2950, 851); }
+static void test_soil_matches_float_round_cal(void)    { check_soil_pair(2800, 0); }
+static void test_soil_matches_float_narrow_cal(void)   { check_soil_pair(2600, 1200); }
+static void test_soil_matches_float_wide_cal(void)     { check_soil_pair(3100, 1000); }
+
+static void test_soil_inverted_cal(void) {
+    // dry <= wet is a bad calibration; both paths treat it the same way.
+    for (int32_t fx = 0; fx <= (3300 << SOIL_MV_FRAC_BITS); fx += 7) {
+        TEST_ASSERT_EQUAL_UINT16(
+            zigbee_encode_soil_pct(soil_moisture_calc_percentage_fx(fx, 1000, 2000)),
+            soil_moisture_calc_pct_x100(fx, 1000, 2000));
+    }
+}
+
+int main(void) {
+    UNITY_BEGIN();
+    RUN_TEST(test_fx_curve_matches_float_curve);
+    RUN_TEST(test_soc_hits_every_knot);
+    RUN_TEST(test_soc_clamps);
+    RUN_TEST(test_soc_x100_matches_float_every_mv);
+    RUN_TEST(test_zcl_batt_pct_matches_float_every_mv);
+    RUN_TEST(test_zcl_batt_pct_exact_on_divider_mv);
+    RUN_TEST(test_zcl_batt_voltage_matches_float_every_mv);
+    RUN_TEST(test_display_pct_matches_float_every_mv);
+    RUN_TEST(test_soil_matches_float_default_cal);
+    RUN_TEST(test_soil_matches_float_round_cal);
+    RUN_TEST(test_soil_matches_float_narrow_cal);
+    RUN_TEST(test_soil_matches_float_wide_cal);
+    RUN_TEST(test_soil_inverted_cal);
+    return UNITY_END();
+}
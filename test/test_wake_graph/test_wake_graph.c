@@ -0,0 +1,223 @@
+#include <unity.h>
+#include <string.h>
+
+#define TEST_HOST 1
+#include "../../src/wake_graph.c"
+
+void setUp(void) {}
+void tearDown(void) {}
+
+static bool run_nop(void *ctx) { (void)ctx; return true; }
+
+static wake_graph_node_t nodes[WAKE_GRAPH_MAX_NODES];
+
+static wake_graph_t pipeline(bool net_first) {
+    wake_graph_fn run[WAKE_NODE_COUNT];
+    for (size_t i = 0; i < WAKE_NODE_COUNT; i++) run[i] = run_nop;
+    wake_pipeline_init(nodes, run, net_first);
+    return (wake_graph_t){ .node = nodes, .n = WAKE_NODE_COUNT };
+}
+
+#define BIT(n)  WAKE_GRAPH_DEP(WAKE_NODE_##n)
+
+// Event-driven run on a simulated clock: each node takes dur[i] and fails if
+// its bit is in `fail`. Records start times (-1 = never ran) and returns the
+// finish time of the last node.
+static int32_t started_at[WAKE_GRAPH_MAX_NODES];
+
+static uint32_t simulate(const wake_graph_t *g, const uint32_t *dur, uint32_t fail,
+                         wake_graph_state_t *st) {
+    uint32_t finish[WAKE_GRAPH_MAX_NODES];
+    uint32_t now = 0, running = 0;
+    memset(st, 0, sizeof(*st));
+    for (size_t i = 0; i < WAKE_GRAPH_MAX_NODES; i++) started_at[i] = -1;
+
+    while (!wake_graph_finished(g, st)) {
+        uint32_t ready = wake_graph_next(g, st);
+        for (size_t i = 0; i < g->n; i++) {
+            if (!(ready & WAKE_GRAPH_DEP(i))) continue;
+            started_at[i] = (int32_t)now;
+            finish[i] = now + dur[i];
+            running |= WAKE_GRAPH_DEP(i);
+        }
+        if (!running) continue;
+        size_t first = 0;
+        uint32_t best = UINT32_MAX;
+        for (size_t i = 0; i < g->n; i++) {
+            if ((running & WAKE_GRAPH_DEP(i)) && finish[i] < best) { best = finish[i]; first = i; }
+        }
+        now = best;
+        running &= ~WAKE_GRAPH_DEP(first);
+        wake_graph_complete(st, first, !(fail & WAKE_GRAPH_DEP(first)));
+    }
+    return now;
+}
+
+// Typical wake, ms: probe settle + oversampling, fast-path association,
+// client start, connect + publish + PUBACK, full e-paper refresh, and the
+// daily SNTP exchange.
+static const uint32_t TYPICAL_MS[WAKE_NODE_COUNT] = {
+    [WAKE_NODE_SENSE]   = 320,
+    [WAKE_NODE_NET]     = 450,
+    [WAKE_NODE_BROKER]  = 15,
+    [WAKE_NODE_PUBLISH] = 380,
+    [WAKE_NODE_DISPLAY] = 1900,
+    [WAKE_NODE_CLOCK]   = 250,
+};
+
+// ---- Validity ----
+
+static void test_pipeline_is_valid(void) {
+    wake_graph_t g = pipeline(false);
+    TEST_ASSERT_TRUE(wake_graph_valid(&g));
+    g = pipeline(true);
+    TEST_ASSERT_TRUE(wake_graph_valid(&g));
+}
+
+static void test_cycle_and_bad_deps_are_rejected(void) {
+    wake_graph_node_t n[3] = {
+        { .name = "a", .deps = 0,                    .run = run_nop },
+        { .name = "b", .deps = WAKE_GRAPH_DEP(2),    .run = run_nop },
+        { .name = "c", .deps = WAKE_GRAPH_DEP(1),    .run = run_nop },
+    };
+    wake_graph_t g = { .node = n, .n = 3 };
+    TEST_ASSERT_FALSE(wake_graph_valid(&g));          // b <-> c
+
+    n[2].deps = WAKE_GRAPH_DEP(2);
+    TEST_ASSERT_FALSE(wake_graph_valid(&g));          // depends on itself
+
+    n[1].deps = 0;
+    n[2].deps = WAKE_GRAPH_DEP(5);
+    TEST_ASSERT_FALSE(wake_graph_valid(&g));          // no node 5
+
+    n[2].deps = WAKE_GRAPH_DEP(0) | WAKE_GRAPH_DEP(1);
+    TEST_ASSERT_TRUE(wake_graph_valid(&g));
+
+    g.n = 0;
+    TEST_ASSERT_FALSE(wake_graph_valid(&g));
+}
+
+// ---- Ordering ----
+
+static void test_radio_waits_for_the_report_decision(void) {
+    wake_graph_t g = pipeline(false);
+    wake_graph_state_t st = {0};
+    TEST_ASSERT_EQUAL_HEX32(BIT(SENSE), wake_graph_next(&g, &st));
+    TEST_ASSERT_EQUAL_HEX32(0, wake_graph_next(&g, &st));     // nothing until it returns
+    wake_graph_complete(&st, WAKE_NODE_SENSE, true);
+    TEST_ASSERT_EQUAL_HEX32(BIT(NET), wake_graph_next(&g, &st));
+}
+
+static void test_net_first_overlaps_sensing(void) {
+    wake_graph_t g = pipeline(true);
+    wake_graph_state_t st = {0};
+    TEST_ASSERT_EQUAL_HEX32(BIT(SENSE) | BIT(NET), wake_graph_next(&g, &st));
+}
+
+static void test_display_runs_alongside_publish(void) {
+    wake_graph_t g = pipeline(false);
+    wake_graph_state_t st;
+    simulate(&g, TYPICAL_MS, 0, &st);
+    TEST_ASSERT_EQUAL_INT32(started_at[WAKE_NODE_PUBLISH], started_at[WAKE_NODE_DISPLAY]);
+    TEST_ASSERT_EQUAL_INT32(TYPICAL_MS[WAKE_NODE_SENSE] + TYPICAL_MS[WAKE_NODE_NET] +
+                            TYPICAL_MS[WAKE_NODE_BROKER], started_at[WAKE_NODE_PUBLISH]);
+    TEST_ASSERT_EQUAL_HEX32((1u << WAKE_NODE_COUNT) - 1, st.ok);
+}
+
+// ---- Failures ----
+
+static void test_unchanged_reading_keeps_the_radio_off(void) {
+    wake_graph_t g = pipeline(false);
+    wake_graph_state_t st;
+    simulate(&g, TYPICAL_MS, BIT(SENSE), &st);
+    TEST_ASSERT_EQUAL_INT32(-1, started_at[WAKE_NODE_NET]);
+    TEST_ASSERT_EQUAL_INT32(-1, started_at[WAKE_NODE_DISPLAY]);
+    TEST_ASSERT_EQUAL_HEX32(0, st.ok);
+}
+
+static void test_no_link_skips_publish_and_display(void) {
+    wake_graph_t g = pipeline(true);
+    wake_graph_state_t st;
+    simulate(&g, TYPICAL_MS, BIT(NET), &st);
+    TEST_ASSERT_EQUAL_HEX32(BIT(SENSE), st.ok);
+    TEST_ASSERT_EQUAL_INT32(-1, started_at[WAKE_NODE_BROKER]);
+    TEST_ASSERT_EQUAL_INT32(-1, started_at[WAKE_NODE_PUBLISH]);
+    TEST_ASSERT_EQUAL_INT32(-1, started_at[WAKE_NODE_DISPLAY]);
+}
+
+static void test_failed_publish_still_refreshes_display(void) {
+    wake_graph_t g = pipeline(false);
+    wake_graph_state_t st;
+    simulate(&g, TYPICAL_MS, BIT(PUBLISH), &st);
+    TEST_ASSERT_EQUAL_HEX32(BIT(SENSE) | BIT(NET) | BIT(BROKER) | BIT(DISPLAY) | BIT(CLOCK), st.ok);
+}
+
+static void test_skips_cascade_in_one_step(void) {
+    wake_graph_node_t n[4] = {
+        { .name = "a", .deps = 0,                 .run = run_nop },
+        { .name = "b", .deps = WAKE_GRAPH_DEP(0), .run = run_nop },
+        { .name = "c", .deps = WAKE_GRAPH_DEP(1), .run = run_nop },
+        { .name = "d", .deps = 0,                 .run = run_nop },
+    };
+    wake_graph_t g = { .node = n, .n = 4 };
+    wake_graph_state_t st = {0};
+    TEST_ASSERT_EQUAL_HEX32(0x9, wake_graph_next(&g, &st));
+    wake_graph_complete(&st, 0, false);
+    TEST_ASSERT_EQUAL_HEX32(0, wake_graph_next(&g, &st));
+    TEST_ASSERT_EQUAL_HEX32(0x7, st.done);            // b and c skipped, d still running
+    TEST_ASSERT_FALSE(wake_graph_finished(&g, &st));
+    wake_graph_complete(&st, 3, true);
+    TEST_ASSERT_TRUE(wake_graph_finished(&g, &st));
+    TEST_ASSERT_EQUAL_HEX32(0x8, st.ok);
+}
+
+// ---- Wall time ----
+
+static void test_critical_path(void) {
+    wake_graph_t g = pipeline(false);
+    uint32_t serial = 0;
+    for (size_t i = 0; i < WAKE_NODE_COUNT; i++) serial += TYPICAL_MS[i];
+    uint32_t wall = wake_graph_critical_path(&g, TYPICAL_MS);
+    // sense -> net -> broker -> display; publish and SNTP hide behind the refresh
+    TEST_ASSERT_EQUAL_UINT32(320 + 450 + 15 + 1900, wall);
+    TEST_ASSERT_EQUAL_UINT32(serial - TYPICAL_MS[WAKE_NODE_PUBLISH] - TYPICAL_MS[WAKE_NODE_CLOCK],
+                             wall);
+
+    g = pipeline(true);                               // sensing hides behind association
+    TEST_ASSERT_EQUAL_UINT32(450 + 15 + 1900, wake_graph_critical_path(&g, TYPICAL_MS));
+}
+
+// The scheduler starts every node the moment it can: a simulated run takes
+// exactly the critical path.
+static void test_scheduler_meets_critical_path(void) {
+    static const uint32_t cases[][WAKE_NODE_COUNT] = {
+        { 320, 450, 15, 380, 1900, 0 },
+        { 320, 3000, 15, 380, 1900, 0 },              // slow association
+        { 900, 100, 10, 2500, 600, 250 },             // slow broker, partial refresh
+        { 320, 450, 15, 380, 600, 3000 },             // SNTP server timing out
+    };
+    for (size_t c = 0; c < sizeof(cases) / sizeof(cases[0]); c++) {
+        for (int net_first = 0; net_first < 2; net_first++) {
+            wake_graph_t g = pipeline(net_first);
+            wake_graph_state_t st;
+            TEST_ASSERT_EQUAL_UINT32(wake_graph_critical_path(&g, cases[c]),
+                                     simulate(&g, cases[c], 0, &st));
+        }
+    }
+}
+
+int main(void) {
+    UNITY_BEGIN();
+    RUN_TEST(test_pipeline_is_valid);
+    RUN_TEST(test_cycle_and_bad_deps_are_rejected);
+    RUN_TEST(test_radio_waits_for_the_report_decision);
+    RUN_TEST(test_net_first_overlaps_sensing);
+    RUN_TEST(test_display_runs_alongside_publish);
+    RUN_TEST(test_unchanged_reading_keeps_the_radio_off);
+    RUN_TEST(test_no_link_skips_publish_and_display);
+    RUN_TEST(test_failed_publish_still_refreshes_display);
+    RUN_TEST(test_skips_cascade_in_one_step);
+    RUN_TEST(test_critical_path);
+    RUN_TEST(test_scheduler_meets_critical_path);
+    return UNITY_END();
+}
@@ -0,0 +1,129 @@
+#include <unity.h>
+#include <string.h>
+
+#define TEST_HOST 1
+#include "../../src/telemetry_enc.c"
+#include "../../src/wake_stub.c"
+
+#define HOUR_S      3600u
+#define HEARTBEAT_S (6 * HOUR_S)
+#define STEP_US     3600000000ULL
+
+static wake_stub_t s;
+
+void setUp(void) {
+    wake_stub_reset(&s);
+}
+void tearDown(void) {}
+
+// ---- Stub decision ----
+
+static void test_unarmed_stub_boots(void) {
+    TEST_ASSERT_TRUE(wake_stub_valid(&s));
+    TEST_ASSERT_FALSE(wake_stub_absorb(&s, true));
+    TEST_ASSERT_EQUAL_UINT32(1, s.wakes);
+}
+
+static void test_run_absorbs_all_but_last_wake(void) {
+    wake_stub_arm(&s, 3, STEP_US);
+    TEST_ASSERT_TRUE(wake_stub_absorb(&s, true));
+    TEST_ASSERT_TRUE(wake_stub_absorb(&s, true));
+    TEST_ASSERT_FALSE(wake_stub_absorb(&s, true));
+    TEST_ASSERT_EQUAL_UINT32(3, s.wakes);
+    TEST_ASSERT_EQUAL_UINT32(2, s.absorbed);
+    // Booted: nothing more is absorbed until the app arms again
+    TEST_ASSERT_FALSE(wake_stub_absorb(&s, true));
+    TEST_ASSERT_TRUE(wake_stub_valid(&s));
+}
+
+static void test_button_wake_always_boots(void) {
+    wake_stub_arm(&s, 4, STEP_US);
+    TEST_ASSERT_TRUE(wake_stub_absorb(&s, true));
+    TEST_ASSERT_FALSE(wake_stub_absorb(&s, false));
+    TEST_ASSERT_EQUAL_UINT32(0, s.countdown);
+}
+
+static void test_corrupt_schedule_boots(void) {
+    wake_stub_arm(&s, 4, STEP_US);
+    s.countdown = 40000;                            // bit flips in RTC memory
+    TEST_ASSERT_FALSE(wake_stub_absorb(&s, true));
+    wake_stub_arm(&s, 4, STEP_US);
+    s.step_us ^= 1ULL << 40;
+    TEST_ASSERT_FALSE(wake_stub_absorb(&s, true));
+    wake_stub_arm(&s, 4, 0);                        // no sleep length: can't go back down
+    TEST_ASSERT_FALSE(wake_stub_absorb(&s, true));
+}
+
+// ---- Thinning ----
+
+static void test_quiet_streak_ramps_up_and_caps(void) {
+    TEST_ASSERT_EQUAL_UINT32(1, wake_stub_boot_every(&s, HOUR_S, HEARTBEAT_S));
+    for (uint32_t q = 1; q <= WAKE_STUB_MAX_SKIP + 2; q++) {
+        wake_stub_note_quiet(&s);
+        uint32_t expect = q < WAKE_STUB_MAX_SKIP ? q + 1 : WAKE_STUB_MAX_SKIP + 1;
+        TEST_ASSERT_EQUAL_UINT32(expect, wake_stub_boot_every(&s, HOUR_S, HEARTBEAT_S));
+    }
+    wake_stub_note_change(&s);
+    TEST_ASSERT_EQUAL_UINT32(1, wake_stub_boot_every(&s, HOUR_S, HEARTBEAT_S));
+}
+
+static void test_heartbeat_caps_the_run(void) {
+    for (int i = 0; i < 10; i++) wake_stub_note_quiet(&s);
+    TEST_ASSERT_EQUAL_UINT32(2, wake_stub_boot_every(&s, HOUR_S, 2 * HOUR_S + 100));
+    TEST_ASSERT_EQUAL_UINT32(1, wake_stub_boot_every(&s, HOUR_S, HOUR_S - 1));
+    TEST_ASSERT_EQUAL_UINT32(1, wake_stub_boot_every(&s, HOUR_S, 0));
+}
+
+// Two quiet days on an hourly cadence with a 6 h heartbeat: most wakes
+// stay in the stub, and no heartbeat is late.
+static void test_quiet_days_skip_most_boots(void) {
+    uint32_t published = 0, boots = 0, longest_silence = 0;
+    for (uint32_t now = HOUR_S; now <= 48 * HOUR_S; now += HOUR_S) {
+        if (wake_stub_absorb(&s, true)) continue;
+        boots++;
+        if (now - published >= HEARTBEAT_S) {
+            if (now - published > longest_silence) longest_silence = now - published;
+            published = now;                        // heartbeat report: streak stands
+        } else {
+            wake_stub_note_quiet(&s);
+        }
+        uint32_t headroom = published + HEARTBEAT_S - now;
+        wake_stub_arm(&s, wake_stub_boot_every(&s, HOUR_S, headroom), STEP_US);
+    }
+    TEST_ASSERT_EQUAL_UINT32(HEARTBEAT_S, longest_silence);
+    TEST_ASSERT_EQUAL_UINT32(48, s.wakes);
+    TEST_ASSERT_EQUAL_UINT32(48 - boots, s.absorbed);
+    TEST_ASSERT_LESS_THAN(20, boots);               // every wake boots without the stub
+}
+
+// ---- Telemetry ----
+
+static void test_encode(void) {
+    char buf[64];
+    telemetry_enc_t e;
+    telemetry_enc_init(&e, TELEMETRY_FMT_JSON, buf, sizeof(buf));
+    wake_stub_encode(&s, &e);                       // never woken: nothing
+    TEST_ASSERT_EQUAL_INT(0, telemetry_enc_finish(&e));
+
+    wake_stub_arm(&s, 3, STEP_US);
+    wake_stub_absorb(&s, true);
+    wake_stub_absorb(&s, true);
+    wake_stub_absorb(&s, true);
+    telemetry_enc_init(&e, TELEMETRY_FMT_JSON, buf, sizeof(buf));
+    wake_stub_encode(&s, &e);
+    TEST_ASSERT_GREATER_THAN(0, telemetry_enc_finish(&e));
+    TEST_ASSERT_EQUAL_STRING("\"stub\":{\"wakes\":3,\"absorbed\":2}", buf);
+}
+
+int main(void) {
+    UNITY_BEGIN();
+    RUN_TEST(test_unarmed_stub_boots);
+    RUN_TEST(test_run_absorbs_all_but_last_wake);
+    RUN_TEST(test_button_wake_always_boots);
+    RUN_TEST(test_corrupt_schedule_boots);
+    RUN_TEST(test_quiet_streak_ramps_up_and_caps);
+    RUN_TEST(test_heartbeat_caps_the_run);
+    RUN_TEST(test_quiet_days_skip_most_boots);
+    RUN_TEST(test_encode);
+    return UNITY_END();
+}
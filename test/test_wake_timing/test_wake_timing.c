@@ -0,0 +1,219 @@
+#include <unity.h>
+#include <string.h>
+
+#define TEST_HOST 1
+#include "../../src/crc32.c"
+#include "../../src/telemetry_enc.c"
+#include "../../src/wake_timing.c"
+
+void setUp(void) {}
+void tearDown(void) {}
+
+static wake_timing_log_t log_;
+
+// One WiFi-style wake: boot 80 ms, init 120 ms, net 900 ms with the MQTT
+// connect wait nested in publish, then sleep at 1.5 s + `extra_us`.
+static void run_wake(wake_timing_t *t, int64_t extra_us) {
+    wake_timing_begin_at(t, 80000, true);
+    wake_timing_start_at(t, WAKE_PHASE_INIT, 80000);
+    wake_timing_stop_at(t, WAKE_PHASE_INIT, 200000);
+    wake_timing_start_at(t, WAKE_PHASE_NET, 200000);
+    wake_timing_stop_at(t, WAKE_PHASE_NET, 1100000);
+    wake_timing_start_at(t, WAKE_PHASE_PUBLISH, 1100000);
+    wake_timing_start_at(t, WAKE_PHASE_CONNECT, 1100000);
+    wake_timing_stop_at(t, WAKE_PHASE_CONNECT, 1300000);
+    wake_timing_stop_at(t, WAKE_PHASE_PUBLISH, 1400000 + extra_us);
+    wake_timing_finish_at(t, 1500000 + extra_us);
+}
+
+// ---- Record ----
+
+static void test_phases_accumulate_and_nest(void) {
+    wake_timing_t t;
+    run_wake(&t, 0);
+    TEST_ASSERT_EQUAL_UINT32(80000, t.rec.phase_us[WAKE_PHASE_BOOT]);
+    TEST_ASSERT_EQUAL_UINT32(120000, t.rec.phase_us[WAKE_PHASE_INIT]);
+    TEST_ASSERT_EQUAL_UINT32(900000, t.rec.phase_us[WAKE_PHASE_NET]);
+    TEST_ASSERT_EQUAL_UINT32(200000, t.rec.phase_us[WAKE_PHASE_CONNECT]);
+    TEST_ASSERT_EQUAL_UINT32(300000, t.rec.phase_us[WAKE_PHASE_PUBLISH]);
+    TEST_ASSERT_EQUAL_UINT32(1500000, t.rec.total_us);
+    TEST_ASSERT_EQUAL_HEX16((1u << WAKE_PHASE_BOOT) | (1u << WAKE_PHASE_INIT) |
+                            (1u << WAKE_PHASE_NET) | (1u << WAKE_PHASE_CONNECT) |
+                            (1u << WAKE_PHASE_PUBLISH), t.rec.phase_mask);
+}
+
+static void test_reentered_phase_sums(void) {
+    wake_timing_t t;
+    wake_timing_begin_at(&t, 1000, false);
+    wake_timing_start_at(&t, WAKE_PHASE_SENSE, 1000);
+    wake_timing_stop_at(&t, WAKE_PHASE_SENSE, 1500);
+    wake_timing_start_at(&t, WAKE_PHASE_SENSE, 3000);
+    wake_timing_start_at(&t, WAKE_PHASE_SENSE, 3200);   // already open: ignored
+    wake_timing_stop_at(&t, WAKE_PHASE_SENSE, 3700);
+    wake_timing_stop_at(&t, WAKE_PHASE_SENSE, 9000);    // already closed: ignored
+    wake_timing_finish_at(&t, 4000);
+    TEST_ASSERT_EQUAL_UINT32(1200, t.rec.phase_us[WAKE_PHASE_SENSE]);
+    TEST_ASSERT_EQUAL_UINT32(3000, t.rec.total_us);
+    TEST_ASSERT_EQUAL_UINT32(0, t.rec.phase_us[WAKE_PHASE_BOOT]);
+    TEST_ASSERT_FALSE(t.rec.phase_mask & (1u << WAKE_PHASE_BOOT));
+}
+
+static void test_finish_closes_open_phases(void) {
+    wake_timing_t t;
+    wake_timing_begin_at(&t, 0, false);
+    wake_timing_start_at(&t, WAKE_PHASE_DISPLAY, 500);
+    wake_timing_finish_at(&t, 2500);
+    TEST_ASSERT_EQUAL_UINT32(2000, t.rec.phase_us[WAKE_PHASE_DISPLAY]);
+}
+
+// ---- Ring ----
+
+static void test_reset_log_is_valid_and_empty(void) {
+    wake_timing_log_reset(&log_);
+    TEST_ASSERT_TRUE(wake_timing_log_valid(&log_));
+    TEST_ASSERT_EQUAL_UINT32(0, log_.count);
+    TEST_ASSERT_NULL(wake_timing_log_last(&log_));
+}
+
+static void test_corruption_invalidates_log(void) {
+    wake_timing_t t;
+    wake_timing_log_reset(&log_);
+    run_wake(&t, 0);
+    wake_timing_log_push(&log_, &t.rec);
+    TEST_ASSERT_TRUE(wake_timing_log_valid(&log_));
+    log_.rec[0].phase_us[WAKE_PHASE_NET] ^= 1;
+    TEST_ASSERT_FALSE(wake_timing_log_valid(&log_));
+
+    memset(&log_, 0, sizeof(log_));                 // cold-boot RTC contents
+    TEST_ASSERT_FALSE(wake_timing_log_valid(&log_));
+}
+
+static void test_ring_keeps_newest_records(void) {
+    wake_timing_t t;
+    wake_timing_log_reset(&log_);
+    for (int i = 0; i < WAKE_TIMING_RECORDS + 3; i++) {
+        run_wake(&t, i * 1000);
+        wake_timing_log_push(&log_, &t.rec);
+    }
+    TEST_ASSERT_TRUE(wake_timing_log_valid(&log_));
+    TEST_ASSERT_EQUAL_UINT32(WAKE_TIMING_RECORDS, log_.count);
+    TEST_ASSERT_EQUAL_UINT32(WAKE_TIMING_RECORDS + 3, log_.seq);
+
+    wake_timing_stats_t s;
+    wake_timing_log_stats(&log_, WAKE_PHASE_COUNT, &s);
+    TEST_ASSERT_EQUAL_UINT32(WAKE_TIMING_RECORDS, s.n);
+    TEST_ASSERT_EQUAL_UINT32(1500000 + 3 * 1000, s.min_us);                        // oldest kept
+    TEST_ASSERT_EQUAL_UINT32(1500000 + (WAKE_TIMING_RECORDS + 2) * 1000, s.last_us);
+    TEST_ASSERT_EQUAL_UINT32(s.last_us, s.max_us);
+    TEST_ASSERT_EQUAL_UINT32(s.last_us, wake_timing_log_last(&log_)->total_us);
+}
+
+// ---- Summary ----
+
+static void test_stats_skip_records_without_the_phase(void) {
+    wake_timing_t t;
+    wake_timing_log_reset(&log_);
+    run_wake(&t, 0);                                   // has NET
+    wake_timing_log_push(&log_, &t.rec);
+    wake_timing_begin_at(&t, 0, false);                // no NET (e.g. failed early)
+    wake_timing_finish_at(&t, 5000);
+    wake_timing_log_push(&log_, &t.rec);
+
+    wake_timing_stats_t s;
+    wake_timing_log_stats(&log_, WAKE_PHASE_NET, &s);
+    TEST_ASSERT_EQUAL_UINT32(1, s.n);
+    TEST_ASSERT_EQUAL_UINT32(900000, s.last_us);
+
+    wake_timing_log_stats(&log_, WAKE_PHASE_COUNT, &s);
+    TEST_ASSERT_EQUAL_UINT32(2, s.n);
+    TEST_ASSERT_EQUAL_UINT32(5000, s.last_us);
+    TEST_ASSERT_EQUAL_UINT32((1500000 + 5000) / 2, s.mean_us);
+
+    wake_timing_log_stats(&log_, WAKE_PHASE_DISPLAY, &s);
+    TEST_ASSERT_EQUAL_UINT32(0, s.n);
+}
+
+static void test_json_lists_entered_phases_in_ms(void) {
+    wake_timing_t t;
+    wake_timing_log_reset(&log_);
+    run_wake(&t, 0);
+    wake_timing_log_push(&log_, &t.rec);
+    run_wake(&t, 101000);                              // publish 101 ms slower
+    wake_timing_log_push(&log_, &t.rec);
+
+    char buf[256];
+    int n = wake_timing_format_json(&log_, buf, sizeof(buf));
+    TEST_ASSERT_EQUAL_STRING(
+        "{\"n\":2,\"total\":[1601,1551,1601],\"boot\":[80,80,80],\"init\":[120,120,120],"
+        "\"net\":[900,900,900],\"conn\":[200,200,200],\"pub\":[401,351,401]}", buf);
+    TEST_ASSERT_EQUAL_INT((int)strlen(buf), n);
+}
+
+static void test_json_empty_log(void) {
+    char buf[16];
+    wake_timing_log_reset(&log_);
+    TEST_ASSERT_EQUAL_INT(7, wake_timing_format_json(&log_, buf, sizeof(buf)));
+    TEST_ASSERT_EQUAL_STRING("{\"n\":0}", buf);
+}
+
+static void test_json_too_small_fails(void) {
+    wake_timing_t t;
+    char buf[256];
+    wake_timing_log_reset(&log_);
+    run_wake(&t, 0);
+    wake_timing_log_push(&log_, &t.rec);
+    int full = wake_timing_format_json(&log_, buf, sizeof(buf));
+    TEST_ASSERT_TRUE(full > 0);
+    TEST_ASSERT_EQUAL_INT(-1, wake_timing_format_json(&log_, buf, (size_t)full));
+    TEST_ASSERT_EQUAL_INT(full, wake_timing_format_json(&log_, buf, (size_t)full + 1));
+}
+
+static void test_pack_layout(void) {
+    wake_timing_t t;
+    uint8_t out[WAKE_TIMING_PACK_LEN + 1];
+    wake_timing_log_reset(&log_);
+    run_wake(&t, 0);
+    wake_timing_log_push(&log_, &t.rec);
+    wake_timing_pack_zcl(&log_, out);
+
+    TEST_ASSERT_EQUAL_UINT8(WAKE_TIMING_PACK_LEN, out[0]);
+    TEST_ASSERT_EQUAL_UINT8(WAKE_TIMING_PACK_VERSION, out[1]);
+    TEST_ASSERT_EQUAL_UINT8(1, out[2]);
+    // Total: 1500 ms = 0x05DC, little-endian, last then mean.
+    TEST_ASSERT_EQUAL_UINT8(0xDC, out[3]);
+    TEST_ASSERT_EQUAL_UINT8(0x05, out[4]);
+    TEST_ASSERT_EQUAL_UINT8(0xDC, out[5]);
+    TEST_ASSERT_EQUAL_UINT8(0x05, out[6]);
+    // NET (900 ms = 0x0384) sits at 3 + 4 * (1 + WAKE_PHASE_NET).
+    const uint8_t *net = &out[3 + 4 * (1 + WAKE_PHASE_NET)];
+    TEST_ASSERT_EQUAL_UINT8(0x84, net[0]);
+    TEST_ASSERT_EQUAL_UINT8(0x03, net[1]);
+    // DISPLAY was never entered.
+    const uint8_t *disp = &out[3 + 4 * (1 + WAKE_PHASE_DISPLAY)];
+    TEST_ASSERT_EQUAL_UINT8(0xFF, disp[0]);
+    TEST_ASSERT_EQUAL_UINT8(0xFF, disp[1]);
+}
+
+static void test_every_phase_has_a_name(void) {
+    for (int p = 0; p < WAKE_PHASE_COUNT; p++) {
+        TEST_ASSERT_NOT_NULL(PHASE_NAMES[p]);
+    }
+    TEST_ASSERT_EQUAL_STRING("?", wake_timing_phase_name(WAKE_PHASE_COUNT));
+}
+
+int main(void) {
+    UNITY_BEGIN();
+    RUN_TEST(test_phases_accumulate_and_nest);
+    RUN_TEST(test_reentered_phase_sums);
+    RUN_TEST(test_finish_closes_open_phases);
+    RUN_TEST(test_reset_log_is_valid_and_empty);
+    RUN_TEST(test_corruption_invalidates_log);
+    RUN_TEST(test_ring_keeps_newest_records);
+    RUN_TEST(test_stats_skip_records_without_the_phase);
+    RUN_TEST(test_json_lists_entered_phases_in_ms);
+    RUN_TEST(test_json_empty_log);
+    RUN_TEST(test_json_too_small_fails);
+    RUN_TEST(test_pack_layout);
+    RUN_TEST(test_every_phase_has_a_name);
+    return UNITY_END();
+}
@@ -0,0 +1,108 @@
+#include <unity.h>
+#include <string.h>
+
+#define TEST_HOST 1
+#include "../../src/crc32.c"
+#include "../../src/wifi_fast_cache.c"
+
+void setUp(void) {}
+void tearDown(void) {}
+
+static const uint8_t BSSID[6] = { 0x24, 0x0A, 0xC4, 0x11, 0x22, 0x33 };
+static wifi_fast_cache_t c;
+
+static uint32_t key(void) {
+    return wifi_fast_cache_key("garden", "hunter22");
+}
+
+static void store_dhcp(uint32_t now_s, uint32_t lease_s) {
+    wifi_fast_cache_store(&c, key(), BSSID, 6, 0x6401A8C0u, 0x00FFFFFFu, 0x0101A8C0u,
+                          0x0101A8C0u, now_s, true, lease_s);
+}
+
+static void test_cold_boot_cache_is_unused(void) {
+    memset(&c, 0, sizeof(c));
+    TEST_ASSERT_FALSE(wifi_fast_cache_valid(&c));
+    TEST_ASSERT_FALSE(wifi_fast_cache_use_bssid(&c, key()));
+    TEST_ASSERT_FALSE(wifi_fast_cache_use_ip(&c, key(), 0));
+}
+
+static void test_store_and_use(void) {
+    store_dhcp(1000, 86400);
+    TEST_ASSERT_TRUE(wifi_fast_cache_valid(&c));
+    TEST_ASSERT_TRUE(wifi_fast_cache_use_bssid(&c, key()));
+    TEST_ASSERT_TRUE(wifi_fast_cache_use_ip(&c, key(), 1000 + 3600));
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(BSSID, c.bssid, 6);
+    TEST_ASSERT_EQUAL_UINT8(6, c.channel);
+}
+
+static void test_ip_reuse_stops_at_half_lease(void) {
+    store_dhcp(1000, 86400);
+    TEST_ASSERT_TRUE(wifi_fast_cache_use_ip(&c, key(), 1000 + 43199));
+    TEST_ASSERT_FALSE(wifi_fast_cache_use_ip(&c, key(), 1000 + 43200));
+    // The BSSID hint outlives the lease.
+    TEST_ASSERT_TRUE(wifi_fast_cache_use_bssid(&c, key()));
+}
+
+static void test_unknown_lease_uses_default(void) {
+    store_dhcp(0, 0);
+    TEST_ASSERT_EQUAL_UINT32(WIFI_FAST_LEASE_S, c.lease_s);
+    TEST_ASSERT_TRUE(wifi_fast_cache_use_ip(&c, key(), WIFI_FAST_LEASE_S / 2 - 1));
+    TEST_ASSERT_FALSE(wifi_fast_cache_use_ip(&c, key(), WIFI_FAST_LEASE_S / 2));
+}
+
+static void test_reused_ip_keeps_lease_clock(void) {
+    store_dhcp(1000, 86400);
+    // A static-IP wake refreshes the BSSID (AP roamed) but not the lease.
+    uint8_t other[6] = { 0x24, 0x0A, 0xC4, 0x44, 0x55, 0x66 };
+    wifi_fast_cache_store(&c, key(), other, 11, 0x6401A8C0u, 0x00FFFFFFu, 0x0101A8C0u,
+                          0x0101A8C0u, 30000, false, 0);
+    TEST_ASSERT_EQUAL_UINT32(1000, c.lease_start_s);
+    TEST_ASSERT_EQUAL_UINT8(11, c.channel);
+    TEST_ASSERT_FALSE(wifi_fast_cache_use_ip(&c, key(), 1000 + 43200));
+}
+
+static void test_reused_ip_without_grant_forces_dhcp(void) {
+    memset(&c, 0, sizeof(c));
+    wifi_fast_cache_store(&c, key(), BSSID, 6, 0x6401A8C0u, 0x00FFFFFFu, 0x0101A8C0u,
+                          0, 500, false, 0);
+    TEST_ASSERT_TRUE(wifi_fast_cache_use_bssid(&c, key()));
+    TEST_ASSERT_FALSE(wifi_fast_cache_use_ip(&c, key(), 500));
+}
+
+static void test_new_credentials_or_corruption_invalidate(void) {
+    store_dhcp(1000, 86400);
+    TEST_ASSERT_FALSE(wifi_fast_cache_use_bssid(&c, wifi_fast_cache_key("garden", "new-pass")));
+    TEST_ASSERT_TRUE(wifi_fast_cache_key("ab", "c") != wifi_fast_cache_key("a", "bc"));
+
+    c.ip ^= 1;
+    TEST_ASSERT_FALSE(wifi_fast_cache_valid(&c));
+    TEST_ASSERT_FALSE(wifi_fast_cache_use_ip(&c, key(), 1001));
+}
+
+static void test_clock_behind_grant_skips_ip(void) {
+    store_dhcp(50000, 86400);
+    TEST_ASSERT_FALSE(wifi_fast_cache_use_ip(&c, key(), 10));
+    TEST_ASSERT_TRUE(wifi_fast_cache_use_bssid(&c, key()));
+}
+
+static void test_invalidate(void) {
+    store_dhcp(1000, 86400);
+    wifi_fast_cache_invalidate(&c);
+    TEST_ASSERT_FALSE(wifi_fast_cache_valid(&c));
+    TEST_ASSERT_FALSE(wifi_fast_cache_use_bssid(&c, key()));
+}
+
+int main(void) {
+    UNITY_BEGIN();
+    RUN_TEST(test_cold_boot_cache_is_unused);
+    RUN_TEST(test_store_and_use);
+    RUN_TEST(test_ip_reuse_stops_at_half_lease);
+    RUN_TEST(test_unknown_lease_uses_default);
+    RUN_TEST(test_reused_ip_keeps_lease_clock);
+    RUN_TEST(test_reused_ip_without_grant_forces_dhcp);
+    RUN_TEST(test_new_credentials_or_corruption_invalidate);
+    RUN_TEST(test_clock_behind_grant_skips_ip);
+    RUN_TEST(test_invalidate);
+    return UNITY_END();
+}
@@ -4,9 +4,19 @@
 //   - soil_moisture %  (carried on the Relative Humidity cluster 0x0405, since the
 //                       SDK's custom Soil Moisture 0x0408 cluster asserts; humidity
 //                       and soil moisture share the same 0.01% uint16 wire format)
+//   - soil_moisture_2..4
+//                      (multi-probe builds, SOIL_PROBE_COUNT > 1: probe n reports
+//                       on endpoint 1+n; same keys as the firmware's MQTT payload)
 //   - label            (device-set sensor name, from Basic cluster
 //                       LocationDescription 0x0010; published in every payload so
 //                       Node-RED can identify the physical sensor)
+//   - wake_timing      (manufacturer-specific Basic attribute 0xF000: per-phase
+//                       ms of the last few report cycles, read on configure or
+//                       on demand from the dev console with manufacturerCode 0xFEFE)
+//   - mAh_per_wake, days_remaining
+//                      (manufacturer-specific Basic attributes 0xF001/0xF002: the
+//                       firmware's mean charge per wake cycle since its ledger
+//                       reset, as the MQTT mAh_per_wake; read the same way)
 //
 // Install: copy this file into the zigbee2mqtt config dir, reference it under
 //   external_converters:
@@ -23,7 +33,7 @@
 //     disable_automatic_update_check: true   # staged/manual rollout
 // Trigger updates per device in the z2m UI (device -> OTA -> Update).
 
-const {battery, numeric} = require('zigbee-herdsman-converters/lib/modernExtend');
+const {battery} = require('zigbee-herdsman-converters/lib/modernExtend');
 const exposes = require('zigbee-herdsman-converters/lib/exposes');
 const e = exposes.presets;
 const ea = exposes.access;
@@ -38,6 +48,76 @@ const fzLabel = {
     },
 };
 
+// Phase order of the firmware's wake_phase_t (include/wake_timing.h).
+const WAKE_PHASES = ['boot', 'init', 'ocv', 'net', 'broker', 'conn', 'adc', 'sense', 'pub', 'disp'];
+const ATTR_WAKE_TIMING = 0xF000;
+
+// Manufacturer attributes arrive keyed by numeric id (no name in the cluster
+// definition); accept either key form.
+const attr = (data, id) => data[id] ?? data[String(id)];
+
+// Octet string: version 1, cycle count, then {last_ms, mean_ms} u16 LE for the
+// total and each phase; 0xFFFF marks a phase not entered in any retained cycle.
+const fzWakeTiming = {
+    cluster: 'genBasic',
+    type: ['attributeReport', 'readResponse'],
+    convert: (model, msg, publish, options, meta) => {
+        const raw = attr(msg.data, ATTR_WAKE_TIMING);
+        if (!raw || raw.length < 2 || raw[0] !== 1) {
+            return;
+        }
+        const timing = {cycles: raw[1]};
+        ['total', ...WAKE_PHASES].forEach((name, i) => {
+            const off = 2 + 4 * i;
+            if (off + 4 > raw.length || raw.readUInt16LE(off) === 0xffff) {
+                return;
+            }
+            timing[name] = {last_ms: raw.readUInt16LE(off), mean_ms: raw.readUInt16LE(off + 2)};
+        });
+        return {wake_timing: timing};
+    },
+};
+
+// Probe n of the firmware's soil_probe table reports on endpoint 1+n; keys match
+// the MQTT payload (include/soil_probe.h, src/soil_probe.c).
+const SOIL_KEYS = {1: 'soil_moisture', 2: 'soil_moisture_2', 3: 'soil_moisture_3', 4: 'soil_moisture_4'};
+
+const fzSoil = {
+    cluster: 'msRelativeHumidity',
+    type: ['attributeReport', 'readResponse'],
+    convert: (model, msg, publish, options, meta) => {
+        const key = SOIL_KEYS[msg.endpoint.ID];
+        const value = msg.data.measuredValue;
+        if (key && value !== undefined) {
+            return {[key]: Math.round(value / 10) / 10};
+        }
+    },
+};
+
+// Endpoints of this device that carry a probe (just 1 on single-probe builds).
+const soilEndpoints = (device) =>
+    (device ? device.endpoints : [{ID: 1}]).filter((ep) => SOIL_KEYS[ep.ID]);
+
+const ATTR_MEAN_NAH = 0xF001;
+const ATTR_DAYS_LEFT_X10 = 0xF002;
+
+const fzEnergy = {
+    cluster: 'genBasic',
+    type: ['attributeReport', 'readResponse'],
+    convert: (model, msg, publish, options, meta) => {
+        const result = {};
+        const nah = attr(msg.data, ATTR_MEAN_NAH);
+        const days = attr(msg.data, ATTR_DAYS_LEFT_X10);
+        if (nah !== undefined) {
+            result.mAh_per_wake = nah / 1e6;
+        }
+        if (days !== undefined) {
+            result.days_remaining = days / 10;
+        }
+        return Object.keys(result).length ? result : undefined;
+    },
+};
+
 module.exports = [
     {
         zigbeeModel: ['DFR-SoilSensor'],
@@ -52,25 +132,30 @@ module.exports = [
                 percentage: true,
                 voltage: true,
             }),
-            numeric({
-                name: 'soil_moisture',
-                cluster: 'msRelativeHumidity',          // 0x0405
-                attribute: 'measuredValue',
-                scale: 100,                              // 0.01% units -> %
-                unit: '%',
-                precision: 1,
-                description: 'Soil moisture',
-                access: 'STATE',
-                reporting: {min: '10_SECONDS', max: '1_HOUR', change: 50},
-            }),
         ],
-        fromZigbee: [fzLabel],
-        exposes: [
+        fromZigbee: [fzSoil, fzLabel, fzWakeTiming, fzEnergy],
+        exposes: (device, options) => [
+            ...soilEndpoints(device).map((ep) =>
+                e.numeric(SOIL_KEYS[ep.ID], ea.STATE).withUnit('%')
+                    .withDescription(ep.ID === 1 ? 'Soil moisture' : `Soil moisture, probe ${ep.ID}`)),
             e.text('label', ea.STATE).withDescription('Device-set sensor name (Node-RED identifier)'),
         ],
         configure: async (device, coordinatorEndpoint, logger) => {
+            // 0x0405 measuredValue in 0.01% units; report on 0.5% change.
+            for (const soilEp of soilEndpoints(device)) {
+                await soilEp.bind('msRelativeHumidity', coordinatorEndpoint);
+                await soilEp.configureReporting('msRelativeHumidity', [{
+                    attribute: 'measuredValue',
+                    minimumReportInterval: 10,
+                    maximumReportInterval: 3600,
+                    reportableChange: 50,
+                }]);
+            }
             const ep = device.getEndpoint(1);
             await ep.read('genBasic', ['locationDesc']);
+            // Older firmware has no wake-timing attribute; don't fail configure over it.
+            await ep.read('genBasic', [ATTR_WAKE_TIMING, ATTR_MEAN_NAH, ATTR_DAYS_LEFT_X10],
+                {manufacturerCode: 0xFEFE}).catch(() => {});
         },
         // OTA (z2m 2.x form): `ota: true` opts the device into z2m's OTA subsystem,
         // which matches an image from the override index by manufacturerCode 0xFEFE
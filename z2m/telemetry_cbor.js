@@ -0,0 +1,89 @@
+// Decoder for the WiFi build's CBOR telemetry (src/telemetry_enc.c), for
+// devices set to "CBOR" in the config portal. They publish to
+// zigbee2mqtt/{device_id}/cbor instead of the JSON topic; decode() returns
+// the same object the JSON payload would parse to.
+//
+// Only the subset the firmware writes is handled: integers, text strings,
+// indefinite-length maps/arrays, and tag 4 decimal fractions (fixed-point
+// values such as battery volts), which come back as plain numbers.
+//
+// Node-RED: put this file's decode() in a function node (or require it via
+// functionGlobalContext) after an "mqtt in" node on zigbee2mqtt/+/cbor with
+// output "a Buffer":
+//     msg.payload = decode(msg.payload);
+//     msg.topic = msg.topic.replace(/\/cbor$/, '');
+//     return msg;
+//
+// CLI check against a captured payload:
+//     node z2m/telemetry_cbor.js bf6162c482211901...ff
+
+'use strict';
+
+function decode(buf) {
+    let pos = 0;
+
+    const arg = (info) => {
+        if (info < 24) return info;
+        const n = {24: 1, 25: 2, 26: 4}[info];
+        if (n === undefined) throw new Error(`unsupported length encoding ${info} at ${pos - 1}`);
+        let v = 0;
+        for (let i = 0; i < n; i++) v = v * 256 + buf[pos++];
+        return v;
+    };
+
+    const item = () => {
+        if (pos >= buf.length) throw new Error('truncated payload');
+        const b = buf[pos++];
+        const major = b >> 5;
+        const info = b & 0x1f;
+        switch (major) {
+        case 0: return arg(info);
+        case 1: return -1 - arg(info);
+        case 3: {
+            const n = arg(info);
+            const s = buf.toString('utf8', pos, pos + n);
+            pos += n;
+            return s;
+        }
+        case 4: {
+            if (info !== 31) return Array.from({length: arg(info)}, item);
+            const out = [];
+            while (buf[pos] !== 0xff) out.push(item());
+            pos++;
+            return out;
+        }
+        case 5: {
+            if (info !== 31) throw new Error('definite-length map not expected');
+            const out = {};
+            while (buf[pos] !== 0xff) {
+                const k = item();
+                out[k] = item();
+            }
+            pos++;
+            return out;
+        }
+        case 6: {
+            const tag = arg(info);
+            const v = item();
+            if (tag === 4) {
+                // [exponent, mantissa]; toFixed keeps 4.1 as 4.1, not 4.1000000000000005
+                const [exp, mant] = v;
+                return exp < 0 ? Number((mant * 10 ** exp).toFixed(-exp)) : mant * 10 ** exp;
+            }
+            return v;
+        }
+        default:
+            throw new Error(`unsupported major type ${major} at ${pos - 1}`);
+        }
+    };
+
+    const v = item();
+    if (pos !== buf.length) throw new Error(`${buf.length - pos} trailing bytes`);
+    return v;
+}
+
+module.exports = {decode};
+
+if (require.main === module) {
+    console.log(JSON.stringify(decode(Buffer.from(process.argv[2], 'hex'))));
+}